@@ -163,6 +163,17 @@ standard names. */
 
 /* USER CODE BEGIN Defines */
 /* Section where parameter definitions can be added (for instance, to override default ones in FreeRTOS.h) */
+/* Tickless idle: the suppressed ticks are limited to the next expiry of LibTimer and caught up on wake-up, see
+   freertos.c. While awake the tick is unchanged. */
+#define configUSE_TICKLESS_IDLE                  1
+#if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
+  void PreSuppressTicksProcessing(uint32_t *ulExpectedIdleTime);
+  void PreSleepProcessing(uint32_t *ulExpectedIdleTime);
+  void StepTickProcessing(uint32_t ulTicksToJump);
+#endif
+#define configPRE_SUPPRESS_TICKS_AND_SLEEP_PROCESSING(x) PreSuppressTicksProcessing(&(x))
+#define configPRE_SLEEP_PROCESSING(x)            PreSleepProcessing(&(x))
+#define traceINCREASE_TICK_COUNT(x)              StepTickProcessing(x)
 /* USER CODE END Defines */
 
 #endif /* FREERTOS_CONFIG_H */
@@ -28,6 +28,13 @@
 #include "CanNm.h"
 #include "CanIF.h"
 #include "CanTask.h"
+#include "LibTimer.h"
+
+#if (configUSE_TICKLESS_IDLE != 0) && !defined(LIBTIMERCFG_DEFERRED_CALLBACKS)
+/* LibTimer_StepTicks() runs inside vTaskStepTick() with the interrupts disabled: the timers expired during the sleep
+   have to be queued for the dispatch task instead of running their callbacks there */
+#error "The tickless idle mode requires LIBTIMERCFG_DEFERRED_CALLBACKS"
+#endif
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -47,7 +54,24 @@
 
 /* Private variables ---------------------------------------------------------*/
 /* USER CODE BEGIN Variables */
-
+#ifdef CANTASK_CFG_SPLIT_SERVICE_HOSTS
+/* Definitions for TaskBSWIL10ms, hosting the CAN interaction layer */
+osThreadId_t TaskBSWIL10msHandle;
+const osThreadAttr_t TaskBSWIL10ms_attributes = {
+  .name = "TaskBSWIL10ms",
+  .stack_size = 128 * 4,
+  .priority = (osPriority_t) osPriorityNormal,
+};
+#endif
+#ifdef LIBTIMERCFG_DEFERRED_CALLBACKS
+/* Definitions for TaskTimerDispatch, invoking the LibTimer callbacks outside the tick ISR */
+osThreadId_t TaskTimerDispatchHandle;
+const osThreadAttr_t TaskTimerDispatch_attributes = {
+  .name = "TaskTimerDispatch",
+  .stack_size = 128 * 4,
+  .priority = (osPriority_t) osPriorityRealtime,
+};
+#endif
 /* USER CODE END Variables */
 /* Definitions for Task10ms */
 osThreadId_t Task10msHandle;
@@ -97,7 +121,13 @@ const osEventFlagsAttr_t myEvent01_attributes = {
 
 /* Private function prototypes -----------------------------------------------*/
 /* USER CODE BEGIN FunctionPrototypes */
-
+#ifdef CANTASK_CFG_SPLIT_SERVICE_HOSTS
+void StartBSWILTask10ms(void *argument);
+#endif
+#ifdef LIBTIMERCFG_DEFERRED_CALLBACKS
+void StartTimerDispatchTask(void *argument);
+static void TimerDispatch_Notify(void *pData);
+#endif
 /* USER CODE END FunctionPrototypes */
 
 void StartTask10ms(void *argument);
@@ -120,6 +150,55 @@ void vApplicationTickHook( void )
    functions can be used (those that end in FromISR()). */
   LibTimer_Tick();
 }
+
+/**
+* @brief Limit the number of ticks suppressed by the idle task to the next expiry of LibTimer.
+* @param ulExpectedIdleTime: ticks until the next RTOS timeout, may be lowered
+* @retval None
+*/
+void PreSuppressTicksProcessing(uint32_t *ulExpectedIdleTime)
+{
+  uint32_t ulNextExpiry;
+
+  taskENTER_CRITICAL();
+  ulNextExpiry = LibTimer_GetNextExpiry_ms();
+  taskEXIT_CRITICAL();
+
+  if (ulNextExpiry < *ulExpectedIdleTime)
+  {
+    *ulExpectedIdleTime = ulNextExpiry;
+  }
+}
+
+/**
+* @brief Check the limit again right before the sleep, called with interrupts disabled.
+* @param ulExpectedIdleTime: ticks the SysTick has been programmed for, set to 0 to skip the sleep
+* @retval None
+*/
+void PreSleepProcessing(uint32_t *ulExpectedIdleTime)
+{
+  /* a timer has been started by an interrupt in the meantime: the SysTick would wake up too late */
+  if (LibTimer_GetNextExpiry_ms() < *ulExpectedIdleTime)
+  {
+    *ulExpectedIdleTime = 0U;
+  }
+}
+
+/**
+* @brief Catch up on the ticks suppressed by the tickless idle mode, called with interrupts disabled.
+* @param ulTicksToJump: number of suppressed ticks
+* @retval None
+*/
+void StepTickProcessing(uint32_t ulTicksToJump)
+{
+  uint32_t ulTick;
+
+  for (ulTick = 0U; ulTick < ulTicksToJump; ulTick++)
+  {
+    HAL_IncTick();
+  }
+  LibTimer_StepTicks(ulTicksToJump);
+}
 /* USER CODE END 3 */
 
 /* USER CODE BEGIN 4 */
@@ -184,6 +263,14 @@ void MX_FREERTOS_Init(void) {
 
   /* USER CODE BEGIN RTOS_THREADS */
   /* add threads, ... */
+#ifdef CANTASK_CFG_SPLIT_SERVICE_HOSTS
+  /* creation of TaskBSWIL10ms */
+  TaskBSWIL10msHandle = osThreadNew(StartBSWILTask10ms, NULL, &TaskBSWIL10ms_attributes);
+#endif
+#ifdef LIBTIMERCFG_DEFERRED_CALLBACKS
+  /* creation of TaskTimerDispatch */
+  TaskTimerDispatchHandle = osThreadNew(StartTimerDispatchTask, NULL, &TaskTimerDispatch_attributes);
+#endif
   /* USER CODE END RTOS_THREADS */
 
   /* creation of myEvent01 */
@@ -228,9 +315,6 @@ void StartTask10ms(void *argument)
 void StartBSWTask10ms(void *argument)
 {
   /* USER CODE BEGIN StartBSWTask10ms */
-  TickType_t xLastWakeTime;
-  xLastWakeTime = osKernelGetTickCount();
-
   TASK_CAN_ServiceHostInit();
 
 
@@ -238,9 +322,13 @@ void StartBSWTask10ms(void *argument)
   for(;;)
   {
     
-    TASK_CAN_ServiceHostMain();
-
-    vTaskDelayUntil(&xLastWakeTime, 10);
+    /* run the next pass right away while services are pending, otherwise block until the next event: the timer
+       callbacks, the CAN interrupts and the other tasks notify the task, so no periodic wake-up is required and the
+       tickless idle mode can sleep until the next LibTimer expiry */
+    if (!TASK_CAN_ServiceHostMain())
+    {
+      (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
   }
   /* USER CODE END StartBSWTask10ms */
 }
@@ -255,6 +343,58 @@ void Callback01(void *argument)
 
 /* Private application code --------------------------------------------------*/
 /* USER CODE BEGIN Application */
+#ifdef CANTASK_CFG_SPLIT_SERVICE_HOSTS
+/**
+* @brief Function implementing the TaskBSWIL10ms thread.
+* @param argument: Not used
+* @retval None
+*/
+void StartBSWILTask10ms(void *argument)
+{
+  TASK_CANIL_ServiceHostInit();
+
+  /* Infinite loop */
+  for(;;)
+  {
+    /* run the next pass right away while services are pending, otherwise block until the next event */
+    if (!TASK_CANIL_ServiceHostMain())
+    {
+      (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+  }
+}
+#endif
+
+#ifdef LIBTIMERCFG_DEFERRED_CALLBACKS
+/**
+* @brief Function implementing the TaskTimerDispatch thread.
+* @param argument: Not used
+* @retval None
+*/
+void StartTimerDispatchTask(void *argument)
+{
+  LibTimer_SetDispatchCallback(TimerDispatch_Notify, xTaskGetCurrentTaskHandle());
+
+  /* Infinite loop */
+  for(;;)
+  {
+    LibTimer_Dispatch();
 
+    /* wait for the tick to report expired timers */
+    (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+  }
+}
+
+/**
+* @brief Wake up the TaskTimerDispatch thread, called from the tick hook.
+* @param pData: handle of the TaskTimerDispatch thread
+* @retval None
+*/
+static void TimerDispatch_Notify(void *pData)
+{
+  /* the yield request is picked up at the end of the tick interrupt */
+  vTaskNotifyGiveFromISR((TaskHandle_t)pData, NULL);
+}
+#endif
 /* USER CODE END Application */
 
@@ -40,6 +40,18 @@ struct S_LibDiagCom_Msg_t;
 // --------------------------------------------------------------------------------------------------------------------
 typedef void (*LibDiagCom_MsgSendClbk)(struct S_LibDiagCom_Msg_t* pMsg);
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Lend the transmit buffer of the connection which received the request
+///
+/// \param pMsg
+/// The received request
+/// \param pMaxLen
+/// Size of the buffer
+/// \return
+/// The buffer, NULL if it cannot be lent
+// --------------------------------------------------------------------------------------------------------------------
+typedef uint8_t* (*LibDiagCom_TxBufferClbk)(struct S_LibDiagCom_Msg_t* pMsg, uint16_t* pMaxLen);
+
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief 
 // --------------------------------------------------------------------------------------------------------------------
@@ -49,6 +61,11 @@ typedef struct S_LibDiagCom_Msg_t {
 	// ----------------------------------------------------------------------------------------------------------------
 	E_LibDrv_DevId_t 		DevId;
 
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Transport layer connection which received the request, the response is sent over the same connection
+	// ----------------------------------------------------------------------------------------------------------------
+	uint8_t 				ConnId;
+
 	// ----------------------------------------------------------------------------------------------------------------
 	/// \brief 
 	// ----------------------------------------------------------------------------------------------------------------
@@ -83,6 +100,13 @@ typedef struct S_LibDiagCom_Msg_t {
 	/// \brief 
 	// ----------------------------------------------------------------------------------------------------------------
 	LibDiagCom_MsgSendClbk 	SendMessage;
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Lends the transmit buffer of the connection, NULL if the transport layer does not lend its buffer
+	///
+	/// A response written into the lent buffer and sent with pPayload pointing to it is segmented straight from the
+	/// buffer, the transport layer does not copy it.
+	// ----------------------------------------------------------------------------------------------------------------
+	LibDiagCom_TxBufferClbk	GetTxBuffer;
 } S_LibDiagCom_Msg_t;
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -152,6 +176,20 @@ extern void LibDiagCom_MsgSend(S_LibUds_IfaceCfg_t* pMsg);
 // --------------------------------------------------------------------------------------------------------------------
 extern S_LibDiagCom_Msg_t* LibDiagCom_GetMsg(void);
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Get the transmit buffer of the connection of the request in process
+///
+/// The response is assembled in place and sent by LibDiagCom_MsgSend() with S_LibUds_IfaceCfg_t::pPayload pointing to
+/// the buffer, the transport layer then segments it without a copy. The buffer is the one which holds the request,
+/// request data must be read before it is overwritten by the response.
+///
+/// \param pMaxLen
+/// Size of the buffer
+/// \return
+/// The buffer, NULL if no request is in process or the transport layer does not lend its buffer
+// --------------------------------------------------------------------------------------------------------------------
+extern uint8_t* LibDiagCom_GetTxBuffer(uint16_t* pMaxLen);
+
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief Notify the DiagCom that a request is processed and the response is available
 // --------------------------------------------------------------------------------------------------------------------
@@ -255,6 +255,9 @@ void LibDiagCom_MsgSend(S_LibUds_IfaceCfg_t* pMsg)
 
 		LibDiagCom_MsgSendInt(pComMsg);
 	}
+
+	// the request is finished, the transport layer may hand over the next received message
+	LibService_SetEvent(&LibCanTp_Service, LIBCANTP_SRV_EV_DIAGCOM_READY);
 }
 
 void LibDiagCom_MsgSendInt(S_LibDiagCom_Msg_t* pMsg)
@@ -280,6 +283,7 @@ extern void LibDiagCom_AbortRequest(void)
 		LibLog_Debug("UdsAssist is aborted\n");
 	}
 	LibUds_Init();
+	LibService_SetEvent(&LibCanTp_Service, LIBCANTP_SRV_EV_DIAGCOM_READY);
 }
 
 S_LibDiagCom_Msg_t* LibDiagCom_GetMsg(void)
@@ -287,6 +291,21 @@ S_LibDiagCom_Msg_t* LibDiagCom_GetMsg(void)
 	return &LibDiagCom_ComMsg;
 }
 
+uint8_t* LibDiagCom_GetTxBuffer(uint16_t* pMaxLen)
+{
+	S_LibDiagCom_Msg_t* pComMsg = LibDiagCom_Tracker.pComMsg;
+	uint8_t* pBuffer = NULL;
+
+	// only the connection of the request in process is lent, its buffer belongs to DiagCom until the response
+	if ((LIBDIAGCOM_STATE_PROCESSING == LibDiagCom_Tracker.State) && (NULL != pComMsg)
+	 && (NULL != pComMsg->GetTxBuffer))
+	{
+		pBuffer = pComMsg->GetTxBuffer(pComMsg, pMaxLen);
+	}
+
+	return pBuffer;
+}
+
 void LibDiagCom_RequestProcessed(void)
 {
 	LibDiagCom_MsgSend(LibDiagCom_Tracker.pUdsIface);
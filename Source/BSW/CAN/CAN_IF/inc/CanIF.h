@@ -7,6 +7,8 @@
 #include "can.h"
 #include "can_message.h"
 #include "LibFifoQueue.h"
+#include "LibFifoTyped.h"
+#include "LibCanMsg.h"
 // --------------------------------------------------------------------------------------------------------------------
 //	Global Definitions
 // --------------------------------------------------------------------------------------------------------------------
@@ -17,16 +19,41 @@
 /* ------------------------------------------------------------------------------------------------------- */
 
 // -------------------------------------------------------------------------------------------------------------------- 
-/// \brief Number of messages allowed in the RECEIVE FIFO 
+/// \brief Number of messages allowed in the RECEIVE FIFO (power of two, the FIFO is lock-free)
 // -------------------------------------------------------------------------------------------------------------------- 
 #define CANIF_MSG_RECV_FIFO_ELEMENTS  8U
 
+// -------------------------------------------------------------------------------------------------------------------- 
+/// \brief Number of entries of the RECEIVE FIFO reserved for priority messages (network management and transport
+/// protocol): other messages are dropped as soon as only this number of entries is left
+// -------------------------------------------------------------------------------------------------------------------- 
+#define CANIF_MSG_RECV_PRIORITY_ELEMENTS  2U
+
+// -------------------------------------------------------------------------------------------------------------------- 
+/// \brief Number of transmit mailboxes of one CAN controller
+// -------------------------------------------------------------------------------------------------------------------- 
+#define CANIF_TX_MAILBOXES  3U
+
 // --------------------------------------------------------------------------------------------------------------------
 //	Global Data Types
 // --------------------------------------------------------------------------------------------------------------------
 
+// -------------------------------------------------------------------------------------------------------------------- 
+/// \brief Receive FIFO specialized for CAN messages: type S_CanIF_MsgRecv_Fifo_t and functions CanIF_MsgRecv_xxx()
+// -------------------------------------------------------------------------------------------------------------------- 
+LIBFIFO_DECLARE_TYPED(CanIF_MsgRecv, S_LibCan_Msg_t, CANIF_MSG_RECV_FIFO_ELEMENTS)
+
+extern S_CanIF_MsgRecv_Fifo_t CanIF_MsgRecvFifo;
 
-extern S_LibFifoQueue_Inst_t CanIF_MsgRecvFifo;
+// -------------------------------------------------------------------------------------------------------------------- 
+/// \brief Callback invoked from the transmit complete interrupt for a frame sent by CanIF_TxFrame()
+///
+/// \param pData
+/// User data given to CanIF_TxFrame()
+/// \param isSent
+/// true if the frame was transmitted, false if the transmission was aborted or failed
+// -------------------------------------------------------------------------------------------------------------------- 
+typedef void (*CanIF_TxCompleteClbk)(void* pData, bool_t isSent);
 // --------------------------------------------------------------------------------------------------------------------
 //	Imported Variables
 // --------------------------------------------------------------------------------------------------------------------
@@ -56,5 +83,24 @@ extern void Can2_Bus_Off(void);
 extern uint8_t Can1_Bus_Off_flag;
 extern uint8_t Can2_Bus_Off_flag;
 
+// -------------------------------------------------------------------------------------------------------------------- 
+/// \brief Write a frame into a free transmit mailbox
+///
+/// May be called from task and interrupt context. The callback is invoked from the transmit complete interrupt of
+/// the mailbox. The mailboxes are sent by the priority of the identifier (no transmit FIFO priority), frames with the
+/// same identifier may leave in any order: a caller which depends on the order writes the next frame after the
+/// completion of the previous one. CanChannel_All is sent on CAN1, CAN2 has no driver.
+///
+/// \param pMsg
+/// The frame to be sent
+/// \param clbk
+/// Callback for the completion of the transmission, may be NULL
+/// \param pData
+/// User data passed to the callback
+/// \return
+/// LIBRET_OK if the frame is written into a mailbox, LIBRET_BUSY if all mailboxes are in use
+// -------------------------------------------------------------------------------------------------------------------- 
+extern Ret_t CanIF_TxFrame(const S_LibCan_Msg_t* pMsg, CanIF_TxCompleteClbk clbk, void* pData);
+
 
 #endif // CANIF_H__INCLUDED
@@ -27,28 +27,43 @@
 #include "CanTask.h"
 #include "LibCanMsg.h"
 #include "CanNm.h"
+#ifdef LIBCANTP
+#include "LibCanTp.h"
+#endif
 // --------------------------------------------------------------------------------------------------------------------
 //	Local Data Types
 // --------------------------------------------------------------------------------------------------------------------
 
+// -------------------------------------------------------------------------------------------------------------------- 
+/// \brief Completion callback registered for the frame in a transmit mailbox
+// -------------------------------------------------------------------------------------------------------------------- 
+typedef struct
+{
+	CanIF_TxCompleteClbk Clbk;
+	void* pData;
+} S_CanIF_TxMailbox_t;
+
 // --------------------------------------------------------------------------------------------------------------------
 //	Local Variables
 // --------------------------------------------------------------------------------------------------------------------
 static CAN_FilterTypeDef CAN1Filter;
 
 // -------------------------------------------------------------------------------------------------------------------- 
-/// \brief FIFO buffer for CANIF Receiver
+/// \brief Completion callbacks of the CAN1 transmit mailboxes, written with interrupts suspended and consumed by the
+/// transmit complete interrupt
+// -------------------------------------------------------------------------------------------------------------------- 
+static S_CanIF_TxMailbox_t CanIF_Can1TxMailbox[CANIF_TX_MAILBOXES];
+
+// -------------------------------------------------------------------------------------------------------------------- 
+/// \brief A frame of the CAN task was not written by CanIF_TxFrame(), the task is woken up when a mailbox gets free
 // -------------------------------------------------------------------------------------------------------------------- 
-static S_LibCan_Msg_t CanIF_MsgRecvBuffer[CANIF_MSG_RECV_FIFO_ELEMENTS];
+static uint32_t CanIF_IsTaskTxDeferred = 0u;
 
 // -------------------------------------------------------------------------------------------------------------------- 
-/// \brief Settings for the FIFO 
+/// \brief FIFO for CANIF Receiver, filled by the receive interrupt and emptied by the CAN task (lock-free, the receive
+/// interrupt is the only producer)
 // -------------------------------------------------------------------------------------------------------------------- 
-LIBFIFO_DEFINE_INST(CanIF_MsgRecvFifo,
-                   (uint32_t*)(void*)CanIF_MsgRecvBuffer,
-                   sizeof(S_LibCan_Msg_t),
-                   (uint32_t)CANIF_MSG_RECV_FIFO_ELEMENTS,
-                   false);
+S_CanIF_MsgRecv_Fifo_t CanIF_MsgRecvFifo = LIBFIFO_TYPED_INIT();
 // -------------------------------------------------------------------------------------------------------------------- 
 /// \brief Buffer configuration 
 // -------------------------------------------------------------------------------------------------------------------- 
@@ -63,6 +78,31 @@ uint8_t Can2_Bus_Off_flag = false;
 //	Local Function Prototypes
 // --------------------------------------------------------------------------------------------------------------------
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Check whether a received message may use the entries of the RECEIVE FIFO reserved for priority messages
+/// \param msgId The CAN ID of the message
+/// \return True for network management and transport protocol messages
+/// \sa CANIF_MSG_RECV_PRIORITY_ELEMENTS
+// --------------------------------------------------------------------------------------------------------------------
+static bool_t CanIF_IsPriorityMsg(uint32_t msgId);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief A transmit mailbox got free: invoke the completion callback of its frame and let the transport protocol
+/// refill the mailbox
+/// \param hcan The CAN handle
+/// \param mailboxIdx Index of the mailbox (0 - CANIF_TX_MAILBOXES-1)
+/// \param isSent true if the frame was transmitted, false if the transmission was aborted or failed
+// --------------------------------------------------------------------------------------------------------------------
+static void CanIF_TxMailboxDone(CAN_HandleTypeDef *hcan, uint32_t mailboxIdx, bool_t isSent);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Check whether a transmit mailbox holds a pending frame with the given identifier
+/// \param hcan The CAN handle
+/// \param pHeader The header of the frame to be sent
+/// \return true if a mailbox with the same identifier and type of identifier is pending
+// --------------------------------------------------------------------------------------------------------------------
+static bool_t CanIF_IsIdPending(const CAN_HandleTypeDef *hcan, const CAN_TxHeaderTypeDef *pHeader);
+
 // --------------------------------------------------------------------------------------------------------------------
 //	Functions
 // --------------------------------------------------------------------------------------------------------------------
@@ -125,7 +165,7 @@ void Can1IfDrv_Start(void)
 		CAN1Filter.FilterActivation = ENABLE;
 		CAN1Filter.SlaveStartFilterBank = 14;
 
-		HAL_CAN_ActivateNotification(&hcan1, CAN_IT_RX_FIFO0_MSG_PENDING|CAN_IT_BUSOFF);
+		HAL_CAN_ActivateNotification(&hcan1, CAN_IT_RX_FIFO0_MSG_PENDING|CAN_IT_BUSOFF|CAN_IT_TX_MAILBOX_EMPTY);
 		HAL_CAN_ConfigFilter(&hcan1, &CAN1Filter);
 		HAL_CAN_Start(&hcan1);
 	}
@@ -136,7 +176,7 @@ void Can1IfDrv_Stop(void)
 	HAL_CAN_StateTypeDef state = HAL_CAN_GetState(&hcan1);
 	if(state == HAL_CAN_STATE_LISTENING)
 	{
-		HAL_CAN_DeactivateNotification(&hcan1, CAN_IT_RX_FIFO0_MSG_PENDING|CAN_IT_BUSOFF);
+		HAL_CAN_DeactivateNotification(&hcan1, CAN_IT_RX_FIFO0_MSG_PENDING|CAN_IT_BUSOFF|CAN_IT_TX_MAILBOX_EMPTY);
 		HAL_CAN_Stop(&hcan1);
 	}
 }
@@ -187,12 +227,29 @@ void Can2IfDrv_WakeUp(void)
 **************************************************************************************/
 void HAL_CAN_ErrorCallback(CAN_HandleTypeDef *hcan)
 {
+	static const uint32_t CANTxErrCodes[CANIF_TX_MAILBOXES] = {
+		HAL_CAN_ERROR_TX_ALST0 | HAL_CAN_ERROR_TX_TERR0,
+		HAL_CAN_ERROR_TX_ALST1 | HAL_CAN_ERROR_TX_TERR1,
+		HAL_CAN_ERROR_TX_ALST2 | HAL_CAN_ERROR_TX_TERR2
+	};
 	uint32_t CANErrCode;
 
+	// the HAL accumulates the error codes of all interrupts in the handle, they are reset below so that only the
+	// errors raised by this interrupt are handled
 	CANErrCode = HAL_CAN_GetError(hcan);
-	switch (CANErrCode)
+
+	// a mailbox whose transmission failed is free again, its frame is reported as not sent
+	for(uint32_t mailboxIdx = 0u; mailboxIdx < CANIF_TX_MAILBOXES; mailboxIdx++)
+	{
+		if((CANErrCode & CANTxErrCodes[mailboxIdx]) != 0u)
+		{
+			CanIF_TxMailboxDone(hcan, mailboxIdx, false);
+		}
+	}
+
+	// the bus-off interrupt raises the error warning and error passive codes as well
+	if((CANErrCode & HAL_CAN_ERROR_BOF) != 0u)
 	{
-	case HAL_CAN_ERROR_BOF:
 		if(hcan->Instance == CAN1)
 		{
 			Can1_Bus_Off_flag=true;
@@ -202,11 +259,9 @@ void HAL_CAN_ErrorCallback(CAN_HandleTypeDef *hcan)
 			Can2_Bus_Off_flag=true;
 		}
 		Can_BusOff((void*)hcan);
-		break;
-	
-	default:
-		break;
 	}
+
+	(void)HAL_CAN_ResetError(hcan);
 }
 
 /**************************************************************************************
@@ -221,40 +276,60 @@ void HAL_CAN_RxFifo0MsgPendingCallback(CAN_HandleTypeDef *hcan)
 	uint32_t RxFrameNum;
 
 	do{
-		S_LibCan_Msg_t Can1IF_Receive_Msg;
-		HAL_StatusTypeDef MsgState = HAL_CAN_GetRxMessage(hcan, CAN_RX_FIFO0, &CANRxHeader, Can1IF_Receive_Msg.Data);
+		// the message is read from the mailbox directly into the receive queue, a full queue still has to drain the
+		// mailbox into a scratch message
+		S_LibCan_Msg_t Can1IF_Discard_Msg;
+		S_LibCan_Msg_t* pCan1IF_Receive_Msg = CanIF_MsgRecv_Reserve(&CanIF_MsgRecvFifo);
+		bool_t stored = (pCan1IF_Receive_Msg != NULL);
+		if (stored == false)
+		{
+			pCan1IF_Receive_Msg = &Can1IF_Discard_Msg;
+		}
+
+		HAL_StatusTypeDef MsgState = HAL_CAN_GetRxMessage(hcan, CAN_RX_FIFO0, &CANRxHeader, pCan1IF_Receive_Msg->Data);
 		if(MsgState == HAL_OK)
 		{
-			Can1IF_Receive_Msg.CanDevId = CanChannel_1;
+			pCan1IF_Receive_Msg->CanDevId = CanChannel_1;
 			if(CANRxHeader.IDE == CAN_ID_STD)
 			{
-				Can1IF_Receive_Msg.IsExtId = false;
-				Can1IF_Receive_Msg.Id = CANRxHeader.StdId;
+				pCan1IF_Receive_Msg->IsExtId = false;
+				pCan1IF_Receive_Msg->Id = CANRxHeader.StdId;
 			}
 			else
 			{
-				Can1IF_Receive_Msg.IsExtId = true;
-				Can1IF_Receive_Msg.Id = CANRxHeader.ExtId;
+				pCan1IF_Receive_Msg->IsExtId = true;
+				pCan1IF_Receive_Msg->Id = CANRxHeader.ExtId;
 			}
 			if(CANRxHeader.RTR == CAN_RTR_DATA)
 			{
-				Can1IF_Receive_Msg.IsRemote = false;
-				Can1IF_Receive_Msg.Length = CANRxHeader.DLC;
+				pCan1IF_Receive_Msg->IsRemote = false;
+				pCan1IF_Receive_Msg->Length = CANRxHeader.DLC;
 			}
 			else
 			{
-				Can1IF_Receive_Msg.IsRemote = true;
-				Can1IF_Receive_Msg.Length = 0u;
+				pCan1IF_Receive_Msg->IsRemote = true;
+				pCan1IF_Receive_Msg->Length = 0u;
+			}
+
+			// the last entries are kept free for priority messages, so a burst of other messages cannot crowd out
+			// network management and diagnostic frames
+			if ((stored == true) &&
+				(CanIF_MsgRecv_GetCount(&CanIF_MsgRecvFifo) >=
+				 (CANIF_MSG_RECV_FIFO_ELEMENTS - CANIF_MSG_RECV_PRIORITY_ELEMENTS)) &&
+				(CanIF_IsPriorityMsg(pCan1IF_Receive_Msg->Id) == false))
+			{
+				CanIF_MsgRecv_Discard(&CanIF_MsgRecvFifo);
+				stored = false;
 			}
 
-			bool_t stored = LibFifoQueue_Push(&CanIF_MsgRecvFifo, (void*)(&Can1IF_Receive_Msg));
 			if (stored == false)
 			{
-				(void)LibFifoQueue_Clear(&CanIF_MsgRecvFifo);
+				// the queue belongs to the CAN task as consumer, it cannot be cleared here: drop the newest message
 				LibLog_Error("CANIF: Cannot store receive message\n");
 			}
 			else
 			{
+				CanIF_MsgRecv_Commit(&CanIF_MsgRecvFifo);
 				/* Can_HandleCanMsgs(hcan); */
 				Can_MsgReceived((void*)hcan);
 			}
@@ -270,6 +345,94 @@ void HAL_CAN_RxFifo0MsgPendingCallback(CAN_HandleTypeDef *hcan)
 	
 }
 
+/**************************************************************************************
+* FunctionName   : CanIF_TxFrame
+* Description    : Write a frame into a free transmit mailbox and register its completion callback
+* EntryParameter : pMsg,clbk,pData
+* ReturnValue    : LIBRET_OK, LIBRET_BUSY if no mailbox is free
+**************************************************************************************/
+Ret_t CanIF_TxFrame(const S_LibCan_Msg_t* pMsg, CanIF_TxCompleteClbk clbk, void* pData)
+{
+	CAN_TxHeaderTypeDef TxMessageHeader;
+	uint32_t txMailbox;
+	Ret_t ret = LIBRET_BUSY;
+
+	if(pMsg->CanDevId == CanChannel_2)
+	{
+		return LIBRET_INV_PARAM;
+	}
+
+	if(pMsg->IsExtId)
+	{
+		TxMessageHeader.IDE = CAN_ID_EXT;
+		TxMessageHeader.ExtId = pMsg->Id;
+	}
+	else
+	{
+		TxMessageHeader.IDE = CAN_ID_STD;
+		TxMessageHeader.StdId = pMsg->Id;
+	}
+	TxMessageHeader.DLC = pMsg->Length;
+	TxMessageHeader.RTR = CAN_RTR_DATA;
+	TxMessageHeader.TransmitGlobalTime = DISABLE;
+
+	// the callback has to be registered before the transmit complete interrupt of the mailbox can be served. The
+	// mailboxes are sent by the priority of the identifier, a frame waits for the previous one with the same
+	// identifier so that the frames of a connection keep their order.
+	SuspendAllInterrupts();
+	if((HAL_CAN_GetTxMailboxesFreeLevel(&hcan1) > 0u) && (!CanIF_IsIdPending(&hcan1, &TxMessageHeader)) &&
+	   (HAL_CAN_AddTxMessage(&hcan1, &TxMessageHeader, pMsg->Data, &txMailbox) == HAL_OK))
+	{
+		const uint32_t mailboxIdx = (txMailbox == CAN_TX_MAILBOX0) ? 0u : ((txMailbox == CAN_TX_MAILBOX1) ? 1u : 2u);
+		CanIF_Can1TxMailbox[mailboxIdx].Clbk = clbk;
+		CanIF_Can1TxMailbox[mailboxIdx].pData = pData;
+		ret = LIBRET_OK;
+	}
+	else if(clbk == NULL)
+	{
+		CanIF_IsTaskTxDeferred = 1u;
+	}
+	ResumeAllInterrupts();
+
+	return ret;
+}
+
+/**************************************************************************************
+* FunctionName   : HAL_CAN_TxMailboxXCompleteCallback / HAL_CAN_TxMailboxXAbortCallback
+* Description    : Can1 transmit complete/abort interrupt callback functions
+* EntryParameter : hcan
+* ReturnValue    : None
+**************************************************************************************/
+void HAL_CAN_TxMailbox0CompleteCallback(CAN_HandleTypeDef *hcan)
+{
+	CanIF_TxMailboxDone(hcan, 0u, true);
+}
+
+void HAL_CAN_TxMailbox1CompleteCallback(CAN_HandleTypeDef *hcan)
+{
+	CanIF_TxMailboxDone(hcan, 1u, true);
+}
+
+void HAL_CAN_TxMailbox2CompleteCallback(CAN_HandleTypeDef *hcan)
+{
+	CanIF_TxMailboxDone(hcan, 2u, true);
+}
+
+void HAL_CAN_TxMailbox0AbortCallback(CAN_HandleTypeDef *hcan)
+{
+	CanIF_TxMailboxDone(hcan, 0u, false);
+}
+
+void HAL_CAN_TxMailbox1AbortCallback(CAN_HandleTypeDef *hcan)
+{
+	CanIF_TxMailboxDone(hcan, 1u, false);
+}
+
+void HAL_CAN_TxMailbox2AbortCallback(CAN_HandleTypeDef *hcan)
+{
+	CanIF_TxMailboxDone(hcan, 2u, false);
+}
+
 /**************************************************************************************
 * FunctionName   : Can2IF_RxCallback
 * Description    : Can2 receive interrupt callback function
@@ -292,6 +455,12 @@ void Can1_Bus_Off(void)
    {
 	   Can1IfDrv_Deinit();
 
+	   // the pending frames are lost with the reinitialization of the controller
+	   for(uint32_t mailboxIdx = 0u; mailboxIdx < CANIF_TX_MAILBOXES; mailboxIdx++)
+	   {
+		   CanIF_TxMailboxDone(&hcan1, mailboxIdx, false);
+	   }
+
 	   Can1IfDrv_Init();
 	   Can1IfDrv_Start();
 	   Can1_Bus_Off_flag=false;
@@ -314,4 +483,73 @@ void Can2_Bus_Off(void)
 	   Can2_Bus_Off_flag=false;
    }
 }
+/**************************************************************************************
+* FunctionName   : CanIF_IsPriorityMsg
+* Description    : Check whether a receive message is a priority message
+* EntryParameter : msgId
+* ReturnValue    : true for NM and TP messages
+**************************************************************************************/
+static bool_t CanIF_IsPriorityMsg(uint32_t msgId)
+{
+	bool_t isPrio = CanNm_Module.IsMsg(msgId);
+#ifdef LIBCANTP
+	isPrio = isPrio || LibCanTp_Module.IsMsg(msgId);
+#endif
+	return isPrio;
+}
 
+/**************************************************************************************
+* FunctionName   : CanIF_TxMailboxDone
+* Description    : Complete the frame of a free transmit mailbox and refill the mailbox
+* EntryParameter : hcan,mailboxIdx,isSent
+* ReturnValue    : None
+**************************************************************************************/
+static void CanIF_TxMailboxDone(CAN_HandleTypeDef *hcan, uint32_t mailboxIdx, bool_t isSent)
+{
+	if(hcan->Instance == CAN1)
+	{
+		const CanIF_TxCompleteClbk clbk = CanIF_Can1TxMailbox[mailboxIdx].Clbk;
+		void* const pData = CanIF_Can1TxMailbox[mailboxIdx].pData;
+
+		CanIF_Can1TxMailbox[mailboxIdx].Clbk = NULL;
+		if(clbk != NULL)
+		{
+			clbk(pData, isSent);
+		}
+
+#ifdef LIBCANTP
+		LibCanTp_TxMailboxFree(CanChannel_1);
+#endif
+
+		if(LibAtomic_FetchAnd(&CanIF_IsTaskTxDeferred, 0u) != 0u)
+		{
+			(void)LibService_SetEvent(&TASK_CAN, EV_CAN_MSG_REQ);
+		}
+	}
+}
+
+/**************************************************************************************
+* FunctionName   : CanIF_IsIdPending
+* Description    : Check whether a transmit mailbox holds a pending frame with the identifier
+* EntryParameter : hcan,pHeader
+* ReturnValue    : true if a frame with the same identifier is pending
+**************************************************************************************/
+static bool_t CanIF_IsIdPending(const CAN_HandleTypeDef *hcan, const CAN_TxHeaderTypeDef *pHeader)
+{
+	static const uint32_t CANTxEmpty[CANIF_TX_MAILBOXES] = { CAN_TSR_TME0, CAN_TSR_TME1, CAN_TSR_TME2 };
+	const uint32_t tsr = hcan->Instance->TSR;
+	const uint32_t idMask = CAN_TI0R_STID | CAN_TI0R_EXID | CAN_TI0R_IDE;
+	const uint32_t tir = (pHeader->IDE == CAN_ID_STD) ? (pHeader->StdId << CAN_TI0R_STID_Pos) :
+						 ((pHeader->ExtId << CAN_TI0R_EXID_Pos) | CAN_ID_EXT);
+	bool_t isPending = false;
+
+	for(uint32_t mailboxIdx = 0u; mailboxIdx < CANIF_TX_MAILBOXES; mailboxIdx++)
+	{
+		if(((tsr & CANTxEmpty[mailboxIdx]) == 0u) && ((hcan->Instance->sTxMailBox[mailboxIdx].TIR & idMask) == tir))
+		{
+			isPending = true;
+		}
+	}
+
+	return isPending;
+}
@@ -75,7 +75,7 @@ Ret_t LibMcan_IoCtl(void* pData, uint8_t command)
 		{
 
 			S_LibCan_Msg_t* pMsg;
-			pMsg = (S_LibCan_Msg_t*)LibFifoQueue_GetPopItem(&CanIF_MsgRecvFifo);
+			pMsg = CanIF_MsgRecv_Peek(&CanIF_MsgRecvFifo);
 			if(pMsg == NULL)
 			{
 				retval = LIBRET_NO_ENTRY;
@@ -83,33 +83,33 @@ Ret_t LibMcan_IoCtl(void* pData, uint8_t command)
 			}
 			S_LibCan_Msg_t* const pRecMsg = (S_LibCan_Msg_t*)pData;
 			(void)memcpy(pRecMsg, pMsg, sizeof(S_LibCan_Msg_t));
+			// release the entry to the receive interrupt only after the copy
+			CanIF_MsgRecv_Pop(&CanIF_MsgRecvFifo);
 		    break;	
 		} 
 
+		case LIBCAN_IOCTL_PEEK_NEXT_MSG:
+		{
+			S_LibCan_Msg_t** const ppMsg = (S_LibCan_Msg_t**)pData;
+			*ppMsg = CanIF_MsgRecv_Peek(&CanIF_MsgRecvFifo);
+			if (NULL == *ppMsg)
+			{
+				retval = LIBRET_NO_ENTRY;
+			}
+			break;
+		}
+
+		case LIBCAN_IOCTL_RELEASE_MSG:
+		{
+			CanIF_MsgRecv_Pop(&CanIF_MsgRecvFifo);
+			break;
+		}
+
 		
 		case LIBCAN_IOCTL_SEND_MSG:
 		{
-			CAN_TxHeaderTypeDef TxMessageHeader;
-			uint8_t TxMessage[LIBCAN_MAXDATABYTENUM];
-			uint32_t txMailbox;
-
 			S_LibCan_Msg_t* const pMsg = (S_LibCan_Msg_t*)pData;
-			if(pMsg->IsExtId)
-			{
-				TxMessageHeader.IDE = CAN_ID_EXT;
-				TxMessageHeader.ExtId = pMsg->Id;
-			}
-			else
-			{
-				TxMessageHeader.IDE = CAN_ID_STD;
-				TxMessageHeader.StdId = pMsg->Id;
-			}
-			TxMessageHeader.DLC = pMsg->Length;
-			TxMessageHeader.RTR = CAN_RTR_DATA;
-			TxMessageHeader.TransmitGlobalTime = DISABLE;
 
-			(void)memcpy(TxMessage, pMsg->Data, pMsg->Length);
-            
 			uint8_t CanDrvChoseBit = 0x00;
 			switch (pMsg->CanDevId)
 			{
@@ -131,14 +131,11 @@ Ret_t LibMcan_IoCtl(void* pData, uint8_t command)
 
 			if(CanDrvChoseBit & CANDRV1_MASK)
 			{
-				HAL_StatusTypeDef send_status1 = HAL_ERROR;
-				uint32_t MailBoxNum = HAL_CAN_GetTxMailboxesFreeLevel(&hcan1);
-				if(MailBoxNum > 0u)
-				{
-					send_status1 = HAL_CAN_AddTxMessage(&hcan1, &TxMessageHeader, TxMessage, &txMailbox);
-				}
-
-				if(HAL_OK == send_status1)
+				// the mailboxes are also written by the transmit complete interrupt (LibCanTp), CanIF_TxFrame() takes
+				// the interrupt lock around the check for a free mailbox and the write. LIBRET_BUSY is returned if the
+				// frame has to wait for a mailbox, the CAN task is woken up again when a mailbox gets free.
+				retval = CanIF_TxFrame(pMsg, NULL, NULL);
+				if(LIBRET_OK == retval)
 				{
 					// Only CAN TP/NM need Send Confirm
 					/* Can_ModuleTable[i]->IsMsg(msg.Id) */
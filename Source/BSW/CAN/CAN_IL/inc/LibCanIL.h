@@ -36,6 +36,7 @@
 #define LIBCANIL_EVENT_TXCYCLE_MESSAGE_TIMER			UINT32_C(0x00000008)
 #define LIBCANIL_EVENT_TXEVENT_MESSAGE_TIMER            UINT32_C(0x00000020)
 #define LIBCANIL_EVENT_RXCYCLE_MESSAGE_TIMER            UINT32_C(0x00000040)
+#define LIBCANIL_EVENT_CONTROL_REQ						UINT32_C(0x00000080)
 
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -194,6 +195,12 @@ typedef struct
 	// ----------------------------------------------------------------------------------------------------------------
 	const bool_t						IsIntel;
 
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief  The flag is the received message last-is-best: only the newest frame is kept in a mailbox and decoded
+	/// once per pass instead of queueing and decoding every frame.
+	// ----------------------------------------------------------------------------------------------------------------
+	const bool_t						IsLastIsBest;
+
 	// ----------------------------------------------------------------------------------------------------------------
 	/// \brief  The cycle time for this message to transmit.
 	// ----------------------------------------------------------------------------------------------------------------
@@ -389,6 +396,9 @@ extern void LibCanIL_CallRequestedCallbacks(void);
 
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief Start the transmission.
+///
+/// The start/stop/enable/disable functions may be called from any service host: the request is queued and executed
+/// by the IL service in its own service host, in the order of the requests.
 // --------------------------------------------------------------------------------------------------------------------
 extern void LibCanIL_TxStart(void);
 
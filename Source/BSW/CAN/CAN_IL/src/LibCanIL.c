@@ -29,6 +29,23 @@
 #define LIBCANIL_MSG_REQ_FIFO_ELEMENTS	(8U)
 #define LIBCANIL_MSG_IND_FIFO_ELEMENTS	(8U)
 #define LIBCANIL_MSG_CON_FIFO_ELEMENTS	(8U)
+#define LIBCANIL_CTRL_FIFO_ELEMENTS		(8U)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Number of bits of one word of the mailbox ready bitmap
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBCANIL_MAILBOX_WORD_BITS		(32U)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Number of words of the mailbox ready bitmap
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBCANIL_MAILBOX_READY_WORDS	\
+	((((uint32_t)LIBCANILCFG_MESSAGE_NAME_DIMENSION) + LIBCANIL_MAILBOX_WORD_BITS - 1U) / LIBCANIL_MAILBOX_WORD_BITS)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Index of the lowest set bit of a non-zero mask
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBCANIL_LOWEST_BIT_IDX(mask)	((uint32_t)__builtin_ctz(mask))
 
 #if LIBCANILCFG_NUMBER_OF_TX_EVENT_MESSAGE 
 //the interval need to be 20ms, set to be 19ms because the delay
@@ -46,6 +63,19 @@
 //	Local Data Types
 // --------------------------------------------------------------------------------------------------------------------
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Start/stop requests of the transmission and reception, executed by the IL service in request order
+// --------------------------------------------------------------------------------------------------------------------
+typedef enum E_LibCanIL_CtrlReq_t {
+	LIBCANIL_CTRL_TX_START,
+	LIBCANIL_CTRL_RX_START,
+	LIBCANIL_CTRL_TX_STOP,
+	LIBCANIL_CTRL_RX_STOP,
+	LIBCANIL_CTRL_TX_ENABLE,
+	LIBCANIL_CTRL_RX_ENABLE,
+	LIBCANIL_CTRL_TX_DISABLE,
+	LIBCANIL_CTRL_RX_DISABLE,
+} E_LibCanIL_CtrlReq_t;
 
 // --------------------------------------------------------------------------------------------------------------------
 //	Local Function Prototypes
@@ -179,11 +209,73 @@ static void LibCanIL_ServiceEvTxCycleMessageTimer(void);
 static void LibCanIL_ServiceEvRxCycleMessageTimer(void);
 #endif
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Handle Service Event CONTROL_REQ: execute the queued start/stop requests
+// --------------------------------------------------------------------------------------------------------------------
+static void LibCanIL_ServiceEvCtrlReq(void);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Queue a start/stop request for the IL service
+///
+/// The transmission and reception state is owned by the IL service, the public start/stop functions may be called
+/// from other service hosts (e.g. by the NM) and therefore only queue the request.
+///
+/// \param req
+/// The request
+// --------------------------------------------------------------------------------------------------------------------
+static void LibCanIL_RequestCtrl(const E_LibCanIL_CtrlReq_t req);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Start/stop/enable/disable the transmission resp. reception, called by the IL service only
+// --------------------------------------------------------------------------------------------------------------------
+static void LibCanIL_ExecTxStart(void);
+static void LibCanIL_ExecRxStart(void);
+static void LibCanIL_ExecTxStop(void);
+static void LibCanIL_ExecRxStop(void);
+static void LibCanIL_ExecRxDisable(void);
+
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief Handle Service Event MESSAGE_INDICATION
 // --------------------------------------------------------------------------------------------------------------------
 static void LibCanIL_ServiceEvMessageInd(void);
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Handle one received message of the MESSAGE_INDICATION queue
+///
+/// \param pMsg
+/// The received message.
+// --------------------------------------------------------------------------------------------------------------------
+static void LibCanIL_HandleMessageInd(const S_LibCanIL_MsgIndBufferEntry_t* pMsg);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Handle all messages posted to the last-is-best mailboxes, each message at most once
+// --------------------------------------------------------------------------------------------------------------------
+static void LibCanIL_HandleMailboxes(void);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Drop the frames of all last-is-best mailboxes
+// --------------------------------------------------------------------------------------------------------------------
+static void LibCanIL_ClearMailboxes(void);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Decode a received message into the signal storage resp. hand it to the application
+///
+/// \param msgName
+/// The name of the received message.
+/// \param pMsg
+/// The received message.
+// --------------------------------------------------------------------------------------------------------------------
+static void LibCanIL_DecodeMessage(E_LibCanILCfg_MessageNames_t msgName, const S_LibCanIL_MsgIndBufferEntry_t* pMsg);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Search the configuration of a received message
+///
+/// \param msgId
+/// The CAN ID of the message
+/// \return The name of the message, LIBCANILCFG_MESSAGE_NAME_NO_MESSAGE if no receive message has this ID
+// --------------------------------------------------------------------------------------------------------------------
+static E_LibCanILCfg_MessageNames_t LibCanIL_FindRxMessage(uint32_t msgId);
+
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief Handle Service Event MESSAGE_CONFIRM
 // --------------------------------------------------------------------------------------------------------------------
@@ -199,6 +291,20 @@ static void LibCanIL_ServiceEvMessageCon(void);
 // --------------------------------------------------------------------------------------------------------------------
 static void LibCanIL_MsgIndicate(S_LibCan_Msg_t *pMsg);
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Check whether a received message supersedes a message in the MESSAGE_INDICATION queue
+///
+/// The signals of the interaction layer are last-is-best, so of two messages with the same ID only the newer one has
+/// to be handled when the queue overflows.
+///
+/// \param pQueuedItem
+/// The message in the queue
+/// \param pItem
+/// The received message
+/// \return True if both messages have the same ID
+// --------------------------------------------------------------------------------------------------------------------
+static bool_t LibCanIL_IsSameMsg(const void* pQueuedItem, const void* pItem);
+
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief Confirms the successful transmission of a CAN message
 ///
@@ -259,28 +365,53 @@ const S_LibCanModule_Module_t LibCanIL_Module = {
 static S_LibCanIL_MsgReqBufferEntry_t LibCanIL_MsgReqBuffer[LIBCANIL_MSG_REQ_FIFO_ELEMENTS];
 static S_LibCanIL_MsgIndBufferEntry_t LibCanIL_MsgIndBuffer[LIBCANIL_MSG_IND_FIFO_ELEMENTS];
 static S_LibCanIL_MsgConBufferEntry_t LibCanIL_MsgConBuffer[LIBCANIL_MSG_CON_FIFO_ELEMENTS];
+static uint8_t LibCanIL_CtrlBuffer[LIBCANIL_CTRL_FIFO_ELEMENTS];
 
 // --------------------------------------------------------------------------------------------------------------------
 ///	\brief Settings for the FIFO
+///
+/// The FIFOs are shared with the CAN task which may run in a service host of a different task. If the
+/// MESSAGE_INDICATION queue overflows, a received message replaces the queued message with the same ID, otherwise it
+/// is dropped.
 // --------------------------------------------------------------------------------------------------------------------
-LIBFIFO_DEFINE_INST(LibCanIL_MsgReqFifo,
+LIBFIFO_DEFINE_SHARED_INST(LibCanIL_MsgReqFifo,
 						   (uint32_t*)(void*)LibCanIL_MsgReqBuffer,
 						   sizeof(S_LibCanIL_MsgReqBufferEntry_t),
 						   (uint32_t)LIBCANIL_MSG_REQ_FIFO_ELEMENTS,
 						   false);
 
-LIBFIFO_DEFINE_INST(LibCanIL_MsgIndFifo,
-						   (uint32_t*)(void*)LibCanIL_MsgIndBuffer,
-						   sizeof(S_LibCanIL_MsgIndBufferEntry_t),
-						   (uint32_t)LIBCANIL_MSG_IND_FIFO_ELEMENTS,
-						   false);
+LIBFIFO_DEFINE_COALESCING_INST(LibCanIL_MsgIndFifo,
+							   (uint32_t*)(void*)LibCanIL_MsgIndBuffer,
+							   sizeof(S_LibCanIL_MsgIndBufferEntry_t),
+							   (uint32_t)LIBCANIL_MSG_IND_FIFO_ELEMENTS,
+							   false,
+							   true,
+							   LibCanIL_IsSameMsg);
 
-LIBFIFO_DEFINE_INST(LibCanIL_MsgConFifo,
+LIBFIFO_DEFINE_SHARED_INST(LibCanIL_MsgConFifo,
 						   (uint32_t*)(void*)LibCanIL_MsgConBuffer,
 						   sizeof(S_LibCanIL_MsgConBufferEntry_t),
 						   (uint32_t)LIBCANIL_MSG_CON_FIFO_ELEMENTS,
 						   false);
 
+// --------------------------------------------------------------------------------------------------------------------
+///	\brief Start/stop requests (E_LibCanIL_CtrlReq_t) from other service hosts, executed by the IL service
+// --------------------------------------------------------------------------------------------------------------------
+LIBFIFO_DEFINE_SHARED_INST(LibCanIL_CtrlFifo,
+						   (uint32_t*)(void*)LibCanIL_CtrlBuffer,
+						   sizeof(uint8_t),
+						   (uint32_t)LIBCANIL_CTRL_FIFO_ELEMENTS,
+						   false);
+
+
+// ----------------------------------------------------------------------------------------------------------------
+/// \brief  Mailboxes holding the newest frame of each last-is-best message, see S_LibCanIL_MessageDesc_t::IsLastIsBest
+///
+/// The mailboxes and the ready bitmap are written by the CAN task and read by the IL service with interrupts
+/// suspended, a set bit marks a mailbox holding a frame which has not been decoded yet.
+// ----------------------------------------------------------------------------------------------------------------
+static S_LibCanIL_MsgIndBufferEntry_t LibCanIL_Mailbox[(uint8_t)LIBCANILCFG_MESSAGE_NAME_DIMENSION];
+static uint32_t LibCanIL_MailboxReady[LIBCANIL_MAILBOX_READY_WORDS];
 
 // ----------------------------------------------------------------------------------------------------------------
 /// \brief  Internal storage of all CAN signal.
@@ -371,6 +502,12 @@ static void LibCanIL_ServiceHndl(void* pData)
 		LibCanIL_Init();
 	}
 
+	// start/stop requests, before the messages so a stopped reception drops the queued messages
+	if(LibService_CheckClearEvent(&LibCanIL_Service, LIBCANIL_EVENT_CONTROL_REQ))
+	{
+		LibCanIL_ServiceEvCtrlReq();
+	}
+
 #if LIBCANILCFG_NUMBER_OF_TX_EVENT_MESSAGE 
 	// Tx Event message service
 	if(LibService_CheckClearEvent(&LibCanIL_Service, LIBCANIL_EVENT_TXEVENT_MESSAGE_TIMER))
@@ -399,6 +536,7 @@ static void LibCanIL_ServiceHndl(void* pData)
 	if (LibService_CheckClearEvent(&LibCanIL_Service, LIBCANIL_EVENT_CAN_MESSAGE_IND))
 	{
 		LibCanIL_ServiceEvMessageInd();
+		LibCanIL_CallRequestedCallbacks();
 	}
 
 	// confirm transmitted massages from CAN transceiver
@@ -708,85 +846,143 @@ static void LibCanIL_ServiceEvRxCycleMessageTimer(void)
 uint16_t Log_IL_count_temp;
 static void LibCanIL_ServiceEvMessageInd(void)
 {
-	do
+	S_LibCanIL_MsgIndBufferEntry_t msg;
+
+	// the messages are copied out: a queued message may be replaced by a newer one with the same ID at any time
+	while (LibFifoQueue_PopCopy(&LibCanIL_MsgIndFifo, &msg))
 	{
-		const S_LibCanIL_MsgIndBufferEntry_t* pMsg;
-		pMsg = (S_LibCanIL_MsgIndBufferEntry_t*)LibFifoQueue_GetItem(&LibCanIL_MsgIndFifo, UINT32_C(0));
-		
-		// no message in queue
-		if (pMsg == NULL)
+		LibCanIL_HandleMessageInd(&msg);
+	}
+
+	LibCanIL_HandleMailboxes();
+}
+
+//=====================================================================================================================
+// LibCanIL_HandleMailboxes:
+//=====================================================================================================================
+static void LibCanIL_HandleMailboxes(void)
+{
+	S_LibCanIL_MsgIndBufferEntry_t msg;
+
+	for (uint32_t word = 0U; word < LIBCANIL_MAILBOX_READY_WORDS; word++)
+	{
+		// frames posted after this snapshot are handled in the next pass, so the work per pass is bounded by the
+		// number of messages and not by the frame rate
+		uint32_t ready = LibAtomic_Load(&LibCanIL_MailboxReady[word]);
+
+		while (0U != ready)
 		{
-			break;
+			const uint32_t bitIdx = LIBCANIL_LOWEST_BIT_IDX(ready);
+			const uint32_t msgIdx = (word * LIBCANIL_MAILBOX_WORD_BITS) + bitIdx;
+			ready &= ready - 1U;
+
+			SuspendAllInterrupts();
+			msg = LibCanIL_Mailbox[msgIdx];
+			LibCanIL_MailboxReady[word] &= ~(UINT32_C(1) << bitIdx);
+			ResumeAllInterrupts();
+
+			LibCanIL_DecodeMessage((E_LibCanILCfg_MessageNames_t)msgIdx, &msg);
 		}
-		// read the current message in queue
-		uint8_t loop;
-		for (loop = 0; loop < LibCanILCfg_MessageTable.NumOfMessages; loop++)
-		{
-			const S_LibCanIL_MessageDesc_t* msgDesc = &LibCanILCfg_MessageTable.pMessageDesc[loop];
-			if ((pMsg->Id == msgDesc->Id) && (msgDesc -> IsTx == false))
-			{
-				Log_IL_count_temp++;
-				if( Log_IL_count_temp>1200 )
-				{
-					Log_IL_count_temp = 0;
-					LibLog_Debug("LibCanIL_ReadMessage\n");
-				}
+	}
+}
+
+//=====================================================================================================================
+// LibCanIL_HandleMessageInd:
+//=====================================================================================================================
+static void LibCanIL_HandleMessageInd(const S_LibCanIL_MsgIndBufferEntry_t* pMsg)
+{
+	// read the current message in queue
+	const E_LibCanILCfg_MessageNames_t msgName = LibCanIL_FindRxMessage(pMsg->Id);
+	if (msgName != LIBCANILCFG_MESSAGE_NAME_NO_MESSAGE)
+	{
+		LibCanIL_DecodeMessage(msgName, pMsg);
+	}
+}
+
+//=====================================================================================================================
+// LibCanIL_ClearMailboxes:
+//=====================================================================================================================
+static void LibCanIL_ClearMailboxes(void)
+{
+	SuspendAllInterrupts();
+	for (uint32_t word = 0U; word < LIBCANIL_MAILBOX_READY_WORDS; word++)
+	{
+		LibCanIL_MailboxReady[word] = 0U;
+	}
+	ResumeAllInterrupts();
+}
+
+//=====================================================================================================================
+// LibCanIL_DecodeMessage:
+//=====================================================================================================================
+static void LibCanIL_DecodeMessage(E_LibCanILCfg_MessageNames_t msgName, const S_LibCanIL_MsgIndBufferEntry_t* pMsg)
+{
+	const S_LibCanIL_MessageDesc_t* msgDesc = &LibCanILCfg_MessageTable.pMessageDesc[(uint8_t)msgName];
+
+	Log_IL_count_temp++;
+	if( Log_IL_count_temp>1200 )
+	{
+		Log_IL_count_temp = 0;
+		LibLog_Debug("LibCanIL_ReadMessage\n");
+	}
 #if LIBCANILCFG_NUMBER_OF_RX_CYCLE_MESSAGE 
-				if(LibCanIL_RxMsgMonitor(msgDesc,(E_LibCanILCfg_MessageNames_t)loop) == true)
+	if(LibCanIL_RxMsgMonitor(msgDesc, msgName) == true)
 #endif
+	{
+		if (msgDesc -> IsASWHndle == true)
+		{
+			CAN_DATATYPE * const ASWCANFrameData = msgDesc -> ASWCANFrame;;
+			ASWCANFrameData -> Extended = (uint8_T)(pMsg -> IsExtId);
+			ASWCANFrameData -> Length = (uint8_T)(pMsg -> Length);
+			ASWCANFrameData -> ID = (uint32_T)(pMsg -> Id);
+			memcpy((void*)ASWCANFrameData -> Data, (void*)(pMsg -> Data), (size_t)(pMsg -> Length));
+			msgDesc -> ASWHndleFunc();
+
+			// Set all relevant message callbacks to Requested.
+/* 					const S_LibCanIL_MessageDesc_t* pMsgDesc = &LibCanILCfg_MessageTable.pMessageDesc[(uint8_t)msgName]; */
+			const E_LibCanILCfg_CallbackNames_t firstDataChCbk = msgDesc->FirstMsgRecCbk;
+			for(uint8_t cbkLoop = UINT8_C(0); cbkLoop < msgDesc->NDataChCbks; cbkLoop++)
+			{
+				if ((((uint8_t)firstDataChCbk) + cbkLoop) < LibCanILCfg_CallbackTable.NumOfCallbacks)
 				{
-					if (msgDesc -> IsASWHndle == true)
-					{
-						CAN_DATATYPE * const ASWCANFrameData = msgDesc -> ASWCANFrame;;
-						ASWCANFrameData -> Extended = (uint8_T)(pMsg -> IsExtId);
-						ASWCANFrameData -> Length = (uint8_T)(pMsg -> Length);
-						ASWCANFrameData -> ID = (uint32_T)(pMsg -> Id);
-						memcpy((void*)ASWCANFrameData -> Data, (void*)(pMsg -> Data), (size_t)(pMsg -> Length));
-						msgDesc -> ASWHndleFunc();
-
-						// Set all relevant message callbacks to Requested.
-	/* 					const S_LibCanIL_MessageDesc_t* pMsgDesc = &LibCanILCfg_MessageTable.pMessageDesc[(uint8_t)msgName]; */
-						const E_LibCanILCfg_CallbackNames_t firstDataChCbk = msgDesc->FirstMsgRecCbk;
-						for(uint8_t cbkLoop = UINT8_C(0); cbkLoop < msgDesc->NDataChCbks; cbkLoop++)
-						{
-							if ((((uint8_t)firstDataChCbk) + cbkLoop) < LibCanILCfg_CallbackTable.NumOfCallbacks)
-							{
-								LibCanIL_CallbackIsRequested[((uint8_t)firstDataChCbk) + cbkLoop] = true;
-							}
-						}
-					}
-					else
-					{
-						LibCanIL_ReadMessage((E_LibCanILCfg_MessageNames_t)loop, pMsg);	
-					}
+					LibCanIL_CallbackIsRequested[((uint8_t)firstDataChCbk) + cbkLoop] = true;
 				}
-				
-				break;
 			}
 		}
-
-		LibFifoQueue_Pop(&LibCanIL_MsgIndFifo);
-
-	}while(true);
+		else
+		{
+			LibCanIL_ReadMessage(msgName, pMsg);
+		}
+	}
 }
 
 //=====================================================================================================================
-// LibCanIL_ServiceEvMessageCon:
+// LibCanIL_FindRxMessage:
 //=====================================================================================================================
-static void LibCanIL_ServiceEvMessageCon(void)
+static E_LibCanILCfg_MessageNames_t LibCanIL_FindRxMessage(uint32_t msgId)
 {
-	do
+	E_LibCanILCfg_MessageNames_t msgName = LIBCANILCFG_MESSAGE_NAME_NO_MESSAGE;
+
+	for (uint8_t loop = 0U; loop < LibCanILCfg_MessageTable.NumOfMessages; loop++)
 	{
-		const S_LibCanIL_MsgConBufferEntry_t* pMsg;
-		pMsg = (S_LibCanIL_MsgConBufferEntry_t*)LibFifoQueue_GetItem(&LibCanIL_MsgConFifo, UINT32_C(0));
-		// no confirm in queue
-		if (pMsg == NULL)
+		const S_LibCanIL_MessageDesc_t* msgDesc = &LibCanILCfg_MessageTable.pMessageDesc[loop];
+		if ((msgId == msgDesc->Id) && (msgDesc->IsTx == false))
 		{
+			msgName = (E_LibCanILCfg_MessageNames_t)loop;
 			break;
 		}
+	}
 
-		LibFifoQueue_Pop(&LibCanIL_MsgConFifo);
-	}while(true);
+	return msgName;
+}
+
+//=====================================================================================================================
+// LibCanIL_ServiceEvMessageCon:
+//=====================================================================================================================
+static void LibCanIL_ServiceEvMessageCon(void)
+{
+	// confirmations are not evaluated: drop all of them at once
+	LibFifoQueue_PopN(&LibCanIL_MsgConFifo, UINT32_MAX);
 }
 
 
@@ -817,6 +1013,7 @@ static void LibCanIL_Init(void)
 	LibFifoQueue_Clear(&LibCanIL_MsgReqFifo);
 	LibFifoQueue_Clear(&LibCanIL_MsgIndFifo);
 	LibFifoQueue_Clear(&LibCanIL_MsgConFifo);
+	LibCanIL_ClearMailboxes();
 }
 
 //=====================================================================================================================
@@ -1169,15 +1366,44 @@ static void LibCanIL_RxCycleMsgTimerCallback(void* pData)
 //=====================================================================================================================
 static void LibCanIL_MsgIndicate(S_LibCan_Msg_t *pMsg)
 {
-	Ret_t pushed = LibFifoQueue_Push(&LibCanIL_MsgIndFifo, (void*)(pMsg));
-	if (!pushed)
+	const E_LibCanILCfg_MessageNames_t msgName = LibCanIL_FindRxMessage(pMsg->Id);
+
+	if ((msgName != LIBCANILCFG_MESSAGE_NAME_NO_MESSAGE) &&
+		(LibCanILCfg_MessageTable.pMessageDesc[(uint8_t)msgName].IsLastIsBest == true))
+	{
+		// only the newest frame of a last-is-best message is kept, an older one not yet decoded is superseded
+		const uint32_t msgIdx = (uint32_t)msgName;
+
+		SuspendAllInterrupts();
+		LibCanIL_Mailbox[msgIdx] = *pMsg;
+		LibCanIL_MailboxReady[msgIdx / LIBCANIL_MAILBOX_WORD_BITS] |=
+			UINT32_C(1) << (msgIdx % LIBCANIL_MAILBOX_WORD_BITS);
+		ResumeAllInterrupts();
+	}
+	// a full queue coalesces the message with a queued one of the same ID or drops it, the other messages are kept
+	else if (LibFifoQueue_Push(&LibCanIL_MsgIndFifo, pMsg) == false)
 	{
 		LibLog_Warning("CAN:IL push not possible");
-		LibFifoQueue_Clear(&LibCanIL_MsgIndFifo);
+	}
+	else
+	{
+		// the message is queued
 	}
 	(void)LibService_SetEvent(&LibCanIL_Service, LIBCANIL_EVENT_CAN_MESSAGE_IND);
 }
 
+//=====================================================================================================================
+// LibCanIL_IsSameMsg:
+//=====================================================================================================================
+static bool_t LibCanIL_IsSameMsg(const void* pQueuedItem, const void* pItem)
+{
+	const S_LibCanIL_MsgIndBufferEntry_t* const pQueuedMsg = (const S_LibCanIL_MsgIndBufferEntry_t*)pQueuedItem;
+	const S_LibCanIL_MsgIndBufferEntry_t* const pMsg = (const S_LibCanIL_MsgIndBufferEntry_t*)pItem;
+
+	return ((pQueuedMsg->Id == pMsg->Id) && (pQueuedMsg->IsExtId == pMsg->IsExtId) &&
+			(pQueuedMsg->CanDevId == pMsg->CanDevId));
+}
+
 //=====================================================================================================================
 // LibCanIL_MsgConfirm:
 //=====================================================================================================================
@@ -1439,9 +1665,9 @@ void LibCanIL_CallRequestedCallbacks(void)
 }
 
 //=====================================================================================================================
-// LibCanIL_TxStart:
+// LibCanIL_ExecTxStart:
 //=====================================================================================================================
-void LibCanIL_TxStart(void)
+static void LibCanIL_ExecTxStart(void)
 {
 	LibLog_Info("CAN:IL TX Start\n");
 
@@ -1493,9 +1719,9 @@ void LibCanIL_TxStart(void)
 }
 
 //=====================================================================================================================
-// LibCanIL_RxStart:
+// LibCanIL_ExecRxStart:
 //=====================================================================================================================
-void LibCanIL_RxStart(void)
+static void LibCanIL_ExecRxStart(void)
 {
 	LibLog_Info("CAN:IL RX Start\n");
 	LibCanIL_ReceiveEnabled = true;
@@ -1513,9 +1739,9 @@ void LibCanIL_RxStart(void)
 }
 
 //=====================================================================================================================
-// LibCanIL_TxStop:
+// LibCanIL_ExecTxStop:
 //=====================================================================================================================
-void LibCanIL_TxStop(void)
+static void LibCanIL_ExecTxStop(void)
 {
 	LibLog_Info("CAN:IL TX Stop\n");
 	LibCanIL_TransmitEnabled = false;
@@ -1527,14 +1753,15 @@ void LibCanIL_TxStop(void)
 }
 
 //=====================================================================================================================
-// LibCanIL_RxStop:
+// LibCanIL_ExecRxStop:
 //=====================================================================================================================
-void LibCanIL_RxStop(void)
+static void LibCanIL_ExecRxStop(void)
 {
 	LibLog_Info("CAN:IL RX Stop\n");
 	LibCanIL_ReceiveEnabled = false;
 
 	LibFifoQueue_Clear(&LibCanIL_MsgIndFifo);
+	LibCanIL_ClearMailboxes();
 
 #if LIBCANILCFG_NUMBER_OF_RX_CYCLE_MESSAGE 
 	LibTimer_Stop(&LibCanIL_RxCycleMsgTimer);
@@ -1546,13 +1773,61 @@ void LibCanIL_RxStop(void)
 
 }
 
+
+
+
+//=====================================================================================================================
+// LibCanIL_ExecRxDisable:
+//=====================================================================================================================
+static void LibCanIL_ExecRxDisable(void)
+{
+	LibLog_Info("CAN:IL RX Disable\n");
+	LibCanIL_ReceiveEnabled = false;
+
+#if LIBCANILCFG_NUMBER_OF_RX_CYCLE_MESSAGE 
+	LibTimer_Stop(&LibCanIL_RxCycleMsgTimer);
+#endif
+
+}
+
+//=====================================================================================================================
+// LibCanIL_TxStart:
+//=====================================================================================================================
+void LibCanIL_TxStart(void)
+{
+	LibCanIL_RequestCtrl(LIBCANIL_CTRL_TX_START);
+}
+
+//=====================================================================================================================
+// LibCanIL_RxStart:
+//=====================================================================================================================
+void LibCanIL_RxStart(void)
+{
+	LibCanIL_RequestCtrl(LIBCANIL_CTRL_RX_START);
+}
+
+//=====================================================================================================================
+// LibCanIL_TxStop:
+//=====================================================================================================================
+void LibCanIL_TxStop(void)
+{
+	LibCanIL_RequestCtrl(LIBCANIL_CTRL_TX_STOP);
+}
+
+//=====================================================================================================================
+// LibCanIL_RxStop:
+//=====================================================================================================================
+void LibCanIL_RxStop(void)
+{
+	LibCanIL_RequestCtrl(LIBCANIL_CTRL_RX_STOP);
+}
+
 //=====================================================================================================================
 // LibCanIL_TxEnable:
 //=====================================================================================================================
 void LibCanIL_TxEnable(void)
 {
-	LibLog_Info("CAN:IL TX Enable\n");
-	LibCanIL_TransmitEnabled = true;
+	LibCanIL_RequestCtrl(LIBCANIL_CTRL_TX_ENABLE);
 }
 
 //=====================================================================================================================
@@ -1560,8 +1835,7 @@ void LibCanIL_TxEnable(void)
 //=====================================================================================================================
 void LibCanIL_RxEnable(void)
 {
-	LibLog_Info("CAN:IL RX Enable\n");
-	LibCanIL_ReceiveEnabled = true;
+	LibCanIL_RequestCtrl(LIBCANIL_CTRL_RX_ENABLE);
 }
 
 //=====================================================================================================================
@@ -1569,8 +1843,7 @@ void LibCanIL_RxEnable(void)
 //=====================================================================================================================
 void LibCanIL_TxDisable(void)
 {
-	LibLog_Info("CAN:IL TX Disable\n");
-	LibCanIL_TransmitEnabled = false;
+	LibCanIL_RequestCtrl(LIBCANIL_CTRL_TX_DISABLE);
 }
 
 //=====================================================================================================================
@@ -1578,13 +1851,67 @@ void LibCanIL_TxDisable(void)
 //=====================================================================================================================
 void LibCanIL_RxDisable(void)
 {
-	LibLog_Info("CAN:IL RX Disable\n");
-	LibCanIL_ReceiveEnabled = false;
+	LibCanIL_RequestCtrl(LIBCANIL_CTRL_RX_DISABLE);
+}
 
-#if LIBCANILCFG_NUMBER_OF_RX_CYCLE_MESSAGE 
-	LibTimer_Stop(&LibCanIL_RxCycleMsgTimer);
-#endif
+//=====================================================================================================================
+// LibCanIL_RequestCtrl:
+//=====================================================================================================================
+static void LibCanIL_RequestCtrl(const E_LibCanIL_CtrlReq_t req)
+{
+	const uint8_t item = (uint8_t)req;
 
+	if (!LibFifoQueue_Push(&LibCanIL_CtrlFifo, &item))
+	{
+		// the IL service did not run for LIBCANIL_CTRL_FIFO_ELEMENTS requests, which is a configuration error
+		Lib_Assert(false);
+	}
+	(void)LibService_SetEvent(&LibCanIL_Service, LIBCANIL_EVENT_CONTROL_REQ);
+}
+
+//=====================================================================================================================
+// LibCanIL_ServiceEvCtrlReq:
+//=====================================================================================================================
+static void LibCanIL_ServiceEvCtrlReq(void)
+{
+	uint8_t req;
+
+	while (LibFifoQueue_PopCopy(&LibCanIL_CtrlFifo, &req))
+	{
+		switch ((E_LibCanIL_CtrlReq_t)req)
+		{
+		case LIBCANIL_CTRL_TX_START:
+			LibCanIL_ExecTxStart();
+			break;
+		case LIBCANIL_CTRL_RX_START:
+			LibCanIL_ExecRxStart();
+			break;
+		case LIBCANIL_CTRL_TX_STOP:
+			LibCanIL_ExecTxStop();
+			break;
+		case LIBCANIL_CTRL_RX_STOP:
+			LibCanIL_ExecRxStop();
+			break;
+		case LIBCANIL_CTRL_TX_ENABLE:
+			LibLog_Info("CAN:IL TX Enable\n");
+			LibCanIL_TransmitEnabled = true;
+			break;
+		case LIBCANIL_CTRL_RX_ENABLE:
+			LibLog_Info("CAN:IL RX Enable\n");
+			LibCanIL_ReceiveEnabled = true;
+			break;
+		case LIBCANIL_CTRL_TX_DISABLE:
+			LibLog_Info("CAN:IL TX Disable\n");
+			LibCanIL_TransmitEnabled = false;
+			break;
+		case LIBCANIL_CTRL_RX_DISABLE:
+			LibCanIL_ExecRxDisable();
+			break;
+		default:
+			Lib_Assert(false);
+			break;
+		}
+	}
 }
 
 //=====================================================================================================================
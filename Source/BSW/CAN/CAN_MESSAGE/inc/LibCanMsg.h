@@ -24,7 +24,14 @@
 //	Global Definitions
 // --------------------------------------------------------------------------------------------------------------------
 
-#define LIBCAN_MAXDATABYTENUM		8		//!< Maximum number of CAN message data bytes.
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Maximum number of CAN message data bytes.
+///
+/// Define it to 64 for the whole project (compiler option) to carry CAN FD frames in S_LibCan_Msg_t.
+// --------------------------------------------------------------------------------------------------------------------
+#ifndef LIBCAN_MAXDATABYTENUM
+#define LIBCAN_MAXDATABYTENUM		8
+#endif
 
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief I/O command to start CAN communication.
@@ -72,6 +79,28 @@
 // --------------------------------------------------------------------------------------------------------------------
 #define LIBCAN_IOCTL_SEND_MSG		   3
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Access the next CAN message from the received messages in place.
+///
+/// This I/O command expects a pointer to a variable of type S_LibCan_Msg_t* to store the address of the received CAN
+/// message. The message stays valid until it is released by #LIBCAN_IOCTL_RELEASE_MSG.
+///
+/// This I/O command may return the following values:
+/// - #LIBRET_OK - The CAN message is available.
+/// - #LIBRET_NO_ENTRY - No CAN message available.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBCAN_IOCTL_PEEK_NEXT_MSG	   4
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Release the CAN message accessed by #LIBCAN_IOCTL_PEEK_NEXT_MSG.
+///
+/// No data is required for this I/O command.
+///
+/// This I/O command may return the following values:
+/// - #LIBRET_OK
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBCAN_IOCTL_RELEASE_MSG	   5
+
 
 // --------------------------------------------------------------------------------------------------------------------
 //	Global Data Types
@@ -175,6 +204,19 @@ typedef struct
 // --------------------------------------------------------------------------------------------------------------------
 uint8_t LibCan_GetMsgDataLength(E_LibCan_DlcSize_t dlc);
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Get the smallest CAN message DLC which holds the given data length
+///
+/// Up to 8 bytes the DLC equals the data length, above it is rounded up to the next CAN FD data size.
+///
+/// \param dataLength
+/// CAN message data length in bytes (at most 64)
+///
+/// \return
+/// CAN message DLC (Data Length Code)
+// --------------------------------------------------------------------------------------------------------------------
+E_LibCan_DlcSize_t LibCan_GetMsgDlc(uint8_t dataLength);
+
 
 #endif // LIB_CAN_H__INCLUDED
 
@@ -45,6 +45,7 @@ static const S_LibCanIL_MessageDesc_t LibCanILCfg_Messages[(uint8_t)LIBCANILCFG_
 		.Length			= LIBCAN_DLCSIZE_8_B,
 		.IsTx			= false,
 		.IsIntel		= false,
+		.IsLastIsBest	= true,
 		.CycleTime		= UINT16_C(0),
 		.StartDelayTime	= UINT16_C(0),
 		.CanDevId		= CAN_NM_CHANNEL,
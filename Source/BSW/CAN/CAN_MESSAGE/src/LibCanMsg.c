@@ -83,3 +83,17 @@ uint8_t LibCan_GetMsgDataLength(E_LibCan_DlcSize_t dlc)
 	return LibCan_MsgDataLenth[dlc];
 }
 
+//=====================================================================================================================
+// LibCan_GetMsgDlc:
+//=====================================================================================================================
+E_LibCan_DlcSize_t LibCan_GetMsgDlc(uint8_t dataLength)
+{
+	E_LibCan_DlcSize_t dlc = LIBCAN_DLCSIZE_0_B;
+
+	while ((dlc < LIBCAN_DLCSIZE_64_B) && (LibCan_MsgDataLenth[dlc] < dataLength))
+	{
+		dlc++;
+	}
+
+	return dlc;
+}
@@ -54,6 +54,10 @@ typedef enum
 } NM_Status;
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief used to enable/disable CanNm fun
+///
+/// \attention
+/// Change the flag by CanNm_SetEnable(): the CanNm service is not polled, a direct write only takes effect with the
+/// next event of the service.
 // --------------------------------------------------------------------------------------------------------------------
 extern bool_t NM_enable_flag;
 /// \brief Service Instance of the CAN Network Management
@@ -109,6 +113,14 @@ NM_Status CanNM_GetCanNM_Status(void);
 //pan.sw add
 //bool_t IL_send_fifo_empty = false;
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Enable or disable the CAN network management (NM switch).
+///
+/// \param enable
+/// The new value of NM_enable_flag, handled by the CanNm service.
+// --------------------------------------------------------------------------------------------------------------------
+extern void CanNm_SetEnable(const bool_t enable);
+
 extern void CanNM_SetWakeUpReason(uint32_t reason);
 
 extern void CanNM_ClearWakeUpReason(uint32_t reason);
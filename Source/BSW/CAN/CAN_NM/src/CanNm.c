@@ -21,6 +21,7 @@
 #define CANNM_SRV_EV_GO_TO_SLEEP_TIMEOUT                UINT32_C(0x00000080)
 #define CANNM_SRV_EV_REPEAT_MSG_TIMEOUT                 UINT32_C(0x00000100)
 #define CANNM_SRV_EV_WakeUp                             UINT32_C(0x00000200)
+#define CANNM_SRV_EV_ENABLE_CHANGED                     UINT32_C(0x00000400)
 
 // ----------------------------------------------------------------
 
@@ -100,7 +101,7 @@
     ENTRY(CANNM_EV_GO_TO_SLEEP,     CANNM_STATE_SLEEP,          LibFsm_Empty)
 
 
-LIBFSM_DECLARE_STATE_MACHINE(CanNm, CANNM_EVENTS, CANNM_STATE, NULL);
+LIBFSM_DECLARE_DENSE_STATE_MACHINE(CanNm, CANNM_EVENTS, CANNM_STATE, NULL);
 
 // --------------------------------------------------------------------------------------------------------------------
 //  Global Function Prototypes
@@ -228,7 +229,8 @@ static uint32_t NM_Wakeup_Reason = NM_Wakeup_None;
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief Service Instance of the CAN Network Management
 ///
-/// Initialize the service with the Service handler. No data is required.
+/// Initialize the service with the Service handler. No data is required. The service only runs on events, so the
+/// service host stays idle in the sleep states: a change of the NM switch flag is signalled by CanNm_SetEnable().
 // --------------------------------------------------------------------------------------------------------------------
 S_LibService_Inst_t CanNm_Service = LIBSERVICE_INIT_SERVICE(CanNm_ServiceHndl, NULL);
 
@@ -375,6 +377,7 @@ static void CanNM_OpenNmSwitchByJumpsignal(void)
 static void CanNm_ServiceHndl(void* pData)
 {
     static bool_t CanNm_FirstWakeup_InitFlag = false;
+    (void)LibService_CheckClearEvent(&CanNm_Service, CANNM_SRV_EV_ENABLE_CHANGED);
     CanNM_OpenNmSwitchByJumpsignal();
     // Initialization method
     if (LibService_CheckClearEvent(&CanNm_Service, LIBSERVICE_EV_INIT | LIBSERVICE_EV_RE_INIT) != false)
@@ -924,6 +927,15 @@ static uint32_t CanNM_GetWakeUpReason(void)
     return NM_Wakeup_Reason;
 }
 
+//=====================================================================================================================
+// CanNm_SetEnable:
+//=====================================================================================================================
+void CanNm_SetEnable(const bool_t enable)
+{
+    NM_enable_flag = enable;
+    LibService_SetEvent(&CanNm_Service, CANNM_SRV_EV_ENABLE_CHANGED);
+}
+
 void CanNM_SetWakeUpReason(uint32_t reason)
 {
     NM_Wakeup_Reason |= reason;
@@ -160,7 +160,39 @@ extern void Can_BusOff(void* pData);
 
 extern void TASK_CAN_ServiceHostInit(void);
 
-extern void TASK_CAN_ServiceHostMain(void);
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Run one pass of the CAN service host.
+///
+/// \retval true
+/// Services are still pending (time budget exhausted or events left): the next pass has to follow right away.
+/// \retval false
+/// The service host is idle: the task may block until it is notified about the next event.
+// --------------------------------------------------------------------------------------------------------------------
+extern bool_t TASK_CAN_ServiceHostMain(void);
+
+#ifdef CANTASK_CFG_SPLIT_SERVICE_HOSTS
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Bind the CAN IL service host to the calling task and initialize it.
+// --------------------------------------------------------------------------------------------------------------------
+extern void TASK_CANIL_ServiceHostInit(void);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Run one pass of the CAN IL service host.
+///
+/// \retval true
+/// Services are still pending: the next pass has to follow right away.
+/// \retval false
+/// The service host is idle: the task may block until it is notified about the next event.
+// --------------------------------------------------------------------------------------------------------------------
+extern bool_t TASK_CANIL_ServiceHostMain(void);
+#endif // CANTASK_CFG_SPLIT_SERVICE_HOSTS
+
+#ifdef LIBSERVICECFG_PROFILING
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Dump the execution profiles of the CAN services to the UART log.
+// --------------------------------------------------------------------------------------------------------------------
+extern void TASK_CAN_ServiceHostDumpProfile(void);
+#endif // LIBSERVICECFG_PROFILING
 
 
 #endif // CAN_H__INCLUDED
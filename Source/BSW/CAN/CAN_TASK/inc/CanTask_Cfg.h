@@ -5,4 +5,10 @@
 #define REPORT_LOST_COMM_EN
 #endif
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Host the CAN services in two service hosts: TASK_CAN, TP and NM in the high priority BSW task and the
+/// interaction layer in its own task of normal priority. Comment it out to host all services in the BSW task.
+// --------------------------------------------------------------------------------------------------------------------
+#define CANTASK_CFG_SPLIT_SERVICE_HOSTS
+
 #endif
\ No newline at end of file
@@ -30,6 +30,7 @@
 #include "LibServiceHost.h"
 #include "LibTypes.h"
 #include "CanNm.h"
+#include "task.h"
 
 #if 0
 #include "xcp_can.h"
@@ -100,25 +101,76 @@ const uint8_t CanCfg_NumberOfModules = sizeof(Can_ModuleTable) / sizeof(Can_Modu
 // --------------------------------------------------------------------------------------------------------------------
 //static bool_t Can_IsWakeUpRequested = true;
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Services of the CAN service host ordered by descending priority.
+///
+/// The CAN task dispatches received and confirmed frames to the modules, so it runs first and the modules get
+/// serviced within the same pass. The transport protocol and the network management are time critical compared to
+/// the interaction layer.
+// --------------------------------------------------------------------------------------------------------------------
 static S_LibService_Inst_t* const Can_ServiceTable[] = {
 	&TASK_CAN,
-	&LibCanIL_Service,
 #ifdef LIBCANTP
 	&LibCanTp_Service,
 #endif /* jianggang */
 	&CanNm_Service,
+#ifndef CANTASK_CFG_SPLIT_SERVICE_HOSTS
+	&LibCanIL_Service,
+#endif
 #ifdef XCP_USING_LIBFIFO
 	&LibXcp_Service,
 #endif
 };
 
-static const S_LibServiceHost_Inst_t Can_ServiceHost = {
-		NULL,
-		NULL,
-		Can_ServiceTable,
-		sizeof(Can_ServiceTable) / sizeof(Can_ServiceTable[0])
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Time budget in milliseconds of one pass of the CAN service host (0 = no limit).
+// --------------------------------------------------------------------------------------------------------------------
+#define CAN_SERVICEHOST_PASS_BUDGET_MS	UINT32_C(5)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Handle of the task hosting the CAN service host, notified on pending events.
+// --------------------------------------------------------------------------------------------------------------------
+static TaskHandle_t Can_ServiceHostTask = NULL;
+
+static S_LibServiceHost_State_t Can_ServiceHostState;
+
+static void Can_ServiceHostNotify(void* pData);
+
+static const S_LibServiceHost_Inst_t Can_ServiceHost =
+	LIBSERVICEHOST_INIT_CALLBACK_EX(Can_ServiceHostNotify,
+									&Can_ServiceHostTask,
+									Can_ServiceTable,
+									sizeof(Can_ServiceTable) / sizeof(Can_ServiceTable[0]),
+									&Can_ServiceHostState,
+									NULL,
+									CAN_SERVICEHOST_PASS_BUDGET_MS);
+
+#ifdef CANTASK_CFG_SPLIT_SERVICE_HOSTS
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Services of the CAN IL service host ordered by descending priority.
+///
+/// The interaction layer and the application callbacks invoked by it run in a task of lower priority, so a long
+/// callback chain does not delay the transport protocol and the network management.
+// --------------------------------------------------------------------------------------------------------------------
+static S_LibService_Inst_t* const Can_IlServiceTable[] = {
+	&LibCanIL_Service,
 };
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Handle of the task hosting the CAN IL service host, notified on pending events.
+// --------------------------------------------------------------------------------------------------------------------
+static TaskHandle_t Can_IlServiceHostTask = NULL;
+
+static S_LibServiceHost_State_t Can_IlServiceHostState;
+
+static const S_LibServiceHost_Inst_t Can_IlServiceHost =
+	LIBSERVICEHOST_INIT_CALLBACK(Can_ServiceHostNotify,
+								 &Can_IlServiceHostTask,
+								 Can_IlServiceTable,
+								 sizeof(Can_IlServiceTable) / sizeof(Can_IlServiceTable[0]),
+								 &Can_IlServiceHostState);
+#endif // CANTASK_CFG_SPLIT_SERVICE_HOSTS
+
 void TASK_CAN_ServiceHndl(void* pData);
 // --------------------------------------------------------------------------------------------------------------------
 //	Local Function Prototypes
@@ -134,9 +186,18 @@ S_LibService_Inst_t TASK_CAN = LIBSERVICE_INIT_SERVICE(TASK_CAN_ServiceHndl, NUL
 static void Can_TransmitCanMsgs(void);
 static void Can_ConfirmCanMsgs(void);
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Send the CAN messages of a transmit queue until a message has to wait for a transmit mailbox.
+///
+/// \param pFifo
+/// The transmit queue holding items of type S_LibCan_Msg_t.
+// --------------------------------------------------------------------------------------------------------------------
+static void Can_TransmitFifo(S_LibFifoQueue_Inst_t* const pFifo);
+
 static uint32_t Can_MsgSentFifoBuffer[LIBCANTASK_MSG_CON_FIFO_ELEMENTS];
 
-LIBFIFO_DEFINE_INST(Can_MsgSentFifo, Can_MsgSentFifoBuffer, sizeof(uint32_t), LIBCANTASK_MSG_CON_FIFO_ELEMENTS, false);
+LIBFIFO_DEFINE_SHARED_INST(Can_MsgSentFifo, Can_MsgSentFifoBuffer, sizeof(uint32_t), LIBCANTASK_MSG_CON_FIFO_ELEMENTS,
+						   false);
 
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief Can_StartNormalComm
@@ -236,9 +297,12 @@ void Can_MsgReceived(void* pData)
 //=====================================================================================================================
 void Can_MsgSent(uint32_t msgId)
 {
-	LibFifoQueue_Push(&Can_MsgSentFifo, (const void*)&msgId);
+	// a full queue drops the confirmation, the ISR context only reports it
+	if (LibFifoQueue_Push(&Can_MsgSentFifo, (const void*)&msgId) == false)
+	{
+		LibLog_Warning("CAN: confirmation push not possible");
+	}
 	(void)LibService_SetEvent(&TASK_CAN, EV_CAN_MSG_CON);
-	Lib_Assert(Can_MsgSentFifo.Count > 0);
 }
 
 //=====================================================================================================================
@@ -254,6 +318,33 @@ void Can_BusOff(void* pData)
 void Can_TriggerShutdown(const S_LibServiceHost_Inst_t* const pServiceHost)
 {
 	LibServiceHost_TriggerShutdown(pServiceHost);
+#ifdef CANTASK_CFG_SPLIT_SERVICE_HOSTS
+	LibServiceHost_TriggerShutdown(&Can_IlServiceHost);
+#endif // CANTASK_CFG_SPLIT_SERVICE_HOSTS
+}
+
+//=====================================================================================================================
+// Can_ServiceHostNotify:
+//=====================================================================================================================
+static void Can_ServiceHostNotify(void* pData)
+{
+	// events may be set from tasks of other service hosts, from timer callbacks in the tick hook and from the CAN
+	// interrupts: wake up the task hosting the service host
+	const TaskHandle_t hTask = *(TaskHandle_t*)pData;
+
+	if (NULL != hTask)
+	{
+		if (xPortIsInsideInterrupt())
+		{
+			BaseType_t higherPrioTaskWoken = pdFALSE;
+			vTaskNotifyGiveFromISR(hTask, &higherPrioTaskWoken);
+			portYIELD_FROM_ISR(higherPrioTaskWoken);
+		}
+		else
+		{
+			(void)xTaskNotifyGive(hTask);
+		}
+	}
 }
 #if 0
 //=====================================================================================================================
@@ -286,16 +377,40 @@ static void CanTask_AllService_Polling(void)
 //=====================================================================================================================
 void TASK_CAN_ServiceHostInit(void)
 {
-	// initialize the service host
+	// bind the service host to the calling task and initialize it
+	Can_ServiceHostTask = xTaskGetCurrentTaskHandle();
 	LibServiceHost_Init(&Can_ServiceHost);
 }
 
-void TASK_CAN_ServiceHostMain(void)
+bool_t TASK_CAN_ServiceHostMain(void)
 {
 	LibServiceHost_Service(&Can_ServiceHost);
 	//LibCanIL_CallRequestedCallbacks();
+	return LibServiceHost_IsPending(&Can_ServiceHost);
+}
+
+#ifdef CANTASK_CFG_SPLIT_SERVICE_HOSTS
+void TASK_CANIL_ServiceHostInit(void)
+{
+	// bind the service host to the calling task and initialize it
+	Can_IlServiceHostTask = xTaskGetCurrentTaskHandle();
+	LibServiceHost_Init(&Can_IlServiceHost);
 }
 
+bool_t TASK_CANIL_ServiceHostMain(void)
+{
+	LibServiceHost_Service(&Can_IlServiceHost);
+	return LibServiceHost_IsPending(&Can_IlServiceHost);
+}
+#endif // CANTASK_CFG_SPLIT_SERVICE_HOSTS
+
+#ifdef LIBSERVICECFG_PROFILING
+void TASK_CAN_ServiceHostDumpProfile(void)
+{
+	LibServiceHost_DumpProfile(&Can_ServiceHost);
+}
+#endif // LIBSERVICECFG_PROFILING
+
 
 void TASK_CAN_ServiceHndl(void* pData)
 {
@@ -346,7 +461,6 @@ void TASK_CAN_ServiceHndl(void* pData)
 	if(LibService_CheckClearEvent(&TASK_CAN, EV_CAN_MSG_RCVD))
 	{
 		Can_HandleCanMsgs(NULL);
-		LibCanIL_CallRequestedCallbacks();
 	}
 
 	if(LibService_CheckClearEvent(&TASK_CAN, EV_CAN_MSG_REQ))
@@ -395,21 +509,22 @@ void Can_HandleCanMsgs(pLibDrv_Hndl_t hndl)
 	// fetch messages until there are no messages to fetch anymore
 	do
 	{
-		S_LibCan_Msg_t	msg;
-		ret = LibMcan_IoCtl(&msg, LIBCAN_IOCTL_GET_NEXT_MSG);
+		// the message is accessed in place in the receive queue and handed to the modules without a copy
+		S_LibCan_Msg_t*	pMsg = NULL;
+		ret = LibMcan_IoCtl(&pMsg, LIBCAN_IOCTL_PEEK_NEXT_MSG);
 		if (LIBRET_OK == ret)
 		{
 #ifdef REPORT_LOST_COMM_EN 
-			CanTask_LostComm_MsgCheck(msg.Id);
+			CanTask_LostComm_MsgCheck(pMsg->Id);
 #endif
 
 			if(CanNm_Appframe_RxEnable == false)
 			{
 				//only chcek the CAN NM module is "interested" in the confirm singal
-				if(CanNm_Module.IsMsg(msg.Id))
+				if(CanNm_Module.IsMsg(pMsg->Id))
 				{
 					//invoke the indicate function of CAN NM module
-					CanNm_Module.MsgIndicate(&msg);
+					CanNm_Module.MsgIndicate(pMsg);
 				}
 			}
 			else
@@ -418,14 +533,16 @@ void Can_HandleCanMsgs(pLibDrv_Hndl_t hndl)
 				for (uint8_t i = 0U; i < CanCfg_NumberOfModules; i++)
 				{
 					// check if the current module is "interested" in the confirm signal
-					if (Can_ModuleTable[i]->IsMsg(msg.Id))
+					if (Can_ModuleTable[i]->IsMsg(pMsg->Id))
 					{
 						//invoke the indicate function of that module
-						Can_ModuleTable[i]->MsgIndicate(&msg);
+						Can_ModuleTable[i]->MsgIndicate(pMsg);
 					}
 				}
 			}
 
+			(void)LibMcan_IoCtl(NULL, LIBCAN_IOCTL_RELEASE_MSG);
+
 			//ret = LIBRET_NO_ENTRY;
 		}
 		else if (LIBRET_NO_ENTRY == ret)
@@ -446,87 +563,59 @@ void Can_HandleCanMsgs(pLibDrv_Hndl_t hndl)
 //=====================================================================================================================
 static void Can_TransmitCanMsgs(void)
 {
-	Ret_t    ret  = LIBRET_OK;
-
     //handles all transmit massages from Network Management 
-     do
-     {
-         S_LibCan_Msg_t* pMsg;
-         pMsg = (S_LibCan_Msg_t*)LibFifoQueue_GetItem(&CanNm_NmMsgSendFifo, UINT32_C(0));
-         if(pMsg == NULL)
-         {
-             break;
-         }
- 
-         ret = LibMcan_IoCtl(pMsg, LIBCAN_IOCTL_SEND_MSG);
-         if (LIBRET_OK != ret)
-         {
-             LibLog_Info("CAN: Cannot handle message: %d", ret);
-         }
-         LibFifoQueue_Pop(&CanNm_NmMsgSendFifo);
-     }
-     while (true);
+	Can_TransmitFifo(&CanNm_NmMsgSendFifo);
 
 	//handles all transmit massages from Transport Protocol
 	#if 0
-	do
-	{
-		S_LibCanTp_MsgReqBufferEntry_t*	pMsg;
-		pMsg = (S_LibCanTp_MsgReqBufferEntry_t*)LibFifoQueue_GetItem(&LibCanTp_MsgReqFifo, UINT32_C(0));
-		if(pMsg == NULL)
-		{
-			break;
-		}
-
-		ret = LibMcan_IoCtl ((S_LibCan_Msg_t*)&pMsg, LIBCAN_IOCTL_SEND_MSG);
-		if (LIBRET_OK != ret)
-		{
-			LibLog_Info("CAN: Cannot handle message: %d", ret);
-		}
-		LibFifoQueue_Pop(&LibCanTp_MsgReqFifo);
-	}
-	while (true);
+	Can_TransmitFifo(&LibCanTp_MsgReqFifo);
 	#endif /* jianggang */
 
 	// handles all transmit massages from Interaction Layer
-	do
-	{
-		S_LibCanIL_MsgReqBufferEntry_t*	pMsg;
-		pMsg = (S_LibCanIL_MsgReqBufferEntry_t*)LibFifoQueue_GetItem(&LibCanIL_MsgReqFifo, UINT32_C(0));
-		if(pMsg == NULL)
-		{
-			break;
-		}
-		
-		ret = LibMcan_IoCtl(&pMsg, LIBCAN_IOCTL_SEND_MSG);
-		if (LIBRET_OK != ret)
-		{
-			LibLog_Info("CAN: Cannot handle message: %d", ret);
-		}
-		LibFifoQueue_Pop(&LibCanIL_MsgReqFifo);
-	}
-	while (true);
+	Can_TransmitFifo(&LibCanIL_MsgReqFifo);
 
 #ifdef XCP_USING_LIBFIFO
 	// handles all transmit massages from Xcp
+	Can_TransmitFifo(&LibXcp_MsgReqFifo);
+#endif
+}
+
+//=====================================================================================================================
+// Can_TransmitFifo:
+//=====================================================================================================================
+static void Can_TransmitFifo(S_LibFifoQueue_Inst_t* const pFifo)
+{
+	S_LibFifoQueue_Span_t spans[LIBFIFO_NUM_SPANS];
+	uint32_t numMsgs;
+	bool_t isBusy = false;
+
+	// send the whole burst of queued messages in place and remove it at once. A message which has to wait for a
+	// transmit mailbox stays in the queue with the following ones, CanIF sets EV_CAN_MSG_REQ when a mailbox got free.
 	do
 	{
-		S_LibXcp_MsgReqBufferEntry_t*	pMsg;
-		pMsg = (S_LibXcp_MsgReqBufferEntry_t*)LibFifoQueue_GetItem(&LibXcp_MsgReqFifo, UINT32_C(0));
-		if(pMsg == NULL)
-		{
-			break;
-		}
+		uint32_t numSent = 0U;
 
-		ret = LibMcan_IoCtl(&pMsg, LIBCAN_IOCTL_SEND_MSG);
-		if (LIBRET_OK != ret)
+		numMsgs = LibFifoQueue_GetSpans(pFifo, spans);
+		for (uint32_t span = 0U; (span < LIBFIFO_NUM_SPANS) && (!isBusy); span++)
 		{
-			LibLog_Info("CAN: Cannot handle message: %d", ret);
+			S_LibCan_Msg_t* const pMsgs = (S_LibCan_Msg_t*)spans[span].pItems;
+			for (uint32_t msgIdx = 0U; (msgIdx < spans[span].NumItems) && (!isBusy); msgIdx++)
+			{
+				const Ret_t ret = LibMcan_IoCtl(&pMsgs[msgIdx], LIBCAN_IOCTL_SEND_MSG);
+				isBusy = (LIBRET_BUSY == ret);
+				if (!isBusy)
+				{
+					if (LIBRET_OK != ret)
+					{
+						LibLog_Info("CAN: Cannot handle message: %d", ret);
+					}
+					numSent++;
+				}
+			}
 		}
-		LibFifoQueue_Pop(&LibXcp_MsgReqFifo);
+		LibFifoQueue_PopN(pFifo, numSent);
 	}
-	while (true);
-#endif
+	while ((numMsgs != 0U) && (!isBusy));
 }
 
 //=====================================================================================================================
@@ -534,40 +623,38 @@ static void Can_TransmitCanMsgs(void)
 //=====================================================================================================================
 static void Can_ConfirmCanMsgs(void)
 {
+	S_LibFifoQueue_Span_t spans[LIBFIFO_NUM_SPANS];
+	uint32_t numIds;
 	uint8_t i;
 
 	// fetch messages until there are no messages to fetch anymore
 	do
 	{
-		// The Can_MsgSentFifo is modified from the ISR context (see \ref Can_MsgSent).
-		//DisableAllInterrupts();
-		uint32_t* pId      = LibFifoQueue_GetItem(&Can_MsgSentFifo, UINT32_C(0));
-		bool_t   msgFound = (pId != NULL);
-		uint32_t id;
-		if (msgFound)
-		{
-			id = *pId;
-			LibFifoQueue_Pop(&Can_MsgSentFifo);
-		}
-		//EnableAllInterrupts();
-
-		if(!msgFound)
-		{
-			break;
-		}
-
-		// loop over CAN modules
-		for (i = 0U; i < CanCfg_NumberOfModules; i++)
+		// The Can_MsgSentFifo is modified from the ISR context (see \ref Can_MsgSent), the spans stay valid until the
+		// confirmations are popped.
+		numIds = LibFifoQueue_GetSpans(&Can_MsgSentFifo, spans);
+		for (uint32_t span = 0U; span < LIBFIFO_NUM_SPANS; span++)
 		{
-			// check if the current module is "interested" in the confirm signal
-			if (Can_ModuleTable[i]->IsMsg(id))
+			const uint32_t* const pIds = (const uint32_t*)spans[span].pItems;
+			for (uint32_t idIdx = 0U; idIdx < spans[span].NumItems; idIdx++)
 			{
-				// invoke the confirm function of that module
-				Can_ModuleTable[i]->MsgConfirm(id);
+				const uint32_t id = pIds[idIdx];
+
+				// loop over CAN modules
+				for (i = 0U; i < CanCfg_NumberOfModules; i++)
+				{
+					// check if the current module is "interested" in the confirm signal
+					if (Can_ModuleTable[i]->IsMsg(id))
+					{
+						// invoke the confirm function of that module
+						Can_ModuleTable[i]->MsgConfirm(id);
+					}
+				}
 			}
 		}
+		LibFifoQueue_PopN(&Can_MsgSentFifo, numIds);
 		
-	}while(true);
+	}while(numIds != 0U);
 }
 
 
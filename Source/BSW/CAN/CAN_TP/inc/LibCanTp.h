@@ -72,6 +72,35 @@
 // --------------------------------------------------------------------------------------------------------------------
 #define LIBCANTP_SRV_EV_COMERR	UINT32_C(0x00000008)
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Service Event - Abort
+///
+/// A timeout or protocol error occurred on one or more connections, which are reinitialized
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBCANTP_SRV_EV_ABORT	UINT32_C(0x00000010)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Service Event - DiagCom Ready
+///
+/// The DiagCom layer finished the processing of a request and accepts the next received message
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBCANTP_SRV_EV_DIAGCOM_READY	UINT32_C(0x00000020)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Service Event - FlowControl Retry
+///
+/// A deferred FlowControl may be sent now: a receive segment was provided, the receive queue was emptied or DiagCom
+/// released the buffer of a connection
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBCANTP_SRV_EV_FC_RETRY	UINT32_C(0x00000040)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Service Event - FlowControl Wait
+///
+/// N_Br elapsed for a deferred FlowControl, a WAIT is sent
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBCANTP_SRV_EV_FC_WAIT		UINT32_C(0x00000080)
+
 
 // --------------------------------------------------------------------------------------------------------------------
 //	Global Data Types
@@ -82,6 +111,52 @@ typedef S_LibCanTp_BufferEntry_t S_LibCanTp_MsgReqBufferEntry_t;
 typedef S_LibCanTp_BufferEntry_t S_LibCanTp_MsgIndBufferEntry_t;
 typedef uint32_t S_LibCanTp_MsgConBufferEntry_t;
 
+#if (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Upper layer of a streaming reception (StartOfReception / CopyRxData style)
+///
+/// All callbacks are called from the CanTP service.
+// --------------------------------------------------------------------------------------------------------------------
+typedef struct S_LibCanTp_RxStream_t {
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief A FirstFrame was received on the connection
+	///
+	/// Returns true to take over the message, the first segment should be provided before the function returns. If
+	/// false is returned the message is received into the connection buffer and handed over to DiagCom.
+	///
+	/// \param pUserData
+	/// S_LibCanTp_RxStream_t::pUserData
+	/// \param msgLength
+	/// Length of the message (FF_DL)
+	/// \param pData
+	/// Payload of the FirstFrame, e.g. to check the service identifier
+	/// \param dataLength
+	/// Number of payload bytes in the FirstFrame
+	// ----------------------------------------------------------------------------------------------------------------
+	bool_t (*StartOfReception)(void* pUserData, const uint32_t msgLength, const uint8_t* pData, const uint32_t dataLength);
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief A segment is filled (or the last segment of the message is filled partially)
+	///
+	/// The segment belongs to the upper layer again.
+	// ----------------------------------------------------------------------------------------------------------------
+	void (*SegmentReceived)(void* pUserData, uint8_t* pSegment, const uint32_t length);
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief The streaming reception ended
+	///
+	/// result is LIBRET_OK if the message was received completely, otherwise the reception was aborted. The segments
+	/// which were provided but not handed over are no longer used by the CanTP.
+	// ----------------------------------------------------------------------------------------------------------------
+	void (*RxIndication)(void* pUserData, const Ret_t result);
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief User data passed to the callbacks
+	// ----------------------------------------------------------------------------------------------------------------
+	void* pUserData;
+} S_LibCanTp_RxStream_t;
+#endif // (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+
 
 // --------------------------------------------------------------------------------------------------------------------
 //	Imported Variables
@@ -133,12 +208,72 @@ extern void LibCanTp_MsgConfirm(uint32_t msgId);
 
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief Request the transmission of a TP message (not CAN frame)
-/// 
-/// \param pMsg 
-/// The message that should be sent
+///
+/// \param pMsg
+/// The message that should be sent. It is sent over the connection given by ConnId, which is the connection that
+/// received the request.
 // --------------------------------------------------------------------------------------------------------------------
 extern void LibCanTp_MsgRequest(S_LibDiagCom_Msg_t* pMsg);
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Lend the transmit buffer of a connection for a zero-copy response
+///
+/// The buffer holds the request which DiagCom processes. The response is written into it in place and committed by
+/// LibCanTp_MsgRequest() with pPayload pointing to the buffer and PayloadLen set; the message is then segmented
+/// straight from the buffer. Installed as S_LibDiagCom_Msg_t::GetTxBuffer.
+///
+/// \param pMsg
+/// The request indicated to DiagCom, its ConnId selects the connection
+/// \param pMaxLen
+/// Size of the buffer (LIBCANTPCFG_MULTIFRAME_BUFFER_SIZE)
+/// \return
+/// The buffer, NULL if the connection does not hold a request processed by DiagCom
+// --------------------------------------------------------------------------------------------------------------------
+extern uint8_t* LibCanTp_TxBufferLend(S_LibDiagCom_Msg_t* pMsg, uint16_t* pMaxLen);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief A transmit mailbox of the CAN controller got free
+///
+/// Called from the transmit complete interrupt of the CAN driver. The free mailboxes are refilled with the segmented
+/// ConsecutiveFrames of the connections on this device.
+///
+/// \param devId
+/// The Device Driver Identifier
+/// \sa LIBCANTPCFG_TX_BURST_FRAMES
+// --------------------------------------------------------------------------------------------------------------------
+extern void LibCanTp_TxMailboxFree(const E_LibDrv_DevId_t devId);
+
+#if (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Register the upper layer of the streaming reception of a connection
+///
+/// \param connId
+/// Connection (index of the instance, S_LibDiagCom_Msg_t::ConnId)
+/// \param pStream
+/// Callbacks of the upper layer, NULL to unregister
+/// \return
+/// LIBRET_OK, LIBRET_INV_PARAM for an unknown connection
+// --------------------------------------------------------------------------------------------------------------------
+extern Ret_t LibCanTp_RxStreamRegister(const uint8_t connId, const S_LibCanTp_RxStream_t* pStream);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Provide a receive segment for the streaming reception of a connection
+///
+/// May be called from any task. The segments are filled in the order they are provided.
+///
+/// \param connId
+/// Connection (index of the instance, S_LibDiagCom_Msg_t::ConnId)
+/// \param pSegment
+/// Segment to be filled
+/// \param size
+/// Size of the segment in bytes
+/// \return
+/// LIBRET_OK, LIBRET_INV_PARAM for an unknown connection or an empty segment, LIBRET_BUFF_ERR if
+/// LIBCANTPCFG_RX_STREAM_SEGMENTS segments are queued already
+// --------------------------------------------------------------------------------------------------------------------
+extern Ret_t LibCanTp_RxStreamProvide(const uint8_t connId, uint8_t* pSegment, const uint32_t size);
+#endif // (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief Stop the transmission.
 // --------------------------------------------------------------------------------------------------------------------
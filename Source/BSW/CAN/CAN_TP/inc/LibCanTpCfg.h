@@ -21,6 +21,7 @@
 
 #include "LibTypes.h"
 #include "CanTask.h"
+#include "CanIF.h"
 
 // --------------------------------------------------------------------------------------------------------------------
 //	Global Definitions
@@ -37,6 +38,19 @@
 #define LIBCANTPCFG_FRAMELENGTH               (8U)
 #define LIBCANTPCFG_FRAMEPADDING              (0xCCU)
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Frame data length (TX_DL) of the connections with CAN FD framing
+///
+/// Valid CAN FD data sizes are 8, 12, 16, 20, 24, 32, 48 and 64. It must not exceed LIBCAN_MAXDATABYTENUM, so 64 byte
+/// frames need LIBCAN_MAXDATABYTENUM defined to 64.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBCANTPCFG_CANFD_TX_DL               (LIBCAN_MAXDATABYTENUM)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief The CAN FD frames are sent with bit rate switch
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBCANTPCFG_CANFD_BRS                 true
+
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief FC Min DLC
 // --------------------------------------------------------------------------------------------------------------------
@@ -58,7 +72,14 @@
 #define LIBCANTP_CONSECUTIVE_TIMEOUT_MS		UINT32_C(500)
 
 // --------------------------------------------------------------------------------------------------------------------
-/// \brief Max of SEPARATIONTIMEMINMUM and this value should less than N_Cr
+/// \brief Time for N_Br: a FlowControl which cannot be sent as ContinueToSend within this time is sent as WAIT
+///
+/// Must be clearly below the N_Bs of the sender (1000 ms for UDS).
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBCANTP_FLOWCONTROL_WAIT_MS		UINT32_C(100)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Max of SEPARATIONTIMEMINMUM in milliseconds (also used for reserved STmin values), should be less than N_Cr
 // --------------------------------------------------------------------------------------------------------------------
 #define LIBCANTP_SEPARATIONTIMEMINMUM_MAX   UINT32_C(127)
 
@@ -89,8 +110,41 @@
 
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief Flow Control Configuration: WaitFrame Time Maximum
+///
+/// Number of FlowControl WAIT frames sent in a row while the receiver cannot continue (no free segment of a
+/// streaming reception, receive queue full, connection buffer still held by DiagCom).
+///
+/// 0x00		=> WAIT is not used, the reception is given up after N_Br
+/// 0x01 - 0xFF	=> WAIT is sent every LIBCANTP_FLOWCONTROL_WAIT_MS, the reception is given up after WFTmax WAITs (a
+///				   FirstFrame held while DiagCom processes the previous message is answered with OVFLW)
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBCANTPCFG_FC_PARAM_WFTMAX			UINT8_C(10)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Flow Control Configuration: adapt BS and STmin of every ContinueToSend to the receive load
+///
+/// The load is given by the free entries of the frame indication queue and the latency of the CanTP service (the time
+/// a received frame waits for the service, which grows with the CPU load). While the sender could overrun the queue
+/// before the service runs, STmin spreads the ConsecutiveFrames so that at most the free entries are received within
+/// the latency and the BS ends the block after LIBCANTPCFG_FC_ADAPTIVE_BLOCK_RUNS latencies. Entries which other
+/// receiving connections may fill are not free. Without any free entry the ContinueToSend is deferred.
+/// LIBCANTPCFG_FC_PARAM_BS and LIBCANTPCFG_FC_PARAM_STMIN are used on an unloaded ECU, STmin is never below it.
+///
+/// 0 => the configured BS and STmin are always sent
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBCANTPCFG_FC_ADAPTIVE				1
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Shortest time between two received ConsecutiveFrames in microseconds (8 byte frames at 500 kbit/s)
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBCANTPCFG_FC_ADAPTIVE_FRAME_US	UINT32_C(250)
+
 // --------------------------------------------------------------------------------------------------------------------
-#define LIBCANTPCFG_FC_PARAM_WFTMAX			UINT8_C(0)
+/// \brief Number of service runs a block spans on a loaded ECU, the next ContinueToSend adapts to the load again
+///
+/// A block of one connection must end for another connection to get its share of the indication queue.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBCANTPCFG_FC_ADAPTIVE_BLOCK_RUNS	UINT32_C(8)
 
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief Receiver buffer size
@@ -102,6 +156,18 @@
 // --------------------------------------------------------------------------------------------------------------------
 #define LIBCANTPCFG_MULTIFRAME_BUFFER_SIZE	UINT32_C(1344)
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Number of receive segments a connection queues for the streaming reception
+///
+/// An upper layer registered with LibCanTp_RxStreamRegister() may take over a segmented message on its FirstFrame.
+/// The message is then not limited by LIBCANTPCFG_MULTIFRAME_BUFFER_SIZE: it is copied into the segments provided by
+/// LibCanTp_RxStreamProvide() and every filled segment is handed over while the following frames arrive. The BS of
+/// the FlowControl frames is limited to the provided space.
+///
+/// 0 => no streaming reception, every message is received into the connection buffer
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBCANTPCFG_RX_STREAM_SEGMENTS		(2U)
+
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief Addressing scheme of diagnostic
 ///
@@ -120,11 +186,33 @@
 #define LIBCANTPCFG_TESTER_PHYS_ADDRESS		0x498U
 
 // --------------------------------------------------------------------------------------------------------------------
-/// \brief Declare instances of the Transport Protocol
+/// \brief Driver device (CAN channel) on which the diagnostic connections are received
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBDRV_DEVID_MCAN					CanChannel_1
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Declare instances (connections) of the Transport Protocol
+///
+/// Every instance is one ISO-TP connection with its own state machine, timers and buffer, so the connections
+/// receive and send independently of each other. A received frame is routed to the instance with matching device and
+/// receive CAN identifier, the response is sent over the instance which received the request.
+///
+/// ENTRY(name, devId, rxId, txId, isPhysical, isCanFd)
+/// - devId: driver device (CAN channel) of the connection
+/// - rxId: CAN identifier of the frames received by the ECU (request, FlowControl)
+/// - txId: CAN identifier of the frames sent by the ECU (response, FlowControl)
+/// - isPhysical: true for physical addressing (1-to-1), false for functional addressing (1-to-n)
+/// - isCanFd: true for CAN FD framing with LIBCANTPCFG_CANFD_TX_DL (ISO 15765-2:2016), false for classic 8 byte frames
+///
+/// A second tester is added with an additional physical entry with its own request/response identifiers, e.g.
+/// ENTRY(PHYS2, LIBDRV_DEVID_MCAN, 0x49AU, 0x49BU, true, false)
+///
+/// \attention At most 32 instances are supported.
+/// \attention CAN FD framing needs a CAN FD controller, the bxCAN of the STM32F7 sends classic frames only.
 // --------------------------------------------------------------------------------------------------------------------
-#define LIBDRV_DEVID_MCAN 1
 #define LIBCANTPCFG_INSTANCES(ENTRY) \
-	ENTRY(MCAN, LIBDRV_DEVID_MCAN)
+	ENTRY(PHYS, LIBDRV_DEVID_MCAN, LIBCANTPCFG_TESTER_PHYS_ADDRESS, LIBCANTPCFG_ECU_PHYS_ADDRESS, true, false) \
+	ENTRY(FUNC, LIBDRV_DEVID_MCAN, LIBCANTPCFG_ECU_FUNC_ADDRESS, LIBCANTPCFG_ECU_PHYS_ADDRESS, false, false)
 
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -132,6 +220,27 @@
 // --------------------------------------------------------------------------------------------------------------------
 #define LIBCANTPCFG_SET_TASKEV_REQ()   (void)LibService_SetEvent(&TASK_CAN, EV_CAN_MSG_REQ)
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Number of ConsecutiveFrames segmented ahead per connection (interrupt paced transmission)
+///
+/// The service segments the CFs of a block into a queue of this size. A connection has one CF in a transmit mailbox
+/// at a time (the mailboxes are sent by the priority of the identifier, two CFs of a connection could be swapped),
+/// the next one is written from the transmit complete interrupt, so it does not wait for a service pass. STmin is
+/// honored between two CFs and no more CFs than the BS of the last FlowControl are segmented.
+///
+/// 0 => every CF is sent by a separate service pass after the confirmation of the previous one
+// --------------------------------------------------------------------------------------------------------------------
+#ifndef LIBCANTPCFG_TX_BURST_FRAMES
+#define LIBCANTPCFG_TX_BURST_FRAMES			(8U)
+#endif
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief The method to write a frame into a free transmit mailbox (task and interrupt context)
+///
+/// Shall return LIBRET_OK if the frame is accepted and invoke the callback from the transmit complete interrupt.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBCANTPCFG_TX_FRAME(pMsg, clbk, pData)	CanIF_TxFrame((pMsg), (clbk), (pData))
+
 // --------------------------------------------------------------------------------------------------------------------
 //	Global Data Types
 // --------------------------------------------------------------------------------------------------------------------
@@ -23,7 +23,7 @@
 #include "LibCanTp.h"
 #include "LibCanTpCfg.h"
 
-#include "LibTimer.h"
+#include "LibHrTimer.h"
 
 #include "LibTypes.h"
 
@@ -31,6 +31,12 @@
 //	Global Definitions
 // --------------------------------------------------------------------------------------------------------------------
 
+#ifdef LIBFSMCFG_TRACE
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Number of states of the FSM of the TP instances (LIBCANTP_FSM_STATES in LibCanTpFsm.c)
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBCANTP_FSM_STATE_NUM				4U
+#endif // LIBFSMCFG_TRACE
 
 // --------------------------------------------------------------------------------------------------------------------
 //	Global Data Types
@@ -46,6 +52,15 @@ typedef enum E_LibCanTp_FrameType_t {
 	LIBCANTP_FRAMETYPE_FLOWCONTROL		= 0x03U,
 } E_LibCanTp_FrameType_t;
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief FlowStatus values of a FlowControl frame defined by ISO 15765-2 (ISO TP)
+// --------------------------------------------------------------------------------------------------------------------
+typedef enum E_LibCanTp_FlowStatus_t {
+	LIBCANTP_FLOWSTATUS_CTS				= 0x00U,
+	LIBCANTP_FLOWSTATUS_WAIT			= 0x01U,
+	LIBCANTP_FLOWSTATUS_OVFLW			= 0x02U,
+} E_LibCanTp_FlowStatus_t;
+
 typedef enum E_LibCanTp_AddressingScheme_t {
 	LIBCANTP_ADDR_SCHEME_NORMAL_ADDRESSING,
 	LIBCANTP_ADDR_SCHEME_NORMAL_FIXED_ADDRESSING,
@@ -89,6 +104,13 @@ typedef struct S_LibCanTp_DataUnit_t {
 	// ----------------------------------------------------------------------------------------------------------------
 	uint32_t			Length;
 
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Data length of the CAN frames of the message being received (RX_DL)
+	///
+	/// Taken from the FirstFrame, every ConsecutiveFrame except the last one has to carry this length.
+	// ----------------------------------------------------------------------------------------------------------------
+	uint8_t				RxDl;
+
 	// ----------------------------------------------------------------------------------------------------------------
 	/// \brief Buffer in which the received data or the data to be sent is stored. Its size is determined by the 
 	/// configuration given by the OEM. This information can be retrieved from CDD.
@@ -97,6 +119,20 @@ typedef struct S_LibCanTp_DataUnit_t {
 	// ----------------------------------------------------------------------------------------------------------------
 	uint8_t				Buffer[LIBCANTPCFG_MULTIFRAME_BUFFER_SIZE];
 
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Data of the message being sent
+	///
+	/// Buffer, or TxSingleFrame for a SingleFrame sent while DiagCom owns Buffer. A response assembled in the lent
+	/// Buffer is segmented from it without a copy.
+	// ----------------------------------------------------------------------------------------------------------------
+	const uint8_t*		pTxData;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Data of a SingleFrame sent while DiagCom owns Buffer (e.g. ResponsePending during the assembly of the
+	/// response in the lent buffer)
+	// ----------------------------------------------------------------------------------------------------------------
+	uint8_t				TxSingleFrame[LIBCAN_MAXDATABYTENUM];
+
 	// ----------------------------------------------------------------------------------------------------------------
 	/// \brief Read/Write index for handling with the buffer
 	// ----------------------------------------------------------------------------------------------------------------
@@ -157,6 +193,8 @@ typedef struct S_LibCanTp_FlowCtrlSts_t {
 
 	// ----------------------------------------------------------------------------------------------------------------
 	/// \brief Number of frames until the sender has to wait for next Flow Control frame
+	///
+	/// While receiving: number of frames until the next Flow Control frame is sent
 	// ----------------------------------------------------------------------------------------------------------------
 	uint8_t				BlockSizeRemaining;
 
@@ -170,8 +208,20 @@ typedef struct S_LibCanTp_FlowCtrlSts_t {
 
 	// ----------------------------------------------------------------------------------------------------------------
 	/// \brief Minimal time between two sent frames received by last Flow Control frame
+	///
+	/// While receiving: STmin sent by the last Flow Control frame
 	// ----------------------------------------------------------------------------------------------------------------
 	uint8_t				SeparationTimeMinimum;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief While receiving: the next Flow Control frame waits until the reception can continue, N_Br is running
+	// ----------------------------------------------------------------------------------------------------------------
+	bool_t				IsCtsDeferred;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief While receiving: number of WAIT Flow Control frames sent in a row
+	// ----------------------------------------------------------------------------------------------------------------
+	uint8_t				WaitCount;
 } S_LibCanTp_FlowCtrlSts_t;
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -186,7 +236,7 @@ typedef struct S_LibCanTp_Timers_t {
 	///
 	/// This timer is according to ISO 17565-2 N_As (sender role) or N_Ar (receiver role)
 	// ----------------------------------------------------------------------------------------------------------------
-	S_LibTimer_Inst_t 		TransmissionTimer;
+	S_LibHrTimer_Inst_t		TransmissionTimer;
 
 	// ----------------------------------------------------------------------------------------------------------------
 	/// \brief Timer to monitor the timings of FlowControl messages
@@ -195,7 +245,7 @@ typedef struct S_LibCanTp_Timers_t {
 	///
 	/// This timer is according to ISO 17565-2 N_Bs (sender role) or N_Br (receiver role)
 	// ----------------------------------------------------------------------------------------------------------------
-	S_LibTimer_Inst_t		FlowControlTimer;
+	S_LibHrTimer_Inst_t		FlowControlTimer;
 
 	// --------------------------------------------------------------------------------------------------------------------
 	/// \brief 
@@ -209,24 +259,146 @@ typedef struct S_LibCanTp_Timers_t {
 	///
 	/// This timer is according to ISO 17565-2 N_Cs (sender role) or N_Cr (receiver role)
 	// ----------------------------------------------------------------------------------------------------------------
-	S_LibTimer_Inst_t		ConsecutiveTimer;
+	S_LibHrTimer_Inst_t		ConsecutiveTimer;
 
 	// ----------------------------------------------------------------------------------------------------------------
-	/// \brief Timer to monitor the timings of Send ConsecutiveFrame messages
-	///
-	/// 
+	/// \brief Timer to delay the sending of the next ConsecutiveFrame by the STmin of the last FlowControl frame
 	///
-	/// 
+	/// This timer runs with microsecond resolution, so the STmin values 0xF1 - 0xF9 (100us - 900us) are honored.
 	// ----------------------------------------------------------------------------------------------------------------
-	S_LibTimer_Inst_t		SeparationTimeMinTimer;
+	S_LibHrTimer_Inst_t		SeparationTimeMinTimer;
 } S_LibCanTp_Timers_t;
 
+#if (LIBCANTPCFG_TX_BURST_FRAMES > 0U)
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Interrupt paced transmission of ConsecutiveFrames
+///
+/// \sa LIBCANTPCFG_TX_BURST_FRAMES
+// --------------------------------------------------------------------------------------------------------------------
+typedef struct S_LibCanTp_TxBurst_t {
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief ConsecutiveFrames segmented by the service and not yet written into a transmit mailbox
+	// ----------------------------------------------------------------------------------------------------------------
+	S_LibFifoQueue_Inst_t* const	pFifo;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Number of frames in transmit mailboxes which are not completed yet
+	// ----------------------------------------------------------------------------------------------------------------
+	uint32_t						InFlight;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief The next frame waits for the SeparationTimeMinTimer
+	// ----------------------------------------------------------------------------------------------------------------
+	bool_t							IsStMinWait;
+} S_LibCanTp_TxBurst_t;
+#endif // (LIBCANTPCFG_TX_BURST_FRAMES > 0U)
+
+#if (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Receive segment provided by the upper layer
+// --------------------------------------------------------------------------------------------------------------------
+typedef struct S_LibCanTp_RxSegment_t {
+	uint8_t*	pData;	//!< Start of the segment
+	uint32_t	Size;	//!< Size of the segment in bytes
+} S_LibCanTp_RxSegment_t;
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Streaming reception into the segments of the upper layer
+///
+/// \sa LIBCANTPCFG_RX_STREAM_SEGMENTS
+// --------------------------------------------------------------------------------------------------------------------
+typedef struct S_LibCanTp_RxStreamSts_t {
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Registered upper layer, NULL if the connection receives into its buffer only
+	// ----------------------------------------------------------------------------------------------------------------
+	const S_LibCanTp_RxStream_t*	pStream;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Segments provided by the upper layer and not filled yet (S_LibCanTp_RxSegment_t)
+	// ----------------------------------------------------------------------------------------------------------------
+	S_LibFifoQueue_Inst_t* const	pFifo;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Free bytes in the current and the queued segments, increased by LibCanTp_RxStreamProvide()
+	// ----------------------------------------------------------------------------------------------------------------
+	uint32_t						FreeBytes;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Segment which is filled currently, pData is NULL if none is taken from the queue
+	// ----------------------------------------------------------------------------------------------------------------
+	S_LibCanTp_RxSegment_t			Segment;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Number of bytes in the current segment
+	// ----------------------------------------------------------------------------------------------------------------
+	uint32_t						SegmentIdx;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief The current reception is streamed to the upper layer
+	// ----------------------------------------------------------------------------------------------------------------
+	bool_t							IsActive;
+} S_LibCanTp_RxStreamSts_t;
+#endif // (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+
 typedef struct S_LibCanTp_Inst_t {
 	// ----------------------------------------------------------------------------------------------------------------
 	/// \brief Driver Device ID for which the Instance is running
 	// ----------------------------------------------------------------------------------------------------------------
 	const E_LibDrv_DevId_t 			DevId;
 
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Index of the instance in the instance table, passed to DiagCom as connection identifier
+	// ----------------------------------------------------------------------------------------------------------------
+	const uint8_t					Idx;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief CAN identifier of the frames received by this connection
+	// ----------------------------------------------------------------------------------------------------------------
+	const uint32_t					RxId;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief CAN identifier of the frames sent by this connection
+	// ----------------------------------------------------------------------------------------------------------------
+	const uint32_t					TxId;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief The connection uses physical addressing (otherwise functional addressing)
+	// ----------------------------------------------------------------------------------------------------------------
+	const bool_t					IsPhysical;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief The connection sends CAN FD frames (ISO 15765-2:2016), otherwise classic CAN frames
+	// ----------------------------------------------------------------------------------------------------------------
+	const bool_t					IsCanFd;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Data length of the sent CAN frames (TX_DL): 8 for classic CAN, LIBCANTPCFG_CANFD_TX_DL for CAN FD
+	// ----------------------------------------------------------------------------------------------------------------
+	const uint8_t					TxDl;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief A received message waits for DiagCom, which is busy with the request of another connection
+	// ----------------------------------------------------------------------------------------------------------------
+	bool_t							IsIndicationPending;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief The received message is processed by DiagCom, the buffer must not be overwritten by a new reception
+	// ----------------------------------------------------------------------------------------------------------------
+	bool_t							IsIndicated;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief A sent frame of this connection waits for its confirmation
+	// ----------------------------------------------------------------------------------------------------------------
+	bool_t							IsTxConfPending;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Sequence number of the frame waiting for confirmation
+	///
+	/// Connections may share the same transmit CAN identifier (e.g. physical and functional connection of a tester), a
+	/// confirmation is routed to the connection with the oldest frame, as frames are confirmed in the sending order.
+	// ----------------------------------------------------------------------------------------------------------------
+	uint32_t						TxConfSeq;
+
 	// ----------------------------------------------------------------------------------------------------------------
 	/// \brief Flow control configuration which is sent by the AMP
 	// ----------------------------------------------------------------------------------------------------------------
@@ -254,10 +426,44 @@ typedef struct S_LibCanTp_Inst_t {
 	// ----------------------------------------------------------------------------------------------------------------
 	S_LibFsm_t						Fsm;
 
+#ifdef LIBFSMCFG_TRACE
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Time in state statistics of Fsm, the FSMs of the instances are copies of one template and would share
+	/// the statistics of the template otherwise
+	// ----------------------------------------------------------------------------------------------------------------
+	S_LibFsm_StateStats_t			FsmStateStats[LIBCANTP_FSM_STATE_NUM];
+#endif // LIBFSMCFG_TRACE
+
 	// ----------------------------------------------------------------------------------------------------------------
 	/// \brief Instances of timers for this Transport Protocol instance
 	// ----------------------------------------------------------------------------------------------------------------
 	S_LibCanTp_Timers_t				Timers;
+
+#if (LIBCANTPCFG_TX_BURST_FRAMES > 0U)
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Interrupt paced transmission of the ConsecutiveFrames
+	// ----------------------------------------------------------------------------------------------------------------
+	S_LibCanTp_TxBurst_t			TxBurst;
+#endif // (LIBCANTPCFG_TX_BURST_FRAMES > 0U)
+
+#if (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Streaming reception into the segments of the upper layer
+	// ----------------------------------------------------------------------------------------------------------------
+	S_LibCanTp_RxStreamSts_t		RxStream;
+#endif // (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+
+#if (LIBCANTPCFG_FC_PARAM_WFTMAX > 0U)
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief FirstFrame received while the buffer was held by DiagCom, answered by WAIT until the buffer is released
+	// ----------------------------------------------------------------------------------------------------------------
+	S_LibCan_Msg_t					HeldFirstFrame;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief HeldFirstFrame is valid
+	// ----------------------------------------------------------------------------------------------------------------
+	bool_t							IsFirstFrameHeld;
+#endif // (LIBCANTPCFG_FC_PARAM_WFTMAX > 0U)
 } S_LibCanTp_Inst_t;
 
 
@@ -267,33 +473,288 @@ typedef struct S_LibCanTp_Inst_t {
 //	Imported Variables
 // --------------------------------------------------------------------------------------------------------------------
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Table of all CanTP instances (connections), indexed by S_LibCanTp_Inst_t::Idx
+// --------------------------------------------------------------------------------------------------------------------
+extern S_LibCanTp_Inst_t* const LibCanTp_Inst_Table[];
 
 // --------------------------------------------------------------------------------------------------------------------
 //	Global Function Prototypes
 // --------------------------------------------------------------------------------------------------------------------
 
-void LibCanTpInt_ParseAddrRx(const S_LibCan_Msg_t* pMsg, 
-							 uint8_t* pSrc, 
-							 uint8_t* pTgt, 
+void LibCanTpInt_ParseAddrRx(const S_LibCanTp_Inst_t* pInst,
+							 const S_LibCan_Msg_t* pMsg,
+							 uint8_t* pSrc,
+							 uint8_t* pTgt,
 							 bool_t* const pIsPhysical);
 
 
-void LibCanTpInt_ParseAddrTx(S_LibCan_Msg_t* pMsg, 
-							 const uint8_t src, 
-							 const uint8_t tgt, 
+void LibCanTpInt_ParseAddrTx(const S_LibCanTp_Inst_t* pInst,
+							 S_LibCan_Msg_t* pMsg,
+							 const uint8_t src,
+							 const uint8_t tgt,
 							 const bool_t isPhysical);
 
 extern E_LibCanTp_FrameType_t LibCanTpInt_ParseFrameTypeRx(const S_LibCan_Msg_t* pMsg);
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Decode the STmin parameter of a FlowControl frame (ISO 15765-2 9.6.5.5)
+///
+/// \param sepTimeMin
+/// STmin as received: 0x00 - 0x7F in milliseconds, 0xF1 - 0xF9 in 100 microseconds, all other values are reserved
+/// and are handled as the longest STmin (127ms) as required by ISO 15765-2 9.6.5.6.
+/// \return
+/// The separation time in microseconds
+// --------------------------------------------------------------------------------------------------------------------
+extern uint32_t LibCanTpInt_DecodeSepTimeMin_us(const uint8_t sepTimeMin);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Encode a separation time into the STmin parameter of a FlowControl frame (ISO 15765-2 9.6.5.5)
+///
+/// \param sepTimeMin_us
+/// Separation time in microseconds, rounded up to the next value which can be encoded (at most 127ms)
+/// \return
+/// STmin to be sent
+// --------------------------------------------------------------------------------------------------------------------
+extern uint8_t LibCanTpInt_EncodeSepTimeMin(const uint32_t sepTimeMin_us);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Send a FlowControl frame
+///
+/// \param pInst
+/// Connection which sends the frame
+/// \param flowStatus
+/// FlowStatus (CTS, WAIT or OVFLW)
+/// \param blockSize
+/// BS parameter
+/// \param sepTimeMin
+/// STmin parameter (encoded)
+/// \param src
+/// Source address of the frame
+/// \param tgt
+/// Target address of the frame
+/// \param isPhysical
+/// Physical or functional addressing
+// --------------------------------------------------------------------------------------------------------------------
+extern void LibCanTpInt_SendFlowControl(S_LibCanTp_Inst_t* pInst,
+										const E_LibCanTp_FlowStatus_t flowStatus,
+										const uint8_t blockSize,
+										const uint8_t sepTimeMin,
+										const uint8_t src,
+										const uint8_t tgt,
+										const bool_t isPhysical);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Segment the next ConsecutiveFrame of the message to be sent
+///
+/// Advances the sequence number and the read index of the data unit of the connection.
+///
+/// \param pInst
+/// Connection which sends the message
+/// \param pCanMsg
+/// Frame which is set up (identifier, PCI, data and length)
+// --------------------------------------------------------------------------------------------------------------------
+extern void LibCanTpInt_SegmentConsecutiveFrame(S_LibCanTp_Inst_t* pInst, S_LibCan_Msg_t* pCanMsg);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Set the length of a frame to be sent
+///
+/// Above 8 bytes the length is rounded up to the next CAN FD data size and the added bytes are padded with
+/// LIBCANTPCFG_FRAMEPADDING (mandatory for CAN FD).
+///
+/// \param pCanMsg
+/// Frame to be sent
+/// \param dataLength
+/// Number of used data bytes including the PCI
+// --------------------------------------------------------------------------------------------------------------------
+extern void LibCanTpInt_SetFrameLength(S_LibCan_Msg_t* pCanMsg, const uint8_t dataLength);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Pad a frame to be sent to LIBCANTPCFG_FRAMELENGTH with LIBCANTPCFG_FRAMEPADDING
+///
+/// \param pCanMsg
+/// Frame to be sent
+// --------------------------------------------------------------------------------------------------------------------
+extern void LibCanTpInt_PadFrame(S_LibCan_Msg_t* pCanMsg);
+
 
 extern void LibCanTp_HandleSingleFrame(S_LibCanTp_Inst_t* pInst);
 extern void LibCanTp_HandleFirstFrame(S_LibCanTp_Inst_t* pInst);
 extern void LibCanTp_HandleConsecutiveFrame(S_LibCanTp_Inst_t* pInst);
 extern void LibCanTp_HandleFlowControl(S_LibCanTp_Inst_t* pInst);
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Send a FlowControl ContinueToSend frame for the next block of the message being received
+///
+/// The BS is limited to the free space of a streaming reception and, with LIBCANTPCFG_FC_ADAPTIVE, BS and STmin are
+/// adapted to the receive load. If not even one ConsecutiveFrame can be received the FlowControl is deferred: it is
+/// retried on LIBCANTP_SRV_EV_FC_RETRY and replaced by a WAIT whenever N_Br elapses.
+///
+/// \param pInst
+/// Connection which receives a segmented message
+// --------------------------------------------------------------------------------------------------------------------
+extern void LibCanTpInt_SendFlowControlCts(S_LibCanTp_Inst_t* pInst);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Continue a deferred FlowControl of a connection
+///
+/// Sends the ContinueToSend if the reception can continue now (a held FirstFrame is handled). Otherwise, if N_Br
+/// elapsed, a WAIT is sent, or the reception is given up after LIBCANTPCFG_FC_PARAM_WFTMAX WAITs.
+///
+/// \param pInst
+/// Connection with a deferred FlowControl
+/// \param isWaitTime
+/// N_Br elapsed
+// --------------------------------------------------------------------------------------------------------------------
+extern void LibCanTpInt_HandleFcDeferred(S_LibCanTp_Inst_t* pInst, const bool_t isWaitTime);
+
+#if (LIBCANTPCFG_FC_PARAM_WFTMAX > 0U)
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Keep a FirstFrame which arrived while the buffer of the connection is held by DiagCom
+///
+/// The FirstFrame is handled when the buffer is released, meanwhile the sender is held by WAIT frames. A held
+/// FirstFrame is dropped when the connection starts to send or WFTmax is reached.
+///
+/// \param pInst
+/// Connection which received the FirstFrame
+/// \param pFrame
+/// The FirstFrame
+// --------------------------------------------------------------------------------------------------------------------
+extern void LibCanTpInt_HoldFirstFrame(S_LibCanTp_Inst_t* pInst, const S_LibCan_Msg_t* pFrame);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Drop the held FirstFrame of a connection, its sender gets a FlowControl OVFLW
+///
+/// \param pInst
+/// Connection which holds the FirstFrame
+// --------------------------------------------------------------------------------------------------------------------
+extern void LibCanTpInt_DropHeldFirstFrame(S_LibCanTp_Inst_t* pInst);
+#endif // (LIBCANTPCFG_FC_PARAM_WFTMAX > 0U)
+
+#if (LIBCANTPCFG_FC_ADAPTIVE > 0)
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Get the current receive load of a connection
+///
+/// The frames which the other receiving connections may send within the service latency are reserved for them.
+///
+/// \param pInst
+/// Connection which sends the next ContinueToSend
+/// \param pFreeFrames
+/// Number of frames which may still be queued for the CanTP service by the connection
+/// \param pLatency_us
+/// Latency of the CanTP service: time a received frame waits for the service (peak with slow decay)
+// --------------------------------------------------------------------------------------------------------------------
+extern void LibCanTp_GetRxLoad(const S_LibCanTp_Inst_t* pInst, uint32_t* pFreeFrames, uint32_t* pLatency_us);
+#endif // (LIBCANTPCFG_FC_ADAPTIVE > 0)
+
 extern Ret_t LibCanTp_HandleTxMessage(S_LibCanTp_Inst_t* pInst);
 extern void LibCanTp_HandleFlowCtrlStsBlockSize(S_LibCanTp_Inst_t* pInst);
 
+#if (LIBCANTPCFG_TX_BURST_FRAMES > 0U)
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Segment the ConsecutiveFrames of a connection ahead and start their transmission
+///
+/// Segments CFs until the queue of the connection is full, the block (BS) is complete or the message is segmented
+/// completely. The queued CFs are written into the free transmit mailboxes, further CFs follow from the transmit
+/// complete interrupt.
+///
+/// \param pInst
+/// Connection which sends a segmented message
+// --------------------------------------------------------------------------------------------------------------------
+extern void LibCanTp_TxBurstFill(S_LibCanTp_Inst_t* pInst);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Write the queued ConsecutiveFrames of the connections on a device into the free transmit mailboxes
+///
+/// \note This function may be called from interrupt context (transmit complete interrupt, timer callbacks)
+///
+/// \param devId
+/// The Device Driver Identifier
+// --------------------------------------------------------------------------------------------------------------------
+extern void LibCanTp_TxBurstRelease(const E_LibDrv_DevId_t devId);
+#endif // (LIBCANTPCFG_TX_BURST_FRAMES > 0U)
+
+#if (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Offer a received FirstFrame to the registered upper layer of the streaming reception
+///
+/// \param pInst
+/// Connection which received the FirstFrame
+/// \param msgLength
+/// Length of the message (FF_DL)
+/// \param pData
+/// Payload of the FirstFrame
+/// \param dataLength
+/// Number of payload bytes in the FirstFrame
+/// \return
+/// LIBRET_OK if the message is streamed and the payload is copied, LIBRET_NOT_SUPPORTED if the message is received
+/// into the connection buffer, LIBRET_BUFF_ERR if the upper layer took the message without providing a segment
+// --------------------------------------------------------------------------------------------------------------------
+extern Ret_t LibCanTp_RxStreamStart(S_LibCanTp_Inst_t* pInst, const uint32_t msgLength, const uint8_t* pData,
+									const uint32_t dataLength);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Copy received payload into the segments of a streaming reception, filled segments are handed over
+///
+/// \return
+/// false if the provided segments are too small
+// --------------------------------------------------------------------------------------------------------------------
+extern bool_t LibCanTp_RxStreamCopy(S_LibCanTp_Inst_t* pInst, const uint8_t* pData, const uint32_t dataLength);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief End a streaming reception and release the segments which were not handed over
+///
+/// \param pInst
+/// Connection which received the message
+/// \param result
+/// LIBRET_OK if the message is complete (the partially filled segment is handed over), otherwise aborted
+// --------------------------------------------------------------------------------------------------------------------
+extern void LibCanTp_RxStreamEnd(S_LibCanTp_Inst_t* pInst, const Ret_t result);
+#endif // (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Request the sending of the next frame of a connection by the CanTP service
+///
+/// \note This function may be called from interrupt context (timer callbacks)
+///
+/// \param pInst
+/// Connection which shall send its next frame
+// --------------------------------------------------------------------------------------------------------------------
+extern void LibCanTp_RequestSend(S_LibCanTp_Inst_t* pInst);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Request the reinitialization of a connection by the CanTP service, the other connections are not affected
+///
+/// \note This function may be called from interrupt context (timer callbacks)
+///
+/// \param pInst
+/// Connection which is aborted
+// --------------------------------------------------------------------------------------------------------------------
+extern void LibCanTp_RequestAbort(S_LibCanTp_Inst_t* pInst);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Request the continuation of a deferred FlowControl of a connection by the CanTP service
+///
+/// \note This function may be called from interrupt context (timer callbacks)
+///
+/// \param pInst
+/// Connection with a deferred FlowControl
+/// \param isWaitTime
+/// N_Br elapsed (LIBCANTP_SRV_EV_FC_WAIT), otherwise the reception may be able to continue (LIBCANTP_SRV_EV_FC_RETRY)
+// --------------------------------------------------------------------------------------------------------------------
+extern void LibCanTp_RequestFcDeferred(S_LibCanTp_Inst_t* pInst, const bool_t isWaitTime);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Hand a completely received message over to DiagCom
+///
+/// If DiagCom is still busy with the request of another connection the message is kept in the buffer of the connection
+/// and handed over on LIBCANTP_SRV_EV_DIAGCOM_READY.
+///
+/// \param pInst
+/// Connection which received the message
+// --------------------------------------------------------------------------------------------------------------------
+extern void LibCanTp_IndicateMsg(S_LibCanTp_Inst_t* pInst);
+
 extern void LibCanTp_TransmissionTimerTimeout(void* pData);
 extern void LibCanTp_FlowControlTimerTimeout(void* pData);
 extern void LibCanTp_ConsecutiveTimerTimeout(void* pData);
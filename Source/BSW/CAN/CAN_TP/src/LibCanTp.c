@@ -39,6 +39,10 @@
 //	Asserts for not yet implemented features
 // --------------------------------------------------------------------------------------------------------------------
 
+#if (LIBCANTPCFG_CANFD_TX_DL > LIBCAN_MAXDATABYTENUM) || (LIBCANTPCFG_CANFD_TX_DL < 8)
+#error "LIBCANTPCFG_CANFD_TX_DL must be a CAN FD data size between 8 and LIBCAN_MAXDATABYTENUM"
+#endif
+
 // Checks for features that are not implemented yet
 //Lib_AssertStatic(LIBCANTPCFG_FC_PARAM_BS == 0U);
 //Lib_AssertStatic(LIBCANTPCFG_FC_PARAM_WFTMAX == 0U);
@@ -59,30 +63,78 @@
 // --------------------------------------------------------------------------------------------------------------------
 #define LIBCANTP_DECL_CAN_MESSAGE(name, ...) static S_LibCan_Msg_t LibCanTp_CanMsg_##name;
 
+#if (LIBCANTPCFG_TX_BURST_FRAMES > 0U)
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Declare the local queue of segmented ConsecutiveFrames (used by the CanTp_Inst)
+///
+/// The queue is shared between the service (producer) and the transmit complete interrupt (consumer).
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBCANTP_DECL_TX_BURST(name, ...)                                                                                    \
+	static S_LibCan_Msg_t LibCanTp_TxBurstBuffer_##name[LIBCANTPCFG_TX_BURST_FRAMES];                                        \
+	static LIBFIFO_DEFINE_SHARED_INST(LibCanTp_TxBurstFifo_##name, (uint32_t *)(void *)LibCanTp_TxBurstBuffer_##name,        \
+									  sizeof(S_LibCan_Msg_t), (uint32_t)LIBCANTPCFG_TX_BURST_FRAMES, false);
+
+#define LIBCANTP_INIT_TX_BURST(name)                                                                                         \
+	.TxBurst = {.pFifo = &LibCanTp_TxBurstFifo_##name, .InFlight = 0U, .IsStMinWait = false},
+#else
+#define LIBCANTP_DECL_TX_BURST(name, ...)
+#define LIBCANTP_INIT_TX_BURST(name)
+#endif // (LIBCANTPCFG_TX_BURST_FRAMES > 0U)
+
+#if (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Declare the local queue of provided receive segments (used by the CanTp_Inst)
+///
+/// The queue is shared between the upper layer (producer) and the service (consumer).
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBCANTP_DECL_RX_STREAM(name, ...)                                                                                   \
+	static S_LibCanTp_RxSegment_t LibCanTp_RxSegmentBuffer_##name[LIBCANTPCFG_RX_STREAM_SEGMENTS];                           \
+	static LIBFIFO_DEFINE_SHARED_INST(LibCanTp_RxSegmentFifo_##name, (uint32_t *)(void *)LibCanTp_RxSegmentBuffer_##name,    \
+									  sizeof(S_LibCanTp_RxSegment_t), (uint32_t)LIBCANTPCFG_RX_STREAM_SEGMENTS, false);
+
+#define LIBCANTP_INIT_RX_STREAM(name)                                                                                        \
+	.RxStream = {.pStream = NULL, .pFifo = &LibCanTp_RxSegmentFifo_##name, .FreeBytes = 0U},
+#else
+#define LIBCANTP_DECL_RX_STREAM(name, ...)
+#define LIBCANTP_INIT_RX_STREAM(name)
+#endif // (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief Declare the CanTP instance
 // --------------------------------------------------------------------------------------------------------------------
-#define LIBCANTP_DECL_INSTANCE(name, devid)                                                                                  \
+#define LIBCANTP_DECL_INSTANCE(name, devid, rxId, txId, isPhysical, isCanFd)                                                 \
 	LIBCANTP_DECL_CAN_MESSAGE(name, devid)                                                                                   \
 																												             \
 	LIBCANTP_DECL_DATA_UNIT(name, devid)                                                                                     \
 																												             \
+	LIBCANTP_DECL_TX_BURST(name, devid)                                                                                      \
+																												             \
+	LIBCANTP_DECL_RX_STREAM(name, devid)                                                                                     \
+																												             \
 	static S_LibCanTp_Inst_t LibCanTp_Inst_##name = {                                                                        \
 		.DevId = devid,                                                                                                      \
+		.Idx = (uint8_t)LIBCANTP_INST_##name,                                                                                \
+		.RxId = (rxId),                                                                                                      \
+		.TxId = (txId),                                                                                                      \
+		.IsPhysical = (isPhysical),                                                                                          \
+		.IsCanFd = (isCanFd),                                                                                                \
+		.TxDl = (isCanFd) ? (uint8_t)LIBCANTPCFG_CANFD_TX_DL : (uint8_t)LIBCANTPCFG_FRAMELENGTH,                              \
 		.FlowCtrlCfg =                                                                                                       \
 			{                                                                                                                \
 				.BlockSize  = LIBCANTPCFG_FC_PARAM_BS,                                                                       \
 				.SepTimeMin = LIBCANTPCFG_FC_PARAM_STMIN,                                                                    \
 			},                                                                                                               \
-		.FlowCtrlSts = {0U, 0U, 0U, 0U},                                                                                     \
+		.FlowCtrlSts = {0U, 0U, 0U, 0U, false, 0U},                                                                          \
 		.pDataUnit   = &LibCanTp_DataUnit_##name,                                                                            \
 		.pCanMsg     = &LibCanTp_CanMsg_##name,                                                                              \
 		.Timers = {																									         \
-			.TransmissionTimer = LIBTIMER_INIT_TIMER(LibCanTp_TransmissionTimerTimeout, &LibCanTp_Inst_##name), 	         \
-			.FlowControlTimer  = LIBTIMER_INIT_TIMER(LibCanTp_FlowControlTimerTimeout, &LibCanTp_Inst_##name),  	         \
-			.ConsecutiveTimer  = LIBTIMER_INIT_TIMER(LibCanTp_ConsecutiveTimerTimeout, &LibCanTp_Inst_##name), 		         \
-			.SeparationTimeMinTimer  = LIBTIMER_INIT_TIMER(LibCanTp_SeparationTimeMinTimerTimeout, &LibCanTp_Inst_##name)    \
-		} 																											         \
+			.TransmissionTimer = LIBHRTIMER_INIT_TIMER(LibCanTp_TransmissionTimerTimeout, &LibCanTp_Inst_##name),            \
+			.FlowControlTimer  = LIBHRTIMER_INIT_TIMER(LibCanTp_FlowControlTimerTimeout, &LibCanTp_Inst_##name),             \
+			.ConsecutiveTimer  = LIBHRTIMER_INIT_TIMER(LibCanTp_ConsecutiveTimerTimeout, &LibCanTp_Inst_##name),             \
+			.SeparationTimeMinTimer  = LIBHRTIMER_INIT_TIMER(LibCanTp_SeparationTimeMinTimerTimeout, &LibCanTp_Inst_##name)  \
+		},                                                                                                                   \
+		LIBCANTP_INIT_TX_BURST(name)                                                                                         \
+		LIBCANTP_INIT_RX_STREAM(name)                                                                                        \
 	};
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -141,6 +193,58 @@ static void LibCanTp_HandleRxFrame(const S_LibCanTp_MsgIndBufferEntry_t *pBufEnt
 // --------------------------------------------------------------------------------------------------------------------
 static void LibCanTp_HandleConfirm(const uint32_t msgId);
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Select the connection a received CAN frame belongs to
+///
+/// \param pMsg
+/// The received CAN frame
+/// \return
+/// The connection with matching device and receive identifier or NULL if there is none
+// --------------------------------------------------------------------------------------------------------------------
+static S_LibCanTp_Inst_t* LibCanTp_GetRxInst(const S_LibCan_Msg_t* pMsg);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Select the connection a confirmation belongs to
+///
+/// \param msgId
+/// CAN ID of the confirmed frame
+/// \return
+/// The connection with the oldest unconfirmed frame sent with this identifier or NULL if there is none
+// --------------------------------------------------------------------------------------------------------------------
+static S_LibCanTp_Inst_t* LibCanTp_GetConfirmInst(const uint32_t msgId);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief DiagCom is ready again: release the connections and hand over the next waiting message
+// --------------------------------------------------------------------------------------------------------------------
+static void LibCanTp_HandleDiagComReady(void);
+
+#if (LIBCANTPCFG_FC_ADAPTIVE > 0)
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Measure the latency of the service for the frames waiting in the indication queue
+// --------------------------------------------------------------------------------------------------------------------
+static void LibCanTp_UpdateRxLatency(void);
+#endif // (LIBCANTPCFG_FC_ADAPTIVE > 0)
+
+#if (LIBCANTPCFG_TX_BURST_FRAMES > 0U)
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Write the queued ConsecutiveFrames into the free transmit mailboxes, alternating between the connections
+///
+/// \param devMask
+/// Devices whose mailboxes are refilled, bit n stands for the device with the ID n
+// --------------------------------------------------------------------------------------------------------------------
+static void LibCanTp_TxBurstWrite(const uint32_t devMask);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Completion of a ConsecutiveFrame written by LibCanTp_TxBurstWrite (transmit complete interrupt)
+///
+/// \param pData
+/// Connection which sent the frame
+/// \param isSent
+/// true if the frame was transmitted, otherwise the connection is aborted by the expiring N_As timer
+// --------------------------------------------------------------------------------------------------------------------
+static void LibCanTp_TxBurstConfirm(void *pData, bool_t isSent);
+#endif // (LIBCANTPCFG_TX_BURST_FRAMES > 0U)
+
 // --------------------------------------------------------------------------------------------------------------------
 //	Global Variables
 // --------------------------------------------------------------------------------------------------------------------
@@ -183,7 +287,71 @@ static S_LibCanTp_MsgConBufferEntry_t LibCanTp_MsgConBuffer[LIBCANTP_MSG_CON_FIF
 
 LIBCANTPCFG_INSTANCES(LIBCANTP_DECL_INSTANCE)
 
-S_LibCanTp_Inst_t *LibCanTp_Inst_Table[] = {LIBCANTPCFG_INSTANCES(LIBCANTP_EXPAND_TABLE)};
+S_LibCanTp_Inst_t* const LibCanTp_Inst_Table[LIBCANTP_INST_COUNT] = {LIBCANTPCFG_INSTANCES(LIBCANTP_EXPAND_TABLE)};
+
+// --------------------------------------------------------------------------------------------------------------------
+///	\brief Connections with a pending send request, bit n stands for LibCanTp_Inst_Table[n]
+///
+/// Set from task and timer interrupt context, consumed by the service on LIBCANTP_SRV_EV_REQ.
+// --------------------------------------------------------------------------------------------------------------------
+static uint32_t LibCanTp_SendPendingMask = 0U;
+
+// --------------------------------------------------------------------------------------------------------------------
+///	\brief Connections with a pending abort (reinitialization), bit n stands for LibCanTp_Inst_Table[n]
+///
+/// Set from task and timer interrupt context, consumed by the service on LIBCANTP_SRV_EV_ABORT.
+// --------------------------------------------------------------------------------------------------------------------
+static uint32_t LibCanTp_AbortPendingMask = 0U;
+
+// --------------------------------------------------------------------------------------------------------------------
+///	\brief Sequence number of the next sent frame, used to route confirmations to the oldest waiting connection
+// --------------------------------------------------------------------------------------------------------------------
+static uint32_t LibCanTp_TxSeq = 0U;
+
+// --------------------------------------------------------------------------------------------------------------------
+///	\brief Connections whose deferred FlowControl may be sent now, bit n stands for LibCanTp_Inst_Table[n]
+///
+/// Set from any task, consumed by the service on LIBCANTP_SRV_EV_FC_RETRY.
+// --------------------------------------------------------------------------------------------------------------------
+static uint32_t LibCanTp_FcRetryPendingMask = 0U;
+
+// --------------------------------------------------------------------------------------------------------------------
+///	\brief Connections whose deferred FlowControl reached N_Br, bit n stands for LibCanTp_Inst_Table[n]
+///
+/// Set from timer interrupt context, consumed by the service on LIBCANTP_SRV_EV_FC_WAIT.
+// --------------------------------------------------------------------------------------------------------------------
+static uint32_t LibCanTp_FcWaitPendingMask = 0U;
+
+#if (LIBCANTPCFG_FC_ADAPTIVE > 0)
+// --------------------------------------------------------------------------------------------------------------------
+///	\brief Time at which the oldest frame waiting in LibCanTp_MsgIndFifo was received
+// --------------------------------------------------------------------------------------------------------------------
+static uint32_t LibCanTp_RxIndTime_us = 0U;
+
+// --------------------------------------------------------------------------------------------------------------------
+///	\brief Latency of the service for received frames, follows a rise at once and a fall slowly
+// --------------------------------------------------------------------------------------------------------------------
+static uint32_t LibCanTp_RxLatency_us = 0U;
+
+// --------------------------------------------------------------------------------------------------------------------
+///	\brief Frames of LibCanTp_MsgIndFifo which are handled but not removed yet (the burst is removed at once)
+// --------------------------------------------------------------------------------------------------------------------
+static uint32_t LibCanTp_RxFramesHandled = 0U;
+#endif // (LIBCANTPCFG_FC_ADAPTIVE > 0)
+
+#if (LIBCANTPCFG_TX_BURST_FRAMES > 0U)
+// --------------------------------------------------------------------------------------------------------------------
+///	\brief Devices whose transmit mailboxes shall be refilled, bit n stands for the device with the ID n
+// --------------------------------------------------------------------------------------------------------------------
+static uint32_t LibCanTp_TxBurstPendingDevMask = 0U;
+
+// --------------------------------------------------------------------------------------------------------------------
+///	\brief Lock of the mailbox refill, which runs in task and interrupt context
+///
+/// A context which does not get the lock only marks its device as pending, the holder of the lock repeats the refill.
+// --------------------------------------------------------------------------------------------------------------------
+static uint32_t LibCanTp_TxBurstLock = 0U;
+#endif // (LIBCANTPCFG_TX_BURST_FRAMES > 0U)
 
 // --------------------------------------------------------------------------------------------------------------------
 ///	\brief Settings for the FIFO
@@ -206,12 +374,25 @@ LIBFIFO_DEFINE_INST(LibCanTp_MsgConFifo, (uint32_t *)(void *)LibCanTp_MsgConBuff
 //=====================================================================================================================
 void LibCanTp_MsgIndicate(S_LibCan_Msg_t *pMsg)
 {
-	const S_LibCanTp_BufferEntry_t bufEntry =  *pMsg;
-	Ret_t pushed = LibFifoQueue_Push(&LibCanTp_MsgIndFifo, (void *)&bufEntry);
-	if (!pushed)
+	S_LibCanTp_MsgIndBufferEntry_t *pBufEntry =
+		(S_LibCanTp_MsgIndBufferEntry_t *)LibFifoQueue_Reserve(&LibCanTp_MsgIndFifo);
+	if (NULL != pBufEntry)
 	{
+		*pBufEntry = *pMsg;
+		LibFifoQueue_Commit(&LibCanTp_MsgIndFifo);
+#if (LIBCANTPCFG_FC_ADAPTIVE > 0)
+		if (1U == LibFifoQueue_GetCount(&LibCanTp_MsgIndFifo))
+		{
+			// the service latency is measured from the first frame of a burst
+			LibAtomic_Store(&LibCanTp_RxIndTime_us, LibHrTimer_GetTime_us());
+		}
+#endif
+	}
+	else
+	{
+		// drop only the new frame: a lost consecutive frame is detected by its sequence number and aborts one
+		// connection, clearing the queue would also discard the frames of the other connections
 		LibLog_Warning("CAN:TP push not possible");
-		LibFifoQueue_Clear(&LibCanTp_MsgIndFifo);
 	}
 
 	(void)LibService_SetEvent(&LibCanTp_Service, LIBCANTP_SRV_EV_IND);
@@ -226,35 +407,334 @@ void LibCanTp_MsgConfirm(uint32_t msgId)
 	(void)LibService_SetEvent(&LibCanTp_Service, LIBCANTP_SRV_EV_CON);
 }
 
+#if (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+//=====================================================================================================================
+// LibCanTp_RxStreamRegister:
+//=====================================================================================================================
+Ret_t LibCanTp_RxStreamRegister(const uint8_t connId, const S_LibCanTp_RxStream_t *pStream)
+{
+	Ret_t retVal = LIBRET_INV_PARAM;
+
+	if (connId < LIBCANTP_INST_COUNT)
+	{
+		LibCanTp_Inst_Table[connId]->RxStream.pStream = pStream;
+		retVal = LIBRET_OK;
+	}
+
+	return retVal;
+}
+
+//=====================================================================================================================
+// LibCanTp_RxStreamProvide:
+//=====================================================================================================================
+Ret_t LibCanTp_RxStreamProvide(const uint8_t connId, uint8_t *pSegment, const uint32_t size)
+{
+	Ret_t retVal = LIBRET_INV_PARAM;
+
+	if ((connId < LIBCANTP_INST_COUNT) && (NULL != pSegment) && (0U != size))
+	{
+		S_LibCanTp_Inst_t *pInst = LibCanTp_Inst_Table[connId];
+		const S_LibCanTp_RxSegment_t segment = {.pData = pSegment, .Size = size};
+
+		retVal = LIBRET_BUFF_ERR;
+		if (LibFifoQueue_Push(pInst->RxStream.pFifo, &segment))
+		{
+			(void)LibAtomic_FetchAdd(&pInst->RxStream.FreeBytes, size);
+			LibCanTp_RequestFcDeferred(pInst, false);
+			retVal = LIBRET_OK;
+		}
+	}
+
+	return retVal;
+}
+
+//=====================================================================================================================
+// LibCanTp_RxStreamStart:
+//=====================================================================================================================
+Ret_t LibCanTp_RxStreamStart(S_LibCanTp_Inst_t *pInst, const uint32_t msgLength, const uint8_t *pData,
+							 const uint32_t dataLength)
+{
+	S_LibCanTp_RxStreamSts_t *pSts = &pInst->RxStream;
+	const S_LibCanTp_RxStream_t *pStream = pSts->pStream;
+	Ret_t retVal = LIBRET_NOT_SUPPORTED;
+
+	if ((NULL != pStream) && pStream->StartOfReception(pStream->pUserData, msgLength, pData, dataLength))
+	{
+		pSts->IsActive = true;
+		retVal = LIBRET_OK;
+		if (!LibCanTp_RxStreamCopy(pInst, pData, dataLength))
+		{
+			LibCanTp_RxStreamEnd(pInst, LIBRET_BUFF_ERR);
+			retVal = LIBRET_BUFF_ERR;
+		}
+	}
+
+	return retVal;
+}
+
+//=====================================================================================================================
+// LibCanTp_RxStreamCopy:
+//=====================================================================================================================
+bool_t LibCanTp_RxStreamCopy(S_LibCanTp_Inst_t *pInst, const uint8_t *pData, const uint32_t dataLength)
+{
+	S_LibCanTp_RxStreamSts_t *pSts = &pInst->RxStream;
+	uint32_t dataIdx = 0U;
+	bool_t isCopied = (LibAtomic_Load(&pSts->FreeBytes) >= dataLength);
+
+	while (isCopied && (dataIdx < dataLength))
+	{
+		if (NULL == pSts->Segment.pData)
+		{
+			isCopied = LibFifoQueue_PopCopy(pSts->pFifo, &pSts->Segment);
+			pSts->SegmentIdx = 0U;
+		}
+
+		if (isCopied)
+		{
+			const uint32_t segmentFree = pSts->Segment.Size - pSts->SegmentIdx;
+			const uint32_t copyLength = ((dataLength - dataIdx) < segmentFree) ? (dataLength - dataIdx) : segmentFree;
+
+			memcpy(&pSts->Segment.pData[pSts->SegmentIdx], &pData[dataIdx], copyLength);
+			pSts->SegmentIdx += copyLength;
+			dataIdx += copyLength;
+			(void)LibAtomic_FetchAdd(&pSts->FreeBytes, (uint32_t)(0U - copyLength));
+
+			if (pSts->SegmentIdx == pSts->Segment.Size)
+			{
+				// the upper layer consumes the segment while the next frames arrive
+				pSts->pStream->SegmentReceived(pSts->pStream->pUserData, pSts->Segment.pData, pSts->SegmentIdx);
+				pSts->Segment.pData = NULL;
+			}
+		}
+	}
+
+	return isCopied;
+}
+
+//=====================================================================================================================
+// LibCanTp_RxStreamEnd:
+//=====================================================================================================================
+void LibCanTp_RxStreamEnd(S_LibCanTp_Inst_t *pInst, const Ret_t result)
+{
+	S_LibCanTp_RxStreamSts_t *pSts = &pInst->RxStream;
+	S_LibCanTp_RxSegment_t segment;
+
+	if (NULL != pSts->Segment.pData)
+	{
+		if ((LIBRET_OK == result) && (0U != pSts->SegmentIdx))
+		{
+			pSts->pStream->SegmentReceived(pSts->pStream->pUserData, pSts->Segment.pData, pSts->SegmentIdx);
+		}
+		(void)LibAtomic_FetchAdd(&pSts->FreeBytes, (uint32_t)(0U - (pSts->Segment.Size - pSts->SegmentIdx)));
+		pSts->Segment.pData = NULL;
+	}
+
+	// the remaining segments go back to the upper layer, a segment provided meanwhile stays accounted
+	while (LibFifoQueue_PopCopy(pSts->pFifo, &segment))
+	{
+		(void)LibAtomic_FetchAdd(&pSts->FreeBytes, (uint32_t)(0U - segment.Size));
+	}
+
+	pSts->IsActive = false;
+	pSts->pStream->RxIndication(pSts->pStream->pUserData, result);
+}
+#endif // (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+
+//=====================================================================================================================
+// LibCanTp_TxMailboxFree:
+//=====================================================================================================================
+void LibCanTp_TxMailboxFree(const E_LibDrv_DevId_t devId)
+{
+#if (LIBCANTPCFG_TX_BURST_FRAMES > 0U)
+	LibCanTp_TxBurstRelease(devId);
+#else
+	LIB_UNUSED(devId);
+#endif
+}
+
 //=====================================================================================================================
 // LibCanTp_MsgRequest:
 //=====================================================================================================================
 void LibCanTp_MsgRequest(S_LibDiagCom_Msg_t *pMsg)
 {
+	// the response is sent over the connection which received the request
+	if ((pMsg->ConnId < LIBCANTP_INST_COUNT) && (LibCanTp_Inst_Table[pMsg->ConnId]->DevId == pMsg->DevId)
+	 && (pMsg->PayloadLen <= LIBCANTPCFG_MULTIFRAME_BUFFER_SIZE))
+	{
+		S_LibCanTp_Inst_t *pInst = LibCanTp_Inst_Table[pMsg->ConnId];
+		S_LibCanTp_DataUnit_t *pDataUnit = pInst->pDataUnit;
+		const uint32_t maxSingleFrameLen = (pInst->TxDl > 8U) ? ((uint32_t)pInst->TxDl - 2U) : 7U;
+
+		pDataUnit->SourceAddress       = LIBCANTPCFG_ECU_PHYS_ADDRESS;
+		pDataUnit->TargetAddress       = pMsg->TgtAddr;
+		pDataUnit->IsPhysical          = pMsg->IsPhysical;
+		pDataUnit->Length              = pMsg->PayloadLen;
+		pDataUnit->BufferDataRemaining = pMsg->PayloadLen;
+		pDataUnit->BufferRWIdx         = 0U;
+		pDataUnit->IsFinished          = false;
+		if (pMsg->pPayload == pDataUnit->Buffer)
+		{
+			// response assembled in the lent buffer (LibCanTp_TxBufferLend), segmented in place
+			pDataUnit->pTxData = pDataUnit->Buffer;
+		}
+		else if (pInst->IsIndicated && (pMsg->PayloadLen <= maxSingleFrameLen))
+		{
+			// the buffer still belongs to DiagCom (e.g. ResponsePending while the response is assembled in it)
+			memcpy(pDataUnit->TxSingleFrame, pMsg->pPayload, pMsg->PayloadLen);
+			pDataUnit->pTxData = pDataUnit->TxSingleFrame;
+		}
+		else
+		{
+			memmove(pDataUnit->Buffer, pMsg->pPayload, pMsg->PayloadLen);
+			pDataUnit->pTxData = pDataUnit->Buffer;
+		}
+		LibLog_Debug("CAN:TP MsgRequest Conn [%d] Length [%d]\n", pInst->Idx, pInst->pDataUnit->Length);
+		LibCanTp_RequestSend(pInst);
+
+		// Start timer
+		// LibHrTimer_Start(&pInst->Timers.TransmissionTimer, LIBHRTIMER_MS_TO_US(LIBCANTP_TRANSMISSION_TIMEOUT_MS));
+	}
+	else
+	{
+		LibLog_Warning("CAN:TP MsgRequest for unknown connection [%d] or length [%d]", pMsg->ConnId, pMsg->PayloadLen);
+	}
+}
+
+//=====================================================================================================================
+// LibCanTp_TxBufferLend:
+//=====================================================================================================================
+uint8_t* LibCanTp_TxBufferLend(S_LibDiagCom_Msg_t *pMsg, uint16_t *pMaxLen)
+{
+	uint8_t *pBuffer = NULL;
+
+	if ((pMsg->ConnId < LIBCANTP_INST_COUNT) && (LibCanTp_Inst_Table[pMsg->ConnId]->DevId == pMsg->DevId))
+	{
+		S_LibCanTp_Inst_t *pInst = LibCanTp_Inst_Table[pMsg->ConnId];
+
+		// the buffer belongs to DiagCom from the indication until the response, unless a response is sent from it
+		if (pInst->IsIndicated && !(LibCanTpFsm_IsSend(pInst) && (pInst->pDataUnit->pTxData == pInst->pDataUnit->Buffer)))
+		{
+			pBuffer  = pInst->pDataUnit->Buffer;
+			*pMaxLen = LIBCANTPCFG_MULTIFRAME_BUFFER_SIZE;
+		}
+	}
+	return pBuffer;
+}
+
+//=====================================================================================================================
+// LibCanTp_RequestSend:
+//=====================================================================================================================
+void LibCanTp_RequestSend(S_LibCanTp_Inst_t *pInst)
+{
+	(void)LibAtomic_FetchOr(&LibCanTp_SendPendingMask, UINT32_C(1) << pInst->Idx);
+	LibService_SetEvent(&LibCanTp_Service, LIBCANTP_SRV_EV_REQ);
+}
+
+//=====================================================================================================================
+// LibCanTp_RequestAbort:
+//=====================================================================================================================
+void LibCanTp_RequestAbort(S_LibCanTp_Inst_t *pInst)
+{
+	(void)LibAtomic_FetchOr(&LibCanTp_AbortPendingMask, UINT32_C(1) << pInst->Idx);
+	LibService_SetEvent(&LibCanTp_Service, LIBCANTP_SRV_EV_ABORT);
+}
+
+//=====================================================================================================================
+// LibCanTp_RequestFcDeferred:
+//=====================================================================================================================
+void LibCanTp_RequestFcDeferred(S_LibCanTp_Inst_t *pInst, const bool_t isWaitTime)
+{
+	if (isWaitTime)
+	{
+		(void)LibAtomic_FetchOr(&LibCanTp_FcWaitPendingMask, UINT32_C(1) << pInst->Idx);
+		LibService_SetEvent(&LibCanTp_Service, LIBCANTP_SRV_EV_FC_WAIT);
+	}
+	else
+	{
+		(void)LibAtomic_FetchOr(&LibCanTp_FcRetryPendingMask, UINT32_C(1) << pInst->Idx);
+		LibService_SetEvent(&LibCanTp_Service, LIBCANTP_SRV_EV_FC_RETRY);
+	}
+}
+
+#if (LIBCANTPCFG_FC_ADAPTIVE > 0)
+//=====================================================================================================================
+// LibCanTp_GetRxLoad:
+//=====================================================================================================================
+void LibCanTp_GetRxLoad(const S_LibCanTp_Inst_t *pInst, uint32_t *pFreeFrames, uint32_t *pLatency_us)
+{
+	// the handled frames of the current burst are removed before the sender gets the FlowControl
+	uint32_t queued = LibFifoQueue_GetCount(&LibCanTp_MsgIndFifo) - LibCanTp_RxFramesHandled;
 	uint8_t i;
-	S_LibCanTp_Inst_t *pInst = NULL;
 
-	for (i = 0; i < LIBCANTP_INST_COUNT; i++)
+	for (i = 0U; i < LIBCANTP_INST_COUNT; i++)
 	{
-		pInst = LibCanTp_Inst_Table[i];
-		if (pInst->DevId == pMsg->DevId)
+		S_LibCanTp_Inst_t *pOther = LibCanTp_Inst_Table[i];
+
+		if ((pOther != pInst) && LibCanTpFsm_IsRecv(pOther) && (!pOther->FlowCtrlSts.IsCtsDeferred))
 		{
-			pInst->pDataUnit->SourceAddress       = LIBCANTPCFG_ECU_PHYS_ADDRESS;
-			pInst->pDataUnit->TargetAddress       = pMsg->TgtAddr;
-			pInst->pDataUnit->IsPhysical          = pMsg->IsPhysical;
-			pInst->pDataUnit->Length              = pMsg->PayloadLen;
-			pInst->pDataUnit->BufferDataRemaining = pMsg->PayloadLen;
-			pInst->pDataUnit->BufferRWIdx         = 0U;
-			pInst->pDataUnit->IsFinished          = false;
-			memcpy(pInst->pDataUnit->Buffer, pMsg->pPayload, pMsg->PayloadLen);
-			LibLog_Debug("CAN:TP MsgRequest Length [%d]\n", pInst->pDataUnit->Length);
-			LibService_SetEvent(&LibCanTp_Service, LIBCANTP_SRV_EV_REQ);
+			// frames the other sender may send until the service runs, with the STmin it got
+			const uint32_t frameDataLength = (uint32_t)pOther->pDataUnit->RxDl - 1U;
+			const uint32_t sepTimeMin_us = LibCanTpInt_DecodeSepTimeMin_us(pOther->FlowCtrlSts.SeparationTimeMinimum);
+			const uint32_t frameTime_us = (sepTimeMin_us > LIBCANTPCFG_FC_ADAPTIVE_FRAME_US) ? sepTimeMin_us : LIBCANTPCFG_FC_ADAPTIVE_FRAME_US;
+			uint32_t frames = (pOther->pDataUnit->BufferDataRemaining + frameDataLength - 1U) / frameDataLength;
 
-			// Start timer
-			// LibTimer_Start(&pInst->Timers.TransmissionTimer, LIBCANTP_TRANSMISSION_TIMEOUT_MS, UINT32_C(0));
-			break;
+			if ((0U != pOther->FlowCtrlSts.BlockSizeRemaining) && ((uint32_t)pOther->FlowCtrlSts.BlockSizeRemaining < frames))
+			{
+				frames = pOther->FlowCtrlSts.BlockSizeRemaining;
+			}
+			if (((LibCanTp_RxLatency_us / frameTime_us) + 1U) < frames)
+			{
+				frames = (LibCanTp_RxLatency_us / frameTime_us) + 1U;
+			}
+			queued += frames;
 		}
 	}
+
+	*pFreeFrames = (queued < (uint32_t)LIBCANTP_MSG_IND_FIFO_ELEMENTS) ? ((uint32_t)LIBCANTP_MSG_IND_FIFO_ELEMENTS - queued) : 0U;
+	*pLatency_us = LibCanTp_RxLatency_us;
+}
+#endif // (LIBCANTPCFG_FC_ADAPTIVE > 0)
+
+#if !LIBCANTPCFG_FIXED_FC_PARAM
+//=====================================================================================================================
+// LibCanTp_SetFcParams:
+//=====================================================================================================================
+void LibCanTp_SetFcParams(struct S_LibCanTp_Inst_t *pInst, const uint8_t blockSize, const uint8_t sepTimeMin)
+{
+	pInst->FlowCtrlCfg.BlockSize  = blockSize;
+	pInst->FlowCtrlCfg.SepTimeMin = sepTimeMin;
+}
+#endif // !LIBCANTPCFG_FIXED_FC_PARAM
+
+//=====================================================================================================================
+// LibCanTp_IndicateMsg:
+//=====================================================================================================================
+void LibCanTp_IndicateMsg(S_LibCanTp_Inst_t *pInst)
+{
+	if (LibDiagCom_IsReady())
+	{
+		S_LibDiagCom_Msg_t *pComMsg = LibDiagCom_GetMsg();
+		pComMsg->DevId         = pInst->DevId;
+		pComMsg->ConnId        = pInst->Idx;
+		pComMsg->SrcAddr       = pInst->pDataUnit->SourceAddress;
+		pComMsg->TgtAddr       = pInst->pDataUnit->TargetAddress;
+		pComMsg->MaxPayloadLen = LIBCANTPCFG_MULTIFRAME_BUFFER_SIZE;
+		pComMsg->pPayload      = pInst->pDataUnit->Buffer;
+		pComMsg->PayloadLen    = pInst->pDataUnit->Length;
+		pComMsg->IsPhysical    = pInst->pDataUnit->IsPhysical;
+		pComMsg->SendMessage   = LibCanTp_MsgRequest;
+		pComMsg->GetTxBuffer   = LibCanTp_TxBufferLend;
+
+		// set before the hand over, DiagCom may respond and release the connection synchronously
+		pInst->IsIndicated = true;
+		LibDiagCom_MsgReceived(pComMsg);
+	}
+	else
+	{
+		// DiagCom is busy with the request of another connection, keep the message until it is ready again
+		LibLog_Debug("CAN:TP Conn [%d] waits for DiagCom", pInst->Idx);
+		pInst->IsIndicationPending = true;
+	}
 }
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -274,6 +754,9 @@ static void LibCanTp_ServiceHndl(void *pData)
 		{
 			LibCanTp_Inst_Table[i]->Fsm           = LibCanTpInt_Fsm;
 			LibCanTp_Inst_Table[i]->Fsm.pUserData = LibCanTp_Inst_Table[i];
+#ifdef LIBFSMCFG_TRACE
+			LibCanTp_Inst_Table[i]->Fsm.pStateStats = LibCanTp_Inst_Table[i]->FsmStateStats;
+#endif // LIBFSMCFG_TRACE
 
 			LibCanTpFsm_TriggerInit(LibCanTp_Inst_Table[i]);
 		}
@@ -296,43 +779,137 @@ static void LibCanTp_ServiceHndl(void *pData)
 	}
 
 
+	// abort only the connections which had a timeout or protocol error
+	if (LibService_CheckClearEvent(&LibCanTp_Service, LIBCANTP_SRV_EV_ABORT))
+	{
+		const uint32_t abortMask = LibAtomic_FetchAnd(&LibCanTp_AbortPendingMask, UINT32_C(0));
+		for (uint8_t i = 0U; i < LIBCANTP_INST_COUNT; i++)
+		{
+			if (0U != (abortMask & (UINT32_C(1) << i)))
+			{
+				LibCanTpFsm_TriggerInit(LibCanTp_Inst_Table[i]);
+			}
+		}
+	}
+
 	if (LibService_CheckClearEvent(&LibCanTp_Service, LIBCANTP_SRV_EV_REQ))
 	{
-		LibCanTpFsm_TriggerSend(LibCanTp_Inst_Table[0U]);
+		const uint32_t sendMask = LibAtomic_FetchAnd(&LibCanTp_SendPendingMask, UINT32_C(0));
+		for (uint8_t i = 0U; i < LIBCANTP_INST_COUNT; i++)
+		{
+			if (0U != (sendMask & (UINT32_C(1) << i)))
+			{
+#if (LIBCANTPCFG_FC_PARAM_WFTMAX > 0U)
+				S_LibCanTp_Inst_t *pInst = LibCanTp_Inst_Table[i];
+				if (pInst->IsFirstFrameHeld && LibCanTpFsm_IsReady(pInst))
+				{
+					// the connection sends half duplex, the held FirstFrame is rejected
+					LibLog_Warning("CAN:TP Conn [%d] sends, held FirstFrame dropped", pInst->Idx);
+					LibCanTpInt_DropHeldFirstFrame(pInst);
+				}
+#endif
+				LibCanTpFsm_TriggerSend(LibCanTp_Inst_Table[i]);
+			}
+		}
 	}
 
 	// receive messages from CAN transceiver
 	if (LibService_CheckClearEvent(&LibCanTp_Service, LIBCANTP_SRV_EV_IND))
 	{
-		S_LibCanTp_MsgIndBufferEntry_t *pMsg;
+		S_LibFifoQueue_Span_t spans[LIBFIFO_NUM_SPANS];
+		uint32_t numMsgs;
 
+#if (LIBCANTPCFG_FC_ADAPTIVE > 0)
+		LibCanTp_UpdateRxLatency();
+#endif
 		do
 		{
-			pMsg = (S_LibCanTp_MsgIndBufferEntry_t *)LibFifoQueue_GetItem(&LibCanTp_MsgIndFifo, UINT32_C(0));
+			// handle the whole burst of received frames in place and remove it at once
+			numMsgs = LibFifoQueue_GetSpans(&LibCanTp_MsgIndFifo, spans);
+			for (uint32_t span = 0U; span < LIBFIFO_NUM_SPANS; span++)
+			{
+				S_LibCanTp_MsgIndBufferEntry_t *pMsgs = (S_LibCanTp_MsgIndBufferEntry_t *)spans[span].pItems;
+				for (uint32_t msgIdx = 0U; msgIdx < spans[span].NumItems; msgIdx++)
+				{
+#if (LIBCANTPCFG_FC_ADAPTIVE > 0)
+					LibCanTp_RxFramesHandled++;
+#endif
+					LibCanTp_HandleRxFrame(&pMsgs[msgIdx]);
+				}
+			}
+			LibFifoQueue_PopN(&LibCanTp_MsgIndFifo, numMsgs);
+#if (LIBCANTPCFG_FC_ADAPTIVE > 0)
+			LibCanTp_RxFramesHandled = 0U;
+#endif
+
+		} while (numMsgs != 0U);
 
-			if (pMsg != NULL)
+#if (LIBCANTPCFG_FC_ADAPTIVE > 0)
+		// FlowControls deferred by a full queue or by a FirstFrame of this burst are sent now
+		for (uint8_t i = 0U; i < LIBCANTP_INST_COUNT; i++)
+		{
+			if (LibCanTp_Inst_Table[i]->FlowCtrlSts.IsCtsDeferred)
 			{
-				LibCanTp_HandleRxFrame(pMsg);
+				LibCanTpInt_HandleFcDeferred(LibCanTp_Inst_Table[i], false);
 			}
-			LibFifoQueue_Pop(&LibCanTp_MsgIndFifo);
-			
-		} while (pMsg != NULL);
+		}
+#endif
 	}
 
 	// confirm transmitted massages from CAN transceiver
 	if (LibService_CheckClearEvent(&LibCanTp_Service, LIBCANTP_SRV_EV_CON))
 	{
-		S_LibCanTp_MsgConBufferEntry_t *pMsgId;
+		S_LibFifoQueue_Span_t spans[LIBFIFO_NUM_SPANS];
+		uint32_t numMsgIds;
 
 		do
 		{
-			pMsgId = (S_LibCanTp_MsgConBufferEntry_t *)LibFifoQueue_GetItem(&LibCanTp_MsgConFifo, 0U);
-			if (pMsgId != NULL)
+			numMsgIds = LibFifoQueue_GetSpans(&LibCanTp_MsgConFifo, spans);
+			for (uint32_t span = 0U; span < LIBFIFO_NUM_SPANS; span++)
+			{
+				const S_LibCanTp_MsgConBufferEntry_t *pMsgIds =
+					(const S_LibCanTp_MsgConBufferEntry_t *)spans[span].pItems;
+				for (uint32_t msgIdx = 0U; msgIdx < spans[span].NumItems; msgIdx++)
+				{
+					LibCanTp_HandleConfirm(pMsgIds[msgIdx]);
+				}
+			}
+			LibFifoQueue_PopN(&LibCanTp_MsgConFifo, numMsgIds);
+		} while (numMsgIds != 0U);
+	}
+
+	// hand over a message which waited for DiagCom
+	if (LibService_CheckClearEvent(&LibCanTp_Service, LIBCANTP_SRV_EV_DIAGCOM_READY))
+	{
+		LibCanTp_HandleDiagComReady();
+	}
+
+	// send a deferred FlowControl if the reception can continue
+	if (LibService_CheckClearEvent(&LibCanTp_Service, LIBCANTP_SRV_EV_FC_RETRY))
+	{
+		const uint32_t retryMask = LibAtomic_FetchAnd(&LibCanTp_FcRetryPendingMask, UINT32_C(0));
+		for (uint8_t i = 0U; i < LIBCANTP_INST_COUNT; i++)
+		{
+			S_LibCanTp_Inst_t *pInst = LibCanTp_Inst_Table[i];
+			if ((0U != (retryMask & (UINT32_C(1) << i))) && pInst->FlowCtrlSts.IsCtsDeferred)
+			{
+				LibCanTpInt_HandleFcDeferred(pInst, false);
+			}
+		}
+	}
+
+	// hold the sender of a deferred FlowControl by WAIT
+	if (LibService_CheckClearEvent(&LibCanTp_Service, LIBCANTP_SRV_EV_FC_WAIT))
+	{
+		const uint32_t waitMask = LibAtomic_FetchAnd(&LibCanTp_FcWaitPendingMask, UINT32_C(0));
+		for (uint8_t i = 0U; i < LIBCANTP_INST_COUNT; i++)
+		{
+			S_LibCanTp_Inst_t *pInst = LibCanTp_Inst_Table[i];
+			if ((0U != (waitMask & (UINT32_C(1) << i))) && pInst->FlowCtrlSts.IsCtsDeferred)
 			{
-				LibCanTp_HandleConfirm(*pMsgId);
-				LibFifoQueue_Pop(&LibCanTp_MsgConFifo);
+				LibCanTpInt_HandleFcDeferred(pInst, true);
 			}
-		} while (pMsgId != NULL);
+		}
 	}
 
 	// Shutdown/destruct the service
@@ -349,26 +926,22 @@ Ret_t LibCanTp_HandleTxMessage(S_LibCanTp_Inst_t *pInst)
 	if(LibCanTP_TransmitEnabled == true)
 	{
 	  S_LibCan_Msg_t *pCanMsg = pInst->pCanMsg;
-	  // not supported yet
-	  pCanMsg->IsBrs = false;
-	  pCanMsg->IsCanFd = false;
-	  #if defined(LIBCANTPCFG_FRAMELENGTH) && defined(LIBCANTPCFG_FRAMEPADDING)
+	  pCanMsg->CanDevId = pInst->DevId;
+	  // framing of the connection
+	  pCanMsg->IsCanFd = pInst->IsCanFd;
+	  pCanMsg->IsBrs = pInst->IsCanFd && LIBCANTPCFG_CANFD_BRS;
 	  // padding
-	  const uint8_t length = LibCan_GetMsgDataLength(pCanMsg->Length);
-	  const uint8_t neededLength = LibCan_GetMsgDataLength((E_LibCan_DlcSize_t)LIBCANTPCFG_FRAMELENGTH);
-	  if (length < neededLength)
+	  LibCanTpInt_PadFrame(pCanMsg);
+
+	  S_LibCanTp_MsgReqBufferEntry_t *pBufEntry =
+		(S_LibCanTp_MsgReqBufferEntry_t *)LibFifoQueue_Reserve(&LibCanTp_MsgReqFifo);
+	  if (NULL != pBufEntry)
 	  {
-		for (uint8_t idx = length; idx < neededLength; ++idx)
-		{
-			pCanMsg->Data[idx] = (uint8_t)LIBCANTPCFG_FRAMEPADDING;
-		}
-		pCanMsg->Length = (E_LibCan_DlcSize_t)LIBCANTPCFG_FRAMELENGTH;
+		*pBufEntry = *pCanMsg;
+		LibFifoQueue_Commit(&LibCanTp_MsgReqFifo);
+		pInst->TxConfSeq = LibCanTp_TxSeq++;
+		pInst->IsTxConfPending = true;
 	  }
-	  #endif
-
-	  S_LibCanTp_MsgReqBufferEntry_t bufEntry = *pCanMsg;
-
-	  LibFifoQueue_Push(&LibCanTp_MsgReqFifo, &bufEntry);
 	  LIBCANTPCFG_SET_TASKEV_REQ();
 
 		if (pInst->pDataUnit->BufferDataRemaining == 0U)
@@ -382,19 +955,19 @@ Ret_t LibCanTp_HandleTxMessage(S_LibCanTp_Inst_t *pInst)
 		if( LIBCANTP_FRAMETYPE_FIRSTFRAME == messageType ) //Send First Frame and Wait for Receive FlowControl Frame.
 		{
 			//Restart timer N_Bs
-			LibTimer_Stop(&pInst->Timers.FlowControlTimer);
-			LibTimer_Start(&pInst->Timers.FlowControlTimer, LIBCANTP_FLOWCONTROL_TIMEOUT_MS, UINT32_C(0));
+			LibHrTimer_Stop(&pInst->Timers.FlowControlTimer);
+			LibHrTimer_Start(&pInst->Timers.FlowControlTimer, LIBHRTIMER_MS_TO_US(LIBCANTP_FLOWCONTROL_TIMEOUT_MS));
 		}
 		else if(LIBCANTP_FRAMETYPE_FLOWCONTROL == messageType) //Send FlowContol Frame and Wait for Consecutive Frame.
 		{
 			//Restart timer N_Cr
-			LibTimer_Stop(&pInst->Timers.ConsecutiveTimer);
-			LibTimer_Start(&pInst->Timers.ConsecutiveTimer, LIBCANTP_CONSECUTIVE_TIMEOUT_MS, UINT32_C(0));
+			LibHrTimer_Stop(&pInst->Timers.ConsecutiveTimer);
+			LibHrTimer_Start(&pInst->Timers.ConsecutiveTimer, LIBHRTIMER_MS_TO_US(LIBCANTP_CONSECUTIVE_TIMEOUT_MS));
 		}
 
 		//Restart timer N_As
-		LibTimer_Stop(&pInst->Timers.TransmissionTimer);
-	    LibTimer_Start(&pInst->Timers.TransmissionTimer, LIBCANTP_TRANSMISSION_TIMEOUT_MS, UINT32_C(0));
+		LibHrTimer_Stop(&pInst->Timers.TransmissionTimer);
+	    LibHrTimer_Start(&pInst->Timers.TransmissionTimer, LIBHRTIMER_MS_TO_US(LIBCANTP_TRANSMISSION_TIMEOUT_MS));
 
 		LibLog_Debug("CAN:TP TX %[]X", (uint8_t)pCanMsg->Length, pCanMsg->Data);
 
@@ -407,30 +980,36 @@ Ret_t LibCanTp_HandleTxMessage(S_LibCanTp_Inst_t *pInst)
 
 static void LibCanTp_HandleConfirm(const uint32_t msgId)
 {
-	LIB_UNUSED(msgId);
-	S_LibCanTp_Inst_t *pInst = LibCanTp_Inst_Table[0];
+	S_LibCanTp_Inst_t *pInst = LibCanTp_GetConfirmInst(msgId);
+	if (NULL == pInst)
+	{
+		LibLog_Debug("CAN:TP RX confirm 0x%X unexpected", msgId);
+		return;
+	}
+	pInst->IsTxConfPending = false;
 
-	LibTimer_Stop(&pInst->Timers.TransmissionTimer); //Stop timer N_As
+	LibHrTimer_Stop(&pInst->Timers.TransmissionTimer); //Stop timer N_As
 
-	if ((!pInst->pDataUnit->IsFinished)
+	// the FlowControl frames of a reception do not continue a transmission (nor count its block)
+	if ((!pInst->pDataUnit->IsFinished) && (!LibCanTpFsm_IsRecv(pInst))
 		&& ((0U == pInst->FlowCtrlSts.BlockSize) || (0U < pInst->FlowCtrlSts.BlockSizeRemaining)))
 	{
-		if((pInst->FlowCtrlSts.SeparationTimeMinimum > 0)
-			&& (pInst->FlowCtrlSts.SeparationTimeMinimum <= LIBCANTP_SEPARATIONTIMEMINMUM_MAX))
+		const uint32_t sepTimeMin_us = LibCanTpInt_DecodeSepTimeMin_us(pInst->FlowCtrlSts.SeparationTimeMinimum);
+		if(sepTimeMin_us > 0U)
 		{
 			//Restart the STminTimer
-			LibTimer_Stop(&pInst->Timers.SeparationTimeMinTimer); 
-            LibTimer_Start(&pInst->Timers.SeparationTimeMinTimer,pInst->FlowCtrlSts.SeparationTimeMinimum,UINT32_C(0)); 
+			LibHrTimer_Stop(&pInst->Timers.SeparationTimeMinTimer); 
+			LibHrTimer_Start(&pInst->Timers.SeparationTimeMinTimer, sepTimeMin_us);
 		}
 		else
 		{
-            LibService_SetEvent(&LibCanTp_Service, LIBCANTP_SRV_EV_REQ);
+			LibCanTp_RequestSend(pInst);
 			LibCanTp_HandleFlowCtrlStsBlockSize(pInst);
 		}
 	}
-	else if((pInst->pDataUnit->IsFinished) && (msgId == LIBCANTPCFG_ECU_PHYS_ADDRESS))
+	else if(pInst->pDataUnit->IsFinished)
 	{
-		LibTimer_Stop(&pInst->Timers.SeparationTimeMinTimer);  //Stop STminTimer 
+		LibHrTimer_Stop(&pInst->Timers.SeparationTimeMinTimer);  //Stop STminTimer 
 		//S_LibUds_TxConf_t* pTxConfirm = LN7Diag_GetTxConfirm();
 
 		//if (NULL != pTxConfirm->pConfirm)
@@ -447,26 +1026,186 @@ static void LibCanTp_HandleConfirm(const uint32_t msgId)
 			
 }
 
-static void LibCanTp_HandleRxFrame(const S_LibCanTp_MsgIndBufferEntry_t *pBufEntry)
+#if (LIBCANTPCFG_TX_BURST_FRAMES > 0U)
+//=====================================================================================================================
+// LibCanTp_TxBurstFill:
+//=====================================================================================================================
+void LibCanTp_TxBurstFill(S_LibCanTp_Inst_t *pInst)
 {
-	S_LibCanTp_Inst_t *pInst = NULL;
-	E_LibCanTp_FrameType_t messageType = LibCanTpInt_ParseFrameTypeRx(&pBufEntry);
+	S_LibCanTp_DataUnit_t *pMsg = pInst->pDataUnit;
+	bool_t isQueued = LibCanTP_TransmitEnabled;
 
-	// Select the TP instance according to CAN Interface
-	for (uint8_t i = 0; (i < LIBCANTP_INST_COUNT) && (NULL == pInst); i++)
+	while (isQueued && (0U != pMsg->BufferDataRemaining)
+		   && ((0U == pInst->FlowCtrlSts.BlockSize) || (0U < pInst->FlowCtrlSts.BlockSizeRemaining)))
 	{
-		pInst = LibCanTp_Inst_Table[i];
-		if (pInst->DevId != pBufEntry->DevId)
+		S_LibCan_Msg_t *pCanMsg = (S_LibCan_Msg_t *)LibFifoQueue_Reserve(pInst->TxBurst.pFifo);
+		isQueued = (NULL != pCanMsg);
+		if (isQueued)
 		{
-			pInst = NULL;
+			LibCanTpInt_SegmentConsecutiveFrame(pInst, pCanMsg);
+			LibCanTpInt_PadFrame(pCanMsg);
+			LibFifoQueue_Commit(pInst->TxBurst.pFifo);
+
+			if (0U < pInst->FlowCtrlSts.BlockSizeRemaining)
+			{
+				pInst->FlowCtrlSts.BlockSizeRemaining--;
+			}
 		}
 	}
-	Lib_Assert(NULL != pInst);
 
-	if (LibDiagCom_IsReady())
+	if (0U == pMsg->BufferDataRemaining)
 	{
-		
-		memcpy(pInst->pCanMsg, &pBufEntry, sizeof(S_LibCan_Msg_t));
+		// the message is segmented completely, the last CFs are sent while the connection is ready again
+		pMsg->IsFinished = true;
+		pMsg->IsTxMultiFrame = false;
+	}
+
+	LibCanTp_TxBurstRelease(pInst->DevId);
+}
+
+//=====================================================================================================================
+// LibCanTp_TxBurstRelease:
+//=====================================================================================================================
+void LibCanTp_TxBurstRelease(const E_LibDrv_DevId_t devId)
+{
+	uint32_t lock = 0U;
+
+	(void)LibAtomic_FetchOr(&LibCanTp_TxBurstPendingDevMask, UINT32_C(1) << (uint32_t)devId);
+
+	// an interrupt may preempt the refill of the task, it leaves its device to the holder of the lock
+	while ((0U != LibAtomic_Load(&LibCanTp_TxBurstPendingDevMask))
+		   && LibAtomic_CompareExchange(&LibCanTp_TxBurstLock, &lock, UINT32_C(1)))
+	{
+		LibCanTp_TxBurstWrite(LibAtomic_FetchAnd(&LibCanTp_TxBurstPendingDevMask, UINT32_C(0)));
+		LibAtomic_Store(&LibCanTp_TxBurstLock, UINT32_C(0));
+	}
+}
+
+static void LibCanTp_TxBurstWrite(const uint32_t devMask)
+{
+	uint32_t busyDevMask = 0U;
+	bool_t isWritten = true;
+
+	// one frame per connection and round, so connections on the same device share the mailboxes. A connection has
+	// at most one CF in a mailbox: the mailboxes are prioritized by the identifier, so two CFs of the same connection
+	// could leave in the wrong order. The next CF is written from the transmit complete interrupt of the previous one.
+	while (isWritten)
+	{
+		isWritten = false;
+		for (uint8_t i = 0U; i < LIBCANTP_INST_COUNT; i++)
+		{
+			S_LibCanTp_Inst_t *pInst = LibCanTp_Inst_Table[i];
+			const uint32_t devBit = UINT32_C(1) << (uint32_t)pInst->DevId;
+			S_LibCan_Msg_t *pCanMsg = NULL;
+
+			if ((0U != (devMask & devBit)) && (0U == (busyDevMask & devBit))
+				&& (0U == LibAtomic_Load(&pInst->TxBurst.InFlight)) && (!LibAtomic_Load(&pInst->TxBurst.IsStMinWait)))
+			{
+				pCanMsg = (S_LibCan_Msg_t *)LibFifoQueue_Peek(pInst->TxBurst.pFifo);
+			}
+
+			if (NULL != pCanMsg)
+			{
+				// counted before, the frame may complete before LIBCANTPCFG_TX_FRAME returns
+				(void)LibAtomic_FetchAdd(&pInst->TxBurst.InFlight, UINT32_C(1));
+				if (LIBRET_OK == LIBCANTPCFG_TX_FRAME(pCanMsg, LibCanTp_TxBurstConfirm, pInst))
+				{
+					LibFifoQueue_Release(pInst->TxBurst.pFifo);
+					if (0U != pInst->FlowCtrlSts.SeparationTimeMinimum)
+					{
+						// the next CF follows STmin after the completion of this one
+						LibAtomic_Store(&pInst->TxBurst.IsStMinWait, true);
+					}
+
+					//Restart timer N_As
+					LibHrTimer_Stop(&pInst->Timers.TransmissionTimer);
+					LibHrTimer_Start(&pInst->Timers.TransmissionTimer, LIBHRTIMER_MS_TO_US(LIBCANTP_TRANSMISSION_TIMEOUT_MS));
+					isWritten = true;
+				}
+				else
+				{
+					(void)LibAtomic_FetchAdd(&pInst->TxBurst.InFlight, UINT32_MAX);
+					busyDevMask |= devBit;
+				}
+			}
+		}
+	}
+}
+
+static void LibCanTp_TxBurstConfirm(void *pData, bool_t isSent)
+{
+	S_LibCanTp_Inst_t *pInst = (S_LibCanTp_Inst_t *)pData;
+	const uint32_t inFlight = LibAtomic_FetchAdd(&pInst->TxBurst.InFlight, UINT32_MAX) - 1U;
+
+	if (isSent)
+	{
+		if (0U == inFlight)
+		{
+			LibHrTimer_Stop(&pInst->Timers.TransmissionTimer); //Stop timer N_As
+		}
+
+		if (LibAtomic_Load(&pInst->TxBurst.IsStMinWait))
+		{
+			//Restart the STminTimer, its expiry releases the next CF
+			LibHrTimer_Stop(&pInst->Timers.SeparationTimeMinTimer);
+			LibHrTimer_Start(&pInst->Timers.SeparationTimeMinTimer,
+							 LibCanTpInt_DecodeSepTimeMin_us(pInst->FlowCtrlSts.SeparationTimeMinimum));
+		}
+
+		if ((!pInst->pDataUnit->IsFinished) && (pInst->pDataUnit->IsTxMultiFrame))
+		{
+			if ((0U == pInst->FlowCtrlSts.BlockSize) || (0U < pInst->FlowCtrlSts.BlockSizeRemaining))
+			{
+				// segment further CFs before the queue runs empty
+				if (LibFifoQueue_GetCount(pInst->TxBurst.pFifo) <= (LIBCANTPCFG_TX_BURST_FRAMES / 2U))
+				{
+					LibCanTp_RequestSend(pInst);
+				}
+			}
+			else if ((0U == inFlight) && (0U == LibFifoQueue_GetCount(pInst->TxBurst.pFifo)))
+			{
+				// the block is sent completely, restart timer N_Bs for the next FlowControl
+				LibHrTimer_Stop(&pInst->Timers.FlowControlTimer);
+				LibHrTimer_Start(&pInst->Timers.FlowControlTimer, LIBHRTIMER_MS_TO_US(LIBCANTP_FLOWCONTROL_TIMEOUT_MS));
+			}
+		}
+	}
+}
+#endif // (LIBCANTPCFG_TX_BURST_FRAMES > 0U)
+
+static void LibCanTp_HandleRxFrame(const S_LibCanTp_MsgIndBufferEntry_t *pBufEntry)
+{
+	// Select the TP connection according to CAN Interface and identifier
+	S_LibCanTp_Inst_t *pInst = LibCanTp_GetRxInst(pBufEntry);
+	if (NULL == pInst)
+	{
+		LibLog_Warning("CAN:TP no connection for 0x%X", pBufEntry->Id);
+		return;
+	}
+
+	const E_LibCanTp_FrameType_t messageType = LibCanTpInt_ParseFrameTypeRx(pBufEntry);
+	const bool_t isNewMsg = (LIBCANTP_FRAMETYPE_SINGLEFRAME == messageType)
+						 || (LIBCANTP_FRAMETYPE_FIRSTFRAME == messageType);
+
+	// a new message must not overwrite the last one as long as it is waiting for or processed by DiagCom. Frames of
+	// running transfers are always handled, DiagCom being busy with another connection does not stall them.
+	if (isNewMsg && (pInst->IsIndicationPending || pInst->IsIndicated))
+	{
+#if (LIBCANTPCFG_FC_PARAM_WFTMAX > 0U)
+		if ((LIBCANTP_FRAMETYPE_FIRSTFRAME == messageType) && LibCanTpFsm_IsReady(pInst))
+		{
+			// the sender is held by WAIT until DiagCom releases the buffer
+			LibCanTpInt_HoldFirstFrame(pInst, pBufEntry);
+		}
+		else
+#endif
+		{
+			LibLog_Warning("CAN:TP Conn [%d] busy, new message ignored", pInst->Idx);
+		}
+	}
+	else
+	{
+		memcpy(pInst->pCanMsg, pBufEntry, sizeof(S_LibCan_Msg_t));
 		const uint8_t message_length = LibCan_GetMsgDataLength(pInst->pCanMsg->Length);
 
 		switch (messageType)
@@ -499,6 +1238,103 @@ static void LibCanTp_HandleRxFrame(const S_LibCanTp_MsgIndBufferEntry_t *pBufEnt
 		}
 	}
 }
+
+static S_LibCanTp_Inst_t *LibCanTp_GetRxInst(const S_LibCan_Msg_t *pMsg)
+{
+	S_LibCanTp_Inst_t *pInst = NULL;
+
+	for (uint8_t i = 0U; (i < LIBCANTP_INST_COUNT) && (NULL == pInst); i++)
+	{
+		if ((LibCanTp_Inst_Table[i]->DevId == pMsg->CanDevId) && (LibCanTp_Inst_Table[i]->RxId == pMsg->Id))
+		{
+			pInst = LibCanTp_Inst_Table[i];
+		}
+	}
+
+	return pInst;
+}
+
+static S_LibCanTp_Inst_t *LibCanTp_GetConfirmInst(const uint32_t msgId)
+{
+	S_LibCanTp_Inst_t *pInst = NULL;
+	uint32_t maxAge = 0U;
+
+	for (uint8_t i = 0U; i < LIBCANTP_INST_COUNT; i++)
+	{
+		S_LibCanTp_Inst_t *pCandidate = LibCanTp_Inst_Table[i];
+		if ((pCandidate->IsTxConfPending) && (pCandidate->TxId == msgId))
+		{
+			// the age is computed modulo 2^32, so the wrap around of the sequence number is handled
+			const uint32_t age = LibCanTp_TxSeq - pCandidate->TxConfSeq;
+			if ((NULL == pInst) || (age > maxAge))
+			{
+				pInst = pCandidate;
+				maxAge = age;
+			}
+		}
+	}
+
+	return pInst;
+}
+
+#if (LIBCANTPCFG_FC_ADAPTIVE > 0)
+static void LibCanTp_UpdateRxLatency(void)
+{
+	if (0U != LibFifoQueue_GetCount(&LibCanTp_MsgIndFifo))
+	{
+		const uint32_t latency_us = LibHrTimer_GetTime_us() - LibAtomic_Load(&LibCanTp_RxIndTime_us);
+
+		// a rising latency is taken at once, a falling one decays by 1/8 per burst
+		if (latency_us >= LibCanTp_RxLatency_us)
+		{
+			LibCanTp_RxLatency_us = latency_us;
+		}
+		else
+		{
+			LibCanTp_RxLatency_us -= (LibCanTp_RxLatency_us - latency_us) / 8U;
+		}
+	}
+}
+#endif // (LIBCANTPCFG_FC_ADAPTIVE > 0)
+
+static void LibCanTp_HandleDiagComReady(void)
+{
+	S_LibCanTp_Inst_t *pWaiting = NULL;
+	// a connection indicated between the response and this event is still held by DiagCom (and may borrow its buffer)
+	const bool_t isDiagComBusy = !LibDiagCom_IsReady();
+	const uint8_t heldConnId = LibDiagCom_GetMsg()->ConnId;
+
+	for (uint8_t i = 0U; i < LIBCANTP_INST_COUNT; i++)
+	{
+		S_LibCanTp_Inst_t *pInst = LibCanTp_Inst_Table[i];
+		if (!isDiagComBusy || (pInst->Idx != heldConnId))
+		{
+			pInst->IsIndicated = false;
+		}
+		if ((NULL == pWaiting) && (pInst->IsIndicationPending))
+		{
+			pWaiting = pInst;
+		}
+	}
+
+	// DiagCom handles one request at a time, the further waiting connections follow on the next ready event
+	if (NULL != pWaiting)
+	{
+		pWaiting->IsIndicationPending = false;
+		LibCanTp_IndicateMsg(pWaiting);
+	}
+
+#if (LIBCANTPCFG_FC_PARAM_WFTMAX > 0U)
+	// a FirstFrame held while the buffer was in use continues now
+	for (uint8_t i = 0U; i < LIBCANTP_INST_COUNT; i++)
+	{
+		if (LibCanTp_Inst_Table[i]->IsFirstFrameHeld)
+		{
+			LibCanTpInt_HandleFcDeferred(LibCanTp_Inst_Table[i], false);
+		}
+	}
+#endif
+}
 //=====================================================================================================================
 // LibCanTP_TxStop:
 //=====================================================================================================================
@@ -507,6 +1343,12 @@ void LibCanTP_TxStop(void)
 	LibLog_Info("CAN:TP TX Stop");
 	LibCanTP_TransmitEnabled = false;
 	LibFifoQueue_Clear(&LibCanTp_MsgReqFifo);
+#if (LIBCANTPCFG_TX_BURST_FRAMES > 0U)
+	for (uint8_t i = 0U; i < LIBCANTP_INST_COUNT; i++)
+	{
+		LibFifoQueue_Clear(LibCanTp_Inst_Table[i]->TxBurst.pFifo);
+	}
+#endif
 }
 //=====================================================================================================================
 // LibCanTP_RxStopv:
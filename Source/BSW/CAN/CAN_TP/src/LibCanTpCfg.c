@@ -28,6 +28,11 @@
 //	Local Definitions
 // --------------------------------------------------------------------------------------------------------------------
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Expand a CanTP instance into the comparison of the message ID with its receive and transmit identifier
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBCANTPCFG_EXPAND_IS_MSG(name, devid, rxId, txId, isPhysical, isCanFd) || (msgId == (rxId)) || (msgId == (txId))
+
 
 // --------------------------------------------------------------------------------------------------------------------
 //	Local Data Types
@@ -62,10 +67,8 @@ extern bool_t LibCanTP_ReceiveEnabled;
 bool_t LibCanTp_IsMsgTp(uint32_t msgId)
 {
 	bool_t return_value = false;
-    if(    (    ( msgId == LIBCANTPCFG_ECU_PHYS_ADDRESS)
-	        || ( msgId == LIBCANTPCFG_ECU_FUNC_ADDRESS)
-			|| ( msgId == LIBCANTPCFG_TESTER_PHYS_ADDRESS)
-			)&&( LibCanTP_ReceiveEnabled == true)
+    if(    ( false LIBCANTPCFG_INSTANCES(LIBCANTPCFG_EXPAND_IS_MSG) )
+		&& ( LibCanTP_ReceiveEnabled == true)
 	      )
     {
 		return_value = true;
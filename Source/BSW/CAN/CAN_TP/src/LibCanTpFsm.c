@@ -71,6 +71,10 @@
 
 LIBFSM_DECLARE_STATE_MACHINE(LibCanTpInt, LIBCANTP_FSM_EVENTS, LIBCANTP_FSM_STATES, NULL);
 
+#ifdef LIBFSMCFG_TRACE
+typedef char LibCanTpFsm_StateNumMatches[(LibCanTpInt_ST_NUM == LIBCANTP_FSM_STATE_NUM) ? 1 : -1];
+#endif // LIBFSMCFG_TRACE
+
 // --------------------------------------------------------------------------------------------------------------------
 //	Global Variables
 // --------------------------------------------------------------------------------------------------------------------
@@ -95,7 +99,12 @@ LIBFSM_DECLARE_STATE_MACHINE(LibCanTpInt, LIBCANTP_FSM_EVENTS, LIBCANTP_FSM_STAT
 // ====================================================================================================================
 void LibCanTpFsm_TriggerInit(S_LibCanTp_Inst_t* pInst)
 {
-	LibFsm_DispatchEvent(&pInst->Fsm, LIBCANTP_EV_INIT);
+	if (!LibFsm_DispatchEvent(&pInst->Fsm, LIBCANTP_EV_INIT))
+	{
+		// the event queue of the connection is full: the abort must not get lost, the service repeats it
+		LibLog_Error("CAN:TP Conn [%d] INIT dropped, abort requested again", pInst->Idx);
+		LibCanTp_RequestAbort(pInst);
+	}
 }
 
 // ====================================================================================================================
@@ -160,13 +169,39 @@ static void LibCanTpFsm_Init(void* pData)
 	S_LibCanTp_Inst_t* pInst = (S_LibCanTp_Inst_t*)pData;
 
 	//Stop all Timer
-	LibTimer_Stop(&pInst->Timers.TransmissionTimer);
-	LibTimer_Stop(&pInst->Timers.FlowControlTimer);
-	LibTimer_Stop(&pInst->Timers.ConsecutiveTimer);
+	LibHrTimer_Stop(&pInst->Timers.TransmissionTimer);
+	LibHrTimer_Stop(&pInst->Timers.FlowControlTimer);
+	LibHrTimer_Stop(&pInst->Timers.ConsecutiveTimer);
+	LibHrTimer_Stop(&pInst->Timers.SeparationTimeMinTimer);
 
 	pInst->pDataUnit->IsFinished = true; //need to be true
 	pInst->pDataUnit->IsRxMultiFrame = false;
 	pInst->pDataUnit->IsTxMultiFrame = false;
+
+	// a message waiting for DiagCom is dropped, one already processed by DiagCom is released by DiagCom
+	pInst->IsIndicationPending = false;
+	pInst->IsTxConfPending = false;
+
+	// a deferred FlowControl (and a held FirstFrame) ends with the connection
+	pInst->FlowCtrlSts.IsCtsDeferred = false;
+	pInst->FlowCtrlSts.WaitCount = 0U;
+#if (LIBCANTPCFG_FC_PARAM_WFTMAX > 0U)
+	pInst->IsFirstFrameHeld = false;
+#endif
+
+#if (LIBCANTPCFG_TX_BURST_FRAMES > 0U)
+	// segmented CFs which are not in a mailbox yet are dropped, the CFs in the mailboxes complete normally
+	LibFifoQueue_Clear(pInst->TxBurst.pFifo);
+	LibAtomic_Store(&pInst->TxBurst.IsStMinWait, false);
+#endif
+
+#if (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+	// an aborted streaming reception returns its segments to the upper layer
+	if (pInst->RxStream.IsActive)
+	{
+		LibCanTp_RxStreamEnd(pInst, LIBRET_FAILED);
+	}
+#endif
 }
 
 static void LibCanTpFsm_Recv(void* pData)
@@ -182,18 +217,15 @@ static void LibCanTpFsm_Recv(void* pData)
 static void LibCanTpFsm_RecvFinish(void* pData)
 {
 	S_LibCanTp_Inst_t* pInst = (S_LibCanTp_Inst_t*)pData;
-	// LibCanTpDiagCom_Indicate(pInst);
-	// todo
-	S_LibDiagCom_Msg_t* pComMsg = LibDiagCom_GetMsg();
-	pComMsg->DevId = pInst->DevId;
-	pComMsg->SrcAddr = pInst->pDataUnit->SourceAddress;
-	pComMsg->TgtAddr = pInst->pDataUnit->TargetAddress;
-	pComMsg->MaxPayloadLen = LIBCANTPCFG_MULTIFRAME_BUFFER_SIZE;
-	pComMsg->pPayload = pInst->pDataUnit->Buffer;
-	pComMsg->PayloadLen = pInst->pDataUnit->Length;
-	pComMsg->IsPhysical = pInst->pDataUnit->IsPhysical;
-	pComMsg->SendMessage = LibCanTp_MsgRequest;
-	LibDiagCom_MsgReceived(pComMsg);
+#if (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+	if (pInst->RxStream.IsActive)
+	{
+		// the message is in the segments of the upper layer, DiagCom is not involved
+		LibCanTp_RxStreamEnd(pInst, LIBRET_OK);
+		return;
+	}
+#endif
+	LibCanTp_IndicateMsg(pInst);
 }
 
 static void LibCanTpFsm_Send(void* pData)
@@ -203,73 +235,82 @@ static void LibCanTpFsm_Send(void* pData)
 	S_LibCan_Msg_t* pCanMsg = pInst->pCanMsg;
 
 	// Set ID and isExtId
-	LibCanTpInt_ParseAddrTx(pCanMsg, (uint8_t)pMsg->SourceAddress, (uint8_t)pMsg->TargetAddress, pMsg->IsPhysical);
+	LibCanTpInt_ParseAddrTx(pInst, pCanMsg, (uint8_t)pMsg->SourceAddress, (uint8_t)pMsg->TargetAddress, pMsg->IsPhysical);
+
+	// SF_DL above 7 (escape sequence) is possible with CAN FD frames only
+	const uint32_t maxSingleFrameLength = (pInst->TxDl > 8U) ? ((uint32_t)pInst->TxDl - 2U) : 7U;
 
-	if (pMsg->Length <= 7U)
+	if (pMsg->Length <= maxSingleFrameLength)
 	{
 		// SF
-		pCanMsg->Data[0U] = 0x0FU & ((uint8_t)pMsg->Length);
-		pCanMsg->Length = (E_LibCan_DlcSize_t)(pMsg->Length + 1U);
-		memcpy(&pCanMsg->Data[1U], pMsg->Buffer, pMsg->Length);
+		uint8_t dataOffset = 1U;
+
+		if (pMsg->Length <= 7U)
+		{
+			pCanMsg->Data[0U] = 0x0FU & ((uint8_t)pMsg->Length);
+		}
+		else
+		{
+			// ISO 15765-2:2016 9.6.2.1: SF_DL escape sequence, the length follows in byte #2
+			pCanMsg->Data[0U] = 0x00U;
+			pCanMsg->Data[1U] = (uint8_t)pMsg->Length;
+			dataOffset++;
+		}
+		memcpy(&pCanMsg->Data[dataOffset], pMsg->pTxData, pMsg->Length);
+		LibCanTpInt_SetFrameLength(pCanMsg, (uint8_t)(pMsg->Length + dataOffset));
 		pMsg->BufferRWIdx += pMsg->Length;
 		//pMsg->BufferDataRemaining -= pMsg->Length;
 		pMsg->BufferDataRemaining = 0; //hotfix the bug: will always send msg and never stop in some abnormal situation
 		pMsg->IsTxMultiFrame = false;
 	//	LibLog_Info("pCanMsg->Length: %d==%d | buff: %[]X", pCanMsg->Length, LIBCAN_DLCSIZE_8_B, 8, pCanMsg->Data);
 	}
-	else
+	else if (0U == pMsg->BufferRWIdx)
 	{
-		uint8_t dataOffset = 1U;
-		uint8_t dataWritten = 0U;
-		// MultiFrame
-		if (0U == pMsg->BufferRWIdx)
+		// FF
+		uint8_t dataOffset = 2U;
+
+		if (pMsg->Length <= 0xFFFU)
 		{
-			// FF
 			pCanMsg->Data[0U] = 0x10U | (0x0FU & (uint8_t)(pMsg->Length >> 8U));
 			pCanMsg->Data[1U] = (uint8_t)(0xFFU & pMsg->Length);
-			dataOffset += 1U;
-			pInst->FlowCtrlSts.CurSequenceNumber = 0U;
-			pInst->FlowCtrlSts.BlockSizeRemaining = 0U;
-			pInst->FlowCtrlSts.BlockSize = 1U;
-			pMsg->IsTxMultiFrame = true;
 		}
 		else
 		{
-			if(pMsg->IsTxMultiFrame == true)
-			{
-				// CF
-				pInst->FlowCtrlSts.CurSequenceNumber += 1U;
-				pInst->FlowCtrlSts.CurSequenceNumber &= 0x0FU;	// mod 16
-				pCanMsg->Data[0U] = 0x20U | (0x0FU & pInst->FlowCtrlSts.CurSequenceNumber);
-			}
-			else
-			{
-				//if not MultiFrame just abort this msg
-		        LibService_SetEvent(&LibCanTp_Service, LIBSERVICE_EV_RE_INIT);
-				return; 
-			}
-			
+			// ISO 15765-2:2016 9.6.3.1: FF_DL escape sequence, the 32 bit length follows in byte #3 - #6
+			pCanMsg->Data[0U] = 0x10U;
+			pCanMsg->Data[1U] = 0x00U;
+			STR32_BIG(&pCanMsg->Data[2U], pMsg->Length);
+			dataOffset += 4U;
 		}
 
-		// the max amount that still fits into this frame
-		dataWritten += (8U - dataOffset);
-		// take the minimum of the max amount of bytes and the actual remaining data
-		dataWritten = (dataWritten < pMsg->BufferDataRemaining) ? dataWritten : pMsg->BufferDataRemaining;
-
-		pCanMsg->Length = (E_LibCan_DlcSize_t)(dataWritten + dataOffset);
+		const uint32_t dataWritten = (uint32_t)pInst->TxDl - dataOffset;
 
-		// so far no CAN FD supported
-		pCanMsg->IsBrs = false;		// <- no Bit Rate Switch
-		pCanMsg->IsCanFd = false;	// <- no CAN FD
+		pInst->FlowCtrlSts.CurSequenceNumber = 0U;
+		pInst->FlowCtrlSts.BlockSizeRemaining = 0U;
+		pInst->FlowCtrlSts.BlockSize = 1U;
+		pMsg->IsTxMultiFrame = true;
 
-		memcpy(&pCanMsg->Data[dataOffset], &pMsg->Buffer[pMsg->BufferRWIdx], dataWritten);
+		memcpy(&pCanMsg->Data[dataOffset], pMsg->pTxData, dataWritten);
+		LibCanTpInt_SetFrameLength(pCanMsg, pInst->TxDl);
 		pMsg->BufferRWIdx += dataWritten;
-	//	LibLog_Info("** 8+ ** pCanMsg->Length: %d==%d | buff: %[]X", pCanMsg->Length, LIBCAN_DLCSIZE_8_B, 9, pCanMsg->Data);
-
-		// data written must not be greater than remaining data
-		Lib_Assert(pMsg->BufferDataRemaining >= dataWritten);
 		pMsg->BufferDataRemaining -= dataWritten;
 	}
+	else if (pMsg->IsTxMultiFrame == true)
+	{
+		// CF
+#if (LIBCANTPCFG_TX_BURST_FRAMES > 0U)
+		LibCanTp_TxBurstFill(pInst);
+		return;
+#else
+		LibCanTpInt_SegmentConsecutiveFrame(pInst, pCanMsg);
+#endif
+	}
+	else
+	{
+		//if not MultiFrame just abort this msg
+		LibCanTp_RequestAbort(pInst);
+		return;
+	}
 
 	LibCanTp_HandleTxMessage(pInst);
 }
@@ -67,7 +67,9 @@
 /// | Physical   | 0x6   |  0 |  0 | 0xDA  | N_TA | N_SA |
 /// | Functional | 0x6   |  0 |  0 | 0xDB  | N_TA | N_SA |
 /// 
-/// \param pMsg 
+/// \param pInst
+/// Connection which received the frame
+/// \param pMsg
 /// Received CAN Frame
 /// \param pSrc 
 /// Source address
@@ -76,7 +78,8 @@
 /// \param pIsPhysical
 /// if true functional addressing is used
 // --------------------------------------------------------------------------------------------------------------------
-static void LibCanTpInt_ParseAddrRx_NormalFixed(const S_LibCan_Msg_t* pMsg,
+static void LibCanTpInt_ParseAddrRx_NormalFixed(const S_LibCanTp_Inst_t* pInst,
+												const S_LibCan_Msg_t* pMsg,
 												uint8_t* pSrc, 
 												uint8_t* pTgt, 
 												bool_t* const pIsPhysical);
@@ -84,7 +87,9 @@ static void LibCanTpInt_ParseAddrRx_NormalFixed(const S_LibCan_Msg_t* pMsg,
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief Parse received address in NormalFixedAddressing scheme
 /// 
-/// \param pMsg 
+/// \param pInst
+/// Connection which sends the frame
+/// \param pMsg
 /// CAN Frame that will be sent
 /// \param src 
 /// Source address
@@ -93,13 +98,22 @@ static void LibCanTpInt_ParseAddrRx_NormalFixed(const S_LibCan_Msg_t* pMsg,
 /// \param isPhysical
 /// if true functional addressing is used
 // --------------------------------------------------------------------------------------------------------------------
-static void LibCanTpInt_ParseAddrTx_NormalFixed(S_LibCan_Msg_t* pMsg, 
+static void LibCanTpInt_ParseAddrTx_NormalFixed(const S_LibCanTp_Inst_t* pInst,
+												S_LibCan_Msg_t* pMsg,
 												const uint8_t src, 
 												const uint8_t tgt, 
 												const bool_t isPhysical);
 
 static E_LibCanTp_FrameType_t LibCanTpInt_ParseFrameTypeRx_NormalFixed(const S_LibCan_Msg_t* pMsg);
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Defer the FlowControl ContinueToSend of a connection, N_Br is started
+///
+/// \param pInst
+/// Connection which receives a segmented message
+// --------------------------------------------------------------------------------------------------------------------
+static void LibCanTpInt_DeferFlowControlCts(S_LibCanTp_Inst_t* pInst);
+
 
 // --------------------------------------------------------------------------------------------------------------------
 //	Global Functions
@@ -108,7 +122,8 @@ static E_LibCanTp_FrameType_t LibCanTpInt_ParseFrameTypeRx_NormalFixed(const S_L
 //=====================================================================================================================
 // LibCanTpInt_ParseAddrRx:
 //=====================================================================================================================
-void LibCanTpInt_ParseAddrRx(const S_LibCan_Msg_t* pMsg, 
+void LibCanTpInt_ParseAddrRx(const S_LibCanTp_Inst_t* pInst,
+							 const S_LibCan_Msg_t* pMsg,
 							 uint8_t* pSrc, 
 							 uint8_t* pTgt, 
 							 bool_t* const pIsPhysical)
@@ -116,7 +131,7 @@ void LibCanTpInt_ParseAddrRx(const S_LibCan_Msg_t* pMsg,
 	switch (LIBCANTPCFG_ADDRESSING_SCHEME)
 	{
 		case LIBCANTP_ADDR_SCHEME_NORMAL_FIXED_ADDRESSING:
-			LibCanTpInt_ParseAddrRx_NormalFixed(pMsg, pSrc, pTgt, pIsPhysical);
+			LibCanTpInt_ParseAddrRx_NormalFixed(pInst, pMsg, pSrc, pTgt, pIsPhysical);
 		break;
 		default:
 			LibLog_Error("[TODO] CAN:TP Can not handle this addressing scheme");
@@ -127,7 +142,8 @@ void LibCanTpInt_ParseAddrRx(const S_LibCan_Msg_t* pMsg,
 //=====================================================================================================================
 // LibCanTpInt_ParseAddrTx:
 //=====================================================================================================================
-void LibCanTpInt_ParseAddrTx(S_LibCan_Msg_t* pMsg, 
+void LibCanTpInt_ParseAddrTx(const S_LibCanTp_Inst_t* pInst,
+							 S_LibCan_Msg_t* pMsg,
 							 const uint8_t src, 
 							 const uint8_t tgt, 
 							 const bool_t isPhysical)
@@ -135,7 +151,7 @@ void LibCanTpInt_ParseAddrTx(S_LibCan_Msg_t* pMsg,
 	switch (LIBCANTPCFG_ADDRESSING_SCHEME)
 	{
 		case LIBCANTP_ADDR_SCHEME_NORMAL_FIXED_ADDRESSING:
-			LibCanTpInt_ParseAddrTx_NormalFixed(pMsg, src, tgt, isPhysical);
+			LibCanTpInt_ParseAddrTx_NormalFixed(pInst, pMsg, src, tgt, isPhysical);
 		break;
 		default:
 			LibLog_Error("[TODO] CAN:TP Can not handle this addressing scheme");
@@ -163,6 +179,142 @@ E_LibCanTp_FrameType_t LibCanTpInt_ParseFrameTypeRx(const S_LibCan_Msg_t* pMsg)
 	return type;
 }
 
+//=====================================================================================================================
+// LibCanTpInt_DecodeSepTimeMin_us:
+//=====================================================================================================================
+uint32_t LibCanTpInt_DecodeSepTimeMin_us(const uint8_t sepTimeMin)
+{
+	uint32_t sepTimeMin_us;
+
+	if (sepTimeMin <= UINT8_C(0x7F))
+	{
+		sepTimeMin_us = LIBHRTIMER_MS_TO_US(sepTimeMin);
+	}
+	else if ((sepTimeMin >= UINT8_C(0xF1)) && (sepTimeMin <= UINT8_C(0xF9)))
+	{
+		sepTimeMin_us = (uint32_t)(sepTimeMin - UINT8_C(0xF0)) * UINT32_C(100);
+	}
+	else
+	{
+		sepTimeMin_us = LIBHRTIMER_MS_TO_US(LIBCANTP_SEPARATIONTIMEMINMUM_MAX);
+	}
+
+	return sepTimeMin_us;
+}
+
+//=====================================================================================================================
+// LibCanTpInt_EncodeSepTimeMin:
+//=====================================================================================================================
+uint8_t LibCanTpInt_EncodeSepTimeMin(const uint32_t sepTimeMin_us)
+{
+	uint8_t sepTimeMin;
+
+	if (0U == sepTimeMin_us)
+	{
+		sepTimeMin = UINT8_C(0);
+	}
+	else if (sepTimeMin_us <= UINT32_C(900))
+	{
+		sepTimeMin = (uint8_t)(UINT8_C(0xF0) + ((sepTimeMin_us + UINT32_C(99)) / UINT32_C(100)));
+	}
+	else if (sepTimeMin_us < LIBHRTIMER_MS_TO_US(LIBCANTP_SEPARATIONTIMEMINMUM_MAX))
+	{
+		sepTimeMin = (uint8_t)((sepTimeMin_us + UINT32_C(999)) / UINT32_C(1000));
+	}
+	else
+	{
+		sepTimeMin = (uint8_t)LIBCANTP_SEPARATIONTIMEMINMUM_MAX;
+	}
+
+	return sepTimeMin;
+}
+
+//=====================================================================================================================
+// LibCanTpInt_SendFlowControl:
+//=====================================================================================================================
+void LibCanTpInt_SendFlowControl(S_LibCanTp_Inst_t* pInst,
+								 const E_LibCanTp_FlowStatus_t flowStatus,
+								 const uint8_t blockSize,
+								 const uint8_t sepTimeMin,
+								 const uint8_t src,
+								 const uint8_t tgt,
+								 const bool_t isPhysical)
+{
+	S_LibCan_Msg_t* pCanMsg = pInst->pCanMsg;
+
+	LibCanTpInt_ParseAddrTx(pInst, pCanMsg, src, tgt, isPhysical);
+	pCanMsg->Data[0U] = 0x30U | (uint8_t)flowStatus;		// flow control identifier | flow state
+	pCanMsg->Data[1U] = blockSize;
+	pCanMsg->Data[2U] = sepTimeMin;
+	pCanMsg->Length = LIBCAN_DLCSIZE_3_B;
+	LibCanTp_HandleTxMessage(pInst);
+}
+
+//=====================================================================================================================
+// LibCanTpInt_SegmentConsecutiveFrame:
+//=====================================================================================================================
+void LibCanTpInt_SegmentConsecutiveFrame(S_LibCanTp_Inst_t* pInst, S_LibCan_Msg_t* pCanMsg)
+{
+	S_LibCanTp_DataUnit_t* pMsg = pInst->pDataUnit;
+
+	// Set ID and isExtId
+	LibCanTpInt_ParseAddrTx(pInst, pCanMsg, (uint8_t)pMsg->SourceAddress, (uint8_t)pMsg->TargetAddress, pMsg->IsPhysical);
+	pCanMsg->CanDevId = pInst->DevId;
+	pCanMsg->IsRemote = false;
+
+	pInst->FlowCtrlSts.CurSequenceNumber += 1U;
+	pInst->FlowCtrlSts.CurSequenceNumber &= 0x0FU;	// mod 16
+	pCanMsg->Data[0U] = 0x20U | pInst->FlowCtrlSts.CurSequenceNumber;
+
+	// take the minimum of the max amount of bytes in the frame and the actual remaining data
+	const uint32_t maxDataInFrame = (uint32_t)pInst->TxDl - 1U;
+	const uint32_t dataWritten = (pMsg->BufferDataRemaining < maxDataInFrame) ? pMsg->BufferDataRemaining : maxDataInFrame;
+
+	pCanMsg->IsCanFd = pInst->IsCanFd;
+	pCanMsg->IsBrs = pInst->IsCanFd && LIBCANTPCFG_CANFD_BRS;
+
+	memcpy(&pCanMsg->Data[1U], &pMsg->pTxData[pMsg->BufferRWIdx], dataWritten);
+	LibCanTpInt_SetFrameLength(pCanMsg, (uint8_t)(dataWritten + 1U));
+	pMsg->BufferRWIdx += dataWritten;
+	pMsg->BufferDataRemaining -= dataWritten;
+}
+
+//=====================================================================================================================
+// LibCanTpInt_SetFrameLength:
+//=====================================================================================================================
+void LibCanTpInt_SetFrameLength(S_LibCan_Msg_t* pCanMsg, const uint8_t dataLength)
+{
+	pCanMsg->Length = LibCan_GetMsgDlc(dataLength);
+
+	// ISO 15765-2:2016: the bytes up to the next valid CAN FD data size are padded
+	const uint8_t frameLength = LibCan_GetMsgDataLength(pCanMsg->Length);
+	for (uint8_t idx = dataLength; idx < frameLength; ++idx)
+	{
+		pCanMsg->Data[idx] = (uint8_t)LIBCANTPCFG_FRAMEPADDING;
+	}
+}
+
+//=====================================================================================================================
+// LibCanTpInt_PadFrame:
+//=====================================================================================================================
+void LibCanTpInt_PadFrame(S_LibCan_Msg_t* pCanMsg)
+{
+#if defined(LIBCANTPCFG_FRAMELENGTH) && defined(LIBCANTPCFG_FRAMEPADDING)
+	const uint8_t length = LibCan_GetMsgDataLength(pCanMsg->Length);
+	const uint8_t neededLength = LibCan_GetMsgDataLength((E_LibCan_DlcSize_t)LIBCANTPCFG_FRAMELENGTH);
+	if (length < neededLength)
+	{
+		for (uint8_t idx = length; idx < neededLength; ++idx)
+		{
+			pCanMsg->Data[idx] = (uint8_t)LIBCANTPCFG_FRAMEPADDING;
+		}
+		pCanMsg->Length = (E_LibCan_DlcSize_t)LIBCANTPCFG_FRAMELENGTH;
+	}
+#else
+	LIB_UNUSED(pCanMsg);
+#endif
+}
+
 // --------------------------------------------------------------------------------------------------------------------
 //	Functions
 // --------------------------------------------------------------------------------------------------------------------
@@ -170,15 +322,16 @@ E_LibCanTp_FrameType_t LibCanTpInt_ParseFrameTypeRx(const S_LibCan_Msg_t* pMsg)
 //=====================================================================================================================
 // LibCanTpInt_ParseAddrRx_NormalFixed:
 //=====================================================================================================================
-inline static void LibCanTpInt_ParseAddrRx_NormalFixed(const S_LibCan_Msg_t* pMsg, 
+inline static void LibCanTpInt_ParseAddrRx_NormalFixed(const S_LibCanTp_Inst_t* pInst,
+												       const S_LibCan_Msg_t* pMsg,
 												       uint8_t* pSrc, 
 												       uint8_t* pTgt, 
 												       bool_t* const pIsPhysical)
 {
 #if(LIBCANTP_DIAG_CANID_11BIT)
 	*pSrc = (uint8_t)(pMsg->Id);
-    *pTgt = (uint8_t)(LIBCANTPCFG_ECU_PHYS_ADDRESS);
-	*pIsPhysical = (bool_t)(pMsg->Id == LIBCANTPCFG_TESTER_PHYS_ADDRESS);
+    *pTgt = (uint8_t)(pInst->TxId);
+	*pIsPhysical = pInst->IsPhysical;
 #else
 	const uint8_t addressingType = (uint8_t)((pMsg->Id >> 16U) & 0xFFU);
 	*pSrc = (uint8_t)(pMsg->Id & 0xFFU);
@@ -191,13 +344,14 @@ inline static void LibCanTpInt_ParseAddrRx_NormalFixed(const S_LibCan_Msg_t* pMs
 //=====================================================================================================================
 // LibCanTpInt_ParseAddrTx_NormalFixed:
 //=====================================================================================================================
-inline static void LibCanTpInt_ParseAddrTx_NormalFixed(S_LibCan_Msg_t* pMsg, 
+inline static void LibCanTpInt_ParseAddrTx_NormalFixed(const S_LibCanTp_Inst_t* pInst,
+												       S_LibCan_Msg_t* pMsg,
 												       const uint8_t src, 
 												       const uint8_t tgt, 
 												       const bool_t isPhysical)
 {
 	#if(LIBCANTP_DIAG_CANID_11BIT)
-	pMsg->Id = LIBCANTPCFG_ECU_PHYS_ADDRESS;
+	pMsg->Id = pInst->TxId;
 	pMsg->IsExtId = false;
 	#else
 	const uint8_t addressingType = isPhysical ? 218U : 219U;
@@ -215,6 +369,49 @@ static E_LibCanTp_FrameType_t LibCanTpInt_ParseFrameTypeRx_NormalFixed(const S_L
 	return (E_LibCanTp_FrameType_t)((pMsg->Data[0] >> 4U) & 0x0FU);
 }
 
+//=====================================================================================================================
+// LibCanTpInt_DeferFlowControlCts:
+//=====================================================================================================================
+static void LibCanTpInt_DeferFlowControlCts(S_LibCanTp_Inst_t* pInst)
+{
+	// N_Br is not restarted while the ContinueToSend is already deferred
+	if (!pInst->FlowCtrlSts.IsCtsDeferred)
+	{
+		pInst->FlowCtrlSts.IsCtsDeferred = true;
+		pInst->FlowCtrlSts.WaitCount = 0U;
+		LibHrTimer_Stop(&pInst->Timers.ConsecutiveTimer);
+		LibHrTimer_Stop(&pInst->Timers.FlowControlTimer);
+		LibHrTimer_Start(&pInst->Timers.FlowControlTimer, LIBHRTIMER_MS_TO_US(LIBCANTP_FLOWCONTROL_WAIT_MS));
+	}
+}
+
+//=====================================================================================================================
+// LibCanTpInt_GetRxFrameLength:
+//=====================================================================================================================
+static uint8_t LibCanTpInt_GetRxFrameLength(const S_LibCanTp_Inst_t* pInst)
+{
+	const S_LibCan_Msg_t* const pCanMsg = pInst->pCanMsg;
+	uint8_t frameLength = 0U;
+
+	// the DLC is stored as received: a classic CAN frame with a DLC above 8 carries 8 data bytes (ISO 11898-1)
+	if (pCanMsg->Length <= LIBCAN_DLCSIZE_64_B)
+	{
+		frameLength = LibCan_GetMsgDataLength(pCanMsg->Length);
+		if ((!pInst->IsCanFd) && (frameLength > 8U))
+		{
+			frameLength = 8U;
+		}
+	}
+
+	// a frame longer than the frame buffer or the data length of the connection is not parsed at all
+	if ((frameLength > (uint8_t)LIBCAN_MAXDATABYTENUM) || (frameLength > pInst->TxDl))
+	{
+		frameLength = 0U;
+	}
+
+	return frameLength;
+}
+
 //=====================================================================================================================
 // LibCanTp_HandleSingleFrame:
 //=====================================================================================================================
@@ -222,11 +419,18 @@ void LibCanTp_HandleSingleFrame(S_LibCanTp_Inst_t* pInst)
 {
 	const bool_t isInstReady = LibCanTpFsm_IsReady(pInst);
 	const bool_t isInstRecv  = LibCanTpFsm_IsRecv(pInst);
+	const uint8_t frameLength = LibCanTpInt_GetRxFrameLength(pInst);
 
 	S_LibCan_Msg_t* pMsg = pInst->pCanMsg;
 	uint8_t dataOffset = 1U;
 	uint16_t dataLength;
 	Lib_Assert((NULL != pMsg) && (NULL != pInst));
+
+	if (0U == frameLength)
+	{
+		LibLog_Warning("CAN:TP SF exceeds the frame length and is ignored!");
+		return;
+	}
     
 	//ISO 15765-2:2016(E) 9.8.3 Unexpected arrival of N_PDU
 	//An unexpected N_PDU is defined as one that has been received by a node outside the expected order of N_PDUs.
@@ -238,10 +442,17 @@ void LibCanTp_HandleSingleFrame(S_LibCanTp_Inst_t* pInst)
 	{
 
 		//Jude the DLC is correct or not
-		const uint8_t SingleFrame_DLC = pMsg->Data[0];
-		if(    (pMsg->Length <= SingleFrame_DLC)
+		uint8_t SingleFrame_DLC = pMsg->Data[0];
+		if (frameLength > 8U)
+		{
+			// ISO 15765-2:2016 9.6.2.1: CAN FD frames above 8 bytes use the SF_DL escape sequence
+			SingleFrame_DLC = (0U == (pMsg->Data[0] & 0x0FU)) ? pMsg->Data[1] : 0U;
+			dataOffset++;
+		}
+		if(    (frameLength < (SingleFrame_DLC + dataOffset))
 			|| (SingleFrame_DLC == 0)
-			|| (SingleFrame_DLC > 7)
+			|| ((frameLength <= 8U) && (SingleFrame_DLC > 7))
+			|| ((frameLength > 8U) && (LibCan_GetMsgDlc(SingleFrame_DLC + dataOffset) != pMsg->Length))
 		  )
 		{
 
@@ -262,32 +473,23 @@ void LibCanTp_HandleSingleFrame(S_LibCanTp_Inst_t* pInst)
 			else
 			{
 				//Stop N_Bs
-				LibTimer_Stop(&pInst->Timers.FlowControlTimer); 
+				LibHrTimer_Stop(&pInst->Timers.FlowControlTimer); 
 				//Stop N_Cr
-				LibTimer_Stop(&pInst->Timers.ConsecutiveTimer);
+				LibHrTimer_Stop(&pInst->Timers.ConsecutiveTimer);
 
 				/*Then start processing the new reception*/
 			}
 		}
 
-		const uint8_t frameLength = LibCan_GetMsgDataLength(pInst->pCanMsg->Length);
 		uint8_t srcAddr, tgtAddr;
 		bool_t isPhysical;
 
-		LibCanTpInt_ParseAddrRx(pMsg, &srcAddr, &tgtAddr, &isPhysical);
+		LibCanTpInt_ParseAddrRx(pInst, pMsg, &srcAddr, &tgtAddr, &isPhysical);
 		pInst->pDataUnit->SourceAddress = srcAddr;
 		pInst->pDataUnit->TargetAddress = tgtAddr;
 		pInst->pDataUnit->IsPhysical = isPhysical;
 
-		dataLength = pMsg->Data[0U] & 0x0FU;
-
-		if (dataLength == 0U)
-		{
-			dataLength = pMsg->Data[1U];
-			dataOffset++;
-		}
-
-		Lib_Assert(frameLength >= (dataLength + dataOffset));
+		dataLength = SingleFrame_DLC;
 
 		memcpy(pInst->pDataUnit->Buffer, &pMsg->Data[dataOffset], dataLength);
 		pInst->pDataUnit->Length = dataLength;
@@ -309,9 +511,16 @@ void LibCanTp_HandleFirstFrame(S_LibCanTp_Inst_t* pInst)
 {
 	const bool_t isInstReady = LibCanTpFsm_IsReady(pInst);
 	const bool_t isInstRecv = LibCanTpFsm_IsRecv(pInst);
+	const uint8_t frameLength = LibCanTpInt_GetRxFrameLength(pInst);
 
 	S_LibCan_Msg_t* pCanMsg = pInst->pCanMsg;
 	S_LibCanTp_DataUnit_t* pMsg = pInst->pDataUnit;
+
+	if (0U == frameLength)
+	{
+		LibLog_Warning("CAN:TP FF exceeds the frame length and is ignored!");
+		return;
+	}
     
 	//ISO 15765-2:2016(E) 9.8.3 Unexpected arrival of N_PDU
 	//An unexpected N_PDU is defined as one that has been received by a node outside the expected order of N_PDUs.
@@ -321,16 +530,30 @@ void LibCanTp_HandleFirstFrame(S_LibCanTp_Inst_t* pInst)
 	//if (isInstReady || isInstRecv)
 	if(isInstReady)
 	{
-		const uint8_t frameLength = LibCan_GetMsgDataLength(pInst->pCanMsg->Length);
 		uint8_t srcAddr, tgtAddr;
 		bool_t isPhysical;
-		uint8_t dataOffset = 0U;
+		uint8_t dataOffset = 2U;
 		uint32_t dataLength, dataLengthInFrame;
 
 		//Jude the DLC is correct or not
-		const uint32_t FirstFrame_DLC = 0xFFFU & LDR16_BIG(&pCanMsg->Data[0U]);
+		uint32_t FirstFrame_DLC = 0xFFFU & LDR16_BIG(&pCanMsg->Data[0U]);
+		bool_t isEscape = false;
+
+		// ISO 15765-2:2016 9.6.3.1
+		// Messages larger than 4 095 bytes shall use an escape sequence where the lower nibble of Byte #1 and all bits in
+		// Byte #2 are set to 0 (invalid length). This signifies to the network layer that the value of FF_DL is determined
+		// based on the next 32 bits in the frame (Byte #3 is the MSB and Byte #6 the LSB).
+		if (0U == FirstFrame_DLC)
+		{
+			FirstFrame_DLC = LDR32_BIG(&pCanMsg->Data[2U]);
+			dataOffset += 4U;
+			isEscape = true;
+		}
+
+		// the FF sets RX_DL: 8 for classic CAN, any CAN FD data size above
 		if(    (frameLength < 8)
-			|| (FirstFrame_DLC < 7)
+			|| (FirstFrame_DLC < (uint32_t)(frameLength - 1U))
+			|| (isEscape && (FirstFrame_DLC <= 0xFFFU))
 		  )
 		{
 			LibLog_Warning("CAN:TP get incorrect FF DLC! frameLength[%d] FirstFrame_DLC[%d]",frameLength,FirstFrame_DLC);
@@ -338,16 +561,16 @@ void LibCanTp_HandleFirstFrame(S_LibCanTp_Inst_t* pInst)
 			return;
 		}
 
-		LibCanTpInt_ParseAddrRx(pCanMsg, &srcAddr, &tgtAddr, &isPhysical);
+		LibCanTpInt_ParseAddrRx(pInst, pCanMsg, &srcAddr, &tgtAddr, &isPhysical);
 		if(isPhysical) // Physical addr
 		{
 			//If in Recv Status
 			if(isInstRecv)
 			{
 				//Stop N_Bs
-				LibTimer_Stop(&pInst->Timers.FlowControlTimer); 
+				LibHrTimer_Stop(&pInst->Timers.FlowControlTimer); 
 				//Stop N_Cr
-				LibTimer_Stop(&pInst->Timers.ConsecutiveTimer);
+				LibHrTimer_Stop(&pInst->Timers.ConsecutiveTimer);
 
 				/*Then start processing the new reception*/
 			}	
@@ -364,35 +587,30 @@ void LibCanTp_HandleFirstFrame(S_LibCanTp_Inst_t* pInst)
 		pMsg->IsPhysical = isPhysical;
 		pMsg->IsFinished = false;
 
-		dataLength = 0xFFFU & LDR16_BIG(&pCanMsg->Data[0U]);
-		dataOffset += 2U;
+		dataLength = FirstFrame_DLC;
+		pMsg->RxDl = frameLength;
+		dataLengthInFrame = frameLength - dataOffset;
 
-		// ISO 17565-2 9.6.1
-		// Messages larger than 4 095 bytes shall use an escape sequence where the lower nibble of Byte #1 and all bits in 
-		// Byte #2 are set to 0 (invalid length). This signifies to the network layer that the value of FF_DL is determined 
-		// based on the next 32 bits in the frame (Byte #3 is the MSB and Byte #6 the LSB).
-		if (0U == dataLength)
-		{
-			dataLength = LDR32_BIG(&pCanMsg->Data[3U]);
-			dataOffset += 2U;
-		}
+#if (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+		const Ret_t streamRet = LibCanTp_RxStreamStart(pInst, dataLength, &pCanMsg->Data[dataOffset], dataLengthInFrame);
+#else
+		const Ret_t streamRet = LIBRET_NOT_SUPPORTED;
+#endif
 
-		if (dataLength > LIBCANTPCFG_MULTIFRAME_BUFFER_SIZE)
+		if (    (LIBRET_BUFF_ERR == streamRet)
+			|| ((LIBRET_NOT_SUPPORTED == streamRet) && (dataLength > LIBCANTPCFG_MULTIFRAME_BUFFER_SIZE))
+		   )
 		{
-			LibCanTpInt_ParseAddrTx(pCanMsg, tgtAddr, srcAddr, isPhysical);
-			pCanMsg->Data[0U] = 0x32U;		// flow control identifier | flow state = OVFLW
-			pCanMsg->Data[1U] = UINT8_C(0);
-			pCanMsg->Data[2U] = UINT8_C(0);
-			pCanMsg->Length = LIBCAN_DLCSIZE_3_B;
-			LibCanTp_HandleTxMessage(pInst);
+			LibCanTpInt_SendFlowControl(pInst, LIBCANTP_FLOWSTATUS_OVFLW, 0U, 0U, tgtAddr, srcAddr, isPhysical);
 			LibCanTpFsm_TriggerInit(pInst);
 			LibLog_Warning("CAN:TP incoming message exceeded buffer");
 		}
 		else
 		{
-			dataLengthInFrame = frameLength - dataOffset;
-			
-			memcpy(pMsg->Buffer, &pCanMsg->Data[dataOffset], dataLengthInFrame);
+			if (LIBRET_NOT_SUPPORTED == streamRet)
+			{
+				memcpy(pMsg->Buffer, &pCanMsg->Data[dataOffset], dataLengthInFrame);
+			}
 			pInst->pDataUnit->Length = dataLength;
 			pInst->pDataUnit->BufferRWIdx = dataLengthInFrame;
 			pInst->pDataUnit->BufferDataRemaining = dataLength - dataLengthInFrame;
@@ -404,14 +622,19 @@ void LibCanTp_HandleFirstFrame(S_LibCanTp_Inst_t* pInst)
 			LibLog_Debug("CAN:TP Status - RWIdx = %u Remaining = %u", pMsg->BufferRWIdx, pMsg->BufferDataRemaining);
 
 			LibCanTpFsm_TriggerRecv(pInst);
-			LibDiagCom_StartOfMsg();
-
-			LibCanTpInt_ParseAddrTx(pCanMsg, tgtAddr, srcAddr, isPhysical);
-			pCanMsg->Data[0U] = 0x30U;		// flow control identifier | flow state = CTS
-			pCanMsg->Data[1U] = pInst->FlowCtrlCfg.BlockSize;
-			pCanMsg->Data[2U] = pInst->FlowCtrlCfg.SepTimeMin;
-			pCanMsg->Length = LIBCAN_DLCSIZE_3_B;
-			LibCanTp_HandleTxMessage(pInst);
+			if (LIBRET_NOT_SUPPORTED == streamRet)
+			{
+				// a streamed message is received by the upper layer of the stream, DiagCom is not involved
+				LibDiagCom_StartOfMsg();
+			}
+
+#if (LIBCANTPCFG_FC_ADAPTIVE > 0)
+			// sent after the queued frames are handled, a FirstFrame of another connection shares the free entries
+			LibCanTpInt_DeferFlowControlCts(pInst);
+			LibCanTp_RequestFcDeferred(pInst, false);
+#else
+			LibCanTpInt_SendFlowControlCts(pInst);
+#endif
 		}
 	}
 	else
@@ -426,11 +649,16 @@ void LibCanTp_HandleFirstFrame(S_LibCanTp_Inst_t* pInst)
 void LibCanTp_HandleConsecutiveFrame(S_LibCanTp_Inst_t* pInst)
 {
 	const bool_t isInstRecv = LibCanTpFsm_IsRecv(pInst);
+	const uint8_t frameLength = LibCanTpInt_GetRxFrameLength(pInst);
 
-	if(isInstRecv)
+	if (0U == frameLength)
 	{
-		const uint8_t frameLength = LibCan_GetMsgDataLength(pInst->pCanMsg->Length);
+		LibLog_Warning("CAN:TP CF exceeds the frame length and is ignored!");
+		return;
+	}
 
+	if(isInstRecv)
+	{
 		S_LibCan_Msg_t* pCanMsg = pInst->pCanMsg;
 		S_LibCanTp_DataUnit_t* pMsg = pInst->pDataUnit;
 		uint8_t dataOffset = 0U;
@@ -443,11 +671,11 @@ void LibCanTp_HandleConsecutiveFrame(S_LibCanTp_Inst_t* pInst)
 		//IF not Receive FirstFrame, just abort this msg
 		if(pMsg->IsRxMultiFrame == false)
 		{
-			LibService_SetEvent(&LibCanTp_Service, LIBSERVICE_EV_RE_INIT);
+			LibCanTp_RequestAbort(pInst);
 			return;
 		}
 
-		LibCanTpInt_ParseAddrRx(pCanMsg, &srcAddr, &tgtAddr, &isPhysical);
+		LibCanTpInt_ParseAddrRx(pInst, pCanMsg, &srcAddr, &tgtAddr, &isPhysical);
 		if(!isPhysical) // Function addr
 		{
 			LibLog_Warning("CAN:TP Receive functional addr CF and should be ignored!");
@@ -455,7 +683,7 @@ void LibCanTp_HandleConsecutiveFrame(S_LibCanTp_Inst_t* pInst)
 			/*Ignore the new reception*/
 		}
 
-		LibTimer_Stop(&pInst->Timers.FlowControlTimer); //Stop Timer N_Bs
+		LibHrTimer_Stop(&pInst->Timers.FlowControlTimer); //Stop Timer N_Bs
 
 
 		pMsg->SourceAddress = srcAddr;
@@ -474,7 +702,7 @@ void LibCanTp_HandleConsecutiveFrame(S_LibCanTp_Inst_t* pInst)
 		if (pInst->FlowCtrlSts.CurSequenceNumber != sequenceNumber)
 		{
 			LibDiagCom_Error(LIBDIAGCOM_ERROR_WRONG_SEQUENCE_NUMBER);
-			LibService_SetEvent(&LibCanTp_Service, LIBSERVICE_EV_RE_INIT);
+			LibCanTp_RequestAbort(pInst);
 			return;  //When Error occurs, the following code will not be executed
 		}
 
@@ -488,15 +716,30 @@ void LibCanTp_HandleConsecutiveFrame(S_LibCanTp_Inst_t* pInst)
 
 		// TODO: check for padding bytes
 
-		if (((uint32_t)dataLengthInFrame + pMsg->BufferRWIdx) > LIBCANTPCFG_MULTIFRAME_BUFFER_SIZE)
+#if (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+		if (pInst->RxStream.IsActive)
 		{
-			// TODO Handle Buffer overflow
-			LibDiagCom_Error(LIBDIAGCOM_ERROR_BUFFER_OVERFLOW);
-			LibService_SetEvent(&LibCanTp_Service, LIBSERVICE_EV_RE_INIT);
-			return;  //When Error occurs, the following code will not be executed
+			// the sender ignored the BS limited to the provided segments
+			if (!LibCanTp_RxStreamCopy(pInst, &pCanMsg->Data[dataOffset], dataLengthInFrame))
+			{
+				LibDiagCom_Error(LIBDIAGCOM_ERROR_BUFFER_OVERFLOW);
+				LibCanTp_RequestAbort(pInst);
+				return;  //When Error occurs, the following code will not be executed
+			}
 		}
+		else
+#endif
+		{
+			if (((uint32_t)dataLengthInFrame + pMsg->BufferRWIdx) > LIBCANTPCFG_MULTIFRAME_BUFFER_SIZE)
+			{
+				// TODO Handle Buffer overflow
+				LibDiagCom_Error(LIBDIAGCOM_ERROR_BUFFER_OVERFLOW);
+				LibCanTp_RequestAbort(pInst);
+				return;  //When Error occurs, the following code will not be executed
+			}
 
-		memcpy(&pMsg->Buffer[pMsg->BufferRWIdx], &pCanMsg->Data[dataOffset], dataLengthInFrame);
+			memcpy(&pMsg->Buffer[pMsg->BufferRWIdx], &pCanMsg->Data[dataOffset], dataLengthInFrame);
+		}
 		pMsg->BufferDataRemaining -= dataLengthInFrame;
 		pMsg->BufferRWIdx += dataLengthInFrame;
 
@@ -506,22 +749,32 @@ void LibCanTp_HandleConsecutiveFrame(S_LibCanTp_Inst_t* pInst)
 			pMsg->IsFinished = true;
 			pMsg->IsRxMultiFrame = false;
 			// Stop timer N_Cr
-			LibTimer_Stop(&pInst->Timers.ConsecutiveTimer);
+			LibHrTimer_Stop(&pInst->Timers.ConsecutiveTimer);
 		}
 		else
 		{
-			if(dataLengthInFrame < (LIBCANTPCFG_FRAMELENGTH-1))
+			if(frameLength != pMsg->RxDl)
 			{
-                // Short CF DLC (not last CF)
+                // CF DLC differs from RX_DL (not last CF)
 				LibDiagCom_Error(LIBDIAGCOM_ERROR_INVALIDE_CF);
-				LibService_SetEvent(&LibCanTp_Service, LIBSERVICE_EV_RE_INIT);
+				LibCanTp_RequestAbort(pInst);
 				return;  //When Error occurs, the following code will not be executed
 			}
 			else
 			{
 				// Restart timer N_Cr
-				LibTimer_Stop(&pInst->Timers.ConsecutiveTimer);
-				LibTimer_Start(&pInst->Timers.ConsecutiveTimer, LIBCANTP_CONSECUTIVE_TIMEOUT_MS, UINT32_C(0));
+				LibHrTimer_Stop(&pInst->Timers.ConsecutiveTimer);
+				LibHrTimer_Start(&pInst->Timers.ConsecutiveTimer, LIBHRTIMER_MS_TO_US(LIBCANTP_CONSECUTIVE_TIMEOUT_MS));
+
+				// the block is complete, the sender waits for the next FlowControl
+				if (pInst->FlowCtrlSts.BlockSizeRemaining > 0U)
+				{
+					pInst->FlowCtrlSts.BlockSizeRemaining--;
+					if (0U == pInst->FlowCtrlSts.BlockSizeRemaining)
+					{
+						LibCanTpInt_SendFlowControlCts(pInst);
+					}
+				}
 			}
 		}
 
@@ -548,13 +801,13 @@ void LibCanTp_HandleFlowControl(S_LibCanTp_Inst_t* pInst)
 		//jude physical or functional addr and FC DLC
 		uint8_t srcAddr, tgtAddr;
 		bool_t isPhysical;
-		LibCanTpInt_ParseAddrRx(pMsg, &srcAddr, &tgtAddr, &isPhysical);
+		LibCanTpInt_ParseAddrRx(pInst, pMsg, &srcAddr, &tgtAddr, &isPhysical);
 		if((!isPhysical) || (pMsg->Length < LIBCANTP_FC_DLC_MIN)) 
 		{
 			LibLog_Warning("CAN:TP get invalid FC!");
 			//Abort the Sending and return
 			LibDiagCom_Error(LIBDIAGCOM_ERROR_INVALIDE_FC);
-	        LibService_SetEvent(&LibCanTp_Service, LIBSERVICE_EV_RE_INIT);
+	        LibCanTp_RequestAbort(pInst);
 			return; 
 		}
 
@@ -577,11 +830,14 @@ void LibCanTp_HandleFlowControl(S_LibCanTp_Inst_t* pInst)
 					pInst->FlowCtrlSts.BlockSizeRemaining = bs;
 					pInst->FlowCtrlSts.SeparationTimeMinimum = stmin;
 					//Lib_Assert(0U == stmin);
-					LibCanTpFsm_TriggerSend(pInst);
 					// Stop timer N_Bs
-					LibTimer_Stop(&pInst->Timers.FlowControlTimer);
+					LibHrTimer_Stop(&pInst->Timers.FlowControlTimer);
+					LibCanTpFsm_TriggerSend(pInst);
 
+#if (LIBCANTPCFG_TX_BURST_FRAMES == 0U)
+					// the burst transmission counts the block while segmenting
 					LibCanTp_HandleFlowCtrlStsBlockSize(pInst);
+#endif
 
 				}
 				break;
@@ -593,8 +849,8 @@ void LibCanTp_HandleFlowControl(S_LibCanTp_Inst_t* pInst)
 					// (SeparationTime minimum) in the FlowControl message are not relevant and shall be ignored.
 					LibLog_Warning("[TODO] CAN:TP FC WAIT");
 					// Restart timer N_Bs
-					LibTimer_Stop(&pInst->Timers.FlowControlTimer);
-					LibTimer_Start(&pInst->Timers.FlowControlTimer, LIBCANTP_FLOWCONTROL_TIMEOUT_MS, UINT32_C(0));
+					LibHrTimer_Stop(&pInst->Timers.FlowControlTimer);
+					LibHrTimer_Start(&pInst->Timers.FlowControlTimer, LIBHRTIMER_MS_TO_US(LIBCANTP_FLOWCONTROL_TIMEOUT_MS));
 				break;
 				case 2U: // OVFLW
 					// ISO 17565-2 9.6.5.1
@@ -605,13 +861,19 @@ void LibCanTp_HandleFlowControl(S_LibCanTp_Inst_t* pInst)
 					// FirstFrame N_PDU exceeds the buffer size of the receiving entity. If FlowStatus is set to Overflow, 
 					// the values of BS (BlockSize) and STmin (SeparationTime minimum) in the FlowControl message are not 
 					// relevant and shall be ignored.
-					LibLog_Warning("[TODO] CAN:TP FC OVFLW");
+					LibLog_Warning("CAN:TP FC OVFLW");
+					// N_BUFFER_OVFLW
+					LibDiagCom_Error(LIBDIAGCOM_ERROR_BUFFER_OVERFLOW);
+					LibCanTp_RequestAbort(pInst);
 				break;
 				default:
 					// ISO 17565-2 9.6.5.2
 					// If an FC N_PDU message is received with an invalid (reserved) FS parameter value, the message 
 					// transmission shall be aborted
-					LibLog_Warning("[TODO] CAN:TP Handle reserved flow status");
+					LibLog_Warning("CAN:TP FC reserved FS=%u", fs);
+					// N_INVALID_FS
+					LibDiagCom_Error(LIBDIAGCOM_ERROR_INVALIDE_FC);
+					LibCanTp_RequestAbort(pInst);
 			}
 		}
 		else
@@ -625,6 +887,202 @@ void LibCanTp_HandleFlowControl(S_LibCanTp_Inst_t* pInst)
 	}
 }
 
+//=====================================================================================================================
+// LibCanTpInt_SendFlowControlCts:
+//=====================================================================================================================
+void LibCanTpInt_SendFlowControlCts(S_LibCanTp_Inst_t* pInst)
+{
+	S_LibCanTp_DataUnit_t* pMsg = pInst->pDataUnit;
+	const uint32_t frameDataLength = (uint32_t)pMsg->RxDl - 1U;
+	const uint32_t remainingFrames = (pMsg->BufferDataRemaining + frameDataLength - 1U) / frameDataLength;
+	uint32_t maxFrames = remainingFrames;
+	uint8_t blockSize = pInst->FlowCtrlCfg.BlockSize;
+	uint8_t sepTimeMin = pInst->FlowCtrlCfg.SepTimeMin;
+
+#if (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+	if (pInst->RxStream.IsActive)
+	{
+		// only the frames fitting into the provided segments may be sent in this block
+		const uint32_t streamFrames = LibAtomic_Load(&pInst->RxStream.FreeBytes) / frameDataLength;
+		maxFrames = (streamFrames < maxFrames) ? streamFrames : maxFrames;
+	}
+#endif
+
+#if (LIBCANTPCFG_FC_ADAPTIVE > 0)
+	uint32_t freeFrames, latency_us;
+	LibCanTp_GetRxLoad(pInst, &freeFrames, &latency_us);
+
+	// the sender could overrun the indication queue before the service runs
+	if (((latency_us / LIBCANTPCFG_FC_ADAPTIVE_FRAME_US) + 1U) > freeFrames)
+	{
+		if (freeFrames <= 1U)
+		{
+			// a single frame at most, a ContinueToSend without any free entry is deferred
+			maxFrames = (freeFrames < maxFrames) ? freeFrames : maxFrames;
+		}
+		else
+		{
+			// STmin spreads the frames so that at most the free entries are received within the service latency
+			const uint32_t loadSepTimeMin_us = latency_us / (freeFrames - 1U);
+			const uint8_t loadSepTimeMin = LibCanTpInt_EncodeSepTimeMin(loadSepTimeMin_us);
+
+			if (LibCanTpInt_DecodeSepTimeMin_us(loadSepTimeMin) > LibCanTpInt_DecodeSepTimeMin_us(sepTimeMin))
+			{
+				sepTimeMin = loadSepTimeMin;
+			}
+			// the block ends after a few service runs, the next ContinueToSend adapts to the load again. If even the
+			// longest STmin is too short, the block ends with the free entries.
+			const uint32_t loadFrames = (loadSepTimeMin_us > LIBHRTIMER_MS_TO_US(LIBCANTP_SEPARATIONTIMEMINMUM_MAX)) ?
+										freeFrames : (LIBCANTPCFG_FC_ADAPTIVE_BLOCK_RUNS * (freeFrames - 1U));
+			maxFrames = (loadFrames < maxFrames) ? loadFrames : maxFrames;
+		}
+	}
+#endif
+
+	if (0U == maxFrames)
+	{
+		// ISO 15765-2:2016 9.7.2: the receiver cannot continue, the CTS waits (WAIT is sent each N_Br)
+		LibCanTpInt_DeferFlowControlCts(pInst);
+		return;
+	}
+
+	if ((maxFrames < remainingFrames) && ((0U == blockSize) || (maxFrames < (uint32_t)blockSize)))
+	{
+		blockSize = (maxFrames < UINT32_C(0xFF)) ? (uint8_t)maxFrames : UINT8_C(0xFF);
+	}
+
+	pInst->FlowCtrlSts.IsCtsDeferred = false;
+	LibHrTimer_Stop(&pInst->Timers.FlowControlTimer);
+
+	LibCanTpInt_SendFlowControl(pInst, LIBCANTP_FLOWSTATUS_CTS, blockSize, sepTimeMin, (uint8_t)pMsg->TargetAddress,
+								(uint8_t)pMsg->SourceAddress, pMsg->IsPhysical);
+	pInst->FlowCtrlSts.BlockSizeRemaining = blockSize;
+	pInst->FlowCtrlSts.SeparationTimeMinimum = sepTimeMin;
+}
+
+//=====================================================================================================================
+// LibCanTpInt_HandleFcDeferred:
+//=====================================================================================================================
+void LibCanTpInt_HandleFcDeferred(S_LibCanTp_Inst_t* pInst, const bool_t isWaitTime)
+{
+#if (LIBCANTPCFG_FC_PARAM_WFTMAX > 0U)
+	const bool_t isFirstFrameHeld = pInst->IsFirstFrameHeld;
+	const S_LibCan_Msg_t* pWaitFrame = &pInst->HeldFirstFrame;
+
+	if (isFirstFrameHeld)
+	{
+		if ((!pInst->IsIndicationPending) && (!pInst->IsIndicated))
+		{
+			// the buffer is released: the FirstFrame is handled as if it was received now
+			pInst->IsFirstFrameHeld = false;
+			pInst->FlowCtrlSts.IsCtsDeferred = false;
+			LibHrTimer_Stop(&pInst->Timers.FlowControlTimer);
+			memcpy(pInst->pCanMsg, &pInst->HeldFirstFrame, sizeof(S_LibCan_Msg_t));
+			LibCanTp_HandleFirstFrame(pInst);
+			return;
+		}
+	}
+	else
+#endif
+	{
+		if (LibCanTpFsm_IsRecv(pInst))
+		{
+			LibCanTpInt_SendFlowControlCts(pInst);
+		}
+		else
+		{
+			pInst->FlowCtrlSts.IsCtsDeferred = false;
+		}
+	}
+
+	if (isWaitTime && pInst->FlowCtrlSts.IsCtsDeferred)
+	{
+		if (pInst->FlowCtrlSts.WaitCount < LIBCANTPCFG_FC_PARAM_WFTMAX)
+		{
+			uint8_t srcAddr = (uint8_t)pInst->pDataUnit->SourceAddress;
+			uint8_t tgtAddr = (uint8_t)pInst->pDataUnit->TargetAddress;
+			bool_t isPhysical = pInst->pDataUnit->IsPhysical;
+
+#if (LIBCANTPCFG_FC_PARAM_WFTMAX > 0U)
+			if (isFirstFrameHeld)
+			{
+				// the buffer still holds the addresses of the message processed by DiagCom
+				LibCanTpInt_ParseAddrRx(pInst, pWaitFrame, &srcAddr, &tgtAddr, &isPhysical);
+			}
+#endif
+			pInst->FlowCtrlSts.WaitCount++;
+			LibCanTpInt_SendFlowControl(pInst, LIBCANTP_FLOWSTATUS_WAIT, 0U, 0U, tgtAddr, srcAddr, isPhysical);
+			// the sender does not send ConsecutiveFrames after a WAIT, N_Br restarts
+			LibHrTimer_Stop(&pInst->Timers.ConsecutiveTimer);
+			LibHrTimer_Start(&pInst->Timers.FlowControlTimer, LIBHRTIMER_MS_TO_US(LIBCANTP_FLOWCONTROL_WAIT_MS));
+		}
+		else
+		{
+			LibLog_Warning("CAN:TP Conn [%d] WFTmax reached", pInst->Idx);
+			pInst->FlowCtrlSts.IsCtsDeferred = false;
+#if (LIBCANTPCFG_FC_PARAM_WFTMAX > 0U)
+			if (isFirstFrameHeld)
+			{
+				// the previous message is still processed by DiagCom, only the held FirstFrame is given up
+				LibCanTpInt_DropHeldFirstFrame(pInst);
+			}
+			else
+#endif
+			{
+				LibDiagCom_Error(LIBDIAGCOM_ERROR_FLOWCONTROL_TIMEOUT);
+				LibCanTp_RequestAbort(pInst);
+			}
+		}
+	}
+}
+
+#if (LIBCANTPCFG_FC_PARAM_WFTMAX > 0U)
+//=====================================================================================================================
+// LibCanTpInt_HoldFirstFrame:
+//=====================================================================================================================
+void LibCanTpInt_HoldFirstFrame(S_LibCanTp_Inst_t* pInst, const S_LibCan_Msg_t* pFrame)
+{
+	uint8_t srcAddr, tgtAddr;
+	bool_t isPhysical;
+
+	LibCanTpInt_ParseAddrRx(pInst, pFrame, &srcAddr, &tgtAddr, &isPhysical);
+	if (isPhysical)
+	{
+		// a newer FirstFrame replaces the held one, N_Br runs since the first one
+		memcpy(&pInst->HeldFirstFrame, pFrame, sizeof(S_LibCan_Msg_t));
+		if (!pInst->IsFirstFrameHeld)
+		{
+			pInst->IsFirstFrameHeld = true;
+			pInst->FlowCtrlSts.IsCtsDeferred = true;
+			pInst->FlowCtrlSts.WaitCount = 0U;
+			LibHrTimer_Stop(&pInst->Timers.FlowControlTimer);
+			LibHrTimer_Start(&pInst->Timers.FlowControlTimer, LIBHRTIMER_MS_TO_US(LIBCANTP_FLOWCONTROL_WAIT_MS));
+		}
+		LibLog_Debug("CAN:TP Conn [%d] busy, FirstFrame held", pInst->Idx);
+	}
+	else
+	{
+		LibLog_Warning("CAN:TP Functional Addr FF and shoulde be ignored!");
+	}
+}
+
+//=====================================================================================================================
+// LibCanTpInt_DropHeldFirstFrame:
+//=====================================================================================================================
+void LibCanTpInt_DropHeldFirstFrame(S_LibCanTp_Inst_t* pInst)
+{
+	uint8_t srcAddr, tgtAddr;
+	bool_t isPhysical;
+
+	// OVFLW ends the transfer of the sender at once instead of after its N_Bs
+	LibCanTpInt_ParseAddrRx(pInst, &pInst->HeldFirstFrame, &srcAddr, &tgtAddr, &isPhysical);
+	LibCanTpInt_SendFlowControl(pInst, LIBCANTP_FLOWSTATUS_OVFLW, 0U, 0U, tgtAddr, srcAddr, isPhysical);
+	pInst->IsFirstFrameHeld = false;
+	pInst->FlowCtrlSts.IsCtsDeferred = false;
+	LibHrTimer_Stop(&pInst->Timers.FlowControlTimer);
+}
+#endif // (LIBCANTPCFG_FC_PARAM_WFTMAX > 0U)
+
 //=====================================================================================================================
 // LibCanTp_HandleFlowCtrlStsBlockSize:
 //=====================================================================================================================
@@ -634,8 +1092,8 @@ void LibCanTp_HandleFlowCtrlStsBlockSize(S_LibCanTp_Inst_t* pInst)
 	{
 		pInst->FlowCtrlSts.BlockSizeRemaining --;
 		// Restart timer N_Bs
-		LibTimer_Stop(&pInst->Timers.FlowControlTimer);
-		LibTimer_Start(&pInst->Timers.FlowControlTimer, LIBCANTP_FLOWCONTROL_TIMEOUT_MS, UINT32_C(0));
+		LibHrTimer_Stop(&pInst->Timers.FlowControlTimer);
+		LibHrTimer_Start(&pInst->Timers.FlowControlTimer, LIBHRTIMER_MS_TO_US(LIBCANTP_FLOWCONTROL_TIMEOUT_MS));
 	}
 }
 
@@ -645,8 +1103,9 @@ void LibCanTp_HandleFlowCtrlStsBlockSize(S_LibCanTp_Inst_t* pInst)
 void LibCanTp_TransmissionTimerTimeout(void* pData)
 {
 	//LibLog_Warning("LibCanTpInternal: TransmissionTimerTimeout.");
+	S_LibCanTp_Inst_t* pInst = (S_LibCanTp_Inst_t*)pData;
 	LibDiagCom_Error(LIBDIAGCOM_ERROR_TRANSMISSION_TIMEOUT);
-	LibService_SetEvent(&LibCanTp_Service, LIBSERVICE_EV_RE_INIT);
+	LibCanTp_RequestAbort(pInst);
 }
 
 //=====================================================================================================================
@@ -655,8 +1114,17 @@ void LibCanTp_TransmissionTimerTimeout(void* pData)
 void LibCanTp_FlowControlTimerTimeout(void* pData)
 {
 	//LibLog_Warning("LibCanTpInternal: FlowControlTimerTimeout.");
-	LibDiagCom_Error(LIBDIAGCOM_ERROR_FLOWCONTROL_TIMEOUT);
-	LibService_SetEvent(&LibCanTp_Service, LIBSERVICE_EV_RE_INIT);
+	S_LibCanTp_Inst_t* pInst = (S_LibCanTp_Inst_t*)pData;
+	if (pInst->FlowCtrlSts.IsCtsDeferred)
+	{
+		// N_Br of a deferred FlowControl: the service sends a WAIT
+		LibCanTp_RequestFcDeferred(pInst, true);
+	}
+	else
+	{
+		LibDiagCom_Error(LIBDIAGCOM_ERROR_FLOWCONTROL_TIMEOUT);
+		LibCanTp_RequestAbort(pInst);
+	}
 }
 
 //=====================================================================================================================
@@ -665,8 +1133,9 @@ void LibCanTp_FlowControlTimerTimeout(void* pData)
 void LibCanTp_ConsecutiveTimerTimeout(void* pData)
 {
 	//LibLog_Warning("LibCanTpInternal: ConsecutiveTimerTimeout");
+	S_LibCanTp_Inst_t* pInst = (S_LibCanTp_Inst_t*)pData;
 	LibDiagCom_Error(LIBDIAGCOM_ERROR_CONSECUTIVEFRAME_TIMEOUT);
-	LibService_SetEvent(&LibCanTp_Service, LIBSERVICE_EV_RE_INIT);
+	LibCanTp_RequestAbort(pInst);
 }
 
 
@@ -676,6 +1145,12 @@ void LibCanTp_ConsecutiveTimerTimeout(void* pData)
 void LibCanTp_SeparationTimeMinTimerTimeout(void* pData)
 {
 	S_LibCanTp_Inst_t* pInst = (S_LibCanTp_Inst_t*)pData;
-	LibService_SetEvent(&LibCanTp_Service, LIBCANTP_SRV_EV_REQ);
+#if (LIBCANTPCFG_TX_BURST_FRAMES > 0U)
+	// the next queued CF may be written into a mailbox now
+	LibAtomic_Store(&pInst->TxBurst.IsStMinWait, false);
+	LibCanTp_TxBurstRelease(pInst->DevId);
+#else
+	LibCanTp_RequestSend(pInst);
 	LibCanTp_HandleFlowCtrlStsBlockSize(pInst);
+#endif
 }
@@ -0,0 +1,56 @@
+// --------------------------------------------------------------------------------------------------------------------
+///
+/// \file CanIF.h
+///
+/// \brief Host replacement of the CAN interface for the CAN TP benchmark
+///
+/// CanIF_TxFrame() writes into the simulated transmit mailboxes of CanTpBenchSim.c instead of the bxCAN.
+///
+/// Copyright (c) 2021 Neusoft.
+/// All Rights Reserved.
+///
+// --------------------------------------------------------------------------------------------------------------------
+
+#ifndef CANTPBENCH_CANIF_H__INCLUDED
+#define CANTPBENCH_CANIF_H__INCLUDED
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Includes
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "LibTypes.h"
+#include "LibCanMsg.h"
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Global Data Types
+// --------------------------------------------------------------------------------------------------------------------
+
+// -------------------------------------------------------------------------------------------------------------------- 
+/// \brief Callback invoked when a frame sent by CanIF_TxFrame() left the mailbox
+///
+/// \param pData
+/// User data given to CanIF_TxFrame()
+/// \param isSent
+/// true if the frame was transmitted, false if the transmission was aborted or failed
+// -------------------------------------------------------------------------------------------------------------------- 
+typedef void (*CanIF_TxCompleteClbk)(void* pData, bool_t isSent);
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Global Function Prototypes
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Write a frame into a free simulated transmit mailbox
+///
+/// \param pMsg
+/// Frame to be sent
+/// \param clbk
+/// Called when the frame is sent, may be NULL
+/// \param pData
+/// User data given to clbk
+/// \return
+/// LIBRET_OK if the frame is in a mailbox, LIBRET_BUSY if all mailboxes are in use
+// --------------------------------------------------------------------------------------------------------------------
+extern Ret_t CanIF_TxFrame(const S_LibCan_Msg_t* pMsg, CanIF_TxCompleteClbk clbk, void* pData);
+
+#endif // CANTPBENCH_CANIF_H__INCLUDED
@@ -0,0 +1,37 @@
+// --------------------------------------------------------------------------------------------------------------------
+///
+/// \file CanTask.h
+///
+/// \brief Host replacement of the CAN task interface for the CAN TP benchmark
+///
+/// Only the parts used by LibCanTp: the task is simulated by CanTpBenchSim.c, which moves the frames of
+/// LibCanTp_MsgReqFifo into the simulated transmit mailboxes like the CAN task of the target.
+///
+/// Copyright (c) 2021 Neusoft.
+/// All Rights Reserved.
+///
+// --------------------------------------------------------------------------------------------------------------------
+
+#ifndef CANTPBENCH_CANTASK_H__INCLUDED
+#define CANTPBENCH_CANTASK_H__INCLUDED
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Includes
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "LibTypes.h"
+#include "LibService.h"
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Global Definitions
+// --------------------------------------------------------------------------------------------------------------------
+
+#define EV_CAN_MSG_REQ							UINT32_C(0x00000010)	//!< CAN message request
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Imported Variables
+// --------------------------------------------------------------------------------------------------------------------
+
+extern S_LibService_Inst_t TASK_CAN;
+
+#endif // CANTPBENCH_CANTASK_H__INCLUDED
@@ -0,0 +1,256 @@
+// --------------------------------------------------------------------------------------------------------------------
+///
+/// \file CanTpBench.h
+///
+/// \brief Host benchmark and conformance harness of LibCanTp
+///
+/// LibCanTp, LibCanTpFsm and LibCanTpInternal run unchanged on a Linux host together with LibHrTimer, LibFifoQueue,
+/// LibFsm and LibService. Time is simulated: CanTpBench_Run() advances the clock in steps, the CAN bus transmits
+/// one frame at a time with the duration of the frame at the configured bit rate, and tester peers on the bus
+/// send UDS requests and receive the responses of a DiagCom replacement (echo server).
+///
+/// Copyright (c) 2021 Neusoft.
+/// All Rights Reserved.
+///
+// --------------------------------------------------------------------------------------------------------------------
+
+#ifndef CANTPBENCH_H__INCLUDED
+#define CANTPBENCH_H__INCLUDED
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Includes
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "LibTypes.h"
+#include "LibCanMsg.h"
+#include "LibDiagCom.h"
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Global Definitions
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Number of tester peers, tester n uses connection n * 2 (the physical connections of CanTpBenchCfg.h)
+// --------------------------------------------------------------------------------------------------------------------
+#define CANTPBENCH_TESTERS				(2U)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Step of the simulated clock in microseconds
+// --------------------------------------------------------------------------------------------------------------------
+#define CANTPBENCH_STEP_US				UINT32_C(10)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Largest message of the testers (requests and responses)
+// --------------------------------------------------------------------------------------------------------------------
+#define CANTPBENCH_MAX_MSG_LEN			(4096U)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Tester timeouts in microseconds: N_Bs and N_Cr as a tester uses them for UDS, P2*server
+// --------------------------------------------------------------------------------------------------------------------
+#define CANTPBENCH_TESTER_N_BS_US		UINT32_C(1000000)
+#define CANTPBENCH_TESTER_N_CR_US		UINT32_C(1000000)
+#define CANTPBENCH_TESTER_P2_US			UINT32_C(5000000)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Time the transmit mailboxes of the ECU are not served with CANTPBENCH_FAULT_TX_STALL (longer than N_As),
+/// the frames still in the mailboxes are aborted afterwards like after a bus-off recovery
+// --------------------------------------------------------------------------------------------------------------------
+#define CANTPBENCH_TX_STALL_US			UINT32_C(300000)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Upper limit of the simulated time of one run, a run which takes longer is reported as failed
+// --------------------------------------------------------------------------------------------------------------------
+#define CANTPBENCH_RUN_MAX_US			UINT32_C(120000000)
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Global Data Types
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Fault injected into the first exchange of a scenario, the following exchanges must succeed again
+// --------------------------------------------------------------------------------------------------------------------
+typedef enum E_CanTpBench_Fault_t {
+	CANTPBENCH_FAULT_NONE,
+	CANTPBENCH_FAULT_STOP_CF,			///< tester stops the request after the first ConsecutiveFrame (N_Cr)
+	CANTPBENCH_FAULT_WRONG_SN,			///< tester sends a ConsecutiveFrame with a wrong sequence number
+	CANTPBENCH_FAULT_NO_FC,				///< tester does not answer the FirstFrame of the response (N_Bs)
+	CANTPBENCH_FAULT_FC_OVFLW,			///< tester answers the FirstFrame of the response with OVFLW
+	CANTPBENCH_FAULT_FC_RESERVED,		///< tester answers the FirstFrame of the response with a reserved FlowStatus
+	CANTPBENCH_FAULT_FC_SHORT,			///< tester answers the FirstFrame of the response with a too short FlowControl
+	CANTPBENCH_FAULT_TX_STALL,			///< the transmit mailboxes of the ECU are not served (N_As)
+	CANTPBENCH_FAULT_HELD_FF,			///< tester sends the FirstFrame of another request before the response
+	CANTPBENCH_FAULT_STREAM_STALL,		///< the streaming upper layer keeps the segments of the request (WFTmax)
+	CANTPBENCH_FAULT_DLC_ABOVE_8,		///< tester sends the classic CAN frames of the request with DLC 15 (8 bytes)
+	CANTPBENCH_FAULT_SF_DLC_LONG,		///< tester sends the SingleFrame with escape sequence in a longer frame than
+										///< the SF_DL needs (CAN FD, ignored by the ECU)
+	CANTPBENCH_FAULT_SF_NO_ESCAPE,		///< tester sends a SingleFrame without escape sequence in a CAN FD frame above
+										///< 8 bytes (ignored by the ECU)
+} E_CanTpBench_Fault_t;
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief One benchmark run: the testers send Iterations requests each, one after the other
+// --------------------------------------------------------------------------------------------------------------------
+typedef struct S_CanTpBench_Scenario_t {
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Length of the requests (at least 3 bytes: SID and DID)
+	// ----------------------------------------------------------------------------------------------------------------
+	uint32_t				ReqLen;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Length of the responses (at least 2 bytes)
+	// ----------------------------------------------------------------------------------------------------------------
+	uint32_t				RespLen;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief BS and STmin of the receiver: sent by the testers for responses and by the ECU for requests
+	// ----------------------------------------------------------------------------------------------------------------
+	uint8_t					BlockSize;
+	uint8_t					SepTimeMin;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Number of concurrent testers (1 .. CANTPBENCH_TESTERS)
+	// ----------------------------------------------------------------------------------------------------------------
+	uint32_t				NumTesters;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Requests sent by each tester
+	// ----------------------------------------------------------------------------------------------------------------
+	uint32_t				Iterations;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Time from an event until the CanTP service and the CAN task run (CPU load of the ECU)
+	// ----------------------------------------------------------------------------------------------------------------
+	uint32_t				ServiceLatency_us;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Time DiagCom needs to process a request
+	// ----------------------------------------------------------------------------------------------------------------
+	uint32_t				ProcDelay_us;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Fault injected into the first exchange of tester 0
+	// ----------------------------------------------------------------------------------------------------------------
+	E_CanTpBench_Fault_t	Fault;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief The requests are taken over by the streaming upper layer (LIBCANTPCFG_RX_STREAM_SEGMENTS) instead of
+	/// being received into the connection buffer and handed over to DiagCom
+	// ----------------------------------------------------------------------------------------------------------------
+	bool_t					IsRxStream;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Time the streaming upper layer needs to consume a filled segment before it provides it again
+	// ----------------------------------------------------------------------------------------------------------------
+	uint32_t				StreamDelay_us;
+} S_CanTpBench_Scenario_t;
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Result of a benchmark run
+// --------------------------------------------------------------------------------------------------------------------
+typedef struct S_CanTpBench_Result_t {
+	uint32_t				Done;			///< exchanges completed with a correct response
+	uint32_t				Failed;			///< exchanges with a wrong or missing response (the faulty one included)
+	uint64_t				Bytes;			///< payload of the completed exchanges (request and response)
+	uint32_t				Frames;			///< frames on the bus
+	uint32_t				BusBusy_us;		///< time the bus was busy
+	uint64_t				LatencySum_us;	///< sum of the request to response times of the completed exchanges
+	uint32_t				LatencyMin_us;
+	uint32_t				LatencyMax_us;
+	uint32_t				Time_us;		///< simulated time of the run
+	uint32_t				DiagErrors;		///< number of errors reported by LibCanTp to DiagCom
+	E_LibDiagCom_Error_t	FirstDiagError;	///< first error reported by LibCanTp (0 if none)
+	uint32_t				FirstDiagError_us;	///< time of the first error on the simulated clock
+	uint32_t				FaultAt_us;		///< time the tester injected its fault on the simulated clock (0 if none)
+	uint32_t				Violations;		///< frames sent by the ECU against ISO 15765-2 (e.g. a CF after OVFLW)
+	uint32_t				FcWaits;		///< FlowControl WAIT frames sent by the ECU
+	uint32_t				StMinMax_us;	///< longest STmin of the ContinueToSend FlowControls sent by the ECU
+	uint32_t				StreamAborts;	///< streaming receptions ended with an error
+	uint32_t				StreamErrors;	///< streaming receptions with wrong data, segments kept by LibCanTp after
+											///< the end or a DiagCom notification
+} S_CanTpBench_Result_t;
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Global Function Prototypes
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Initialize the libraries and LibCanTp, called once
+// --------------------------------------------------------------------------------------------------------------------
+extern void CanTpBench_Init(void);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Run a scenario on the simulated clock until all testers are done
+///
+/// \param pScenario
+/// Scenario to be run
+/// \param pResult
+/// Result of the run
+// --------------------------------------------------------------------------------------------------------------------
+extern void CanTpBench_Run(const S_CanTpBench_Scenario_t* pScenario, S_CanTpBench_Result_t* pResult);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Current time of the simulated clock in microseconds
+// --------------------------------------------------------------------------------------------------------------------
+extern uint32_t CanTpBench_GetTime_us(void);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Check the FSM trace of the TP connections: the latest entry is decoded with the state and event names and
+/// every connection records the time in state statistics of its own FSM
+///
+/// \return true if the check passed or the trace is not configured
+// --------------------------------------------------------------------------------------------------------------------
+extern bool_t CanTpBench_CheckFsmTrace(void);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Set up the testers for a run
+///
+/// \param pScenario
+/// Scenario to be run
+// --------------------------------------------------------------------------------------------------------------------
+extern void CanTpBench_TesterStart(const S_CanTpBench_Scenario_t* pScenario);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Advance the testers to the current time (start requests, segment ConsecutiveFrames, timeouts)
+// --------------------------------------------------------------------------------------------------------------------
+extern void CanTpBench_TesterTick(void);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Get the frame a tester wants to send with the lowest identifier (arbitration)
+///
+/// \param pTesterIdx
+/// Index of the tester which owns the frame
+/// \return
+/// The frame, NULL if no tester has a frame to send
+// --------------------------------------------------------------------------------------------------------------------
+extern const S_LibCan_Msg_t* CanTpBench_TesterPeekFrame(uint32_t* pTesterIdx);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief The frame of a tester won the arbitration and is on the bus
+///
+/// \param testerIdx
+/// Index of the tester
+// --------------------------------------------------------------------------------------------------------------------
+extern void CanTpBench_TesterFrameSent(const uint32_t testerIdx);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief A frame sent by the ECU was received by the testers
+///
+/// \param pFrame
+/// The frame
+// --------------------------------------------------------------------------------------------------------------------
+extern void CanTpBench_TesterRx(const S_LibCan_Msg_t* pFrame);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief All testers sent their requests and got the responses (or gave up)
+// --------------------------------------------------------------------------------------------------------------------
+extern bool_t CanTpBench_TesterIsDone(void);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Add the results of the testers to the result of the run
+///
+/// \param pResult
+/// Result of the run
+// --------------------------------------------------------------------------------------------------------------------
+extern void CanTpBench_TesterGetResult(S_CanTpBench_Result_t* pResult);
+
+#endif // CANTPBENCH_H__INCLUDED
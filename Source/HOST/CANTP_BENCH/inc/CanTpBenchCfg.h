@@ -0,0 +1,47 @@
+// --------------------------------------------------------------------------------------------------------------------
+///
+/// \file CanTpBenchCfg.h
+///
+/// \brief Host configuration of LibCanTp for the CAN TP benchmark
+///
+/// Included before every source file of the benchmark build (-include). The configuration of the target is used
+/// unchanged, only the connections are replaced: the physical and the functional connection of the target and a
+/// second physical connection for concurrent transfers. With CANTPBENCH_CANFD all connections use CAN FD framing.
+///
+/// Copyright (c) 2021 Neusoft.
+/// All Rights Reserved.
+///
+// --------------------------------------------------------------------------------------------------------------------
+
+#ifndef CANTPBENCHCFG_H__INCLUDED
+#define CANTPBENCHCFG_H__INCLUDED
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Includes
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "LibCanTpCfg.h"
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Global Definitions
+// --------------------------------------------------------------------------------------------------------------------
+
+#ifdef CANTPBENCH_CANFD
+#define CANTPBENCH_IS_CANFD		true
+#else
+#define CANTPBENCH_IS_CANFD		false
+#endif
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief CAN identifiers of the second physical connection
+// --------------------------------------------------------------------------------------------------------------------
+#define CANTPBENCH_PHYS2_RX_ID	UINT32_C(0x49A)
+#define CANTPBENCH_PHYS2_TX_ID	UINT32_C(0x49B)
+
+#undef LIBCANTPCFG_INSTANCES
+#define LIBCANTPCFG_INSTANCES(ENTRY) \
+	ENTRY(PHYS, LIBDRV_DEVID_MCAN, LIBCANTPCFG_TESTER_PHYS_ADDRESS, LIBCANTPCFG_ECU_PHYS_ADDRESS, true, CANTPBENCH_IS_CANFD) \
+	ENTRY(FUNC, LIBDRV_DEVID_MCAN, LIBCANTPCFG_ECU_FUNC_ADDRESS, LIBCANTPCFG_ECU_PHYS_ADDRESS, false, CANTPBENCH_IS_CANFD) \
+	ENTRY(PHYS2, LIBDRV_DEVID_MCAN, CANTPBENCH_PHYS2_RX_ID, CANTPBENCH_PHYS2_TX_ID, true, CANTPBENCH_IS_CANFD)
+
+#endif // CANTPBENCHCFG_H__INCLUDED
@@ -0,0 +1,27 @@
+// --------------------------------------------------------------------------------------------------------------------
+///
+/// \file FreeRTOS.h
+///
+/// \brief Host replacement of the FreeRTOS header for the CAN TP benchmark
+///
+/// The benchmark runs the libraries single threaded on a simulated clock, nothing of the kernel is used.
+///
+/// Copyright (c) 2021 Neusoft.
+/// All Rights Reserved.
+///
+// --------------------------------------------------------------------------------------------------------------------
+
+#ifndef CANTPBENCH_FREERTOS_H__INCLUDED
+#define CANTPBENCH_FREERTOS_H__INCLUDED
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Global Function Prototypes
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief CMSIS interrupt locks, which the FreeRTOS port of the target includes (defined in CanTpBenchSim.c)
+// --------------------------------------------------------------------------------------------------------------------
+extern void __disable_irq(void);
+extern void __enable_irq(void);
+
+#endif // CANTPBENCH_FREERTOS_H__INCLUDED
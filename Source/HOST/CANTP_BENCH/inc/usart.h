@@ -0,0 +1,15 @@
+// --------------------------------------------------------------------------------------------------------------------
+///
+/// \file usart.h
+///
+/// \brief Host replacement of the CubeMX USART header for the CAN TP benchmark
+///
+/// Copyright (c) 2021 Neusoft.
+/// All Rights Reserved.
+///
+// --------------------------------------------------------------------------------------------------------------------
+
+#ifndef CANTPBENCH_USART_H__INCLUDED
+#define CANTPBENCH_USART_H__INCLUDED
+
+#endif // CANTPBENCH_USART_H__INCLUDED
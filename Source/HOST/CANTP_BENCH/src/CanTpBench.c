@@ -0,0 +1,401 @@
+// --------------------------------------------------------------------------------------------------------------------
+///
+/// \file CanTpBench.c
+///
+/// \brief Scenario matrix of the CAN TP benchmark
+///
+/// Runs SingleFrame and multi-frame exchanges over a matrix of message lengths, BS and STmin in both directions,
+/// concurrent testers, a sweep of the service latency, the fault injection and the streaming scenarios. Prints
+/// throughput (bytes/s and frames/s), latency and bus load of every run and returns 1 if any run failed.
+///
+/// Usage: CanTpBench [iterations]
+///
+/// Copyright (c) 2021 Neusoft.
+/// All Rights Reserved.
+///
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Includes
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "CanTpBench.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Definitions
+// --------------------------------------------------------------------------------------------------------------------
+
+#define CANTPBENCH_ARRAY_SIZE(a)			(sizeof(a) / sizeof((a)[0]))
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Default exchanges per tester and run
+// --------------------------------------------------------------------------------------------------------------------
+#define CANTPBENCH_DEFAULT_ITERATIONS		(10U)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Defaults of the scenarios: the short direction of an exchange, service latency and processing time
+// --------------------------------------------------------------------------------------------------------------------
+#define CANTPBENCH_SHORT_REQ_LEN			(3U)
+#define CANTPBENCH_SHORT_RESP_LEN			(2U)
+#define CANTPBENCH_DEFAULT_LATENCY_US		UINT32_C(100)
+#define CANTPBENCH_DEFAULT_PROC_US			UINT32_C(500)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Length of the multi-frame message of the fault scenarios
+// --------------------------------------------------------------------------------------------------------------------
+#define CANTPBENCH_FAULT_MSG_LEN			(254U)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Latest error of an invalid FlowControl, the transmission is aborted at once instead of after N_Bs
+// --------------------------------------------------------------------------------------------------------------------
+#define CANTPBENCH_FC_ABORT_US				UINT32_C(10000)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Length of the requests of the streaming scenarios, longer than LIBCANTPCFG_MULTIFRAME_BUFFER_SIZE
+// --------------------------------------------------------------------------------------------------------------------
+#define CANTPBENCH_STREAM_MSG_LEN			(4000U)
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Data Types
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Fault, streaming or FlowControl scenario and the expected reaction of LibCanTp
+///
+/// Lengths, times and counts which are 0 take the defaults of the scenarios.
+// --------------------------------------------------------------------------------------------------------------------
+typedef struct S_CanTpBench_Case_t {
+	const char*				pName;
+	E_CanTpBench_Fault_t	Fault;
+	bool_t					IsRequest;			///< the case needs a multi-frame request, otherwise a multi-frame response
+	uint32_t				MsgLen;				///< length of the multi-frame message (CANTPBENCH_FAULT_MSG_LEN)
+	bool_t					IsRxStream;			///< the requests are taken over by the streaming upper layer
+	uint32_t				StreamDelay_us;		///< time the streaming upper layer keeps a filled segment
+	uint32_t				NumTesters;
+	uint32_t				ServiceLatency_us;
+	uint32_t				ProcDelay_us;
+
+	bool_t					IsExchangeKept;		///< the faulty exchange completes in spite of the fault
+	E_LibDiagCom_Error_t	ExpectedError;		///< first error reported to DiagCom, 0 if not checked
+	uint32_t				MaxErrorDelay_us;	///< latest time of that error after the injected fault, 0 if not checked
+	bool_t					IsFcWaitExpected;	///< the ECU must send WAIT FlowControls, otherwise it must not
+	bool_t					IsStMinAdapted;		///< the ECU must raise STmin to the service latency
+} S_CanTpBench_Case_t;
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Function Prototypes
+// --------------------------------------------------------------------------------------------------------------------
+
+static uint32_t CanTpBench_RunCases(const char* pPrefix, const S_CanTpBench_Case_t* pCases, const uint32_t numCases,
+									const uint32_t iterations);
+static bool_t CanTpBench_RunOne(const char* pName, const S_CanTpBench_Scenario_t* pScenario,
+								const S_CanTpBench_Case_t* pCase);
+static void CanTpBench_InitScenario(S_CanTpBench_Scenario_t* pScenario, const uint32_t iterations);
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Variables
+// --------------------------------------------------------------------------------------------------------------------
+
+static const uint32_t CanTpBench_MsgLengths[] = { 6U, 62U, 254U, 1024U, 1300U };
+static const uint8_t CanTpBench_BlockSizes[] = { 0U, 8U, 32U };
+static const uint8_t CanTpBench_SepTimeMins[] = { 0x00U, 0xF5U, 0x01U };
+static const uint32_t CanTpBench_Latencies_us[] = { 100U, 1000U, 3000U };
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Faults of the testers and the ECU: the faulty exchange fails unless it is kept, LibCanTp recovers for the
+/// following ones
+// --------------------------------------------------------------------------------------------------------------------
+static const S_CanTpBench_Case_t CanTpBench_FaultCases[] = {
+	{ .pName = "stop CF (N_Cr)", .Fault = CANTPBENCH_FAULT_STOP_CF, .IsRequest = true,
+	  .ExpectedError = LIBDIAGCOM_ERROR_CONSECUTIVEFRAME_TIMEOUT },
+	{ .pName = "wrong SN", .Fault = CANTPBENCH_FAULT_WRONG_SN, .IsRequest = true,
+	  .ExpectedError = LIBDIAGCOM_ERROR_WRONG_SEQUENCE_NUMBER },
+	{ .pName = "no FC (N_Bs)", .Fault = CANTPBENCH_FAULT_NO_FC,
+	  .ExpectedError = LIBDIAGCOM_ERROR_FLOWCONTROL_TIMEOUT },
+	{ .pName = "FC OVFLW", .Fault = CANTPBENCH_FAULT_FC_OVFLW,
+	  .ExpectedError = LIBDIAGCOM_ERROR_BUFFER_OVERFLOW, .MaxErrorDelay_us = CANTPBENCH_FC_ABORT_US },
+	{ .pName = "FC reserved FS", .Fault = CANTPBENCH_FAULT_FC_RESERVED,
+	  .ExpectedError = LIBDIAGCOM_ERROR_INVALIDE_FC, .MaxErrorDelay_us = CANTPBENCH_FC_ABORT_US },
+	{ .pName = "FC too short", .Fault = CANTPBENCH_FAULT_FC_SHORT,
+	  .ExpectedError = LIBDIAGCOM_ERROR_INVALIDE_FC, .MaxErrorDelay_us = CANTPBENCH_FC_ABORT_US },
+	{ .pName = "TX stall (N_As)", .Fault = CANTPBENCH_FAULT_TX_STALL,
+	  .ExpectedError = LIBDIAGCOM_ERROR_TRANSMISSION_TIMEOUT },
+#ifdef CANTPBENCH_CANFD
+	{ .pName = "SF escape long DLC", .Fault = CANTPBENCH_FAULT_SF_DLC_LONG, .IsRequest = true, .MsgLen = 20U },
+	{ .pName = "SF no escape", .Fault = CANTPBENCH_FAULT_SF_NO_ESCAPE, .IsRequest = true, .MsgLen = 5U },
+#else
+	{ .pName = "classic DLC 15", .Fault = CANTPBENCH_FAULT_DLC_ABOVE_8, .IsRequest = true, .IsExchangeKept = true },
+#endif
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief FlowControl of the ECU as receiver: a FirstFrame held while DiagCom processes the previous request is
+/// rejected with OVFLW when the response is sent or WFTmax is reached, and STmin is raised on a loaded ECU
+// --------------------------------------------------------------------------------------------------------------------
+static const S_CanTpBench_Case_t CanTpBench_FcCases[] = {
+	{ .pName = "held FF, response", .Fault = CANTPBENCH_FAULT_HELD_FF, .IsRequest = true,
+	  .ProcDelay_us = 250000U, .IsExchangeKept = true, .IsFcWaitExpected = true },
+	{ .pName = "held FF, WFTmax", .Fault = CANTPBENCH_FAULT_HELD_FF, .IsRequest = true,
+	  .ProcDelay_us = 1500000U, .IsExchangeKept = true, .IsFcWaitExpected = true },
+	{ .pName = "adaptive STmin", .IsRequest = true, .MsgLen = 1024U, .NumTesters = CANTPBENCH_TESTERS,
+	  .ServiceLatency_us = 3000U, .IsStMinAdapted = (LIBCANTPCFG_FC_ADAPTIVE > 0) },
+};
+
+#if (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Streaming reception: segments returned at once, the ContinueToSend deferred until a segment is returned
+/// (within and beyond N_Br, beyond WFTmax) and the segments returned to the upper layer when the reception is aborted
+// --------------------------------------------------------------------------------------------------------------------
+static const S_CanTpBench_Case_t CanTpBench_StreamCases[] = {
+	{ .pName = "no delay", .IsRequest = true, .MsgLen = CANTPBENCH_STREAM_MSG_LEN, .IsRxStream = true },
+	{ .pName = "deferred CTS", .IsRequest = true, .MsgLen = CANTPBENCH_STREAM_MSG_LEN, .IsRxStream = true,
+	  .StreamDelay_us = 30000U },
+	{ .pName = "WAIT (N_Br)", .IsRequest = true, .MsgLen = CANTPBENCH_STREAM_MSG_LEN, .IsRxStream = true,
+	  .StreamDelay_us = 150000U, .IsFcWaitExpected = true },
+	{ .pName = "WFTmax", .Fault = CANTPBENCH_FAULT_STREAM_STALL, .IsRequest = true,
+	  .MsgLen = CANTPBENCH_STREAM_MSG_LEN, .IsRxStream = true, .ExpectedError = LIBDIAGCOM_ERROR_FLOWCONTROL_TIMEOUT,
+	  .IsFcWaitExpected = true },
+	{ .pName = "abort stop CF", .Fault = CANTPBENCH_FAULT_STOP_CF, .IsRequest = true,
+	  .MsgLen = CANTPBENCH_STREAM_MSG_LEN, .IsRxStream = true,
+	  .ExpectedError = LIBDIAGCOM_ERROR_CONSECUTIVEFRAME_TIMEOUT },
+	{ .pName = "abort wrong SN", .Fault = CANTPBENCH_FAULT_WRONG_SN, .IsRequest = true,
+	  .MsgLen = CANTPBENCH_STREAM_MSG_LEN, .IsRxStream = true, .StreamDelay_us = 30000U,
+	  .ExpectedError = LIBDIAGCOM_ERROR_WRONG_SEQUENCE_NUMBER },
+};
+#endif
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Global Functions
+// --------------------------------------------------------------------------------------------------------------------
+
+//=====================================================================================================================
+// main:
+//=====================================================================================================================
+int main(int argc, char** argv)
+{
+	const uint32_t iterations = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : CANTPBENCH_DEFAULT_ITERATIONS;
+	S_CanTpBench_Scenario_t scenario;
+	uint32_t failed = 0U;
+	char name[64];
+
+	CanTpBench_Init();
+
+	printf("%-34s %9s %8s %9s %9s %9s %6s %s\n", "scenario", "bytes/s", "frames/s", "lat avg", "lat min",
+		   "lat max", "bus %", "result");
+
+	// throughput matrix: long responses to short requests and long requests with short responses
+	for (uint32_t dir = 0U; dir < 2U; dir++)
+	{
+		for (uint32_t l = 0U; l < CANTPBENCH_ARRAY_SIZE(CanTpBench_MsgLengths); l++)
+		{
+			for (uint32_t b = 0U; b < CANTPBENCH_ARRAY_SIZE(CanTpBench_BlockSizes); b++)
+			{
+				for (uint32_t s = 0U; s < CANTPBENCH_ARRAY_SIZE(CanTpBench_SepTimeMins); s++)
+				{
+					CanTpBench_InitScenario(&scenario, iterations);
+					scenario.BlockSize  = CanTpBench_BlockSizes[b];
+					scenario.SepTimeMin = CanTpBench_SepTimeMins[s];
+					if (0U == dir)
+					{
+						scenario.RespLen = CanTpBench_MsgLengths[l];
+					}
+					else
+					{
+						scenario.ReqLen = CanTpBench_MsgLengths[l];
+					}
+
+					(void)snprintf(name, sizeof(name), "%s %4u BS %2u STmin 0x%02X", (0U == dir) ? "resp" : "req ",
+								   CanTpBench_MsgLengths[l], scenario.BlockSize, scenario.SepTimeMin);
+					failed += CanTpBench_RunOne(name, &scenario, NULL) ? 0U : 1U;
+				}
+			}
+		}
+	}
+
+	// concurrent testers on both physical connections
+	for (uint32_t dir = 0U; dir < 2U; dir++)
+	{
+		CanTpBench_InitScenario(&scenario, iterations);
+		scenario.NumTesters = CANTPBENCH_TESTERS;
+		if (0U == dir)
+		{
+			scenario.RespLen = 1024U;
+		}
+		else
+		{
+			scenario.ReqLen = 1024U;
+		}
+
+		(void)snprintf(name, sizeof(name), "%s 1024 x%u testers", (0U == dir) ? "resp" : "req ", CANTPBENCH_TESTERS);
+		failed += CanTpBench_RunOne(name, &scenario, NULL) ? 0U : 1U;
+	}
+
+	// latency of the CAN task and the CanTP service (CPU load)
+	for (uint32_t i = 0U; i < CANTPBENCH_ARRAY_SIZE(CanTpBench_Latencies_us); i++)
+	{
+		for (uint32_t dir = 0U; dir < 2U; dir++)
+		{
+			CanTpBench_InitScenario(&scenario, iterations);
+			scenario.NumTesters        = CANTPBENCH_TESTERS;
+			scenario.ServiceLatency_us = CanTpBench_Latencies_us[i];
+			if (0U == dir)
+			{
+				scenario.RespLen = 1024U;
+			}
+			else
+			{
+				scenario.ReqLen = 1024U;
+			}
+
+			(void)snprintf(name, sizeof(name), "%s 1024 x%u latency %4u us", (0U == dir) ? "resp" : "req ",
+						   CANTPBENCH_TESTERS, scenario.ServiceLatency_us);
+			failed += CanTpBench_RunOne(name, &scenario, NULL) ? 0U : 1U;
+		}
+	}
+
+	failed += CanTpBench_RunCases("fault", CanTpBench_FaultCases, CANTPBENCH_ARRAY_SIZE(CanTpBench_FaultCases),
+								  iterations);
+	failed += CanTpBench_RunCases("fc", CanTpBench_FcCases, CANTPBENCH_ARRAY_SIZE(CanTpBench_FcCases), iterations);
+#if (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+	// streaming reception of requests longer than the connection buffer
+	failed += CanTpBench_RunCases("stream", CanTpBench_StreamCases, CANTPBENCH_ARRAY_SIZE(CanTpBench_StreamCases),
+								  iterations);
+#endif
+
+	failed += CanTpBench_CheckFsmTrace() ? 0U : 1U;
+
+	printf("%u run(s) failed\n", failed);
+	return (0U == failed) ? 0 : 1;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Functions
+// --------------------------------------------------------------------------------------------------------------------
+
+//=====================================================================================================================
+// CanTpBench_RunCases:
+//=====================================================================================================================
+static uint32_t CanTpBench_RunCases(const char* pPrefix, const S_CanTpBench_Case_t* pCases, const uint32_t numCases,
+									const uint32_t iterations)
+{
+	S_CanTpBench_Scenario_t scenario;
+	uint32_t failed = 0U;
+	char name[64];
+
+	for (uint32_t i = 0U; i < numCases; i++)
+	{
+		const S_CanTpBench_Case_t* const pCase = &pCases[i];
+		const uint32_t msgLen = (0U != pCase->MsgLen) ? pCase->MsgLen : CANTPBENCH_FAULT_MSG_LEN;
+
+		CanTpBench_InitScenario(&scenario, iterations);
+		scenario.Fault          = pCase->Fault;
+		scenario.IsRxStream     = pCase->IsRxStream;
+		scenario.StreamDelay_us = pCase->StreamDelay_us;
+		if (pCase->IsRequest)
+		{
+			scenario.ReqLen = msgLen;
+		}
+		else
+		{
+			scenario.RespLen = msgLen;
+		}
+		if (0U != pCase->NumTesters)
+		{
+			scenario.NumTesters = pCase->NumTesters;
+		}
+		if (0U != pCase->ServiceLatency_us)
+		{
+			scenario.ServiceLatency_us = pCase->ServiceLatency_us;
+		}
+		if (0U != pCase->ProcDelay_us)
+		{
+			scenario.ProcDelay_us = pCase->ProcDelay_us;
+		}
+
+		(void)snprintf(name, sizeof(name), "%s %s", pPrefix, pCase->pName);
+		failed += CanTpBench_RunOne(name, &scenario, pCase) ? 0U : 1U;
+	}
+
+	return failed;
+}
+
+//=====================================================================================================================
+// CanTpBench_RunOne:
+//=====================================================================================================================
+static bool_t CanTpBench_RunOne(const char* pName, const S_CanTpBench_Scenario_t* pScenario,
+								const S_CanTpBench_Case_t* pCase)
+{
+	S_CanTpBench_Result_t result;
+	const uint32_t exchanges = pScenario->NumTesters * pScenario->Iterations;
+	const bool_t isLost = (CANTPBENCH_FAULT_NONE != pScenario->Fault) && ((NULL == pCase) || (!pCase->IsExchangeKept));
+	bool_t isPassed;
+
+	CanTpBench_Run(pScenario, &result);
+
+	// the faulty exchange fails, a streamed one is aborted with its segments returned to the upper layer
+	isPassed = ((isLost ? (exchanges - 1U) : exchanges) == result.Done) && (0U == result.Violations)
+			   && (0U == result.StreamErrors) && (((pScenario->IsRxStream && isLost) ? 1U : 0U) == result.StreamAborts);
+	if (!isLost)
+	{
+		isPassed = isPassed && (0U == result.DiagErrors);
+	}
+	if (NULL != pCase)
+	{
+		// the cases run with STmin 0: any STmin of the ECU is raised for the load
+		isPassed = isPassed && (pCase->IsFcWaitExpected == (0U != result.FcWaits))
+				   && ((!pCase->IsStMinAdapted) || (pCase->ServiceLatency_us <= result.StMinMax_us))
+				   && ((0 == pCase->ExpectedError) || (pCase->ExpectedError == result.FirstDiagError));
+		if (0U != pCase->MaxErrorDelay_us)
+		{
+			isPassed = isPassed && (0U != result.FaultAt_us) && (0U != result.DiagErrors)
+					   && ((result.FirstDiagError_us - result.FaultAt_us) <= pCase->MaxErrorDelay_us);
+		}
+	}
+
+	const double time_s = (double)result.Time_us / 1e6;
+	printf("%-34s %9.0f %8.0f %9llu %9u %9u %6.1f %s", pName, (double)result.Bytes / time_s,
+		   (double)result.Frames / time_s,
+		   (0U != result.Done) ? (unsigned long long)(result.LatencySum_us / result.Done) : 0ULL,
+		   result.LatencyMin_us, result.LatencyMax_us, (100.0 * result.BusBusy_us) / result.Time_us,
+		   isPassed ? "PASS" : "FAIL");
+	if ((0U != result.DiagErrors) || (0U != result.Violations) || (0U != result.Failed))
+	{
+		printf(" (failed %u, errors %u first 0x%02X, violations %u)", result.Failed, result.DiagErrors,
+			   (unsigned)result.FirstDiagError, result.Violations);
+	}
+	if ((0U != result.FaultAt_us) && (0U != result.DiagErrors))
+	{
+		printf(" (error after %u us)", result.FirstDiagError_us - result.FaultAt_us);
+	}
+	if ((0U != result.FcWaits) || (0U != result.StreamAborts) || (0U != result.StreamErrors))
+	{
+		printf(" (FC WAIT %u, stream aborts %u errors %u)", result.FcWaits, result.StreamAborts, result.StreamErrors);
+	}
+	if ((NULL != pCase) && (0U != result.StMinMax_us))
+	{
+		printf(" (STmin max %u us)", result.StMinMax_us);
+	}
+	printf("\n");
+
+	return isPassed;
+}
+
+//=====================================================================================================================
+// CanTpBench_InitScenario:
+//=====================================================================================================================
+static void CanTpBench_InitScenario(S_CanTpBench_Scenario_t* pScenario, const uint32_t iterations)
+{
+	pScenario->ReqLen            = CANTPBENCH_SHORT_REQ_LEN;
+	pScenario->RespLen           = CANTPBENCH_SHORT_RESP_LEN;
+	pScenario->BlockSize         = 0U;
+	pScenario->SepTimeMin        = 0U;
+	pScenario->NumTesters        = 1U;
+	pScenario->Iterations        = iterations;
+	pScenario->ServiceLatency_us = CANTPBENCH_DEFAULT_LATENCY_US;
+	pScenario->ProcDelay_us      = CANTPBENCH_DEFAULT_PROC_US;
+	pScenario->Fault             = CANTPBENCH_FAULT_NONE;
+	pScenario->IsRxStream        = false;
+	pScenario->StreamDelay_us    = 0U;
+}
@@ -0,0 +1,949 @@
+// --------------------------------------------------------------------------------------------------------------------
+///
+/// \file CanTpBenchSim.c
+///
+/// \brief Simulated environment of LibCanTp for the CAN TP benchmark
+///
+/// Replaces everything LibCanTp needs from the target: the simulated clock drives LibHrTimer, the CAN task moves
+/// LibCanTp_MsgReqFifo into three transmit mailboxes, the service host runs LibCanTp_Service, and the CAN bus
+/// arbitrates between the mailboxes of the ECU and the frames of the testers. DiagCom is replaced by an echo server
+/// which checks the request and answers with a response of the configured length. A streaming upper layer on the
+/// connections of the testers takes over the requests of the streaming scenarios instead of DiagCom.
+///
+/// Copyright (c) 2021 Neusoft.
+/// All Rights Reserved.
+///
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Includes
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "CanTpBench.h"
+#include "CanIF.h"
+#include "CanTask.h"
+
+#include "LibCanTp.h"
+#include "LibCanTpFsm.h"
+#include "LibCanTpInternal.h"
+#include "LibDiagCom.h"
+#include "LibDiagComInt.h"
+#include "LibFifoQueue.h"
+#include "LibHrTimer.h"
+#include "LibService.h"
+#include "LibServiceHost.h"
+#include <stdio.h>
+#include <string.h>
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Definitions
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Number of transmit mailboxes of the ECU (bxCAN), sent by the priority of the identifier
+// --------------------------------------------------------------------------------------------------------------------
+#define CANTPBENCH_TX_MAILBOXES			(3U)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Number of LibCanTp connections of CanTpBenchCfg.h
+// --------------------------------------------------------------------------------------------------------------------
+#define CANTPBENCH_COUNT_INST(name, ...)	+1U
+#define CANTPBENCH_INST_COUNT			(0U LIBCANTPCFG_INSTANCES(CANTPBENCH_COUNT_INST))
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Nominal bit time (500 kbit/s), the data phase of CAN FD frames runs at 4 times the nominal bit rate
+// --------------------------------------------------------------------------------------------------------------------
+#define CANTPBENCH_BIT_TIME_NS			UINT32_C(2000)
+#define CANTPBENCH_FD_DATA_FACTOR		UINT32_C(4)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Service function calls per service run, the service host of the target loops while events are pending
+// --------------------------------------------------------------------------------------------------------------------
+#define CANTPBENCH_SERVICE_LOOPS		(16U)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Service identifier of the requests and the negative response code for a corrupted request
+// --------------------------------------------------------------------------------------------------------------------
+#define CANTPBENCH_NRC_SID				(0x7FU)
+#define CANTPBENCH_NRC_INVALID_FORMAT	(0x13U)
+
+#if (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Segments of the streaming upper layer per connection (as many as LibCanTp queues) and their size
+// --------------------------------------------------------------------------------------------------------------------
+#define CANTPBENCH_STREAM_SEGMENTS		LIBCANTPCFG_RX_STREAM_SEGMENTS
+#define CANTPBENCH_STREAM_SEGMENT_LEN	(256U)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Largest response of the streaming upper layer
+// --------------------------------------------------------------------------------------------------------------------
+#define CANTPBENCH_STREAM_RESP_LEN		(64U)
+#endif // (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Data Types
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Transmit mailbox of the ECU
+// --------------------------------------------------------------------------------------------------------------------
+typedef struct S_CanTpBench_Mailbox_t {
+	S_LibCan_Msg_t			Frame;
+	CanIF_TxCompleteClbk	Clbk;
+	void*					pData;
+} S_CanTpBench_Mailbox_t;
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief State of the simulated CAN bus
+// --------------------------------------------------------------------------------------------------------------------
+typedef struct S_CanTpBench_Bus_t {
+	bool_t					IsBusy;
+	bool_t					IsEcuFrame;		///< the frame on the bus comes from a mailbox of the ECU
+	uint32_t				TesterIdx;		///< owner of the frame on the bus if it does not come from the ECU
+	uint32_t				End_us;			///< end of the frame on the bus
+	S_CanTpBench_Mailbox_t	Mailbox;		///< frame on the bus
+} S_CanTpBench_Bus_t;
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief State of the DiagCom echo server
+// --------------------------------------------------------------------------------------------------------------------
+typedef struct S_CanTpBench_DiagCom_t {
+	S_LibDiagCom_Msg_t		Msg;
+	bool_t					IsBusy;
+	uint32_t				RespAt_us;
+} S_CanTpBench_DiagCom_t;
+
+#if (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Owner of a segment of the streaming upper layer
+// --------------------------------------------------------------------------------------------------------------------
+typedef enum E_CanTpBench_SegmentState_t {
+	CANTPBENCH_SEGMENT_FREE,		///< owned by the upper layer
+	CANTPBENCH_SEGMENT_PROVIDED,	///< provided to LibCanTp and not handed over yet
+	CANTPBENCH_SEGMENT_CONSUMING,	///< handed over filled, provided again after StreamDelay_us
+} E_CanTpBench_SegmentState_t;
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Streaming upper layer of a tester connection: checks the request while it is received and answers it
+// --------------------------------------------------------------------------------------------------------------------
+typedef struct S_CanTpBench_Stream_t {
+	uint8_t						ConnId;
+	uint8_t						Segments[CANTPBENCH_STREAM_SEGMENTS][CANTPBENCH_STREAM_SEGMENT_LEN];
+	E_CanTpBench_SegmentState_t	SegmentStates[CANTPBENCH_STREAM_SEGMENTS];
+	uint32_t					ReturnAt_us[CANTPBENCH_STREAM_SEGMENTS];
+	bool_t						IsActive;		///< a message is streamed
+	bool_t						IsStalled;		///< the filled segments are kept (CANTPBENCH_FAULT_STREAM_STALL)
+	uint32_t					MsgLen;
+	uint32_t					RxIdx;			///< bytes of the message handed over
+	uint8_t						Sid;
+	bool_t						IsValid;		///< the handed over bytes match the request of the testers
+	bool_t						IsRespPending;
+	uint32_t					RespAt_us;
+	uint32_t					TgtAddr;
+	S_LibDiagCom_Msg_t			Resp;
+	uint8_t						RespBuf[CANTPBENCH_STREAM_RESP_LEN];
+} S_CanTpBench_Stream_t;
+#endif // (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Function Prototypes
+// --------------------------------------------------------------------------------------------------------------------
+
+static void CanTpBench_Step(void);
+static void CanTpBench_BusTick(void);
+static void CanTpBench_TaskTick(void);
+static void CanTpBench_ServiceTick(void);
+static void CanTpBench_DiagComTick(void);
+static void CanTpBench_StallTick(void);
+static void CanTpBench_FillResponse(uint8_t* pResp, const uint8_t sid);
+#if (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+static void CanTpBench_StreamTick(void);
+static bool_t CanTpBench_StreamStart(void* pUserData, const uint32_t msgLength, const uint8_t* pData,
+									 const uint32_t dataLength);
+static void CanTpBench_StreamSegment(void* pUserData, uint8_t* pSegment, const uint32_t length);
+static void CanTpBench_StreamEnd(void* pUserData, const Ret_t result);
+#endif
+static bool_t CanTpBench_MailboxPut(const S_LibCan_Msg_t* pMsg, CanIF_TxCompleteClbk clbk, void* pData);
+static uint32_t CanTpBench_FrameTime_us(const S_LibCan_Msg_t* pMsg);
+static bool_t CanTpBench_IsElapsed(const uint32_t time_us);
+static bool_t CanTpBench_IsIdle(void);
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Global Variables
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief CAN task of the target, only its events are used by LibCanTp
+// --------------------------------------------------------------------------------------------------------------------
+S_LibService_Inst_t TASK_CAN = LIBSERVICE_INIT_SERVICE(NULL, NULL);
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Variables
+// --------------------------------------------------------------------------------------------------------------------
+
+static const S_CanTpBench_Scenario_t* CanTpBench_pScenario;
+static uint32_t CanTpBench_Time_us;
+
+static S_CanTpBench_Mailbox_t CanTpBench_Mailboxes[CANTPBENCH_TX_MAILBOXES];
+static uint32_t CanTpBench_MailboxCount;
+static S_CanTpBench_Bus_t CanTpBench_Bus;
+static S_CanTpBench_DiagCom_t CanTpBench_DiagCom;
+
+static bool_t CanTpBench_IsTaskPending;
+static uint32_t CanTpBench_TaskSince_us;
+static bool_t CanTpBench_IsServicePending;
+static uint32_t CanTpBench_ServiceSince_us;
+
+static bool_t CanTpBench_IsStallArmed;
+static bool_t CanTpBench_IsStalled;
+static uint32_t CanTpBench_StallEnd_us;
+
+static uint32_t CanTpBench_Frames;
+static uint32_t CanTpBench_BusBusy_us;
+static uint32_t CanTpBench_DiagErrors;
+static E_LibDiagCom_Error_t CanTpBench_FirstDiagError;
+static uint32_t CanTpBench_FirstDiagError_us;
+
+#if (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Streaming upper layers, stream n is registered on the connection of tester n
+// --------------------------------------------------------------------------------------------------------------------
+static S_CanTpBench_Stream_t CanTpBench_Streams[CANTPBENCH_TESTERS];
+
+static const S_LibCanTp_RxStream_t CanTpBench_StreamUpperLayers[CANTPBENCH_TESTERS] = {
+	{ CanTpBench_StreamStart, CanTpBench_StreamSegment, CanTpBench_StreamEnd, &CanTpBench_Streams[0] },
+	{ CanTpBench_StreamStart, CanTpBench_StreamSegment, CanTpBench_StreamEnd, &CanTpBench_Streams[1] },
+};
+
+static bool_t CanTpBench_IsStreamStallArmed;
+static uint32_t CanTpBench_StreamAborts;
+static uint32_t CanTpBench_StreamErrors;
+#endif
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Global Functions
+// --------------------------------------------------------------------------------------------------------------------
+
+//=====================================================================================================================
+// CanTpBench_Init:
+//=====================================================================================================================
+void CanTpBench_Init(void)
+{
+	LibHrTimer_Init();
+
+	LibService_SetEvent(&LibCanTp_Service, LIBSERVICE_EV_INIT);
+	LibCanTp_Service.ServiceFunc(NULL);
+
+	LibCanTP_TxEnable();
+	LibCanTP_RxEnable();
+}
+
+//=====================================================================================================================
+// CanTpBench_Run:
+//=====================================================================================================================
+void CanTpBench_Run(const S_CanTpBench_Scenario_t* pScenario, S_CanTpBench_Result_t* pResult)
+{
+	CanTpBench_pScenario = pScenario;
+	CanTpBench_MailboxCount = 0U;
+	CanTpBench_IsStallArmed = (CANTPBENCH_FAULT_TX_STALL == pScenario->Fault);
+	CanTpBench_IsStalled = false;
+	CanTpBench_Frames = 0U;
+	CanTpBench_BusBusy_us = 0U;
+	CanTpBench_DiagErrors = 0U;
+	CanTpBench_FirstDiagError = (E_LibDiagCom_Error_t)0;
+	CanTpBench_FirstDiagError_us = 0U;
+
+	for (uint32_t i = 0U; i < CANTPBENCH_INST_COUNT; i++)
+	{
+		LibCanTp_SetFcParams(LibCanTp_Inst_Table[i], pScenario->BlockSize, pScenario->SepTimeMin);
+	}
+
+#if (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+	CanTpBench_IsStreamStallArmed = (CANTPBENCH_FAULT_STREAM_STALL == pScenario->Fault);
+	CanTpBench_StreamAborts = 0U;
+	CanTpBench_StreamErrors = 0U;
+	for (uint32_t i = 0U; i < CANTPBENCH_TESTERS; i++)
+	{
+		S_CanTpBench_Stream_t* const pStream = &CanTpBench_Streams[i];
+
+		pStream->ConnId        = (uint8_t)(i * 2U);
+		pStream->IsActive      = false;
+		pStream->IsRespPending = false;
+		(void)LibCanTp_RxStreamRegister(pStream->ConnId,
+										pScenario->IsRxStream ? &CanTpBench_StreamUpperLayers[i] : NULL);
+	}
+#endif
+
+	CanTpBench_TesterStart(pScenario);
+
+	const uint32_t start_us = CanTpBench_Time_us;
+	while ((!CanTpBench_TesterIsDone()) && ((CanTpBench_Time_us - start_us) < CANTPBENCH_RUN_MAX_US))
+	{
+		CanTpBench_Step();
+	}
+
+	memset(pResult, 0, sizeof(*pResult));
+	pResult->Time_us        = CanTpBench_Time_us - start_us;
+	pResult->Frames         = CanTpBench_Frames;
+	pResult->BusBusy_us     = CanTpBench_BusBusy_us;
+	CanTpBench_TesterGetResult(pResult);
+
+	// let LibCanTp finish the confirmations, the next run starts with idle connections
+	const uint32_t end_us = CanTpBench_Time_us;
+	while ((!CanTpBench_IsIdle()) && ((CanTpBench_Time_us - end_us) < CANTPBENCH_TESTER_N_CR_US))
+	{
+		CanTpBench_Step();
+	}
+
+	pResult->DiagErrors     = CanTpBench_DiagErrors;
+	pResult->FirstDiagError = CanTpBench_FirstDiagError;
+	pResult->FirstDiagError_us = CanTpBench_FirstDiagError_us;
+#if (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+	pResult->StreamAborts   = CanTpBench_StreamAborts;
+	pResult->StreamErrors   = CanTpBench_StreamErrors;
+#endif
+}
+
+//=====================================================================================================================
+// CanTpBench_GetTime_us:
+//=====================================================================================================================
+uint32_t CanTpBench_GetTime_us(void)
+{
+	return CanTpBench_Time_us;
+}
+
+//=====================================================================================================================
+// CanTpBench_CheckFsmTrace:
+//=====================================================================================================================
+bool_t CanTpBench_CheckFsmTrace(void)
+{
+	bool_t isPassed = true;
+
+#ifdef LIBFSMCFG_TRACE
+	const S_LibFsm_TraceEntry_t* const pEntry = LibFsm_GetTraceEntry(0U);
+	char text[96];
+
+	isPassed = (NULL != pEntry);
+	if (isPassed)
+	{
+		LibFsm_DecodeTraceEntry(pEntry, text, sizeof(text));
+		printf("fsm trace: %s\n", text);
+#ifdef LIBFSMCFG_NAME_TABLES
+		isPassed = (NULL != strstr(text, "LIBCANTP_ST_")) && (NULL != strstr(text, "LIBCANTP_EV_"));
+#endif // LIBFSMCFG_NAME_TABLES
+	}
+
+	for (uint32_t i = 0U; isPassed && (i < CANTPBENCH_INST_COUNT); i++)
+	{
+		const S_LibCanTp_Inst_t* const pInst = LibCanTp_Inst_Table[i];
+		uint32_t numLeft = 0U;
+
+		isPassed = (pInst->Fsm.pStateStats == pInst->FsmStateStats);
+		for (uint32_t state = 0U; state < LIBCANTP_FSM_STATE_NUM; state++)
+		{
+			numLeft += pInst->FsmStateStats[state].NumLeft;
+		}
+		printf("fsm state stats: connection %u left %u states\n", (unsigned)i, (unsigned)numLeft);
+	}
+#endif // LIBFSMCFG_TRACE
+
+	return isPassed;
+}
+
+//=====================================================================================================================
+// CanIF_TxFrame:
+//=====================================================================================================================
+Ret_t CanIF_TxFrame(const S_LibCan_Msg_t* pMsg, CanIF_TxCompleteClbk clbk, void* pData)
+{
+	return CanTpBench_MailboxPut(pMsg, clbk, pData) ? LIBRET_OK : LIBRET_BUSY;
+}
+
+//=====================================================================================================================
+// LibDiagCom_IsReady:
+//=====================================================================================================================
+bool_t LibDiagCom_IsReady(void)
+{
+	return !CanTpBench_DiagCom.IsBusy;
+}
+
+//=====================================================================================================================
+// LibDiagCom_GetMsg:
+//=====================================================================================================================
+S_LibDiagCom_Msg_t* LibDiagCom_GetMsg(void)
+{
+	return &CanTpBench_DiagCom.Msg;
+}
+
+//=====================================================================================================================
+// LibDiagCom_StartOfMsg:
+//=====================================================================================================================
+void LibDiagCom_StartOfMsg(void)
+{
+#if (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+	// a message taken over by the streaming upper layer must not reach DiagCom
+	for (uint32_t i = 0U; i < CANTPBENCH_TESTERS; i++)
+	{
+		if (CanTpBench_Streams[i].IsActive)
+		{
+			CanTpBench_StreamErrors++;
+		}
+	}
+#endif
+}
+
+//=====================================================================================================================
+// LibDiagCom_MsgReceived:
+//=====================================================================================================================
+void LibDiagCom_MsgReceived(S_LibDiagCom_Msg_t* pMsg)
+{
+	(void)pMsg;
+#if (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+	if (CanTpBench_pScenario->IsRxStream)
+	{
+		CanTpBench_StreamErrors++;
+	}
+#endif
+	CanTpBench_DiagCom.IsBusy    = true;
+	CanTpBench_DiagCom.RespAt_us = CanTpBench_Time_us + CanTpBench_pScenario->ProcDelay_us;
+}
+
+//=====================================================================================================================
+// LibDiagCom_AbortRequest:
+//=====================================================================================================================
+void LibDiagCom_AbortRequest(void)
+{
+	CanTpBench_DiagCom.IsBusy = false;
+	LibService_SetEvent(&LibCanTp_Service, LIBCANTP_SRV_EV_DIAGCOM_READY);
+}
+
+//=====================================================================================================================
+// LibDiagCom_Error:
+//=====================================================================================================================
+void LibDiagCom_Error(const E_LibDiagCom_Error_t error)
+{
+	if (0U == CanTpBench_DiagErrors)
+	{
+		CanTpBench_FirstDiagError = error;
+		CanTpBench_FirstDiagError_us = CanTpBench_Time_us;
+	}
+	CanTpBench_DiagErrors++;
+}
+
+//=====================================================================================================================
+// LibServiceHost_Notify:
+//=====================================================================================================================
+void LibServiceHost_Notify(const S_LibServiceHost_Inst_t* const pServiceHost)
+{
+	// the services are polled by CanTpBench_ServiceTick()
+	(void)pServiceHost;
+}
+
+//=====================================================================================================================
+// VirtualPrintf:
+//=====================================================================================================================
+int VirtualPrintf(const char* pFormat, ...)
+{
+	(void)pFormat;
+	return 0;
+}
+
+//=====================================================================================================================
+// __disable_irq:
+//=====================================================================================================================
+void __disable_irq(void)
+{
+	// single threaded, nothing to lock
+}
+
+//=====================================================================================================================
+// __enable_irq:
+//=====================================================================================================================
+void __enable_irq(void)
+{
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Functions
+// --------------------------------------------------------------------------------------------------------------------
+
+//=====================================================================================================================
+// CanTpBench_Step:
+//=====================================================================================================================
+static void CanTpBench_Step(void)
+{
+	CanTpBench_Time_us += CANTPBENCH_STEP_US;
+	LibHrTimer_HostAdvance_us(CANTPBENCH_STEP_US);
+
+	CanTpBench_StallTick();
+	CanTpBench_BusTick();
+	CanTpBench_TaskTick();
+	CanTpBench_ServiceTick();
+	CanTpBench_DiagComTick();
+#if (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+	CanTpBench_StreamTick();
+#endif
+	CanTpBench_TesterTick();
+}
+
+//=====================================================================================================================
+// CanTpBench_BusTick:
+//=====================================================================================================================
+static void CanTpBench_BusTick(void)
+{
+	S_CanTpBench_Bus_t* const pBus = &CanTpBench_Bus;
+
+	if (pBus->IsBusy && CanTpBench_IsElapsed(pBus->End_us))
+	{
+		S_LibCan_Msg_t* const pFrame = &pBus->Mailbox.Frame;
+
+		pBus->IsBusy = false;
+		CanTpBench_Frames++;
+
+		if (pBus->IsEcuFrame)
+		{
+			if (NULL != pBus->Mailbox.Clbk)
+			{
+				pBus->Mailbox.Clbk(pBus->Mailbox.pData, true);
+			}
+			LibCanTp_TxMailboxFree(LIBDRV_DEVID_MCAN);
+			CanTpBench_TesterRx(pFrame);
+		}
+		else
+		{
+			// the mailboxes stall when the FlowControl of tester 0 starts the response
+			if (CanTpBench_IsStallArmed && (0U == pBus->TesterIdx) && (0x30U == (pFrame->Data[0] & 0xF0U)))
+			{
+				CanTpBench_IsStallArmed = false;
+				CanTpBench_IsStalled    = true;
+				CanTpBench_StallEnd_us  = CanTpBench_Time_us + CANTPBENCH_TX_STALL_US;
+			}
+
+			if (LibCanTp_IsMsgTp(pFrame->Id))
+			{
+				LibCanTp_MsgIndicate(pFrame);
+			}
+		}
+	}
+
+	if (!pBus->IsBusy)
+	{
+		// arbitration: the lowest identifier wins
+		uint32_t testerIdx = 0U;
+		const S_LibCan_Msg_t* const pTester = CanTpBench_TesterPeekFrame(&testerIdx);
+		const bool_t isEcuReady = (0U < CanTpBench_MailboxCount) && (!CanTpBench_IsStalled);
+		uint32_t ecuIdx = 0U;
+
+		// the mailboxes are prioritized by the identifier as the bxCAN does without transmit FIFO priority (TXFP),
+		// frames with the same identifier leave in the worst case order (the latest written first)
+		for (uint32_t i = 1U; i < CanTpBench_MailboxCount; i++)
+		{
+			if (CanTpBench_Mailboxes[i].Frame.Id <= CanTpBench_Mailboxes[ecuIdx].Frame.Id)
+			{
+				ecuIdx = i;
+			}
+		}
+
+		if (isEcuReady && ((NULL == pTester) || (CanTpBench_Mailboxes[ecuIdx].Frame.Id < pTester->Id)))
+		{
+			pBus->Mailbox    = CanTpBench_Mailboxes[ecuIdx];
+			pBus->IsEcuFrame = true;
+			CanTpBench_MailboxCount--;
+			memmove(&CanTpBench_Mailboxes[ecuIdx], &CanTpBench_Mailboxes[ecuIdx + 1U],
+					(CanTpBench_MailboxCount - ecuIdx) * sizeof(CanTpBench_Mailboxes[0]));
+		}
+		else if (NULL != pTester)
+		{
+			pBus->Mailbox.Frame = *pTester;
+			pBus->Mailbox.Clbk  = NULL;
+			pBus->IsEcuFrame    = false;
+			pBus->TesterIdx     = testerIdx;
+			CanTpBench_TesterFrameSent(testerIdx);
+		}
+		else
+		{
+			return;
+		}
+
+		const uint32_t frameTime_us = CanTpBench_FrameTime_us(&pBus->Mailbox.Frame);
+		pBus->IsBusy = true;
+		pBus->End_us = CanTpBench_Time_us + frameTime_us;
+		CanTpBench_BusBusy_us += frameTime_us;
+	}
+}
+
+//=====================================================================================================================
+// CanTpBench_TaskTick:
+//=====================================================================================================================
+static void CanTpBench_TaskTick(void)
+{
+	if (NULL == LibFifoQueue_Peek(&LibCanTp_MsgReqFifo))
+	{
+		CanTpBench_IsTaskPending = false;
+		return;
+	}
+
+	if (!CanTpBench_IsTaskPending)
+	{
+		CanTpBench_IsTaskPending = true;
+		CanTpBench_TaskSince_us  = CanTpBench_Time_us;
+	}
+
+	if ((CanTpBench_Time_us - CanTpBench_TaskSince_us) >= CanTpBench_pScenario->ServiceLatency_us)
+	{
+		// like the CAN driver: confirmed when the frame is in a mailbox
+		const S_LibCan_Msg_t* pMsg = (const S_LibCan_Msg_t*)LibFifoQueue_Peek(&LibCanTp_MsgReqFifo);
+		while ((NULL != pMsg) && CanTpBench_MailboxPut(pMsg, NULL, NULL))
+		{
+			const uint32_t msgId = pMsg->Id;
+			LibFifoQueue_Release(&LibCanTp_MsgReqFifo);
+			LibCanTp_MsgConfirm(msgId);
+			pMsg = (const S_LibCan_Msg_t*)LibFifoQueue_Peek(&LibCanTp_MsgReqFifo);
+		}
+		CanTpBench_IsTaskPending = false;
+	}
+
+	LibService_ClearEvent(&TASK_CAN, EV_CAN_MSG_REQ);
+}
+
+//=====================================================================================================================
+// CanTpBench_ServiceTick:
+//=====================================================================================================================
+static void CanTpBench_ServiceTick(void)
+{
+	if (0U == LibService_GetEvent(&LibCanTp_Service))
+	{
+		CanTpBench_IsServicePending = false;
+		return;
+	}
+
+	if (!CanTpBench_IsServicePending)
+	{
+		CanTpBench_IsServicePending = true;
+		CanTpBench_ServiceSince_us  = CanTpBench_Time_us;
+	}
+
+	if ((CanTpBench_Time_us - CanTpBench_ServiceSince_us) >= CanTpBench_pScenario->ServiceLatency_us)
+	{
+		for (uint32_t i = 0U; (i < CANTPBENCH_SERVICE_LOOPS) && (0U != LibService_GetEvent(&LibCanTp_Service)); i++)
+		{
+			LibCanTp_Service.ServiceFunc(NULL);
+		}
+		CanTpBench_IsServicePending = false;
+	}
+}
+
+//=====================================================================================================================
+// CanTpBench_DiagComTick:
+//=====================================================================================================================
+static void CanTpBench_DiagComTick(void)
+{
+	S_CanTpBench_DiagCom_t* const pDiag = &CanTpBench_DiagCom;
+
+	if ((!pDiag->IsBusy) || (!CanTpBench_IsElapsed(pDiag->RespAt_us)))
+	{
+		return;
+	}
+
+	const uint8_t* const pReq = pDiag->Msg.pPayload;
+	const uint32_t reqLen = pDiag->Msg.PayloadLen;
+	const uint8_t sid = pReq[0];
+	bool_t isReqValid = (reqLen == CanTpBench_pScenario->ReqLen);
+	for (uint32_t i = 1U; isReqValid && (i < reqLen); i++)
+	{
+		isReqValid = (pReq[i] == (uint8_t)(i * 3U));
+	}
+
+	// the response is assembled in the lent transmit buffer over the request, LibCanTp sends it without a copy
+	uint16_t maxLen = 0U;
+	uint8_t* const pResp = pDiag->Msg.GetTxBuffer(&pDiag->Msg, &maxLen);
+	pDiag->IsBusy = false;
+	if ((NULL == pResp) || (maxLen < CanTpBench_pScenario->RespLen))
+	{
+		// left unanswered, the tester reports the exchange as failed
+		LibService_SetEvent(&LibCanTp_Service, LIBCANTP_SRV_EV_DIAGCOM_READY);
+		return;
+	}
+
+	if (isReqValid)
+	{
+		CanTpBench_FillResponse(pResp, sid);
+		pDiag->Msg.PayloadLen = (uint16_t)CanTpBench_pScenario->RespLen;
+	}
+	else
+	{
+		pResp[0] = CANTPBENCH_NRC_SID;
+		pResp[1] = sid;
+		pResp[2] = CANTPBENCH_NRC_INVALID_FORMAT;
+		pDiag->Msg.PayloadLen = 3U;
+	}
+
+	pDiag->Msg.pPayload = pResp;
+	pDiag->Msg.SendMessage(&pDiag->Msg);
+	LibService_SetEvent(&LibCanTp_Service, LIBCANTP_SRV_EV_DIAGCOM_READY);
+}
+
+//=====================================================================================================================
+// CanTpBench_FillResponse:
+//=====================================================================================================================
+static void CanTpBench_FillResponse(uint8_t* pResp, const uint8_t sid)
+{
+	pResp[0] = (uint8_t)(sid + 0x40U);
+	for (uint32_t i = 1U; i < CanTpBench_pScenario->RespLen; i++)
+	{
+		pResp[i] = (uint8_t)((i * 7U) + 1U);
+	}
+}
+
+#if (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+//=====================================================================================================================
+// CanTpBench_StreamTick:
+//=====================================================================================================================
+static void CanTpBench_StreamTick(void)
+{
+	for (uint32_t i = 0U; i < CANTPBENCH_TESTERS; i++)
+	{
+		S_CanTpBench_Stream_t* const pStream = &CanTpBench_Streams[i];
+
+		for (uint32_t seg = 0U; pStream->IsActive && (seg < CANTPBENCH_STREAM_SEGMENTS); seg++)
+		{
+			// the consumed segment is provided again, the ContinueToSend deferred for it is sent now
+			if ((CANTPBENCH_SEGMENT_CONSUMING == pStream->SegmentStates[seg])
+				&& CanTpBench_IsElapsed(pStream->ReturnAt_us[seg]))
+			{
+				pStream->SegmentStates[seg] = CANTPBENCH_SEGMENT_PROVIDED;
+				if (LIBRET_OK != LibCanTp_RxStreamProvide(pStream->ConnId, pStream->Segments[seg],
+														  CANTPBENCH_STREAM_SEGMENT_LEN))
+				{
+					CanTpBench_StreamErrors++;
+				}
+			}
+		}
+
+		if (pStream->IsRespPending && CanTpBench_IsElapsed(pStream->RespAt_us))
+		{
+			// answered like DiagCom, over the connection which received the request
+			pStream->IsRespPending    = false;
+			CanTpBench_FillResponse(pStream->RespBuf, pStream->Sid);
+			pStream->Resp.DevId       = LIBDRV_DEVID_MCAN;
+			pStream->Resp.ConnId      = pStream->ConnId;
+			pStream->Resp.TgtAddr     = pStream->TgtAddr;
+			pStream->Resp.IsPhysical  = true;
+			pStream->Resp.pPayload    = pStream->RespBuf;
+			pStream->Resp.PayloadLen  = (uint16_t)CanTpBench_pScenario->RespLen;
+			LibCanTp_MsgRequest(&pStream->Resp);
+		}
+	}
+}
+
+//=====================================================================================================================
+// CanTpBench_StreamStart:
+//=====================================================================================================================
+static bool_t CanTpBench_StreamStart(void* pUserData, const uint32_t msgLength, const uint8_t* pData,
+									 const uint32_t dataLength)
+{
+	S_CanTpBench_Stream_t* const pStream = (S_CanTpBench_Stream_t*)pUserData;
+
+	(void)dataLength;
+	// the first request of tester 0 is stalled
+	pStream->IsStalled = CanTpBench_IsStreamStallArmed && (0U == pStream->ConnId);
+	CanTpBench_IsStreamStallArmed = CanTpBench_IsStreamStallArmed && (!pStream->IsStalled);
+	pStream->IsActive = true;
+	pStream->MsgLen   = msgLength;
+	pStream->RxIdx    = 0U;
+	pStream->Sid      = pData[0];
+	pStream->IsValid  = (msgLength == CanTpBench_pScenario->ReqLen)
+						&& (CanTpBench_pScenario->RespLen <= CANTPBENCH_STREAM_RESP_LEN);
+
+	// all segments are provided before the FirstFrame is copied
+	for (uint32_t seg = 0U; seg < CANTPBENCH_STREAM_SEGMENTS; seg++)
+	{
+		pStream->SegmentStates[seg] = CANTPBENCH_SEGMENT_PROVIDED;
+		if (LIBRET_OK != LibCanTp_RxStreamProvide(pStream->ConnId, pStream->Segments[seg],
+												  CANTPBENCH_STREAM_SEGMENT_LEN))
+		{
+			CanTpBench_StreamErrors++;
+		}
+	}
+
+	return true;
+}
+
+//=====================================================================================================================
+// CanTpBench_StreamSegment:
+//=====================================================================================================================
+static void CanTpBench_StreamSegment(void* pUserData, uint8_t* pSegment, const uint32_t length)
+{
+	S_CanTpBench_Stream_t* const pStream = (S_CanTpBench_Stream_t*)pUserData;
+	uint32_t seg = 0U;
+
+	while ((seg < CANTPBENCH_STREAM_SEGMENTS) && (pSegment != pStream->Segments[seg]))
+	{
+		seg++;
+	}
+
+	if ((seg >= CANTPBENCH_STREAM_SEGMENTS) || (CANTPBENCH_SEGMENT_PROVIDED != pStream->SegmentStates[seg]))
+	{
+		// not a segment LibCanTp owns
+		CanTpBench_StreamErrors++;
+		return;
+	}
+
+	for (uint32_t i = 0U; pStream->IsValid && (i < length); i++)
+	{
+		const uint32_t msgIdx = pStream->RxIdx + i;
+		pStream->IsValid = (0U == msgIdx) || (pSegment[i] == (uint8_t)(msgIdx * 3U));
+	}
+	pStream->RxIdx += length;
+
+	// a stalled upper layer keeps the segment until the reception ends
+	pStream->SegmentStates[seg] = pStream->IsStalled ? CANTPBENCH_SEGMENT_FREE : CANTPBENCH_SEGMENT_CONSUMING;
+	pStream->ReturnAt_us[seg]   = CanTpBench_Time_us + CanTpBench_pScenario->StreamDelay_us;
+}
+
+//=====================================================================================================================
+// CanTpBench_StreamEnd:
+//=====================================================================================================================
+static void CanTpBench_StreamEnd(void* pUserData, const Ret_t result)
+{
+	S_CanTpBench_Stream_t* const pStream = (S_CanTpBench_Stream_t*)pUserData;
+	const S_LibCanTp_Inst_t* const pInst = LibCanTp_Inst_Table[pStream->ConnId];
+
+	// the segments not handed over are returned: LibCanTp must not keep any of them
+	if ((0U != LibAtomic_Load(&pInst->RxStream.FreeBytes)) || (NULL != pInst->RxStream.Segment.pData)
+		|| (NULL != LibFifoQueue_Peek(pInst->RxStream.pFifo)))
+	{
+		CanTpBench_StreamErrors++;
+	}
+
+	if (LIBRET_OK == result)
+	{
+		if (pStream->IsValid && (pStream->RxIdx == pStream->MsgLen))
+		{
+			pStream->IsRespPending = true;
+			pStream->RespAt_us     = CanTpBench_Time_us + CanTpBench_pScenario->ProcDelay_us;
+			pStream->TgtAddr       = pInst->pDataUnit->TargetAddress;
+		}
+		else
+		{
+			// left unanswered, the tester reports the exchange as failed
+			CanTpBench_StreamErrors++;
+		}
+	}
+	else
+	{
+		CanTpBench_StreamAborts++;
+	}
+
+	pStream->IsActive = false;
+	for (uint32_t seg = 0U; seg < CANTPBENCH_STREAM_SEGMENTS; seg++)
+	{
+		pStream->SegmentStates[seg] = CANTPBENCH_SEGMENT_FREE;
+	}
+}
+#endif // (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+
+//=====================================================================================================================
+// CanTpBench_StallTick:
+//=====================================================================================================================
+static void CanTpBench_StallTick(void)
+{
+	if (CanTpBench_IsStalled && CanTpBench_IsElapsed(CanTpBench_StallEnd_us))
+	{
+		// recovered: the pending frames are aborted by the driver
+		CanTpBench_IsStalled = false;
+		while (0U < CanTpBench_MailboxCount)
+		{
+			const S_CanTpBench_Mailbox_t mailbox = CanTpBench_Mailboxes[--CanTpBench_MailboxCount];
+			if (NULL != mailbox.Clbk)
+			{
+				mailbox.Clbk(mailbox.pData, false);
+			}
+			LibCanTp_TxMailboxFree(LIBDRV_DEVID_MCAN);
+		}
+	}
+}
+
+//=====================================================================================================================
+// CanTpBench_MailboxPut:
+//=====================================================================================================================
+static bool_t CanTpBench_MailboxPut(const S_LibCan_Msg_t* pMsg, CanIF_TxCompleteClbk clbk, void* pData)
+{
+	if (CanTpBench_MailboxCount >= CANTPBENCH_TX_MAILBOXES)
+	{
+		return false;
+	}
+
+	// like CanIF_TxFrame: a frame waits for the pending frame with the same identifier
+	for (uint32_t i = 0U; i < CanTpBench_MailboxCount; i++)
+	{
+		if ((CanTpBench_Mailboxes[i].Frame.Id == pMsg->Id) && (CanTpBench_Mailboxes[i].Frame.IsExtId == pMsg->IsExtId))
+		{
+			return false;
+		}
+	}
+
+	S_CanTpBench_Mailbox_t* const pMailbox = &CanTpBench_Mailboxes[CanTpBench_MailboxCount++];
+	pMailbox->Frame = *pMsg;
+	pMailbox->Clbk  = clbk;
+	pMailbox->pData = pData;
+	return true;
+}
+
+//=====================================================================================================================
+// CanTpBench_FrameTime_us:
+//=====================================================================================================================
+static uint32_t CanTpBench_FrameTime_us(const S_LibCan_Msg_t* pMsg)
+{
+	uint32_t dataBits = 8U * LibCan_GetMsgDataLength(pMsg->Length);
+
+	if (pMsg->IsCanFd)
+	{
+		// arbitration, ACK, EOF and IFS at the nominal rate, control, data and CRC with stuff bits in the data phase
+		const uint32_t nominalBits = 30U + 13U;
+		uint32_t fastBits = dataBits + 28U;
+		fastBits += fastBits / 10U;
+		return ((nominalBits * CANTPBENCH_BIT_TIME_NS)
+				+ ((fastBits * CANTPBENCH_BIT_TIME_NS) / CANTPBENCH_FD_DATA_FACTOR) + 999U) / 1000U;
+	}
+
+	// standard identifier frame with about 10 % stuff bits, a DLC above 8 carries 8 bytes
+	if (dataBits > 64U)
+	{
+		dataBits = 64U;
+	}
+	uint32_t bits = 47U + dataBits;
+	bits += bits / 10U;
+	return ((bits * CANTPBENCH_BIT_TIME_NS) + 999U) / 1000U;
+}
+
+//=====================================================================================================================
+// CanTpBench_IsElapsed:
+//=====================================================================================================================
+static bool_t CanTpBench_IsElapsed(const uint32_t time_us)
+{
+	return ((int32_t)(CanTpBench_Time_us - time_us) >= 0);
+}
+
+//=====================================================================================================================
+// CanTpBench_IsIdle:
+//=====================================================================================================================
+static bool_t CanTpBench_IsIdle(void)
+{
+	bool_t isIdle = (!CanTpBench_Bus.IsBusy) && (0U == CanTpBench_MailboxCount) && (!CanTpBench_IsStalled)
+		   && (NULL == LibFifoQueue_Peek(&LibCanTp_MsgReqFifo)) && (0U == LibService_GetEvent(&LibCanTp_Service))
+		   && (!CanTpBench_DiagCom.IsBusy);
+
+#if (LIBCANTPCFG_RX_STREAM_SEGMENTS > 0U)
+	for (uint32_t i = 0U; isIdle && (i < CANTPBENCH_TESTERS); i++)
+	{
+		isIdle = !CanTpBench_Streams[i].IsRespPending;
+	}
+#endif
+
+	for (uint32_t i = 0U; isIdle && (i < CANTPBENCH_INST_COUNT); i++)
+	{
+		isIdle = LibCanTpFsm_IsReady(LibCanTp_Inst_Table[i]);
+	}
+
+	return isIdle;
+}
@@ -0,0 +1,822 @@
+// --------------------------------------------------------------------------------------------------------------------
+///
+/// \file CanTpBenchTester.c
+///
+/// \brief Tester peers of the CAN TP benchmark
+///
+/// Each tester is an independent ISO 15765-2 implementation on its own physical connection: it segments the
+/// requests, follows the FlowControl of the ECU, reassembles the responses with its own BS and STmin and checks
+/// their content. Faults are injected into the first exchange of tester 0.
+///
+/// Copyright (c) 2021 Neusoft.
+/// All Rights Reserved.
+///
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Includes
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "CanTpBench.h"
+#include "LibCanTpCfg.h"
+#include <string.h>
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Definitions
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Protocol control information of ISO 15765-2 (high nibble of the first byte)
+// --------------------------------------------------------------------------------------------------------------------
+#define CANTPBENCH_PCI_SF				(0x00U)
+#define CANTPBENCH_PCI_FF				(0x10U)
+#define CANTPBENCH_PCI_CF				(0x20U)
+#define CANTPBENCH_PCI_FC				(0x30U)
+#define CANTPBENCH_PCI_MASK				(0xF0U)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief FlowStatus values, CANTPBENCH_FS_RESERVED is used for CANTPBENCH_FAULT_FC_RESERVED
+// --------------------------------------------------------------------------------------------------------------------
+#define CANTPBENCH_FS_CTS				(0x00U)
+#define CANTPBENCH_FS_WAIT				(0x01U)
+#define CANTPBENCH_FS_OVFLW				(0x02U)
+#define CANTPBENCH_FS_RESERVED			(0x05U)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Service identifier of the requests and its positive response
+// --------------------------------------------------------------------------------------------------------------------
+#define CANTPBENCH_REQ_SID				(0x22U)
+#define CANTPBENCH_RESP_SID				(0x62U)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Padding of frames shorter than their DLC
+// --------------------------------------------------------------------------------------------------------------------
+#define CANTPBENCH_PADDING				(0xCCU)
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Data Types
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief State of a tester
+// --------------------------------------------------------------------------------------------------------------------
+typedef enum E_CanTpBench_TesterState_t {
+	CANTPBENCH_TESTER_IDLE,			///< no exchange in progress
+	CANTPBENCH_TESTER_TX_WAIT_FC,	///< FirstFrame or a block of the request sent, waiting for the FlowControl
+	CANTPBENCH_TESTER_TX_CF,		///< sending the ConsecutiveFrames of the request
+	CANTPBENCH_TESTER_WAIT_RESP,	///< request sent, waiting for the SingleFrame or FirstFrame of the response
+	CANTPBENCH_TESTER_RX_CF,		///< receiving the ConsecutiveFrames of the response
+	CANTPBENCH_TESTER_FAULT_WAIT,	///< fault injected, the ECU must stay silent until the exchange times out
+	CANTPBENCH_TESTER_PROBE_FF,		///< request sent, the FirstFrame of another request is sent before the response
+	CANTPBENCH_TESTER_PROBE_WAIT_FC,	///< waiting for the WAIT frames and the OVFLW for that FirstFrame
+} E_CanTpBench_TesterState_t;
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Tester peer on one physical connection
+// --------------------------------------------------------------------------------------------------------------------
+typedef struct S_CanTpBench_Tester_t {
+	uint32_t					ReqId;
+	uint32_t					RespId;
+	E_CanTpBench_TesterState_t	State;
+	E_CanTpBench_Fault_t		Fault;			///< fault of the current exchange
+	uint32_t					FaultAt_us;		///< time the faulty frame was queued, 0 if none
+	uint32_t					Exchanges;		///< exchanges started
+	uint32_t					Start_us;		///< start of the current exchange
+	uint32_t					Deadline_us;	///< timeout of the current state
+
+	S_LibCan_Msg_t				Frame;			///< frame waiting for the bus
+	bool_t						HasFrame;
+
+	uint8_t						TxBuf[CANTPBENCH_MAX_MSG_LEN];
+	uint32_t					TxLen;
+	uint32_t					TxIdx;
+	uint32_t					TxCfCount;		///< ConsecutiveFrames of the request sent
+	uint8_t						TxSn;
+	uint8_t						PeerBs;
+	uint8_t						PeerStMin;
+	uint32_t					TxCfInBlock;
+	uint32_t					NextTx_us;
+
+	uint8_t						RxBuf[CANTPBENCH_MAX_MSG_LEN];
+	uint32_t					RxLen;
+	uint32_t					RxIdx;
+	uint32_t					RxDl;			///< RX_DL of the response, taken from its FirstFrame
+	uint8_t						RxSn;
+	uint32_t					RxCfInBlock;
+
+	uint32_t					Done;
+	uint64_t					Bytes;
+	uint64_t					LatencySum_us;
+	uint32_t					LatencyMin_us;
+	uint32_t					LatencyMax_us;
+	uint32_t					Violations;
+	uint32_t					FcWaits;		///< WAIT FlowControls of the ECU
+	uint32_t					StMinMax_us;	///< longest STmin of the ContinueToSend FlowControls of the ECU
+} S_CanTpBench_Tester_t;
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Function Prototypes
+// --------------------------------------------------------------------------------------------------------------------
+
+static void CanTpBench_TesterStartExchange(S_CanTpBench_Tester_t* pTester, const uint32_t testerIdx);
+static void CanTpBench_TesterSendCf(S_CanTpBench_Tester_t* pTester);
+static void CanTpBench_TesterSendFf(S_CanTpBench_Tester_t* pTester);
+static void CanTpBench_TesterRequestSent(S_CanTpBench_Tester_t* pTester);
+static void CanTpBench_TesterRxProbeFc(S_CanTpBench_Tester_t* pTester, const S_LibCan_Msg_t* pFrame);
+static void CanTpBench_TesterRxFc(S_CanTpBench_Tester_t* pTester, const S_LibCan_Msg_t* pFrame);
+static void CanTpBench_TesterRxFirst(S_CanTpBench_Tester_t* pTester, const S_LibCan_Msg_t* pFrame);
+static void CanTpBench_TesterRxCf(S_CanTpBench_Tester_t* pTester, const S_LibCan_Msg_t* pFrame);
+static void CanTpBench_TesterSendFc(S_CanTpBench_Tester_t* pTester);
+static void CanTpBench_TesterComplete(S_CanTpBench_Tester_t* pTester);
+static void CanTpBench_TesterFail(S_CanTpBench_Tester_t* pTester);
+static void CanTpBench_TesterQueue(S_CanTpBench_Tester_t* pTester, const uint8_t* pData, const uint32_t length);
+static uint32_t CanTpBench_DecodeSepTimeMin_us(const uint8_t sepTimeMin);
+static bool_t CanTpBench_IsElapsed(const uint32_t time_us);
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Variables
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Testers, tester 0 uses the physical connection of the target, tester 1 the second physical connection
+// --------------------------------------------------------------------------------------------------------------------
+static S_CanTpBench_Tester_t CanTpBench_Testers[CANTPBENCH_TESTERS] = {
+	{ .ReqId = LIBCANTPCFG_TESTER_PHYS_ADDRESS, .RespId = LIBCANTPCFG_ECU_PHYS_ADDRESS },
+	{ .ReqId = CANTPBENCH_PHYS2_RX_ID, .RespId = CANTPBENCH_PHYS2_TX_ID },
+};
+
+static const S_CanTpBench_Scenario_t* CanTpBench_pTesterScenario;
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief TX_DL of the testers: the largest frame of the connection
+// --------------------------------------------------------------------------------------------------------------------
+static const uint32_t CanTpBench_TxDl = CANTPBENCH_IS_CANFD ? LIBCAN_MAXDATABYTENUM : 8U;
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Global Functions
+// --------------------------------------------------------------------------------------------------------------------
+
+//=====================================================================================================================
+// CanTpBench_TesterStart:
+//=====================================================================================================================
+void CanTpBench_TesterStart(const S_CanTpBench_Scenario_t* pScenario)
+{
+	CanTpBench_pTesterScenario = pScenario;
+
+	for (uint32_t i = 0U; i < CANTPBENCH_TESTERS; i++)
+	{
+		S_CanTpBench_Tester_t* const pTester = &CanTpBench_Testers[i];
+		pTester->State         = CANTPBENCH_TESTER_IDLE;
+		pTester->HasFrame      = false;
+		pTester->Exchanges     = 0U;
+		pTester->FaultAt_us    = 0U;
+		pTester->Done          = 0U;
+		pTester->Bytes         = 0U;
+		pTester->LatencySum_us = 0U;
+		pTester->LatencyMin_us = UINT32_MAX;
+		pTester->LatencyMax_us = 0U;
+		pTester->Violations    = 0U;
+		pTester->FcWaits       = 0U;
+		pTester->StMinMax_us   = 0U;
+	}
+}
+
+//=====================================================================================================================
+// CanTpBench_TesterTick:
+//=====================================================================================================================
+void CanTpBench_TesterTick(void)
+{
+	for (uint32_t i = 0U; i < CanTpBench_pTesterScenario->NumTesters; i++)
+	{
+		S_CanTpBench_Tester_t* const pTester = &CanTpBench_Testers[i];
+
+		if ((CANTPBENCH_TESTER_IDLE != pTester->State) && CanTpBench_IsElapsed(pTester->Deadline_us))
+		{
+			// N_Bs, N_Cr or P2 of the tester
+			CanTpBench_TesterFail(pTester);
+		}
+
+		if (pTester->HasFrame)
+		{
+			continue;
+		}
+
+		if (CANTPBENCH_TESTER_IDLE == pTester->State)
+		{
+			if (pTester->Exchanges < CanTpBench_pTesterScenario->Iterations)
+			{
+				CanTpBench_TesterStartExchange(pTester, i);
+			}
+		}
+		else if ((CANTPBENCH_TESTER_TX_CF == pTester->State) && CanTpBench_IsElapsed(pTester->NextTx_us))
+		{
+			CanTpBench_TesterSendCf(pTester);
+		}
+		else if (CANTPBENCH_TESTER_PROBE_FF == pTester->State)
+		{
+			// the request is indicated to DiagCom, the connection must hold this FirstFrame
+			CanTpBench_TesterSendFf(pTester);
+			pTester->State       = CANTPBENCH_TESTER_PROBE_WAIT_FC;
+			pTester->Deadline_us = CanTpBench_GetTime_us() + CANTPBENCH_TESTER_N_BS_US;
+		}
+		else
+		{
+			// waiting for the ECU
+		}
+	}
+}
+
+//=====================================================================================================================
+// CanTpBench_TesterPeekFrame:
+//=====================================================================================================================
+const S_LibCan_Msg_t* CanTpBench_TesterPeekFrame(uint32_t* pTesterIdx)
+{
+	const S_LibCan_Msg_t* pBest = NULL;
+
+	for (uint32_t i = 0U; i < CanTpBench_pTesterScenario->NumTesters; i++)
+	{
+		const S_CanTpBench_Tester_t* const pTester = &CanTpBench_Testers[i];
+		if (pTester->HasFrame && ((NULL == pBest) || (pTester->Frame.Id < pBest->Id)))
+		{
+			pBest       = &pTester->Frame;
+			*pTesterIdx = i;
+		}
+	}
+
+	return pBest;
+}
+
+//=====================================================================================================================
+// CanTpBench_TesterFrameSent:
+//=====================================================================================================================
+void CanTpBench_TesterFrameSent(const uint32_t testerIdx)
+{
+	S_CanTpBench_Tester_t* const pTester = &CanTpBench_Testers[testerIdx];
+
+	pTester->HasFrame = false;
+	if (CANTPBENCH_TESTER_TX_CF == pTester->State)
+	{
+		// STmin counts from the end of the previous frame, which is at most one frame time later
+		pTester->NextTx_us = CanTpBench_GetTime_us() + CanTpBench_DecodeSepTimeMin_us(pTester->PeerStMin);
+	}
+}
+
+//=====================================================================================================================
+// CanTpBench_TesterRx:
+//=====================================================================================================================
+void CanTpBench_TesterRx(const S_LibCan_Msg_t* pFrame)
+{
+	for (uint32_t i = 0U; i < CanTpBench_pTesterScenario->NumTesters; i++)
+	{
+		S_CanTpBench_Tester_t* const pTester = &CanTpBench_Testers[i];
+		if (pTester->RespId != pFrame->Id)
+		{
+			continue;
+		}
+
+		const uint8_t pci = pFrame->Data[0] & CANTPBENCH_PCI_MASK;
+		switch (pTester->State)
+		{
+			case CANTPBENCH_TESTER_TX_WAIT_FC:
+				if (CANTPBENCH_PCI_FC == pci)
+				{
+					CanTpBench_TesterRxFc(pTester, pFrame);
+				}
+				break;
+
+			case CANTPBENCH_TESTER_WAIT_RESP:
+				if ((CANTPBENCH_PCI_SF == pci) || (CANTPBENCH_PCI_FF == pci))
+				{
+					CanTpBench_TesterRxFirst(pTester, pFrame);
+				}
+				break;
+
+			case CANTPBENCH_TESTER_RX_CF:
+				if (CANTPBENCH_PCI_CF == pci)
+				{
+					CanTpBench_TesterRxCf(pTester, pFrame);
+				}
+				break;
+
+			case CANTPBENCH_TESTER_FAULT_WAIT:
+				// e.g. a ConsecutiveFrame after OVFLW or after the ECU aborted the transfer
+				pTester->Violations++;
+				break;
+
+			case CANTPBENCH_TESTER_PROBE_WAIT_FC:
+				CanTpBench_TesterRxProbeFc(pTester, pFrame);
+				break;
+
+			default:
+				break;
+		}
+	}
+}
+
+//=====================================================================================================================
+// CanTpBench_TesterIsDone:
+//=====================================================================================================================
+bool_t CanTpBench_TesterIsDone(void)
+{
+	bool_t isDone = true;
+
+	for (uint32_t i = 0U; isDone && (i < CanTpBench_pTesterScenario->NumTesters); i++)
+	{
+		const S_CanTpBench_Tester_t* const pTester = &CanTpBench_Testers[i];
+		isDone = (CANTPBENCH_TESTER_IDLE == pTester->State) && (!pTester->HasFrame)
+				 && (pTester->Exchanges >= CanTpBench_pTesterScenario->Iterations);
+	}
+
+	return isDone;
+}
+
+//=====================================================================================================================
+// CanTpBench_TesterGetResult:
+//=====================================================================================================================
+void CanTpBench_TesterGetResult(S_CanTpBench_Result_t* pResult)
+{
+	pResult->LatencyMin_us = UINT32_MAX;
+
+	for (uint32_t i = 0U; i < CanTpBench_pTesterScenario->NumTesters; i++)
+	{
+		const S_CanTpBench_Tester_t* const pTester = &CanTpBench_Testers[i];
+
+		pResult->Done          += pTester->Done;
+		// exchanges not finished within the run are failed as well
+		pResult->Failed        += CanTpBench_pTesterScenario->Iterations - pTester->Done;
+		pResult->Bytes         += pTester->Bytes;
+		pResult->LatencySum_us += pTester->LatencySum_us;
+		pResult->Violations    += pTester->Violations;
+		pResult->FcWaits       += pTester->FcWaits;
+		if (0U != pTester->FaultAt_us)
+		{
+			pResult->FaultAt_us = pTester->FaultAt_us;
+		}
+		if (pTester->StMinMax_us > pResult->StMinMax_us)
+		{
+			pResult->StMinMax_us = pTester->StMinMax_us;
+		}
+		if (pTester->LatencyMin_us < pResult->LatencyMin_us)
+		{
+			pResult->LatencyMin_us = pTester->LatencyMin_us;
+		}
+		if (pTester->LatencyMax_us > pResult->LatencyMax_us)
+		{
+			pResult->LatencyMax_us = pTester->LatencyMax_us;
+		}
+	}
+
+	if (0U == pResult->Done)
+	{
+		pResult->LatencyMin_us = 0U;
+	}
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Functions
+// --------------------------------------------------------------------------------------------------------------------
+
+//=====================================================================================================================
+// CanTpBench_TesterStartExchange:
+//=====================================================================================================================
+static void CanTpBench_TesterStartExchange(S_CanTpBench_Tester_t* pTester, const uint32_t testerIdx)
+{
+	const uint32_t now_us = CanTpBench_GetTime_us();
+	uint8_t data[LIBCAN_MAXDATABYTENUM];
+
+	pTester->Fault = ((0U == testerIdx) && (0U == pTester->Exchanges)) ? CanTpBench_pTesterScenario->Fault
+																	   : CANTPBENCH_FAULT_NONE;
+	pTester->Exchanges++;
+	pTester->Start_us  = now_us;
+	pTester->TxLen     = CanTpBench_pTesterScenario->ReqLen;
+	pTester->TxCfCount = 0U;
+	pTester->TxBuf[0]  = CANTPBENCH_REQ_SID;
+	for (uint32_t i = 1U; i < pTester->TxLen; i++)
+	{
+		pTester->TxBuf[i] = (uint8_t)(i * 3U);
+	}
+
+	if (pTester->TxLen <= 7U)
+	{
+		data[0] = (uint8_t)(CANTPBENCH_PCI_SF | pTester->TxLen);
+		memcpy(&data[1], pTester->TxBuf, pTester->TxLen);
+		CanTpBench_TesterQueue(pTester, data, pTester->TxLen + 1U);
+		if (CANTPBENCH_FAULT_SF_NO_ESCAPE == pTester->Fault)
+		{
+			// a CAN FD frame above 8 bytes needs the escape sequence, the ECU must not respond
+			pTester->Frame.Length = LIBCAN_DLCSIZE_12_B;
+			pTester->FaultAt_us   = now_us;
+		}
+		pTester->State       = CANTPBENCH_TESTER_WAIT_RESP;
+		pTester->Deadline_us = now_us + CANTPBENCH_TESTER_P2_US;
+	}
+	else if (pTester->TxLen <= (CanTpBench_TxDl - 2U))
+	{
+		// SingleFrame with escape sequence (CAN FD)
+		data[0] = CANTPBENCH_PCI_SF;
+		data[1] = (uint8_t)pTester->TxLen;
+		memcpy(&data[2], pTester->TxBuf, pTester->TxLen);
+		CanTpBench_TesterQueue(pTester, data, pTester->TxLen + 2U);
+		if (CANTPBENCH_FAULT_SF_DLC_LONG == pTester->Fault)
+		{
+			// the SF_DL has to need the DLC of the frame (ISO 15765-2 9.6.2.2), the ECU must not respond
+			pTester->Frame.Length = LIBCAN_DLCSIZE_64_B;
+			pTester->FaultAt_us   = now_us;
+		}
+		pTester->State       = CANTPBENCH_TESTER_WAIT_RESP;
+		pTester->Deadline_us = now_us + CANTPBENCH_TESTER_P2_US;
+	}
+	else
+	{
+		CanTpBench_TesterSendFf(pTester);
+		pTester->State       = CANTPBENCH_TESTER_TX_WAIT_FC;
+		pTester->Deadline_us = now_us + CANTPBENCH_TESTER_N_BS_US;
+	}
+}
+
+//=====================================================================================================================
+// CanTpBench_TesterSendFf:
+//=====================================================================================================================
+static void CanTpBench_TesterSendFf(S_CanTpBench_Tester_t* pTester)
+{
+	uint8_t data[LIBCAN_MAXDATABYTENUM];
+
+	data[0] = (uint8_t)(CANTPBENCH_PCI_FF | (pTester->TxLen >> 8U));
+	data[1] = (uint8_t)pTester->TxLen;
+	memcpy(&data[2], pTester->TxBuf, CanTpBench_TxDl - 2U);
+	CanTpBench_TesterQueue(pTester, data, CanTpBench_TxDl);
+	pTester->TxIdx = CanTpBench_TxDl - 2U;
+	pTester->TxSn  = 0U;
+}
+
+//=====================================================================================================================
+// CanTpBench_TesterRequestSent:
+//=====================================================================================================================
+static void CanTpBench_TesterRequestSent(S_CanTpBench_Tester_t* pTester)
+{
+	pTester->State       = (CANTPBENCH_FAULT_HELD_FF == pTester->Fault) ? CANTPBENCH_TESTER_PROBE_FF
+																		 : CANTPBENCH_TESTER_WAIT_RESP;
+	pTester->Deadline_us = CanTpBench_GetTime_us() + CANTPBENCH_TESTER_P2_US;
+}
+
+//=====================================================================================================================
+// CanTpBench_TesterSendCf:
+//=====================================================================================================================
+static void CanTpBench_TesterSendCf(S_CanTpBench_Tester_t* pTester)
+{
+	const uint32_t now_us = CanTpBench_GetTime_us();
+	uint8_t data[LIBCAN_MAXDATABYTENUM];
+	uint32_t length = pTester->TxLen - pTester->TxIdx;
+
+	if (length > (CanTpBench_TxDl - 1U))
+	{
+		length = CanTpBench_TxDl - 1U;
+	}
+
+	pTester->TxSn = (uint8_t)((pTester->TxSn + 1U) & 0x0FU);
+	data[0] = (uint8_t)(CANTPBENCH_PCI_CF | pTester->TxSn);
+	if (CANTPBENCH_FAULT_WRONG_SN == pTester->Fault)
+	{
+		data[0] = (uint8_t)(CANTPBENCH_PCI_CF | ((pTester->TxSn + 1U) & 0x0FU));
+	}
+	memcpy(&data[1], &pTester->TxBuf[pTester->TxIdx], length);
+	CanTpBench_TesterQueue(pTester, data, length + 1U);
+	pTester->TxIdx += length;
+	pTester->TxCfCount++;
+	pTester->TxCfInBlock++;
+
+	if ((CANTPBENCH_FAULT_WRONG_SN == pTester->Fault)
+		|| ((CANTPBENCH_FAULT_STOP_CF == pTester->Fault) && (1U == pTester->TxCfCount)))
+	{
+		// the ECU must abort the reception (N_Cr or wrong sequence number) and must not respond
+		pTester->FaultAt_us  = now_us;
+		pTester->State       = CANTPBENCH_TESTER_FAULT_WAIT;
+		pTester->Deadline_us = now_us + CANTPBENCH_TESTER_N_CR_US;
+	}
+	else if (pTester->TxIdx >= pTester->TxLen)
+	{
+		CanTpBench_TesterRequestSent(pTester);
+	}
+	else if ((0U != pTester->PeerBs) && (pTester->TxCfInBlock >= pTester->PeerBs))
+	{
+		pTester->State       = CANTPBENCH_TESTER_TX_WAIT_FC;
+		pTester->Deadline_us = now_us + CANTPBENCH_TESTER_N_BS_US;
+	}
+	else
+	{
+		// next ConsecutiveFrame STmin after this one is on the bus, see CanTpBench_TesterFrameSent()
+	}
+}
+
+//=====================================================================================================================
+// CanTpBench_TesterRxFc:
+//=====================================================================================================================
+static void CanTpBench_TesterRxFc(S_CanTpBench_Tester_t* pTester, const S_LibCan_Msg_t* pFrame)
+{
+	const uint8_t fs = pFrame->Data[0] & 0x0FU;
+
+	if (CANTPBENCH_FS_CTS == fs)
+	{
+		const uint32_t stMin_us = CanTpBench_DecodeSepTimeMin_us(pFrame->Data[2]);
+
+		pTester->StMinMax_us = (stMin_us > pTester->StMinMax_us) ? stMin_us : pTester->StMinMax_us;
+		pTester->PeerBs      = pFrame->Data[1];
+		pTester->PeerStMin   = pFrame->Data[2];
+		pTester->TxCfInBlock = 0U;
+		pTester->NextTx_us   = CanTpBench_GetTime_us();
+		pTester->State       = CANTPBENCH_TESTER_TX_CF;
+		// the tester paces the ConsecutiveFrames itself, only a stuck bus ends the request
+		pTester->Deadline_us = CanTpBench_GetTime_us() + CANTPBENCH_TESTER_P2_US;
+	}
+	else if (CANTPBENCH_FS_WAIT == fs)
+	{
+		// N_Bs restarts with every WAIT
+		pTester->FcWaits++;
+		pTester->Deadline_us = CanTpBench_GetTime_us() + CANTPBENCH_TESTER_N_BS_US;
+	}
+	else
+	{
+		// OVFLW or reserved: the request is given up
+		CanTpBench_TesterFail(pTester);
+	}
+}
+
+//=====================================================================================================================
+// CanTpBench_TesterRxProbeFc:
+//=====================================================================================================================
+static void CanTpBench_TesterRxProbeFc(S_CanTpBench_Tester_t* pTester, const S_LibCan_Msg_t* pFrame)
+{
+	if ((CANTPBENCH_PCI_FC | CANTPBENCH_FS_WAIT) == pFrame->Data[0])
+	{
+		pTester->FcWaits++;
+		pTester->Deadline_us = CanTpBench_GetTime_us() + CANTPBENCH_TESTER_N_BS_US;
+	}
+	else if ((CANTPBENCH_PCI_FC | CANTPBENCH_FS_OVFLW) == pFrame->Data[0])
+	{
+		// the held FirstFrame is rejected, the response of the request follows
+		pTester->State       = CANTPBENCH_TESTER_WAIT_RESP;
+		pTester->Deadline_us = pTester->Start_us + CANTPBENCH_TESTER_P2_US;
+	}
+	else
+	{
+		// a ContinueToSend would overwrite the request processed by DiagCom, the response must follow the OVFLW
+		pTester->Violations++;
+		CanTpBench_TesterFail(pTester);
+	}
+}
+
+//=====================================================================================================================
+// CanTpBench_TesterRxFirst:
+//=====================================================================================================================
+static void CanTpBench_TesterRxFirst(S_CanTpBench_Tester_t* pTester, const S_LibCan_Msg_t* pFrame)
+{
+	const uint32_t frameLen = LibCan_GetMsgDataLength(pFrame->Length);
+	uint32_t offset;
+
+	if (CANTPBENCH_PCI_SF == (pFrame->Data[0] & CANTPBENCH_PCI_MASK))
+	{
+		pTester->RxLen = pFrame->Data[0] & 0x0FU;
+		offset = 1U;
+		if (0U == pTester->RxLen)
+		{
+			pTester->RxLen = pFrame->Data[1];
+			offset = 2U;
+		}
+
+		if ((0U == pTester->RxLen) || ((pTester->RxLen + offset) > frameLen))
+		{
+			CanTpBench_TesterFail(pTester);
+			return;
+		}
+
+		memcpy(pTester->RxBuf, &pFrame->Data[offset], pTester->RxLen);
+		CanTpBench_TesterComplete(pTester);
+		return;
+	}
+
+	pTester->RxLen = ((uint32_t)(pFrame->Data[0] & 0x0FU) << 8U) | pFrame->Data[1];
+	offset = 2U;
+	if (0U == pTester->RxLen)
+	{
+		pTester->RxLen = ((uint32_t)pFrame->Data[2] << 24U) | ((uint32_t)pFrame->Data[3] << 16U)
+						 | ((uint32_t)pFrame->Data[4] << 8U) | pFrame->Data[5];
+		offset = 6U;
+	}
+
+	if ((pTester->RxLen > CANTPBENCH_MAX_MSG_LEN) || (pTester->RxLen < (frameLen - offset)))
+	{
+		CanTpBench_TesterFail(pTester);
+		return;
+	}
+
+	pTester->RxDl        = frameLen;
+	pTester->RxIdx       = frameLen - offset;
+	pTester->RxSn        = 0U;
+	pTester->RxCfInBlock = 0U;
+	memcpy(pTester->RxBuf, &pFrame->Data[offset], pTester->RxIdx);
+
+	switch (pTester->Fault)
+	{
+		case CANTPBENCH_FAULT_NO_FC:
+		case CANTPBENCH_FAULT_FC_OVFLW:
+		case CANTPBENCH_FAULT_FC_RESERVED:
+		case CANTPBENCH_FAULT_FC_SHORT:
+		{
+			uint8_t data[3] = { CANTPBENCH_PCI_FC | CANTPBENCH_FS_CTS, CanTpBench_pTesterScenario->BlockSize,
+								CanTpBench_pTesterScenario->SepTimeMin };
+			if (CANTPBENCH_FAULT_FC_OVFLW == pTester->Fault)
+			{
+				data[0] = (uint8_t)(CANTPBENCH_PCI_FC | CANTPBENCH_FS_OVFLW);
+			}
+			else if (CANTPBENCH_FAULT_FC_RESERVED == pTester->Fault)
+			{
+				data[0] = (uint8_t)(CANTPBENCH_PCI_FC | CANTPBENCH_FS_RESERVED);
+			}
+			else
+			{
+				// CANTPBENCH_FAULT_FC_SHORT: CTS with BS but without STmin, NO_FC: nothing is sent
+			}
+
+			if (CANTPBENCH_FAULT_NO_FC != pTester->Fault)
+			{
+				CanTpBench_TesterQueue(pTester, data, (CANTPBENCH_FAULT_FC_SHORT == pTester->Fault) ? 2U : 3U);
+			}
+
+			// the ECU must not send any ConsecutiveFrame of this response
+			pTester->FaultAt_us  = CanTpBench_GetTime_us();
+			pTester->State       = CANTPBENCH_TESTER_FAULT_WAIT;
+			pTester->Deadline_us = CanTpBench_GetTime_us() + CANTPBENCH_TESTER_N_CR_US;
+			break;
+		}
+
+		default:
+			CanTpBench_TesterSendFc(pTester);
+			pTester->State       = CANTPBENCH_TESTER_RX_CF;
+			pTester->Deadline_us = CanTpBench_GetTime_us() + CANTPBENCH_TESTER_N_CR_US;
+			break;
+	}
+}
+
+//=====================================================================================================================
+// CanTpBench_TesterRxCf:
+//=====================================================================================================================
+static void CanTpBench_TesterRxCf(S_CanTpBench_Tester_t* pTester, const S_LibCan_Msg_t* pFrame)
+{
+	const uint32_t frameLen = LibCan_GetMsgDataLength(pFrame->Length);
+	uint32_t length = pTester->RxLen - pTester->RxIdx;
+
+	pTester->RxSn = (uint8_t)((pTester->RxSn + 1U) & 0x0FU);
+	if ((pFrame->Data[0] & 0x0FU) != pTester->RxSn)
+	{
+		CanTpBench_TesterFail(pTester);
+		return;
+	}
+
+	if (length > (frameLen - 1U))
+	{
+		// all ConsecutiveFrames but the last one use RX_DL
+		length = frameLen - 1U;
+		if (frameLen != pTester->RxDl)
+		{
+			CanTpBench_TesterFail(pTester);
+			return;
+		}
+	}
+
+	memcpy(&pTester->RxBuf[pTester->RxIdx], &pFrame->Data[1], length);
+	pTester->RxIdx += length;
+	pTester->Deadline_us = CanTpBench_GetTime_us() + CANTPBENCH_TESTER_N_CR_US;
+
+	if (pTester->RxIdx >= pTester->RxLen)
+	{
+		CanTpBench_TesterComplete(pTester);
+	}
+	else if ((0U != CanTpBench_pTesterScenario->BlockSize)
+			 && (++pTester->RxCfInBlock >= CanTpBench_pTesterScenario->BlockSize))
+	{
+		pTester->RxCfInBlock = 0U;
+		CanTpBench_TesterSendFc(pTester);
+	}
+	else
+	{
+		// more ConsecutiveFrames of the block
+	}
+}
+
+//=====================================================================================================================
+// CanTpBench_TesterSendFc:
+//=====================================================================================================================
+static void CanTpBench_TesterSendFc(S_CanTpBench_Tester_t* pTester)
+{
+	const uint8_t data[3] = { CANTPBENCH_PCI_FC | CANTPBENCH_FS_CTS, CanTpBench_pTesterScenario->BlockSize,
+							  CanTpBench_pTesterScenario->SepTimeMin };
+	CanTpBench_TesterQueue(pTester, data, sizeof(data));
+}
+
+//=====================================================================================================================
+// CanTpBench_TesterComplete:
+//=====================================================================================================================
+static void CanTpBench_TesterComplete(S_CanTpBench_Tester_t* pTester)
+{
+	const uint32_t latency_us = CanTpBench_GetTime_us() - pTester->Start_us;
+	bool_t isValid = (pTester->RxLen == CanTpBench_pTesterScenario->RespLen)
+					 && (CANTPBENCH_RESP_SID == pTester->RxBuf[0]);
+
+	for (uint32_t i = 1U; isValid && (i < pTester->RxLen); i++)
+	{
+		isValid = (pTester->RxBuf[i] == (uint8_t)((i * 7U) + 1U));
+	}
+
+	if (!isValid)
+	{
+		CanTpBench_TesterFail(pTester);
+		return;
+	}
+
+	pTester->Done++;
+	pTester->Bytes         += pTester->TxLen + pTester->RxLen;
+	pTester->LatencySum_us += latency_us;
+	if (latency_us < pTester->LatencyMin_us)
+	{
+		pTester->LatencyMin_us = latency_us;
+	}
+	if (latency_us > pTester->LatencyMax_us)
+	{
+		pTester->LatencyMax_us = latency_us;
+	}
+	pTester->State = CANTPBENCH_TESTER_IDLE;
+}
+
+//=====================================================================================================================
+// CanTpBench_TesterFail:
+//=====================================================================================================================
+static void CanTpBench_TesterFail(S_CanTpBench_Tester_t* pTester)
+{
+	// counted by CanTpBench_TesterGetResult() as an exchange which is not done
+	pTester->State = CANTPBENCH_TESTER_IDLE;
+}
+
+//=====================================================================================================================
+// CanTpBench_TesterQueue:
+//=====================================================================================================================
+static void CanTpBench_TesterQueue(S_CanTpBench_Tester_t* pTester, const uint8_t* pData, const uint32_t length)
+{
+	S_LibCan_Msg_t* const pFrame = &pTester->Frame;
+
+	memset(pFrame, 0, sizeof(*pFrame));
+	memset(pFrame->Data, CANTPBENCH_PADDING, sizeof(pFrame->Data));
+	memcpy(pFrame->Data, pData, length);
+	pFrame->CanDevId = LIBDRV_DEVID_MCAN;
+	pFrame->Id       = pTester->ReqId;
+	pFrame->IsCanFd  = CANTPBENCH_IS_CANFD;
+	pFrame->IsBrs    = CANTPBENCH_IS_CANFD;
+
+	// classic frames are padded to 8 bytes, CAN FD frames to the next DLC (at least 8 bytes)
+	if ((!CANTPBENCH_IS_CANFD) || (length <= 8U))
+	{
+		pFrame->Length = ((CANTPBENCH_FAULT_FC_SHORT == pTester->Fault) && (length < 3U))
+						 ? LibCan_GetMsgDlc((uint8_t)length) : LIBCAN_DLCSIZE_8_B;
+	}
+	else
+	{
+		pFrame->Length = LibCan_GetMsgDlc((uint8_t)length);
+	}
+	if ((!CANTPBENCH_IS_CANFD) && (CANTPBENCH_FAULT_DLC_ABOVE_8 == pTester->Fault))
+	{
+		// the DLC 9 to 15 of a classic frame stands for 8 data bytes (ISO 11898-1)
+		pFrame->Length = LIBCAN_DLCSIZE_64_B;
+	}
+	pTester->HasFrame = true;
+}
+
+//=====================================================================================================================
+// CanTpBench_DecodeSepTimeMin_us:
+//=====================================================================================================================
+static uint32_t CanTpBench_DecodeSepTimeMin_us(const uint8_t sepTimeMin)
+{
+	uint32_t sepTimeMin_us;
+
+	if (sepTimeMin <= 0x7FU)
+	{
+		sepTimeMin_us = (uint32_t)sepTimeMin * 1000U;
+	}
+	else if ((sepTimeMin >= 0xF1U) && (sepTimeMin <= 0xF9U))
+	{
+		sepTimeMin_us = (uint32_t)(sepTimeMin - 0xF0U) * 100U;
+	}
+	else
+	{
+		// reserved values are interpreted as the longest STmin
+		sepTimeMin_us = 127000U;
+	}
+
+	return sepTimeMin_us;
+}
+
+//=====================================================================================================================
+// CanTpBench_IsElapsed:
+//=====================================================================================================================
+static bool_t CanTpBench_IsElapsed(const uint32_t time_us)
+{
+	return ((int32_t)(CanTpBench_GetTime_us() - time_us) >= 0);
+}
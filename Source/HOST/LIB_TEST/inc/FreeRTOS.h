@@ -0,0 +1,31 @@
+// --------------------------------------------------------------------------------------------------------------------
+///
+/// \file FreeRTOS.h
+///
+/// \brief Host replacement of the FreeRTOS header for the library tests
+///
+/// The tests run the libraries in POSIX threads, each thread standing for a task or an interrupt service routine.
+/// Nothing of the kernel is used apart from the interrupt locks.
+///
+/// Copyright (c) 2021 Neusoft.
+/// All Rights Reserved.
+///
+// --------------------------------------------------------------------------------------------------------------------
+
+#ifndef LIBTEST_FREERTOS_H__INCLUDED
+#define LIBTEST_FREERTOS_H__INCLUDED
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Global Function Prototypes
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief CMSIS interrupt locks, which the FreeRTOS port of the target includes (defined in LibTestSim.c)
+///
+/// Suspending all interrupts is emulated by one global recursive mutex: a section locked by one thread excludes the
+/// locked sections of all other threads, as on the single core target.
+// --------------------------------------------------------------------------------------------------------------------
+extern void __disable_irq(void);
+extern void __enable_irq(void);
+
+#endif // LIBTEST_FREERTOS_H__INCLUDED
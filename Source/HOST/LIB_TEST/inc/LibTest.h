@@ -0,0 +1,95 @@
+// --------------------------------------------------------------------------------------------------------------------
+///
+/// \file LibTest.h
+///
+/// \brief Common definitions of the host library tests
+///
+/// Every test is a function returning true on success. Tests check their conditions with LIBTEST_CHECK(), which
+/// reports the failed condition and returns false. Benchmarks are registered the same way but only run on request
+/// and print their measurements.
+///
+/// Copyright (c) 2021 Neusoft.
+/// All Rights Reserved.
+///
+// --------------------------------------------------------------------------------------------------------------------
+
+#ifndef LIBTEST_H__INCLUDED
+#define LIBTEST_H__INCLUDED
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Includes
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "LibTypes.h"
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Global Definitions
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Check a condition of a test: on failure report it and fail the test
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTEST_CHECK(condition)																					\
+	do {																											\
+		if (!(condition))																							\
+		{																											\
+			LibTest_ReportFailure(__FILE__, __LINE__, #condition);													\
+			return false;																							\
+		}																											\
+	} while (false)
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Global Function Prototypes
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Report a failed condition of the running test (LibTestMain.c)
+// --------------------------------------------------------------------------------------------------------------------
+void LibTest_ReportFailure(const char* pFile, const int line, const char* pCondition);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Monotonic host clock in nanoseconds (LibTestSim.c)
+// --------------------------------------------------------------------------------------------------------------------
+uint64_t LibTest_GetTime_ns(void);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Duration of the long running tests: LIBTEST_DURATION_S from the environment, else the default (LibTestSim.c)
+// --------------------------------------------------------------------------------------------------------------------
+uint64_t LibTest_GetDuration_ns(const uint64_t default_ns);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Reproducible pseudo random numbers (xorshift32) from the given state, which must not be zero (LibTestSim.c)
+// --------------------------------------------------------------------------------------------------------------------
+uint32_t LibTest_Random(uint32_t* const pState);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Tests and benchmark of LibFifoQueue (LibTestFifo.c)
+// --------------------------------------------------------------------------------------------------------------------
+bool_t LibTestFifo_SpscThreads(void);
+bool_t LibTestFifo_SharedThreads(void);
+bool_t LibTestFifo_ReservePopCommit(void);
+bool_t LibTestFifo_Bench(void);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Replay of a bursty receive trace through the overflow policies of LibFifoQueue (LibTestFifoReplay.c)
+// --------------------------------------------------------------------------------------------------------------------
+bool_t LibTestFifo_OverflowReplay(void);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Tests of LibService and LibServiceHost (LibTestService.c)
+// --------------------------------------------------------------------------------------------------------------------
+bool_t LibTestService_EventStress(void);
+bool_t LibTestService_PassBudget(void);
+#ifdef LIBSERVICECFG_PROFILING
+bool_t LibTestService_Profile(void);
+#endif // LIBSERVICECFG_PROFILING
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Tests and benchmark of LibTimer (LibTestTimer.c)
+// --------------------------------------------------------------------------------------------------------------------
+bool_t LibTestTimer_RearmOrder(void);
+bool_t LibTestTimer_StepTicks(void);
+bool_t LibTestTimer_Model(void);
+bool_t LibTestTimer_Bench(void);
+
+#endif // LIBTEST_H__INCLUDED
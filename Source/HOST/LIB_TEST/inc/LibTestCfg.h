@@ -0,0 +1,50 @@
+// --------------------------------------------------------------------------------------------------------------------
+///
+/// \file LibTestCfg.h
+///
+/// \brief Host configuration of the libraries for the library tests
+///
+/// Included before every source file of the test build (-include). The configuration of the target is used unchanged
+/// unless a variant of the build selects otherwise:
+///   LIBTESTCFG_TIMER_LIST             LibTimer uses the sorted list instead of the timing wheel
+///   LIBTESTCFG_TIMER_ISR_CALLBACKS    LibTimer invokes the callbacks from the tick instead of LibTimer_Dispatch()
+///   LIBTESTCFG_FIFO_STATISTICS        LibFifoQueue records the statistics of the queues
+///   LIBTESTCFG_SERVICE_PROFILING      LibServiceHost profiles the execution time of the services
+///
+/// Copyright (c) 2021 Neusoft.
+/// All Rights Reserved.
+///
+// --------------------------------------------------------------------------------------------------------------------
+
+#ifndef LIBTESTCFG_H__INCLUDED
+#define LIBTESTCFG_H__INCLUDED
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Includes
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "LibFifoQueueCfg.h"
+#include "LibServiceCfg.h"
+#include "LibTimerCfg.h"
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Global Definitions
+// --------------------------------------------------------------------------------------------------------------------
+
+#ifdef LIBTESTCFG_TIMER_LIST
+#undef LIBTIMERCFG_TIMING_WHEEL
+#endif
+
+#ifdef LIBTESTCFG_TIMER_ISR_CALLBACKS
+#undef LIBTIMERCFG_DEFERRED_CALLBACKS
+#endif
+
+#if defined(LIBTESTCFG_FIFO_STATISTICS) && !defined(LIBFIFOQUEUECFG_STATISTICS)
+#define LIBFIFOQUEUECFG_STATISTICS
+#endif
+
+#if defined(LIBTESTCFG_SERVICE_PROFILING) && !defined(LIBSERVICECFG_PROFILING)
+#define LIBSERVICECFG_PROFILING
+#endif
+
+#endif // LIBTESTCFG_H__INCLUDED
@@ -0,0 +1,15 @@
+// --------------------------------------------------------------------------------------------------------------------
+///
+/// \file usart.h
+///
+/// \brief Host replacement of the CubeMX USART header for the library tests
+///
+/// Copyright (c) 2021 Neusoft.
+/// All Rights Reserved.
+///
+// --------------------------------------------------------------------------------------------------------------------
+
+#ifndef LIBTEST_USART_H__INCLUDED
+#define LIBTEST_USART_H__INCLUDED
+
+#endif // LIBTEST_USART_H__INCLUDED
@@ -0,0 +1,496 @@
+// --------------------------------------------------------------------------------------------------------------------
+///
+/// \file LibTestFifo.c
+///
+/// \brief Tests of LibFifoQueue
+///
+/// The thread tests run a producer and a consumer on separate threads for LIBTEST_DURATION_S seconds (default 1 s),
+/// long runs are started by e.g.
+///		LIBTEST_DURATION_S=10800 ./build/LibTest fifo_spsc_threads
+///
+/// Copyright (c) 2021 Neusoft.
+/// All Rights Reserved.
+///
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Includes
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "LibTest.h"
+#include "LibFifoQueue.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Definitions
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Number of items of the queue under test, small so that the queue runs full and empty all the time
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTESTFIFO_NUM_ITEMS			(16U)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Number of items of the locked queues under test, not a power of two so that the indexes wrap explicitly
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTESTFIFO_NUM_LOCKED_ITEMS	(5U)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Maximum number of items pushed or popped at once
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTESTFIFO_MAX_BURST			(6U)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Default duration of the thread test
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTESTFIFO_DURATION_NS			UINT64_C(1000000000)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Number of items of the benchmark queues, the largest burst fits and the bursts wrap around the buffer
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTESTFIFO_BENCH_NUM_ITEMS		(128U)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Number of items dequeued per measurement of the benchmark
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTESTFIFO_BENCH_ITEMS			(UINT32_C(1) << 22)
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Data Types
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Item of the queue: all words are derived from the sequence number to detect torn or stale items
+// --------------------------------------------------------------------------------------------------------------------
+typedef struct S_LibTestFifo_Item_t {
+	uint32_t	Seq;
+	uint32_t	Check[3];
+} S_LibTestFifo_Item_t;
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Item of the benchmark, the size of S_LibCan_Msg_t in the host build of the CAN stack
+// --------------------------------------------------------------------------------------------------------------------
+typedef struct S_LibTestFifo_BenchItem_t {
+	uint32_t	Words[7];
+} S_LibTestFifo_BenchItem_t;
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Dequeue method measured by the benchmark
+// --------------------------------------------------------------------------------------------------------------------
+typedef enum E_LibTestFifo_Dequeue_t {
+	LIBTESTFIFO_DEQUEUE_CLEAR,          ///< no dequeue, the queue is cleared: the cost of the push and the loop
+	LIBTESTFIFO_DEQUEUE_GETITEM_POP,    ///< LibFifoQueue_GetItem(0) and LibFifoQueue_Pop() per item
+	LIBTESTFIFO_DEQUEUE_SPANS_POPN      ///< LibFifoQueue_GetSpans() and one LibFifoQueue_PopN() per burst
+} E_LibTestFifo_Dequeue_t;
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief State of a producer/consumer run
+// --------------------------------------------------------------------------------------------------------------------
+typedef struct S_LibTestFifo_Run_t {
+	S_LibFifoQueue_Inst_t*	pFifo;
+	uint64_t	Duration_ns;
+	uint32_t	NumProduced;        ///< written by the producer when it has finished
+	bool_t		IsProduced;         ///< set by the producer when it has finished
+	uint32_t	NumConsumed;
+	uint32_t	NumErrors;
+} S_LibTestFifo_Run_t;
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Function Prototypes
+// --------------------------------------------------------------------------------------------------------------------
+
+static bool_t LibTestFifo_RunThreads(S_LibFifoQueue_Inst_t* const pFifo);
+static void* LibTestFifo_ProducerThread(void* pArg);
+static void* LibTestFifo_ConsumerThread(void* pArg);
+static void LibTestFifo_MakeItem(S_LibTestFifo_Item_t* const pItem, const uint32_t seq);
+static bool_t LibTestFifo_IsItem(const S_LibTestFifo_Item_t* const pItem, const uint32_t seq);
+static uint64_t LibTestFifo_BenchDequeue(S_LibFifoQueue_Inst_t* const pFifo, const uint32_t burst,
+	const E_LibTestFifo_Dequeue_t method);
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Variables
+// --------------------------------------------------------------------------------------------------------------------
+
+static S_LibTestFifo_Item_t LibTestFifo_SpscBuffer[LIBTESTFIFO_NUM_ITEMS];
+
+static LIBFIFO_DEFINE_SPSC_INST(LibTestFifo_SpscFifo, (uint32_t*)(void*)LibTestFifo_SpscBuffer,
+	sizeof(S_LibTestFifo_Item_t), LIBTESTFIFO_NUM_ITEMS);
+
+static S_LibTestFifo_Item_t LibTestFifo_SharedBuffer[LIBTESTFIFO_NUM_LOCKED_ITEMS];
+
+static LIBFIFO_DEFINE_SHARED_INST(LibTestFifo_SharedFifo, (uint32_t*)(void*)LibTestFifo_SharedBuffer,
+	sizeof(S_LibTestFifo_Item_t), LIBTESTFIFO_NUM_LOCKED_ITEMS, false);
+
+static S_LibTestFifo_BenchItem_t LibTestFifo_BenchBuffer[LIBTESTFIFO_BENCH_NUM_ITEMS];
+
+static LIBFIFO_DEFINE_INST(LibTestFifo_BenchFifo, (uint32_t*)(void*)LibTestFifo_BenchBuffer,
+	sizeof(S_LibTestFifo_BenchItem_t), LIBTESTFIFO_BENCH_NUM_ITEMS, false);
+
+static LIBFIFO_DEFINE_SHARED_INST(LibTestFifo_BenchSharedFifo, (uint32_t*)(void*)LibTestFifo_BenchBuffer,
+	sizeof(S_LibTestFifo_BenchItem_t), LIBTESTFIFO_BENCH_NUM_ITEMS, false);
+
+static LIBFIFO_DEFINE_SPSC_INST(LibTestFifo_BenchSpscFifo, (uint32_t*)(void*)LibTestFifo_BenchBuffer,
+	sizeof(S_LibTestFifo_BenchItem_t), LIBTESTFIFO_BENCH_NUM_ITEMS);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Sum of the dequeued items, keeps the compiler from dropping the reads of the benchmark
+// --------------------------------------------------------------------------------------------------------------------
+static volatile uint32_t LibTestFifo_BenchSink = 0U;
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Functions
+// --------------------------------------------------------------------------------------------------------------------
+
+//=====================================================================================================================
+// LibTestFifo_SpscThreads:
+//=====================================================================================================================
+bool_t LibTestFifo_SpscThreads(void)
+{
+	LibFifoQueue_Init(&LibTestFifo_SpscFifo, 0U, 0U);
+	return LibTestFifo_RunThreads(&LibTestFifo_SpscFifo);
+}
+
+//=====================================================================================================================
+// LibTestFifo_SharedThreads:
+//=====================================================================================================================
+bool_t LibTestFifo_SharedThreads(void)
+{
+	LibFifoQueue_Clear(&LibTestFifo_SharedFifo);
+	return LibTestFifo_RunThreads(&LibTestFifo_SharedFifo);
+}
+
+//=====================================================================================================================
+// LibTestFifo_ReservePopCommit:
+//=====================================================================================================================
+bool_t LibTestFifo_ReservePopCommit(void)
+{
+	uint32_t seq = 0U;
+
+	// the consumer pops the last item or clears the queue while the producer holds a reservation, at every position of
+	// the indexes: the committed item must be the reserved one
+	LibFifoQueue_Init(&LibTestFifo_SharedFifo, 0U, 0U);
+	for (uint32_t i = 0U; i < (3U * LIBTESTFIFO_NUM_LOCKED_ITEMS); i++)
+	{
+		S_LibTestFifo_Item_t item;
+		S_LibTestFifo_Item_t* pItem;
+
+		LibTestFifo_MakeItem(&item, seq);
+		LIBTEST_CHECK(LibFifoQueue_Push(&LibTestFifo_SharedFifo, &item));
+		seq++;
+
+		pItem = (S_LibTestFifo_Item_t*)LibFifoQueue_Reserve(&LibTestFifo_SharedFifo);
+		LIBTEST_CHECK(NULL != pItem);
+		// the reserved element is not counted before the commit
+		LIBTEST_CHECK(1U == LibFifoQueue_GetCount(&LibTestFifo_SharedFifo));
+		if (0U == (i % 3U))
+		{
+			LibFifoQueue_Clear(&LibTestFifo_SharedFifo);
+		}
+		else
+		{
+			LIBTEST_CHECK(LibFifoQueue_PopCopy(&LibTestFifo_SharedFifo, &item));
+			LIBTEST_CHECK(LibTestFifo_IsItem(&item, seq - 1U));
+		}
+		LibTestFifo_MakeItem(pItem, seq);
+		LibFifoQueue_Commit(&LibTestFifo_SharedFifo);
+
+		LIBTEST_CHECK(LibFifoQueue_PopCopy(&LibTestFifo_SharedFifo, &item));
+		LIBTEST_CHECK(LibTestFifo_IsItem(&item, seq));
+		LIBTEST_CHECK(NULL == LibFifoQueue_Peek(&LibTestFifo_SharedFifo));
+		seq++;
+
+		// a reservation of an empty queue followed by a push after the commit keeps the order
+		pItem = (S_LibTestFifo_Item_t*)LibFifoQueue_Reserve(&LibTestFifo_SharedFifo);
+		LIBTEST_CHECK(NULL != pItem);
+		LibTestFifo_MakeItem(pItem, seq);
+		LibFifoQueue_Commit(&LibTestFifo_SharedFifo);
+		LibTestFifo_MakeItem(&item, seq + 1U);
+		LIBTEST_CHECK(LibFifoQueue_Push(&LibTestFifo_SharedFifo, &item));
+		LIBTEST_CHECK(LibTestFifo_IsItem((const S_LibTestFifo_Item_t*)LibFifoQueue_GetItem(&LibTestFifo_SharedFifo, 0U),
+										 seq));
+		LIBTEST_CHECK(LibTestFifo_IsItem((const S_LibTestFifo_Item_t*)LibFifoQueue_GetItem(&LibTestFifo_SharedFifo, 1U),
+										 seq + 1U));
+		LIBTEST_CHECK(2U == LibFifoQueue_GetCount(&LibTestFifo_SharedFifo));
+		LibFifoQueue_PopN(&LibTestFifo_SharedFifo, 2U);
+		seq += 2U;
+	}
+
+	return true;
+}
+
+//=====================================================================================================================
+// LibTestFifo_Bench:
+//=====================================================================================================================
+bool_t LibTestFifo_Bench(void)
+{
+	static const uint32_t Bursts[] = { 1U, 8U, 64U };
+	static const struct {
+		const char*				pName;
+		S_LibFifoQueue_Inst_t*	pFifo;
+	} Queues[] = {
+		{ "locked", &LibTestFifo_BenchFifo },
+		{ "shared", &LibTestFifo_BenchSharedFifo },
+		{ "spsc", &LibTestFifo_BenchSpscFifo },
+	};
+
+	// per item cost of the dequeue: the cost of pushing the burst and clearing the queue is subtracted. The lock of
+	// shared queues is the emulation by a mutex, not the interrupt lock of the target.
+	printf("  %8s %8s %18s %18s\n", "queue", "burst", "GetItem+Pop ns", "spans+PopN ns");
+	for (uint32_t q = 0U; q < (sizeof(Queues) / sizeof(Queues[0])); q++)
+	{
+		for (uint32_t b = 0U; b < (sizeof(Bursts) / sizeof(Bursts[0])); b++)
+		{
+			const uint64_t clear_ns = LibTestFifo_BenchDequeue(Queues[q].pFifo, Bursts[b], LIBTESTFIFO_DEQUEUE_CLEAR);
+			const uint64_t single_ns =
+				LibTestFifo_BenchDequeue(Queues[q].pFifo, Bursts[b], LIBTESTFIFO_DEQUEUE_GETITEM_POP);
+			const uint64_t spans_ns =
+				LibTestFifo_BenchDequeue(Queues[q].pFifo, Bursts[b], LIBTESTFIFO_DEQUEUE_SPANS_POPN);
+
+			LIBTEST_CHECK(NULL == LibFifoQueue_Peek(Queues[q].pFifo));
+			printf("  %8s %8u %18.2f %18.2f\n", Queues[q].pName, (unsigned)Bursts[b],
+				((double)single_ns - (double)clear_ns) / LIBTESTFIFO_BENCH_ITEMS,
+				((double)spans_ns - (double)clear_ns) / LIBTESTFIFO_BENCH_ITEMS);
+		}
+	}
+
+	return true;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Functions
+// --------------------------------------------------------------------------------------------------------------------
+
+//=====================================================================================================================
+// LibTestFifo_RunThreads:
+//=====================================================================================================================
+static bool_t LibTestFifo_RunThreads(S_LibFifoQueue_Inst_t* const pFifo)
+{
+	S_LibTestFifo_Run_t run = { .pFifo = pFifo, .Duration_ns = LibTest_GetDuration_ns(LIBTESTFIFO_DURATION_NS) };
+	pthread_t producerThread;
+	pthread_t consumerThread;
+
+	// every item pushed must be consumed exactly once, in order and unchanged
+	LIBTEST_CHECK(0 == pthread_create(&consumerThread, NULL, LibTestFifo_ConsumerThread, &run));
+	LIBTEST_CHECK(0 == pthread_create(&producerThread, NULL, LibTestFifo_ProducerThread, &run));
+	(void)pthread_join(producerThread, NULL);
+	(void)pthread_join(consumerThread, NULL);
+
+	LIBTEST_CHECK(0U == run.NumErrors);
+	LIBTEST_CHECK(run.NumProduced == run.NumConsumed);
+	LIBTEST_CHECK(NULL == LibFifoQueue_Peek(pFifo));
+
+	return true;
+}
+
+//=====================================================================================================================
+// LibTestFifo_ProducerThread:
+//=====================================================================================================================
+static void* LibTestFifo_ProducerThread(void* pArg)
+{
+	S_LibTestFifo_Run_t* const pRun = (S_LibTestFifo_Run_t*)pArg;
+	const uint64_t start_ns = LibTest_GetTime_ns();
+	uint32_t random = UINT32_C(0x12345678);
+	uint32_t seq = 0U;
+	uint32_t numOps = 0U;
+
+	// check the time only every few operations, the clock is slower than the queue
+	while (((++numOps & 0xFFU) != 0U) || ((LibTest_GetTime_ns() - start_ns) < pRun->Duration_ns))
+	{
+		const uint32_t op = LibTest_Random(&random);
+		S_LibTestFifo_Item_t items[LIBTESTFIFO_MAX_BURST];
+		uint32_t numPushed = 0U;
+
+		if (0U == (op & 3U))
+		{
+			S_LibTestFifo_Item_t* const pItem = (S_LibTestFifo_Item_t*)LibFifoQueue_Reserve(pRun->pFifo);
+
+			if (NULL != pItem)
+			{
+				LibTestFifo_MakeItem(pItem, seq);
+				LibFifoQueue_Commit(pRun->pFifo);
+				numPushed = 1U;
+			}
+		}
+		else if (1U == (op & 3U))
+		{
+			const uint32_t numItems = 1U + ((op >> 8) % LIBTESTFIFO_MAX_BURST);
+
+			for (uint32_t i = 0U; i < numItems; i++)
+			{
+				LibTestFifo_MakeItem(&items[i], seq + i);
+			}
+			numPushed = LibFifoQueue_PushN(pRun->pFifo, items, numItems);
+		}
+		else
+		{
+			LibTestFifo_MakeItem(&items[0], seq);
+			numPushed = LibFifoQueue_Push(pRun->pFifo, &items[0]) ? 1U : 0U;
+		}
+
+		seq += numPushed;
+		if (0U == numPushed)
+		{
+			(void)sched_yield();
+		}
+	}
+
+	LibAtomic_Store(&pRun->NumProduced, seq);
+	LibAtomic_Store(&pRun->IsProduced, true);
+
+	return NULL;
+}
+
+//=====================================================================================================================
+// LibTestFifo_ConsumerThread:
+//=====================================================================================================================
+static void* LibTestFifo_ConsumerThread(void* pArg)
+{
+	S_LibTestFifo_Run_t* const pRun = (S_LibTestFifo_Run_t*)pArg;
+	uint32_t random = UINT32_C(0x87654321);
+	uint32_t seq = 0U;
+	bool_t isDone = false;
+
+	while (!isDone)
+	{
+		// read the end of production before the queue, so that the queue is known to hold all remaining items
+		const bool_t isProduced = LibAtomic_Load(&pRun->IsProduced);
+		const uint32_t op = LibTest_Random(&random);
+		uint32_t numPopped = 0U;
+
+		if (0U == (op & 3U))
+		{
+			S_LibTestFifo_Item_t item;
+
+			if (LibFifoQueue_PopCopy(pRun->pFifo, &item))
+			{
+				pRun->NumErrors += LibTestFifo_IsItem(&item, seq) ? 0U : 1U;
+				numPopped = 1U;
+			}
+		}
+		else if (1U == (op & 3U))
+		{
+			S_LibFifoQueue_Span_t spans[LIBFIFO_NUM_SPANS];
+			const uint32_t numItems = LibFifoQueue_GetSpans(pRun->pFifo, spans);
+			// the producer only adds items, the count read afterwards is not below the items of the spans
+			const uint32_t count = LibFifoQueue_GetCount(pRun->pFifo);
+			const uint32_t numToPop = (numItems < (1U + ((op >> 8) % LIBTESTFIFO_MAX_BURST))) ?
+				numItems : (1U + ((op >> 8) % LIBTESTFIFO_MAX_BURST));
+
+			for (uint32_t i = 0U; i < numToPop; i++)
+			{
+				const S_LibTestFifo_Item_t* const pItem = (i < spans[0].NumItems) ?
+					&((const S_LibTestFifo_Item_t*)spans[0].pItems)[i] :
+					&((const S_LibTestFifo_Item_t*)spans[1].pItems)[i - spans[0].NumItems];
+
+				pRun->NumErrors += LibTestFifo_IsItem(pItem, seq + i) ? 0U : 1U;
+			}
+			pRun->NumErrors += ((count >= numItems) && (count <= pRun->pFifo->NumMaxItems)) ? 0U : 1U;
+			LibFifoQueue_PopN(pRun->pFifo, numToPop);
+			numPopped = numToPop;
+		}
+		else
+		{
+			const S_LibTestFifo_Item_t* const pItem = (const S_LibTestFifo_Item_t*)LibFifoQueue_Peek(pRun->pFifo);
+
+			if (NULL != pItem)
+			{
+				pRun->NumErrors += LibTestFifo_IsItem(pItem, seq) ? 0U : 1U;
+				LibFifoQueue_Release(pRun->pFifo);
+				numPopped = 1U;
+			}
+		}
+
+		seq += numPopped;
+		if (0U == numPopped)
+		{
+			isDone = isProduced;
+			(void)sched_yield();
+		}
+	}
+
+	pRun->NumConsumed = seq;
+
+	return NULL;
+}
+
+//=====================================================================================================================
+// LibTestFifo_MakeItem:
+//=====================================================================================================================
+static void LibTestFifo_MakeItem(S_LibTestFifo_Item_t* const pItem, const uint32_t seq)
+{
+	pItem->Seq = seq;
+	pItem->Check[0] = ~seq;
+	pItem->Check[1] = seq * UINT32_C(0x9E3779B9);
+	pItem->Check[2] = seq ^ UINT32_C(0xA5A5A5A5);
+}
+
+//=====================================================================================================================
+// LibTestFifo_IsItem:
+//=====================================================================================================================
+static bool_t LibTestFifo_IsItem(const S_LibTestFifo_Item_t* const pItem, const uint32_t seq)
+{
+	S_LibTestFifo_Item_t expected;
+
+	LibTestFifo_MakeItem(&expected, seq);
+	return (pItem->Seq == expected.Seq) && (pItem->Check[0] == expected.Check[0]) &&
+		(pItem->Check[1] == expected.Check[1]) && (pItem->Check[2] == expected.Check[2]);
+}
+
+//=====================================================================================================================
+// LibTestFifo_BenchDequeue:
+//=====================================================================================================================
+static uint64_t LibTestFifo_BenchDequeue(S_LibFifoQueue_Inst_t* const pFifo, const uint32_t burst,
+	const E_LibTestFifo_Dequeue_t method)
+{
+	static S_LibTestFifo_BenchItem_t Items[LIBTESTFIFO_BENCH_NUM_ITEMS];
+	uint32_t sum = 0U;
+	uint64_t start_ns;
+
+	for (uint32_t i = 0U; i < burst; i++)
+	{
+		Items[i].Words[0] = i;
+	}
+	LibFifoQueue_Clear(pFifo);
+
+	start_ns = LibTest_GetTime_ns();
+	for (uint32_t round = 0U; round < (LIBTESTFIFO_BENCH_ITEMS / burst); round++)
+	{
+		(void)LibFifoQueue_PushN(pFifo, Items, burst);
+
+		if (LIBTESTFIFO_DEQUEUE_GETITEM_POP == method)
+		{
+			const S_LibTestFifo_BenchItem_t* pItem;
+
+			while (NULL != (pItem = (const S_LibTestFifo_BenchItem_t*)LibFifoQueue_GetItem(pFifo, 0U)))
+			{
+				sum += pItem->Words[0];
+				LibFifoQueue_Pop(pFifo);
+			}
+		}
+		else if (LIBTESTFIFO_DEQUEUE_SPANS_POPN == method)
+		{
+			S_LibFifoQueue_Span_t spans[LIBFIFO_NUM_SPANS];
+			const uint32_t numItems = LibFifoQueue_GetSpans(pFifo, spans);
+
+			for (uint32_t span = 0U; span < LIBFIFO_NUM_SPANS; span++)
+			{
+				const S_LibTestFifo_BenchItem_t* const pItems = (const S_LibTestFifo_BenchItem_t*)spans[span].pItems;
+
+				for (uint32_t i = 0U; i < spans[span].NumItems; i++)
+				{
+					sum += pItems[i].Words[0];
+				}
+			}
+			LibFifoQueue_PopN(pFifo, numItems);
+		}
+		else
+		{
+			LibFifoQueue_Clear(pFifo);
+		}
+	}
+	LibTestFifo_BenchSink += sum;
+
+	return LibTest_GetTime_ns() - start_ns;
+}
@@ -0,0 +1,334 @@
+// --------------------------------------------------------------------------------------------------------------------
+///
+/// \file LibTestFifoReplay.c
+///
+/// \brief Replay of a bursty CAN receive trace through the overflow policies of LibFifoQueue
+///
+/// A synthetic trace is pushed into a small receive queue which is drained at a constant rate, as the CAN task drains
+/// the receive queue filled by the receive ISR. The replay reports the frames lost by each overflow policy:
+/// - clear:       the queue is cleared on overflow (the former behaviour of the receive queues)
+/// - drop-newest: the pushed frame is dropped
+/// - drop-oldest: the oldest frame is dropped (overwrite flag)
+/// - coalesce:    the newest queued frame with the same ID is replaced, else the pushed frame is dropped
+/// - priority:    drop-newest with the last CANIF_MSG_RECV_PRIORITY_ELEMENTS entries kept for NM and TP frames, as in
+///                HAL_CAN_RxFifo0MsgPendingCallback(); also replayed without reserved entries
+///
+/// Copyright (c) 2021 Neusoft.
+/// All Rights Reserved.
+///
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Includes
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "LibTest.h"
+#include "LibFifoQueue.h"
+#include "LibFifoTyped.h"
+#include <stdio.h>
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Definitions
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Parameters of the trace: ticks, share of burst ticks in percent, frames of a burst tick, CAN IDs
+///
+/// A normal tick receives one frame. The IDs below LIBTESTFIFOREPLAY_NUM_PRIORITY_IDS are NM and TP frames.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTESTFIFOREPLAY_NUM_TICKS			(100000U)
+#define LIBTESTFIFOREPLAY_BURST_PERCENT		(5U)
+#define LIBTESTFIFOREPLAY_BURST_MIN			(6U)
+#define LIBTESTFIFOREPLAY_BURST_MAX			(15U)
+#define LIBTESTFIFOREPLAY_NUM_IDS			(12U)
+#define LIBTESTFIFOREPLAY_NUM_PRIORITY_IDS	(2U)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Size of the receive queue, frames drained per tick and entries reserved for priority frames
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTESTFIFOREPLAY_NUM_ITEMS			(8U)
+#define LIBTESTFIFOREPLAY_DRAIN_PER_TICK	(2U)
+#define LIBTESTFIFOREPLAY_RESERVED_ITEMS	(2U)
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Data Types
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Received frame of the trace
+// --------------------------------------------------------------------------------------------------------------------
+typedef struct S_LibTestFifoReplay_Frame_t {
+	uint32_t	Id;
+	uint32_t	Seq;
+} S_LibTestFifoReplay_Frame_t;
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Overflow policy of a replay
+// --------------------------------------------------------------------------------------------------------------------
+typedef enum E_LibTestFifoReplay_Policy_t {
+	LIBTESTFIFOREPLAY_CLEAR,
+	LIBTESTFIFOREPLAY_DROP_NEWEST,
+	LIBTESTFIFOREPLAY_DROP_OLDEST,
+	LIBTESTFIFOREPLAY_COALESCE,
+	LIBTESTFIFOREPLAY_PRIORITY_NONE,
+	LIBTESTFIFOREPLAY_PRIORITY_RESERVED,
+	LIBTESTFIFOREPLAY_NUM_POLICIES
+} E_LibTestFifoReplay_Policy_t;
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Result of a replay
+// --------------------------------------------------------------------------------------------------------------------
+typedef struct S_LibTestFifoReplay_Result_t {
+	uint32_t	NumFrames;
+	uint32_t	NumReceived;        ///< frames drained from the queue
+	uint32_t	NumLost;            ///< frames dropped without a newer frame of the same ID in the queue
+	uint32_t	NumSuperseded;      ///< frames replaced by a newer frame of the same ID
+	uint32_t	NumPriorityFrames;
+	uint32_t	NumPriorityLost;
+} S_LibTestFifoReplay_Result_t;
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Function Prototypes
+// --------------------------------------------------------------------------------------------------------------------
+
+static S_LibTestFifoReplay_Result_t LibTestFifoReplay_Run(const E_LibTestFifoReplay_Policy_t policy);
+static bool_t LibTestFifoReplay_PushQueue(S_LibFifoQueue_Inst_t* const pFifo,
+	const S_LibTestFifoReplay_Frame_t* const pFrame, const E_LibTestFifoReplay_Policy_t policy,
+	S_LibTestFifoReplay_Result_t* const pResult);
+static bool_t LibTestFifoReplay_PushTyped(const S_LibTestFifoReplay_Frame_t* const pFrame, const uint32_t numReserved);
+static bool_t LibTestFifoReplay_IsPriority(const uint32_t id);
+static bool_t LibTestFifoReplay_IsSameId(const void* pQueuedItem, const void* pItem);
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Variables
+// --------------------------------------------------------------------------------------------------------------------
+
+LIBFIFO_DECLARE_TYPED(LibTestFifoReplay_Rx, S_LibTestFifoReplay_Frame_t, LIBTESTFIFOREPLAY_NUM_ITEMS)
+
+static S_LibTestFifoReplay_Rx_Fifo_t LibTestFifoReplay_RxFifo = LIBFIFO_TYPED_INIT();
+
+static S_LibTestFifoReplay_Frame_t LibTestFifoReplay_Buffer[LIBTESTFIFOREPLAY_NUM_ITEMS];
+
+static LIBFIFO_DEFINE_INST(LibTestFifoReplay_DropNewestFifo, (uint32_t*)(void*)LibTestFifoReplay_Buffer,
+	sizeof(S_LibTestFifoReplay_Frame_t), LIBTESTFIFOREPLAY_NUM_ITEMS, false);
+
+static LIBFIFO_DEFINE_INST(LibTestFifoReplay_DropOldestFifo, (uint32_t*)(void*)LibTestFifoReplay_Buffer,
+	sizeof(S_LibTestFifoReplay_Frame_t), LIBTESTFIFOREPLAY_NUM_ITEMS, true);
+
+static LIBFIFO_DEFINE_COALESCING_INST(LibTestFifoReplay_CoalescingFifo, (uint32_t*)(void*)LibTestFifoReplay_Buffer,
+	sizeof(S_LibTestFifoReplay_Frame_t), LIBTESTFIFOREPLAY_NUM_ITEMS, false, false, LibTestFifoReplay_IsSameId);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Names of the policies in the report
+// --------------------------------------------------------------------------------------------------------------------
+static const char* const LibTestFifoReplay_PolicyNames[LIBTESTFIFOREPLAY_NUM_POLICIES] =
+{
+	"clear", "drop-newest", "drop-oldest", "coalesce", "priority, 0 reserved", "priority, 2 reserved"
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Functions
+// --------------------------------------------------------------------------------------------------------------------
+
+//=====================================================================================================================
+// LibTestFifo_OverflowReplay:
+//=====================================================================================================================
+bool_t LibTestFifo_OverflowReplay(void)
+{
+	printf("  %u ticks, %u %% burst ticks of %u-%u frames, %u IDs, %u-entry queue drained by %u frames per tick\n",
+		LIBTESTFIFOREPLAY_NUM_TICKS, LIBTESTFIFOREPLAY_BURST_PERCENT, LIBTESTFIFOREPLAY_BURST_MIN,
+		LIBTESTFIFOREPLAY_BURST_MAX, LIBTESTFIFOREPLAY_NUM_IDS, LIBTESTFIFOREPLAY_NUM_ITEMS,
+		LIBTESTFIFOREPLAY_DRAIN_PER_TICK);
+	printf("  %-22s %8s %8s %8s %11s %15s\n", "policy", "frames", "lost", "lost %", "superseded", "priority lost");
+
+	for (uint32_t policy = 0U; policy < (uint32_t)LIBTESTFIFOREPLAY_NUM_POLICIES; policy++)
+	{
+		const S_LibTestFifoReplay_Result_t result = LibTestFifoReplay_Run((E_LibTestFifoReplay_Policy_t)policy);
+
+		// every frame of the trace is received, lost or superseded
+		LIBTEST_CHECK(result.NumFrames == (result.NumReceived + result.NumLost + result.NumSuperseded));
+		printf("  %-22s %8u %8u %8.1f %11u %8u of %5u\n", LibTestFifoReplay_PolicyNames[policy],
+			(unsigned)result.NumFrames, (unsigned)result.NumLost,
+			(100.0 * (double)result.NumLost) / (double)result.NumFrames, (unsigned)result.NumSuperseded,
+			(unsigned)result.NumPriorityLost, (unsigned)result.NumPriorityFrames);
+	}
+
+	return true;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Functions
+// --------------------------------------------------------------------------------------------------------------------
+
+//=====================================================================================================================
+// LibTestFifoReplay_Run:
+//=====================================================================================================================
+static S_LibTestFifoReplay_Result_t LibTestFifoReplay_Run(const E_LibTestFifoReplay_Policy_t policy)
+{
+	S_LibTestFifoReplay_Result_t result = { 0U };
+	S_LibFifoQueue_Inst_t* pFifo = &LibTestFifoReplay_DropNewestFifo;
+	uint32_t random = UINT32_C(0x5EED0039);
+	uint32_t seq = 0U;
+
+	if (LIBTESTFIFOREPLAY_DROP_OLDEST == policy)
+	{
+		pFifo = &LibTestFifoReplay_DropOldestFifo;
+	}
+	else if (LIBTESTFIFOREPLAY_COALESCE == policy)
+	{
+		pFifo = &LibTestFifoReplay_CoalescingFifo;
+	}
+	LibFifoQueue_Init(pFifo, 0U, 0U);
+	LibTestFifoReplay_Rx_Clear(&LibTestFifoReplay_RxFifo);
+
+	// the same trace for every policy: the random sequence does not depend on the queue
+	for (uint32_t tick = 0U; tick < LIBTESTFIFOREPLAY_NUM_TICKS; tick++)
+	{
+		const bool_t isBurst = (LibTest_Random(&random) % 100U) < LIBTESTFIFOREPLAY_BURST_PERCENT;
+		const uint32_t numFrames = isBurst ? (LIBTESTFIFOREPLAY_BURST_MIN +
+			(LibTest_Random(&random) % ((LIBTESTFIFOREPLAY_BURST_MAX - LIBTESTFIFOREPLAY_BURST_MIN) + 1U))) : 1U;
+
+		for (uint32_t i = 0U; i < numFrames; i++)
+		{
+			const S_LibTestFifoReplay_Frame_t frame = { LibTest_Random(&random) % LIBTESTFIFOREPLAY_NUM_IDS, seq++ };
+			bool_t isStored;
+
+			if ((LIBTESTFIFOREPLAY_PRIORITY_NONE == policy) || (LIBTESTFIFOREPLAY_PRIORITY_RESERVED == policy))
+			{
+				isStored = LibTestFifoReplay_PushTyped(&frame,
+					(LIBTESTFIFOREPLAY_PRIORITY_RESERVED == policy) ? LIBTESTFIFOREPLAY_RESERVED_ITEMS : 0U);
+				result.NumLost += isStored ? 0U : 1U;
+			}
+			else
+			{
+				isStored = LibTestFifoReplay_PushQueue(pFifo, &frame, policy, &result);
+			}
+
+			result.NumFrames++;
+			if (LibTestFifoReplay_IsPriority(frame.Id))
+			{
+				result.NumPriorityFrames++;
+				result.NumPriorityLost += isStored ? 0U : 1U;
+			}
+		}
+
+		for (uint32_t i = 0U; i < LIBTESTFIFOREPLAY_DRAIN_PER_TICK; i++)
+		{
+			S_LibTestFifoReplay_Frame_t frame;
+
+			if ((LIBTESTFIFOREPLAY_PRIORITY_NONE == policy) || (LIBTESTFIFOREPLAY_PRIORITY_RESERVED == policy))
+			{
+				const S_LibTestFifoReplay_Frame_t* const pFrame = LibTestFifoReplay_Rx_Peek(&LibTestFifoReplay_RxFifo);
+
+				if (NULL != pFrame)
+				{
+					LibTestFifoReplay_Rx_Pop(&LibTestFifoReplay_RxFifo);
+					result.NumReceived++;
+				}
+			}
+			else if (LibFifoQueue_PopCopy(pFifo, &frame))
+			{
+				result.NumReceived++;
+			}
+			else
+			{
+				// the queue is empty
+			}
+		}
+	}
+
+	// the frames left in the queue are received later
+	if ((LIBTESTFIFOREPLAY_PRIORITY_NONE == policy) || (LIBTESTFIFOREPLAY_PRIORITY_RESERVED == policy))
+	{
+		result.NumReceived += LibTestFifoReplay_Rx_GetCount(&LibTestFifoReplay_RxFifo);
+	}
+	else
+	{
+		S_LibFifoQueue_Span_t spans[LIBFIFO_NUM_SPANS];
+		result.NumReceived += LibFifoQueue_GetSpans(pFifo, spans);
+	}
+
+	return result;
+}
+
+//=====================================================================================================================
+// LibTestFifoReplay_PushQueue:
+//=====================================================================================================================
+static bool_t LibTestFifoReplay_PushQueue(S_LibFifoQueue_Inst_t* const pFifo,
+	const S_LibTestFifoReplay_Frame_t* const pFrame, const E_LibTestFifoReplay_Policy_t policy,
+	S_LibTestFifoReplay_Result_t* const pResult)
+{
+	S_LibFifoQueue_Span_t spans[LIBFIFO_NUM_SPANS];
+	const bool_t isFull = (LIBTESTFIFOREPLAY_NUM_ITEMS == LibFifoQueue_GetSpans(pFifo, spans));
+	bool_t isStored = LibFifoQueue_Push(pFifo, pFrame);
+
+	if (!isFull)
+	{
+		// stored without overflow
+	}
+	else if (LIBTESTFIFOREPLAY_CLEAR == policy)
+	{
+		// the push failed: the queued frames are lost, the pushed frame is stored
+		pResult->NumLost += LIBTESTFIFOREPLAY_NUM_ITEMS;
+		LibFifoQueue_Clear(pFifo);
+		isStored = LibFifoQueue_Push(pFifo, pFrame);
+	}
+	else if ((LIBTESTFIFOREPLAY_COALESCE == policy) && isStored)
+	{
+		pResult->NumSuperseded++;
+	}
+	else if (LIBTESTFIFOREPLAY_DROP_OLDEST == policy)
+	{
+		// the oldest frame is lost, the pushed frame is stored
+		pResult->NumLost++;
+	}
+	else
+	{
+		pResult->NumLost++;
+	}
+
+	return isStored;
+}
+
+//=====================================================================================================================
+// LibTestFifoReplay_PushTyped:
+//=====================================================================================================================
+static bool_t LibTestFifoReplay_PushTyped(const S_LibTestFifoReplay_Frame_t* const pFrame, const uint32_t numReserved)
+{
+	S_LibTestFifoReplay_Frame_t* const pSlot = LibTestFifoReplay_Rx_Reserve(&LibTestFifoReplay_RxFifo);
+	bool_t isStored = (NULL != pSlot);
+
+	// the frame is read into the reserved entry first, as the receive ISR reads the mailbox
+	if (isStored)
+	{
+		*pSlot = *pFrame;
+		if ((LibTestFifoReplay_Rx_GetCount(&LibTestFifoReplay_RxFifo) >= (LIBTESTFIFOREPLAY_NUM_ITEMS - numReserved)) &&
+			!LibTestFifoReplay_IsPriority(pFrame->Id))
+		{
+			LibTestFifoReplay_Rx_Discard(&LibTestFifoReplay_RxFifo);
+			isStored = false;
+		}
+		else
+		{
+			LibTestFifoReplay_Rx_Commit(&LibTestFifoReplay_RxFifo);
+		}
+	}
+
+	return isStored;
+}
+
+//=====================================================================================================================
+// LibTestFifoReplay_IsPriority:
+//=====================================================================================================================
+static bool_t LibTestFifoReplay_IsPriority(const uint32_t id)
+{
+	return id < LIBTESTFIFOREPLAY_NUM_PRIORITY_IDS;
+}
+
+//=====================================================================================================================
+// LibTestFifoReplay_IsSameId:
+//=====================================================================================================================
+static bool_t LibTestFifoReplay_IsSameId(const void* pQueuedItem, const void* pItem)
+{
+	return ((const S_LibTestFifoReplay_Frame_t*)pQueuedItem)->Id == ((const S_LibTestFifoReplay_Frame_t*)pItem)->Id;
+}
@@ -0,0 +1,157 @@
+// --------------------------------------------------------------------------------------------------------------------
+///
+/// \file LibTestMain.c
+///
+/// \brief Runner of the host library tests
+///
+/// Runs all tests, or the tests and benchmarks given by name, and returns 1 if any of them failed.
+///
+/// Usage: LibTest [-b] [name...]
+///        -b runs all benchmarks instead of all tests
+///
+/// Copyright (c) 2021 Neusoft.
+/// All Rights Reserved.
+///
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Includes
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "LibTest.h"
+#include <stdio.h>
+#include <string.h>
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Definitions
+// --------------------------------------------------------------------------------------------------------------------
+
+#define LIBTEST_ARRAY_SIZE(a)			(sizeof(a) / sizeof((a)[0]))
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Data Types
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief A registered test or benchmark
+// --------------------------------------------------------------------------------------------------------------------
+typedef struct S_LibTest_Entry_t {
+	const char*		pName;
+	bool_t			(*TestFunc)(void);
+	bool_t			IsBenchmark;	///< only run on request, prints measurements
+} S_LibTest_Entry_t;
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Variables
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief All tests and benchmarks
+// --------------------------------------------------------------------------------------------------------------------
+static const S_LibTest_Entry_t LibTest_Entries[] =
+{
+	{ "fifo_spsc_threads",		LibTestFifo_SpscThreads,		false },
+	{ "fifo_shared_threads",	LibTestFifo_SharedThreads,		false },
+	{ "fifo_reserve_pop_commit",	LibTestFifo_ReservePopCommit,	false },
+	{ "fifo_bench",				LibTestFifo_Bench,				true },
+	{ "fifo_overflow_replay",	LibTestFifo_OverflowReplay,		true },
+	{ "service_event_stress",	LibTestService_EventStress,		false },
+	{ "service_pass_budget",	LibTestService_PassBudget,		false },
+#ifdef LIBSERVICECFG_PROFILING
+	{ "service_profile",		LibTestService_Profile,			false },
+#endif // LIBSERVICECFG_PROFILING
+	{ "timer_rearm_order",		LibTestTimer_RearmOrder,		false },
+	{ "timer_step_ticks",		LibTestTimer_StepTicks,			false },
+	{ "timer_model",			LibTestTimer_Model,				false },
+	{ "timer_bench",			LibTestTimer_Bench,				true },
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Name of the running test, for the failure report
+// --------------------------------------------------------------------------------------------------------------------
+static const char* LibTest_pRunningName = "";
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Function Prototypes
+// --------------------------------------------------------------------------------------------------------------------
+
+static bool_t LibTest_Run(const S_LibTest_Entry_t* const pEntry);
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Functions
+// --------------------------------------------------------------------------------------------------------------------
+
+//=====================================================================================================================
+// main:
+//=====================================================================================================================
+int main(int argc, char* argv[])
+{
+	const bool_t runBenchmarks = (argc > 1) && (0 == strcmp(argv[1], "-b"));
+	uint32_t numFailed = 0U;
+	uint32_t numRun = 0U;
+
+	if ((argc > 1) && !runBenchmarks)
+	{
+		for (int arg = 1; arg < argc; arg++)
+		{
+			bool_t isFound = false;
+			for (uint32_t i = 0U; i < LIBTEST_ARRAY_SIZE(LibTest_Entries); i++)
+			{
+				if (0 == strcmp(argv[arg], LibTest_Entries[i].pName))
+				{
+					isFound = true;
+					numRun++;
+					numFailed += LibTest_Run(&LibTest_Entries[i]) ? 0U : 1U;
+				}
+			}
+			if (!isFound)
+			{
+				printf("unknown test %s\n", argv[arg]);
+				numFailed++;
+			}
+		}
+	}
+	else
+	{
+		for (uint32_t i = 0U; i < LIBTEST_ARRAY_SIZE(LibTest_Entries); i++)
+		{
+			if (LibTest_Entries[i].IsBenchmark == runBenchmarks)
+			{
+				numRun++;
+				numFailed += LibTest_Run(&LibTest_Entries[i]) ? 0U : 1U;
+			}
+		}
+	}
+
+	printf("%u run, %u failed\n", (unsigned)numRun, (unsigned)numFailed);
+	return (0U == numFailed) ? 0 : 1;
+}
+
+//=====================================================================================================================
+// LibTest_ReportFailure:
+//=====================================================================================================================
+void LibTest_ReportFailure(const char* pFile, const int line, const char* pCondition)
+{
+	printf("%s: %s:%d: check failed: %s\n", LibTest_pRunningName, pFile, line, pCondition);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Functions
+// --------------------------------------------------------------------------------------------------------------------
+
+//=====================================================================================================================
+// LibTest_Run:
+//=====================================================================================================================
+static bool_t LibTest_Run(const S_LibTest_Entry_t* const pEntry)
+{
+	const uint64_t start_ns = LibTest_GetTime_ns();
+	bool_t isPassed;
+
+	LibTest_pRunningName = pEntry->pName;
+	(void)fflush(stdout);
+	isPassed = pEntry->TestFunc();
+	printf("%-40s %s (%.1f ms)\n", pEntry->pName, isPassed ? "PASS" : "FAIL",
+		(double)(LibTest_GetTime_ns() - start_ns) / 1e6);
+
+	return isPassed;
+}
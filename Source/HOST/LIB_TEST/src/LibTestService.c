@@ -0,0 +1,389 @@
+// --------------------------------------------------------------------------------------------------------------------
+///
+/// \file LibTestService.c
+///
+/// \brief Tests of LibService and LibServiceHost
+///
+/// Copyright (c) 2021 Neusoft.
+/// All Rights Reserved.
+///
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Includes
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "LibTest.h"
+#include "LibService.h"
+#include "LibServiceHost.h"
+#include "LibTimer.h"
+#include <pthread.h>
+#include <sched.h>
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Definitions
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Number of hosted services and of producer threads of the stress test
+///
+/// Each producer owns one event bit and sets it on all services in turn, so the producers race on the event masks
+/// of the services and on the pending mask of the service host.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTESTSERVICE_NUM_SERVICES		(4U)
+#define LIBTESTSERVICE_NUM_PRODUCERS	(8U)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Events set by each producer
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTESTSERVICE_NUM_EVENTS		(20000U)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Time a producer waits for its event to be handled before the event is considered lost
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTESTSERVICE_TIMEOUT_NS		UINT64_C(2000000000)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Services of the budget test: the flooded top priority service, a middle and the lowest service
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTESTSERVICE_BUDGET_SERVICES	(3U)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Passes of the budget test, each one stopped by the flooded service if the pass is not resumed
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTESTSERVICE_BUDGET_PASSES	(10U)
+
+#ifdef LIBSERVICECFG_PROFILING
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Calls of the profiled service and the time each call spins, far above the resolution of the host clock
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTESTSERVICE_PROFILE_CALLS	(5U)
+#define LIBTESTSERVICE_PROFILE_SPIN_NS	UINT64_C(200000)
+#endif // LIBSERVICECFG_PROFILING
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Data Types
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Sequence numbers of the events of one service: set by the producers, handled by the service
+// --------------------------------------------------------------------------------------------------------------------
+typedef struct S_LibTestService_Channel_t {
+	uint32_t	SetSeq[LIBTESTSERVICE_NUM_PRODUCERS];
+	uint32_t	HandledSeq[LIBTESTSERVICE_NUM_PRODUCERS];
+} S_LibTestService_Channel_t;
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Function Prototypes
+// --------------------------------------------------------------------------------------------------------------------
+
+static void LibTestService_ServiceFunc(void* pData);
+static void LibTestService_Notify(void* pData);
+static void* LibTestService_HostThread(void* pArg);
+static void* LibTestService_ProducerThread(void* pArg);
+static void LibTestService_BudgetFunc(void* pData);
+#ifdef LIBSERVICECFG_PROFILING
+static void LibTestService_ProfileFunc(void* pData);
+#endif // LIBSERVICECFG_PROFILING
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Variables
+// --------------------------------------------------------------------------------------------------------------------
+
+static S_LibTestService_Channel_t LibTestService_Channels[LIBTESTSERVICE_NUM_SERVICES];
+
+static S_LibService_Inst_t LibTestService_Services[LIBTESTSERVICE_NUM_SERVICES] =
+{
+	LIBSERVICE_INIT_SERVICE(LibTestService_ServiceFunc, &LibTestService_Channels[0]),
+	LIBSERVICE_INIT_SERVICE(LibTestService_ServiceFunc, &LibTestService_Channels[1]),
+	LIBSERVICE_INIT_SERVICE(LibTestService_ServiceFunc, &LibTestService_Channels[2]),
+	LIBSERVICE_INIT_SERVICE(LibTestService_ServiceFunc, &LibTestService_Channels[3]),
+};
+
+static S_LibService_Inst_t* const LibTestService_pServices[LIBTESTSERVICE_NUM_SERVICES] =
+{
+	&LibTestService_Services[0], &LibTestService_Services[1], &LibTestService_Services[2], &LibTestService_Services[3]
+};
+
+static S_LibServiceHost_State_t LibTestService_HostState;
+
+static const S_LibServiceHost_Inst_t LibTestService_Host = LIBSERVICEHOST_INIT_CALLBACK(LibTestService_Notify, NULL,
+	LibTestService_pServices, LIBTESTSERVICE_NUM_SERVICES, &LibTestService_HostState);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Task notification of the host thread (ulTaskNotifyTake() with portMAX_DELAY on the target)
+// --------------------------------------------------------------------------------------------------------------------
+static pthread_mutex_t LibTestService_NotifyLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t LibTestService_NotifyCond = PTHREAD_COND_INITIALIZER;
+static bool_t LibTestService_IsNotified = false;
+static bool_t LibTestService_IsStopped = false;
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Producers which lost an event
+// --------------------------------------------------------------------------------------------------------------------
+static uint32_t LibTestService_NumLost = 0U;
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Service host of the budget test with a budget of 1 ms per pass
+// --------------------------------------------------------------------------------------------------------------------
+static uint32_t LibTestService_BudgetCalls[LIBTESTSERVICE_BUDGET_SERVICES];
+
+static S_LibService_Inst_t LibTestService_BudgetServices[LIBTESTSERVICE_BUDGET_SERVICES] =
+{
+	LIBSERVICE_INIT_SERVICE(LibTestService_BudgetFunc, &LibTestService_BudgetCalls[0]),
+	LIBSERVICE_INIT_SERVICE(LibTestService_BudgetFunc, &LibTestService_BudgetCalls[1]),
+	LIBSERVICE_INIT_SERVICE(LibTestService_BudgetFunc, &LibTestService_BudgetCalls[2]),
+};
+
+static S_LibService_Inst_t* const LibTestService_pBudgetServices[LIBTESTSERVICE_BUDGET_SERVICES] =
+{
+	&LibTestService_BudgetServices[0], &LibTestService_BudgetServices[1], &LibTestService_BudgetServices[2]
+};
+
+static S_LibServiceHost_State_t LibTestService_BudgetHostState;
+
+static const S_LibServiceHost_Inst_t LibTestService_BudgetHost = LIBSERVICEHOST_INIT_CALLBACK_EX(
+	LibTestService_Notify, NULL, LibTestService_pBudgetServices, LIBTESTSERVICE_BUDGET_SERVICES,
+	&LibTestService_BudgetHostState, NULL, 1U);
+
+#ifdef LIBSERVICECFG_PROFILING
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Service host of the profiling test with a single spinning service
+// --------------------------------------------------------------------------------------------------------------------
+static S_LibService_Inst_t LibTestService_ProfileService = LIBSERVICE_INIT_SERVICE(LibTestService_ProfileFunc, NULL);
+
+static S_LibService_Inst_t* const LibTestService_pProfileServices[1] = { &LibTestService_ProfileService };
+
+static S_LibServiceHost_State_t LibTestService_ProfileHostState;
+
+static const S_LibServiceHost_Inst_t LibTestService_ProfileHost = LIBSERVICEHOST_INIT_CALLBACK(LibTestService_Notify,
+	NULL, LibTestService_pProfileServices, 1U, &LibTestService_ProfileHostState);
+#endif // LIBSERVICECFG_PROFILING
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Functions
+// --------------------------------------------------------------------------------------------------------------------
+
+//=====================================================================================================================
+// LibTestService_EventStress:
+//=====================================================================================================================
+bool_t LibTestService_EventStress(void)
+{
+	pthread_t hostThread;
+	pthread_t producerThreads[LIBTESTSERVICE_NUM_PRODUCERS];
+
+	// the producers wait for each event to be handled before setting the next one: every event set must be handled
+	// exactly once, a lost event or a lost notification of the host stalls the producer
+	LibServiceHost_Init(&LibTestService_Host);
+	LIBTEST_CHECK(0 == pthread_create(&hostThread, NULL, LibTestService_HostThread, NULL));
+	for (uintptr_t p = 0U; p < LIBTESTSERVICE_NUM_PRODUCERS; p++)
+	{
+		LIBTEST_CHECK(0 == pthread_create(&producerThreads[p], NULL, LibTestService_ProducerThread, (void*)p));
+	}
+	for (uint32_t p = 0U; p < LIBTESTSERVICE_NUM_PRODUCERS; p++)
+	{
+		(void)pthread_join(producerThreads[p], NULL);
+	}
+
+	(void)pthread_mutex_lock(&LibTestService_NotifyLock);
+	LibTestService_IsStopped = true;
+	(void)pthread_cond_signal(&LibTestService_NotifyCond);
+	(void)pthread_mutex_unlock(&LibTestService_NotifyLock);
+	(void)pthread_join(hostThread, NULL);
+
+	LIBTEST_CHECK(0U == LibTestService_NumLost);
+	for (uint32_t s = 0U; s < LIBTESTSERVICE_NUM_SERVICES; s++)
+	{
+		for (uint32_t p = 0U; p < LIBTESTSERVICE_NUM_PRODUCERS; p++)
+		{
+			LIBTEST_CHECK(LibTestService_Channels[s].HandledSeq[p] == LibTestService_Channels[s].SetSeq[p]);
+		}
+		LIBTEST_CHECK(UINT32_C(0) == LibService_GetEvent(&LibTestService_Services[s]));
+	}
+	LIBTEST_CHECK(UINT32_C(0) == LibAtomic_Load(&LibTestService_HostState.PendingMask));
+
+	return true;
+}
+
+//=====================================================================================================================
+// LibTestService_PassBudget:
+//=====================================================================================================================
+bool_t LibTestService_PassBudget(void)
+{
+	// the top priority service sets its own event again on every call and uses up the budget of the pass: the pass
+	// it stopped is resumed by the next call, so the lower services still get their turn
+	LibServiceHost_Init(&LibTestService_BudgetHost);
+	for (uint32_t pass = 0U; pass < LIBTESTSERVICE_BUDGET_PASSES; pass++)
+	{
+		LibServiceHost_Service(&LibTestService_BudgetHost);
+	}
+
+	LIBTEST_CHECK(LibTestService_BudgetCalls[0] >= (LIBTESTSERVICE_BUDGET_PASSES / 2U));
+	LIBTEST_CHECK(0U != LibTestService_BudgetCalls[1]);
+	LIBTEST_CHECK(0U != LibTestService_BudgetCalls[LIBTESTSERVICE_BUDGET_SERVICES - 1U]);
+	LIBTEST_CHECK(0U != (LibAtomic_Load(&LibTestService_BudgetHostState.PendingMask) & UINT32_C(1)));
+
+	return true;
+}
+
+#ifdef LIBSERVICECFG_PROFILING
+//=====================================================================================================================
+// LibTestService_Profile:
+//=====================================================================================================================
+bool_t LibTestService_Profile(void)
+{
+	S_LibService_Profile_t profile;
+
+	// every call spins for a known time: the profile has to resolve it, a clock with a coarse tick (like clock() on
+	// the host) reports most calls as zero
+	LibServiceHost_Init(&LibTestService_ProfileHost);
+	for (uint32_t call = 0U; call < LIBTESTSERVICE_PROFILE_CALLS; call++)
+	{
+		LibService_SetEvent(&LibTestService_ProfileService, UINT32_C(1));
+		LibServiceHost_Service(&LibTestService_ProfileHost);
+	}
+	LibService_GetProfile(&LibTestService_ProfileService, &profile);
+	LibServiceHost_DumpProfile(&LibTestService_ProfileHost);
+
+	LIBTEST_CHECK(LIBTESTSERVICE_PROFILE_CALLS == profile.Count);
+	LIBTEST_CHECK(profile.MinCycles >= (uint32_t)LIBTESTSERVICE_PROFILE_SPIN_NS);
+	LIBTEST_CHECK(profile.MaxCycles >= profile.MinCycles);
+	LIBTEST_CHECK(profile.TotalCycles >= ((uint64_t)LIBTESTSERVICE_PROFILE_CALLS * LIBTESTSERVICE_PROFILE_SPIN_NS));
+
+	return true;
+}
+#endif // LIBSERVICECFG_PROFILING
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Functions
+// --------------------------------------------------------------------------------------------------------------------
+
+//=====================================================================================================================
+// LibTestService_ServiceFunc:
+//=====================================================================================================================
+static void LibTestService_ServiceFunc(void* pData)
+{
+	S_LibTestService_Channel_t* const pChannel = (S_LibTestService_Channel_t*)pData;
+	S_LibService_Inst_t* const pService = &LibTestService_Services[pChannel - LibTestService_Channels];
+
+	(void)LibService_CheckClearEvent(pService, LIBSERVICE_EV_INIT | LIBSERVICE_EV_RE_INIT);
+
+	// handle one event per call for some of the producers, the others are left pending for the next pass
+	for (uint32_t p = 0U; p < LIBTESTSERVICE_NUM_PRODUCERS; p++)
+	{
+		if (LibService_CheckClearEvent(pService, UINT32_C(1) << p))
+		{
+			LibAtomic_Store(&pChannel->HandledSeq[p], LibAtomic_Load(&pChannel->SetSeq[p]));
+			if (0U != (p & 1U))
+			{
+				break;
+			}
+		}
+	}
+}
+
+//=====================================================================================================================
+// LibTestService_Notify:
+//=====================================================================================================================
+static void LibTestService_Notify(void* pData)
+{
+	(void)pData;
+	(void)pthread_mutex_lock(&LibTestService_NotifyLock);
+	LibTestService_IsNotified = true;
+	(void)pthread_cond_signal(&LibTestService_NotifyCond);
+	(void)pthread_mutex_unlock(&LibTestService_NotifyLock);
+}
+
+//=====================================================================================================================
+// LibTestService_HostThread:
+//=====================================================================================================================
+static void* LibTestService_HostThread(void* pArg)
+{
+	bool_t isStopped = false;
+
+	(void)pArg;
+	while (!isStopped)
+	{
+		(void)pthread_mutex_lock(&LibTestService_NotifyLock);
+		while ((!LibTestService_IsNotified) && (!LibTestService_IsStopped))
+		{
+			(void)pthread_cond_wait(&LibTestService_NotifyCond, &LibTestService_NotifyLock);
+		}
+		LibTestService_IsNotified = false;
+		isStopped = LibTestService_IsStopped;
+		(void)pthread_mutex_unlock(&LibTestService_NotifyLock);
+
+		// a pass can leave services pending (unhandled events): wait for the next notification only when idle
+		do
+		{
+			LibServiceHost_Service(&LibTestService_Host);
+		} while (UINT32_C(0) != LibAtomic_Load(&LibTestService_HostState.PendingMask));
+	}
+
+	return NULL;
+}
+
+//=====================================================================================================================
+// LibTestService_ProducerThread:
+//=====================================================================================================================
+static void* LibTestService_ProducerThread(void* pArg)
+{
+	const uint32_t p = (uint32_t)(uintptr_t)pArg;
+
+	for (uint32_t seq = 1U; seq <= LIBTESTSERVICE_NUM_EVENTS; seq++)
+	{
+		const uint32_t s = (p + seq) % LIBTESTSERVICE_NUM_SERVICES;
+		S_LibTestService_Channel_t* const pChannel = &LibTestService_Channels[s];
+		const uint64_t start_ns = LibTest_GetTime_ns();
+
+		LibAtomic_Store(&pChannel->SetSeq[p], seq);
+		LibService_SetEvent(&LibTestService_Services[s], UINT32_C(1) << p);
+		while (seq != LibAtomic_Load(&pChannel->HandledSeq[p]))
+		{
+			if ((LibTest_GetTime_ns() - start_ns) > LIBTESTSERVICE_TIMEOUT_NS)
+			{
+				(void)LibAtomic_FetchAdd(&LibTestService_NumLost, 1U);
+				return NULL;
+			}
+			(void)sched_yield();
+		}
+	}
+
+	return NULL;
+}
+
+//=====================================================================================================================
+// LibTestService_BudgetFunc:
+//=====================================================================================================================
+static void LibTestService_BudgetFunc(void* pData)
+{
+	uint32_t* const pCalls = (uint32_t*)pData;
+	const uint32_t s = (uint32_t)(pCalls - LibTestService_BudgetCalls);
+	S_LibService_Inst_t* const pService = &LibTestService_BudgetServices[s];
+
+	(void)LibService_CheckClearEvent(pService, LIBSERVICE_EV_INIT | LIBSERVICE_EV_RE_INIT);
+	(*pCalls)++;
+	if (0U == s)
+	{
+		// flooded: the service is pending again at once and its call takes the whole budget of the pass
+		LibService_SetEvent(pService, UINT32_C(1));
+		LibTimer_Tick();
+	}
+}
+
+#ifdef LIBSERVICECFG_PROFILING
+//=====================================================================================================================
+// LibTestService_ProfileFunc:
+//=====================================================================================================================
+static void LibTestService_ProfileFunc(void* pData)
+{
+	const uint64_t start_ns = LibTest_GetTime_ns();
+
+	(void)pData;
+	(void)LibService_CheckClearEvent(&LibTestService_ProfileService, LIBSERVICE_EV_INIT | UINT32_C(1));
+	while ((LibTest_GetTime_ns() - start_ns) < LIBTESTSERVICE_PROFILE_SPIN_NS)
+	{
+		// spin
+	}
+}
+#endif // LIBSERVICECFG_PROFILING
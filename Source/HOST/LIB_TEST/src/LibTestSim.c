@@ -0,0 +1,93 @@
+// --------------------------------------------------------------------------------------------------------------------
+///
+/// \file LibTestSim.c
+///
+/// \brief Host replacements of the target functions used by the libraries under test
+///
+/// Copyright (c) 2021 Neusoft.
+/// All Rights Reserved.
+///
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Includes
+// --------------------------------------------------------------------------------------------------------------------
+
+#define _GNU_SOURCE	// recursive mutex initializer
+#include "LibTest.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Variables
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief The lock emulating suspended interrupts, recursive as the libraries nest SuspendAllInterrupts()
+// --------------------------------------------------------------------------------------------------------------------
+static pthread_mutex_t LibTestSim_IrqLock = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Functions
+// --------------------------------------------------------------------------------------------------------------------
+
+//=====================================================================================================================
+// LibTest_GetTime_ns:
+//=====================================================================================================================
+uint64_t LibTest_GetTime_ns(void)
+{
+	struct timespec now;
+
+	(void)clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((uint64_t)now.tv_sec * UINT64_C(1000000000)) + (uint64_t)now.tv_nsec;
+}
+
+//=====================================================================================================================
+// LibTest_GetDuration_ns:
+//=====================================================================================================================
+uint64_t LibTest_GetDuration_ns(const uint64_t default_ns)
+{
+	const char* const pSeconds = getenv("LIBTEST_DURATION_S");
+
+	return (NULL != pSeconds) ? (strtoull(pSeconds, NULL, 10) * UINT64_C(1000000000)) : default_ns;
+}
+
+//=====================================================================================================================
+// LibTest_Random:
+//=====================================================================================================================
+uint32_t LibTest_Random(uint32_t* const pState)
+{
+	uint32_t x = *pState;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*pState = x;
+	return x;
+}
+
+//=====================================================================================================================
+// VirtualPrintf:
+//=====================================================================================================================
+int VirtualPrintf(const char* pFormat, ...)
+{
+	(void)pFormat;
+	return 0;
+}
+
+//=====================================================================================================================
+// __disable_irq:
+//=====================================================================================================================
+void __disable_irq(void)
+{
+	(void)pthread_mutex_lock(&LibTestSim_IrqLock);
+}
+
+//=====================================================================================================================
+// __enable_irq:
+//=====================================================================================================================
+void __enable_irq(void)
+{
+	(void)pthread_mutex_unlock(&LibTestSim_IrqLock);
+}
@@ -0,0 +1,456 @@
+// --------------------------------------------------------------------------------------------------------------------
+///
+/// \file LibTestTimer.c
+///
+/// \brief Tests and benchmark of LibTimer
+///
+/// The tests run against the backend and callback mode selected by the build variant, so the timing wheel and the
+/// sorted list are checked against the same expectations (see the Makefile).
+///
+/// Copyright (c) 2021 Neusoft.
+/// All Rights Reserved.
+///
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Includes
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "LibTest.h"
+#include "LibTimer.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Definitions
+// --------------------------------------------------------------------------------------------------------------------
+
+#ifdef LIBTIMERCFG_TIMING_WHEEL
+#define LIBTESTTIMER_BACKEND_NAME		"wheel"
+#else
+#define LIBTESTTIMER_BACKEND_NAME		"list"
+#endif
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Timers and operations of the model test
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTESTTIMER_MODEL_TIMERS		(64U)
+#define LIBTESTTIMER_MODEL_TICKS		(200000U)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Maximum number of timers and ticks of the benchmark
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTESTTIMER_BENCH_MAX_TIMERS	(1024U)
+#define LIBTESTTIMER_BENCH_TICKS		(200000U)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Length of the callback trace of the re-arm test
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTESTTIMER_TRACE_LEN			(32U)
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Data Types
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief A timer of the tests and what its callback observed
+// --------------------------------------------------------------------------------------------------------------------
+typedef struct S_LibTestTimer_Timer_t {
+	S_LibTimer_Inst_t	Timer;
+	uint32_t			NumCalls;
+	uint32_t			LastCall_ms;
+	uint32_t			TimeLeft_ms;		///< LibTimer_GetTimeLeft_ms() of the own timer within the last callback
+	bool_t				IsStartedAgain;		///< LibTimer_Start() of the own timer within the last callback succeeded
+	struct S_LibTestTimer_Timer_t* pOther;	///< timer stopped by the callback
+} S_LibTestTimer_Timer_t;
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief The reference model of a timer
+// --------------------------------------------------------------------------------------------------------------------
+typedef struct S_LibTestTimer_Model_t {
+	bool_t		IsRunning;
+	uint32_t	Timeout_ms;
+	uint32_t	Period_ms;
+} S_LibTestTimer_Model_t;
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Function Prototypes
+// --------------------------------------------------------------------------------------------------------------------
+
+static void LibTestTimer_Tick(void);
+static void LibTestTimer_RecordCallback(void* pData);
+static void LibTestTimer_OneShotCallback(void* pData);
+static void LibTestTimer_SelfStopCallback(void* pData);
+static void LibTestTimer_StopOtherCallback(void* pData);
+static void LibTestTimer_ModelCallback(void* pData);
+static void LibTestTimer_BenchCallback(void* pData);
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Variables
+// --------------------------------------------------------------------------------------------------------------------
+
+static S_LibTestTimer_Timer_t LibTestTimer_StopOtherA;
+static S_LibTestTimer_Timer_t LibTestTimer_StopOtherB;
+
+static S_LibTestTimer_Timer_t LibTestTimer_Periodic =
+	{ LIBTIMER_INIT_TIMER(LibTestTimer_RecordCallback, &LibTestTimer_Periodic), 0U, 0U, 0U, false, NULL };
+static S_LibTestTimer_Timer_t LibTestTimer_OneShot =
+	{ LIBTIMER_INIT_TIMER(LibTestTimer_OneShotCallback, &LibTestTimer_OneShot), 0U, 0U, 0U, false, NULL };
+static S_LibTestTimer_Timer_t LibTestTimer_SelfStop =
+	{ LIBTIMER_INIT_TIMER(LibTestTimer_SelfStopCallback, &LibTestTimer_SelfStop), 0U, 0U, 0U, false, NULL };
+static S_LibTestTimer_Timer_t LibTestTimer_StopOtherA =
+	{ LIBTIMER_INIT_TIMER(LibTestTimer_StopOtherCallback, &LibTestTimer_StopOtherA), 0U, 0U, 0U, false,
+	  &LibTestTimer_StopOtherB };
+static S_LibTestTimer_Timer_t LibTestTimer_StopOtherB =
+	{ LIBTIMER_INIT_TIMER(LibTestTimer_StopOtherCallback, &LibTestTimer_StopOtherB), 0U, 0U, 0U, false,
+	  &LibTestTimer_StopOtherA };
+static S_LibTestTimer_Timer_t LibTestTimer_Isr =
+	{ LIBTIMER_INIT_ISR_TIMER(LibTestTimer_RecordCallback, &LibTestTimer_Isr), 0U, 0U, 0U, false, NULL };
+static S_LibTestTimer_Timer_t LibTestTimer_Deferred =
+	{ LIBTIMER_INIT_TIMER(LibTestTimer_RecordCallback, &LibTestTimer_Deferred), 0U, 0U, 0U, false, NULL };
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Callback trace of the re-arm test: up time of each callback
+// --------------------------------------------------------------------------------------------------------------------
+static uint32_t LibTestTimer_TraceTimes[LIBTESTTIMER_TRACE_LEN];
+static uint32_t LibTestTimer_TraceLen = 0U;
+
+static S_LibTimer_Inst_t LibTestTimer_ModelTimers[LIBTESTTIMER_MODEL_TIMERS];
+static S_LibTestTimer_Model_t LibTestTimer_Models[LIBTESTTIMER_MODEL_TIMERS];
+static uint32_t LibTestTimer_ModelCalls[LIBTESTTIMER_MODEL_TIMERS];
+
+static S_LibTimer_Inst_t LibTestTimer_BenchTimers[LIBTESTTIMER_BENCH_MAX_TIMERS];
+static uint32_t LibTestTimer_BenchCalls = 0U;
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Functions
+// --------------------------------------------------------------------------------------------------------------------
+
+//=====================================================================================================================
+// LibTestTimer_RearmOrder:
+//=====================================================================================================================
+bool_t LibTestTimer_RearmOrder(void)
+{
+	const uint32_t start_ms = LibTimer_GetUpTime_ms();
+
+	// started at start_ms the timers expire at start_ms + timeout + 1
+	LibTestTimer_TraceLen = 0U;
+	LIBTEST_CHECK(LibTimer_Start(&LibTestTimer_Periodic.Timer, 4U, 5U));
+	LIBTEST_CHECK(LibTimer_Start(&LibTestTimer_OneShot.Timer, 2U, 0U));
+	LIBTEST_CHECK(LibTimer_Start(&LibTestTimer_SelfStop.Timer, 1U, 2U));
+	LIBTEST_CHECK(LibTimer_Start(&LibTestTimer_StopOtherA.Timer, 9U, 0U));
+	LIBTEST_CHECK(LibTimer_Start(&LibTestTimer_StopOtherB.Timer, 9U, 0U));
+	for (uint32_t tick = 0U; tick < 18U; tick++)
+	{
+		LibTestTimer_Tick();
+	}
+
+	// the periodic timer is re-armed before its callback: one full period left within the callback
+	LIBTEST_CHECK(3U == LibTestTimer_Periodic.NumCalls);
+	LIBTEST_CHECK(5U == LibTestTimer_Periodic.TimeLeft_ms);
+	LIBTEST_CHECK((start_ms + 15U) == LibTestTimer_Periodic.LastCall_ms);
+
+	// the one-shot timer is not running anymore within its callback and restarts itself twice with 3 ms
+	LIBTEST_CHECK(3U == LibTestTimer_OneShot.NumCalls);
+	LIBTEST_CHECK(0U == LibTestTimer_OneShot.TimeLeft_ms);
+	LIBTEST_CHECK(LibTestTimer_OneShot.IsStartedAgain);
+	LIBTEST_CHECK((start_ms + 11U) == LibTestTimer_OneShot.LastCall_ms);
+	LIBTEST_CHECK(0U == LibTimer_GetTimeLeft_ms(&LibTestTimer_OneShot.Timer));
+
+	// the periodic timer stopping itself in its third callback is not invoked again
+	LIBTEST_CHECK(3U == LibTestTimer_SelfStop.NumCalls);
+	LIBTEST_CHECK((start_ms + 6U) == LibTestTimer_SelfStop.LastCall_ms);
+	LIBTEST_CHECK(0U == LibTimer_GetTimeLeft_ms(&LibTestTimer_SelfStop.Timer));
+
+	// of two timers expiring with the same tick the one handled first stops the other: no callback for the other
+	LIBTEST_CHECK(1U == (LibTestTimer_StopOtherA.NumCalls + LibTestTimer_StopOtherB.NumCalls));
+
+	// the callbacks of different ticks are invoked in expiry order
+	for (uint32_t i = 1U; i < LibTestTimer_TraceLen; i++)
+	{
+		LIBTEST_CHECK(LibTestTimer_TraceTimes[i - 1U] <= LibTestTimer_TraceTimes[i]);
+	}
+	LIBTEST_CHECK(10U == LibTestTimer_TraceLen);
+
+	LibTimer_Stop(&LibTestTimer_Periodic.Timer);
+	LibTimer_Stop(&LibTestTimer_OneShot.Timer);
+	LibTimer_Stop(&LibTestTimer_SelfStop.Timer);
+	LibTimer_Stop(&LibTestTimer_StopOtherA.Timer);
+	LibTimer_Stop(&LibTestTimer_StopOtherB.Timer);
+
+	return true;
+}
+
+//=====================================================================================================================
+// LibTestTimer_StepTicks:
+//=====================================================================================================================
+bool_t LibTestTimer_StepTicks(void)
+{
+	const uint32_t start_ms = LibTimer_GetUpTime_ms();
+
+	LibTestTimer_Isr.NumCalls = 0U;
+	LibTestTimer_Deferred.NumCalls = 0U;
+	LIBTEST_CHECK(LibTimer_Start(&LibTestTimer_Isr.Timer, 2U, 2U));
+	LIBTEST_CHECK(LibTimer_Start(&LibTestTimer_Deferred.Timer, 2U, 2U));
+
+	// the ISR timer is invoked by the tick, the other timer by the dispatch task
+	SuspendAllInterrupts();
+	for (uint32_t tick = 0U; tick < 3U; tick++)
+	{
+		LibTimer_Tick();
+	}
+	ResumeAllInterrupts();
+	LIBTEST_CHECK(1U == LibTestTimer_Isr.NumCalls);
+#ifdef LIBTIMERCFG_DEFERRED_CALLBACKS
+	LIBTEST_CHECK(0U == LibTestTimer_Deferred.NumCalls);
+	LibTimer_Dispatch();
+#endif
+	LIBTEST_CHECK(1U == LibTestTimer_Deferred.NumCalls);
+
+	// catching up on a tickless sleep with the interrupts disabled invokes no callback, not even of the ISR timer:
+	// both expired timers wait for the dispatch task, each for one callback
+	SuspendAllInterrupts();
+	LibTimer_StepTicks(10U);
+	ResumeAllInterrupts();
+	LIBTEST_CHECK((start_ms + 13U) == LibTimer_GetUpTime_ms());
+#ifdef LIBTIMERCFG_DEFERRED_CALLBACKS
+	LIBTEST_CHECK(1U == LibTestTimer_Isr.NumCalls);
+	LIBTEST_CHECK(1U == LibTestTimer_Deferred.NumCalls);
+	LIBTEST_CHECK(0U == LibTimer_GetNextExpiry_ms());
+	LibTimer_Dispatch();
+	LIBTEST_CHECK(2U == LibTestTimer_Isr.NumCalls);
+	LIBTEST_CHECK(2U == LibTestTimer_Deferred.NumCalls);
+#endif
+
+	LibTimer_Stop(&LibTestTimer_Isr.Timer);
+	LibTimer_Stop(&LibTestTimer_Deferred.Timer);
+
+	return true;
+}
+
+//=====================================================================================================================
+// LibTestTimer_Model:
+//=====================================================================================================================
+bool_t LibTestTimer_Model(void)
+{
+	uint32_t random = UINT32_C(0x12345678);
+
+	// random start and stop against a reference model: every timer has to be invoked exactly at its expiry ticks
+	for (uint32_t i = 0U; i < LIBTESTTIMER_MODEL_TIMERS; i++)
+	{
+		const S_LibTimer_Inst_t timer = LIBTIMER_INIT_TIMER(LibTestTimer_ModelCallback, &LibTestTimer_ModelCalls[i]);
+		memcpy(&LibTestTimer_ModelTimers[i], &timer, sizeof(timer));
+		LibTestTimer_Models[i].IsRunning = false;
+		LibTestTimer_ModelCalls[i] = 0U;
+	}
+
+	for (uint32_t tick = 0U; tick < LIBTESTTIMER_MODEL_TICKS; tick++)
+	{
+		const uint32_t i = LibTest_Random(&random) % LIBTESTTIMER_MODEL_TIMERS;
+		S_LibTestTimer_Model_t* const pModel = &LibTestTimer_Models[i];
+
+		if (pModel->IsRunning)
+		{
+			if (0U == (LibTest_Random(&random) % 4U))
+			{
+				LibTimer_Stop(&LibTestTimer_ModelTimers[i]);
+				pModel->IsRunning = false;
+			}
+		}
+		else
+		{
+			// long timeouts exercise the coarser levels of the wheel
+			const uint32_t timeout_ms = 1U + ((0U == (LibTest_Random(&random) % 8U)) ?
+				(LibTest_Random(&random) % 300000U) : (LibTest_Random(&random) % 500U));
+			const uint32_t period_ms = (0U == (LibTest_Random(&random) % 2U)) ? 0U :
+				(1U + (LibTest_Random(&random) % 200U));
+			LIBTEST_CHECK(LibTimer_Start(&LibTestTimer_ModelTimers[i], timeout_ms, period_ms));
+			pModel->IsRunning = true;
+			pModel->Timeout_ms = LibTimer_GetUpTime_ms() + timeout_ms + 1U;
+			pModel->Period_ms = period_ms;
+		}
+
+		LibTestTimer_Tick();
+
+		const uint32_t upTime_ms = LibTimer_GetUpTime_ms();
+		for (uint32_t j = 0U; j < LIBTESTTIMER_MODEL_TIMERS; j++)
+		{
+			S_LibTestTimer_Model_t* const pTimerModel = &LibTestTimer_Models[j];
+			uint32_t expectedCalls = 0U;
+
+			if ((pTimerModel->IsRunning) && (upTime_ms == pTimerModel->Timeout_ms))
+			{
+				expectedCalls = 1U;
+				pTimerModel->IsRunning = (0U != pTimerModel->Period_ms);
+				pTimerModel->Timeout_ms = upTime_ms + pTimerModel->Period_ms;
+			}
+			LIBTEST_CHECK(expectedCalls == LibTestTimer_ModelCalls[j]);
+			LIBTEST_CHECK(((pTimerModel->IsRunning) ? (pTimerModel->Timeout_ms - upTime_ms) : 0U)
+				== LibTimer_GetTimeLeft_ms(&LibTestTimer_ModelTimers[j]));
+			LibTestTimer_ModelCalls[j] = 0U;
+		}
+	}
+
+	for (uint32_t i = 0U; i < LIBTESTTIMER_MODEL_TIMERS; i++)
+	{
+		LibTimer_Stop(&LibTestTimer_ModelTimers[i]);
+	}
+
+	return true;
+}
+
+//=====================================================================================================================
+// LibTestTimer_Bench:
+//=====================================================================================================================
+bool_t LibTestTimer_Bench(void)
+{
+	static const uint32_t NumTimers[] = { 16U, 128U, 1024U };
+
+	printf("  backend %s, %s callbacks\n", LIBTESTTIMER_BACKEND_NAME,
+#ifdef LIBTIMERCFG_DEFERRED_CALLBACKS
+		"deferred"
+#else
+		"ISR"
+#endif
+		);
+	printf("  %8s %14s %14s %14s\n", "timers", "start ns", "stop ns", "tick ns");
+
+	for (uint32_t n = 0U; n < (sizeof(NumTimers) / sizeof(NumTimers[0])); n++)
+	{
+		const uint32_t numTimers = NumTimers[n];
+		uint32_t random = UINT32_C(0xCAFE0001);
+		uint64_t start_ns = 0U;
+		uint64_t stop_ns = 0U;
+		uint64_t tick_ns = 0U;
+
+		// a mix of protocol timeouts: most timers are one-shot within a second, some are periodic
+		for (uint32_t i = 0U; i < numTimers; i++)
+		{
+			const S_LibTimer_Inst_t timer = LIBTIMER_INIT_TIMER(LibTestTimer_BenchCallback, NULL);
+			memcpy(&LibTestTimer_BenchTimers[i], &timer, sizeof(timer));
+			LIBTEST_CHECK(LibTimer_Start(&LibTestTimer_BenchTimers[i], 1U + (LibTest_Random(&random) % 1000U),
+				(0U == (i % 8U)) ? (1U + (LibTest_Random(&random) % 100U)) : 0U));
+		}
+
+		// every tick one timer is restarted: stopped and started with a new timeout. The times include the read of the
+		// host clock and the emulated interrupt lock.
+		for (uint32_t tick = 0U; tick < LIBTESTTIMER_BENCH_TICKS; tick++)
+		{
+			S_LibTimer_Inst_t* const pTimer = &LibTestTimer_BenchTimers[LibTest_Random(&random) % numTimers];
+			const uint32_t timeout_ms = 1U + (LibTest_Random(&random) % 1000U);
+			uint64_t t0 = LibTest_GetTime_ns();
+			LibTimer_Stop(pTimer);
+			uint64_t t1 = LibTest_GetTime_ns();
+			(void)LibTimer_Start(pTimer, timeout_ms, 0U);
+			uint64_t t2 = LibTest_GetTime_ns();
+			LibTestTimer_Tick();
+			uint64_t t3 = LibTest_GetTime_ns();
+			stop_ns += t1 - t0;
+			start_ns += t2 - t1;
+			tick_ns += t3 - t2;
+		}
+
+		for (uint32_t i = 0U; i < numTimers; i++)
+		{
+			LibTimer_Stop(&LibTestTimer_BenchTimers[i]);
+		}
+
+		printf("  %8u %14.1f %14.1f %14.1f\n", (unsigned)numTimers,
+			(double)start_ns / LIBTESTTIMER_BENCH_TICKS, (double)stop_ns / LIBTESTTIMER_BENCH_TICKS,
+			(double)tick_ns / LIBTESTTIMER_BENCH_TICKS);
+	}
+	LIBTEST_CHECK(LibTestTimer_BenchCalls > 0U);
+
+	return true;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Functions
+// --------------------------------------------------------------------------------------------------------------------
+
+//=====================================================================================================================
+// LibTestTimer_Tick:
+//=====================================================================================================================
+static void LibTestTimer_Tick(void)
+{
+	// the tick runs in the tick ISR on the target, the callbacks of deferred timers in the dispatch task
+	SuspendAllInterrupts();
+	LibTimer_Tick();
+	ResumeAllInterrupts();
+#ifdef LIBTIMERCFG_DEFERRED_CALLBACKS
+	LibTimer_Dispatch();
+#endif
+}
+
+//=====================================================================================================================
+// LibTestTimer_RecordCallback:
+//=====================================================================================================================
+static void LibTestTimer_RecordCallback(void* pData)
+{
+	S_LibTestTimer_Timer_t* const pTestTimer = (S_LibTestTimer_Timer_t*)pData;
+
+	pTestTimer->NumCalls++;
+	pTestTimer->LastCall_ms = LibTimer_GetUpTime_ms();
+	pTestTimer->TimeLeft_ms = LibTimer_GetTimeLeft_ms(&pTestTimer->Timer);
+	if (LibTestTimer_TraceLen < LIBTESTTIMER_TRACE_LEN)
+	{
+		LibTestTimer_TraceTimes[LibTestTimer_TraceLen] = pTestTimer->LastCall_ms;
+		LibTestTimer_TraceLen++;
+	}
+}
+
+//=====================================================================================================================
+// LibTestTimer_OneShotCallback:
+//=====================================================================================================================
+static void LibTestTimer_OneShotCallback(void* pData)
+{
+	S_LibTestTimer_Timer_t* const pTestTimer = (S_LibTestTimer_Timer_t*)pData;
+
+	LibTestTimer_RecordCallback(pData);
+	if (pTestTimer->NumCalls < 3U)
+	{
+		pTestTimer->IsStartedAgain = LibTimer_Start(&pTestTimer->Timer, 3U, 0U);
+	}
+}
+
+//=====================================================================================================================
+// LibTestTimer_SelfStopCallback:
+//=====================================================================================================================
+static void LibTestTimer_SelfStopCallback(void* pData)
+{
+	S_LibTestTimer_Timer_t* const pTestTimer = (S_LibTestTimer_Timer_t*)pData;
+
+	LibTestTimer_RecordCallback(pData);
+	if (3U == pTestTimer->NumCalls)
+	{
+		LibTimer_Stop(&pTestTimer->Timer);
+	}
+}
+
+//=====================================================================================================================
+// LibTestTimer_StopOtherCallback:
+//=====================================================================================================================
+static void LibTestTimer_StopOtherCallback(void* pData)
+{
+	S_LibTestTimer_Timer_t* const pTestTimer = (S_LibTestTimer_Timer_t*)pData;
+
+	LibTestTimer_RecordCallback(pData);
+	LibTimer_Stop(&pTestTimer->pOther->Timer);
+}
+
+//=====================================================================================================================
+// LibTestTimer_ModelCallback:
+//=====================================================================================================================
+static void LibTestTimer_ModelCallback(void* pData)
+{
+	(*(uint32_t*)pData)++;
+}
+
+//=====================================================================================================================
+// LibTestTimer_BenchCallback:
+//=====================================================================================================================
+static void LibTestTimer_BenchCallback(void* pData)
+{
+	(void)pData;
+	LibTestTimer_BenchCalls++;
+}
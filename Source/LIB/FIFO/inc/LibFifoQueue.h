@@ -18,6 +18,7 @@
 //	Includes
 // --------------------------------------------------------------------------------------------------------------------
 #include "LibTypes.h"
+#include "LibFifoQueueCfg.h"
 
 // --------------------------------------------------------------------------------------------------------------------
 //	Global Definitions
@@ -31,16 +32,78 @@
 /// \param overwrite Overwrite items flag
 // --------------------------------------------------------------------------------------------------------------------
 #define LIBFIFO_DEFINE_MEMBER(pBuffer, itemLength, numItems, overwrite)\
+	LIBFIFO_DEFINE_MEMBER_EX((pBuffer), (itemLength), (numItems), (overwrite), false)
+
+// --------------------------------------------------------------------------------------------------------------------
+///	\brief Define an instance of the FIFO as member with extended settings
+/// \param pBuffer Pointer to the FIFO buffer
+/// \param itemLen The length of one item
+/// \param numItems Max. number items resp. length of the buffer
+/// \param overwrite Overwrite items flag
+/// \param shared Shared flag, set if producer and consumer run in different contexts (ISR or task)
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBFIFO_DEFINE_MEMBER_EX(pBuffer, itemLength, numItems, overwrite, shared)\
+	LIBFIFO_DEFINE_MEMBER_NAMED(NULL, (pBuffer), (itemLength), (numItems), (overwrite), (shared), false, NULL)
+
+// --------------------------------------------------------------------------------------------------------------------
+///	\brief Define an instance of the FIFO as member with all settings, used by the other definition macros
+/// \param queueName Name of the queue in the statistics registry, NULL if unnamed
+/// \param pBuffer Pointer to the FIFO buffer
+/// \param itemLength The length of one item
+/// \param numItems Max. number items resp. length of the buffer
+/// \param overwrite Overwrite items flag
+/// \param shared Shared flag, set if producer and consumer run in different contexts (ISR or task)
+/// \param spsc Lock-free single-producer/single-consumer flag
+/// \param isSameItem Function coalescing items of a full queue, NULL if items are not coalesced
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBFIFO_DEFINE_MEMBER_NAMED(queueName, pBuffer, itemLength, numItems, overwrite, shared, spsc, isSameItem)\
 	{\
 		.pFifoMem = (pBuffer),\
 		.ItemLen = (itemLength),\
 		.NumMaxItems = (numItems),\
 		.OverwriteItems = (overwrite),\
+		.IsShared = (shared),\
+		.IsSpsc = (spsc),\
+		.pfIsSameItem = (isSameItem),\
 		.HeadIdx = 0U,\
 		.TailIdx = 0U,\
 		.Count = 0U\
+		LIBFIFO_INIT_STATS_MEMBERS(queueName)\
 	}
 
+#ifdef LIBFIFOQUEUECFG_STATISTICS
+// --------------------------------------------------------------------------------------------------------------------
+///	\brief Initializer of the members only present if the statistics are enabled
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBFIFO_INIT_STATS_MEMBERS(queueName)	, .Stats = { .pName = (queueName) }
+#else
+#define LIBFIFO_INIT_STATS_MEMBERS(queueName)
+#endif
+
+// --------------------------------------------------------------------------------------------------------------------
+///	\brief Define an instance of the lock-free single-producer/single-consumer FIFO as member
+/// \param pBuffer Pointer to the FIFO buffer
+/// \param itemLength The length of one item
+/// \param numItems Max. number items resp. length of the buffer, must be a power of two
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBFIFO_DEFINE_SPSC_MEMBER(pBuffer, itemLength, numItems)\
+	LIBFIFO_DEFINE_MEMBER_NAMED(NULL, (pBuffer), (itemLength), (numItems), false, false, true, NULL)
+
+// --------------------------------------------------------------------------------------------------------------------
+///	\brief Round a number of items up to the next power of two, as required by LIBFIFO_DEFINE_SPSC_INST()
+/// \param numItems Number of items (1 .. 2^31), evaluated at compile time for constant arguments
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBFIFO_SPSC_NUM_ITEMS(numItems)			(LIBFIFO_SMEAR_16((uint32_t)(numItems) - 1U) + 1U)
+
+// --------------------------------------------------------------------------------------------------------------------
+///	\brief Helpers of LIBFIFO_SPSC_NUM_ITEMS(): set all bits below the most significant set bit
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBFIFO_SMEAR_1(x)			((x) | ((x) >> 1))
+#define LIBFIFO_SMEAR_2(x)			(LIBFIFO_SMEAR_1(x) | (LIBFIFO_SMEAR_1(x) >> 2))
+#define LIBFIFO_SMEAR_4(x)			(LIBFIFO_SMEAR_2(x) | (LIBFIFO_SMEAR_2(x) >> 4))
+#define LIBFIFO_SMEAR_8(x)			(LIBFIFO_SMEAR_4(x) | (LIBFIFO_SMEAR_4(x) >> 8))
+#define LIBFIFO_SMEAR_16(x)			(LIBFIFO_SMEAR_8(x) | (LIBFIFO_SMEAR_8(x) >> 16))
+
 // --------------------------------------------------------------------------------------------------------------------
 ///	\brief Define an instance of the FIFO
 ///	\param name The name of the instance
@@ -52,7 +115,86 @@
 //lint -estring(773, LIBFIFO_DEFINE_INST) Definition is ok
 #define LIBFIFO_DEFINE_INST(name, pBuffer, itemLength, numItems, overwrite)\
 	S_LibFifoQueue_Inst_t (name) =\
-	LIBFIFO_DEFINE_MEMBER((pBuffer), (itemLength), (numItems), (overwrite))
+	LIBFIFO_DEFINE_MEMBER_NAMED(#name, (pBuffer), (itemLength), (numItems), (overwrite), false, false, NULL)
+
+// --------------------------------------------------------------------------------------------------------------------
+///	\brief Define an instance of the FIFO shared between contexts
+/// \details All operations on a shared FIFO are performed with interrupts suspended, so the producer and the consumer
+/// may run in different tasks or in an interrupt service routine.
+///	\param name The name of the instance
+/// \param pBuffer Pointer to the FIFO buffer
+/// \param itemLength The length of one item
+/// \param numItems Max. number items resp. length of the buffer
+/// \param overwrite Overwrite items flag
+// --------------------------------------------------------------------------------------------------------------------
+//lint -estring(773, LIBFIFO_DEFINE_SHARED_INST) Definition is ok
+#define LIBFIFO_DEFINE_SHARED_INST(name, pBuffer, itemLength, numItems, overwrite)\
+	S_LibFifoQueue_Inst_t (name) =\
+	LIBFIFO_DEFINE_MEMBER_NAMED(#name, (pBuffer), (itemLength), (numItems), (overwrite), true, false, NULL)
+
+// --------------------------------------------------------------------------------------------------------------------
+///	\brief Define an instance of the lock-free single-producer/single-consumer FIFO
+/// \details Exactly one context (a task or an interrupt service routine) pushes items and exactly one other context
+/// reads, pops and clears them. The producer only writes the tail index and the consumer only writes the head index,
+/// both are published with release and read with acquire semantics, so no interrupts are suspended at all.
+/// Overwriting items is not supported, LibFifoQueue_Init() and LibFifoQueue_Clear() are reserved to the consumer.
+///	\param name The name of the instance
+/// \param pBuffer Pointer to the FIFO buffer
+/// \param itemLength The length of one item
+/// \param numItems Max. number items resp. length of the buffer, must be a power of two
+/// \sa LIBFIFO_SPSC_NUM_ITEMS
+// --------------------------------------------------------------------------------------------------------------------
+//lint -estring(773, LIBFIFO_DEFINE_SPSC_INST) Definition is ok
+#define LIBFIFO_DEFINE_SPSC_INST(name, pBuffer, itemLength, numItems)\
+	S_LibFifoQueue_Inst_t (name) =\
+	LIBFIFO_DEFINE_MEMBER_NAMED(#name, (pBuffer), (itemLength), (numItems), false, false, true, NULL)
+
+// --------------------------------------------------------------------------------------------------------------------
+///	\brief Define an instance of the FIFO coalescing items on overflow
+/// \details If the queue is full, LibFifoQueue_Push() replaces the newest queued item which isSameItem() reports as
+/// equivalent to the pushed one (e.g. an older CAN frame with the same ID), so that a burst costs only outdated
+/// items. Without an equivalent item the overwrite flag selects whether the oldest or the pushed item is dropped.
+/// The items are replaced in place while the consumer may access them: the consumer has to copy the items out with
+/// LibFifoQueue_PopCopy(). LibFifoQueue_Reserve() and LibFifoQueue_PushN() do not coalesce.
+///	\param name The name of the instance
+/// \param pBuffer Pointer to the FIFO buffer
+/// \param itemLength The length of one item
+/// \param numItems Max. number items resp. length of the buffer
+/// \param overwrite Overwrite items flag, applied if no queued item is equivalent to the pushed one
+/// \param shared Shared flag, set if producer and consumer run in different contexts (ISR or task)
+/// \param isSameItem Function of type LibFifoQueue_IsSameItem_t
+// --------------------------------------------------------------------------------------------------------------------
+//lint -estring(773, LIBFIFO_DEFINE_COALESCING_INST) Definition is ok
+#define LIBFIFO_DEFINE_COALESCING_INST(name, pBuffer, itemLength, numItems, overwrite, shared, isSameItem)\
+	S_LibFifoQueue_Inst_t (name) =\
+	LIBFIFO_DEFINE_MEMBER_NAMED(#name, (pBuffer), (itemLength), (numItems), (overwrite), (shared), false, (isSameItem))
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Statistics of a fifo queue, see LIBFIFOQUEUECFG_STATISTICS
+/// \details The push counters are written by the producer (with interrupts suspended for shared queues), NumCleared by
+/// the consumer. A queue is linked into the registry by its first push, reserve or clear.
+// --------------------------------------------------------------------------------------------------------------------
+typedef struct S_LibFifoQueue_Stats
+{
+	struct S_LibFifoQueue_Stats* pNext;   //!< Next registered queue, NULL for the last one
+	const char*	pName;                  //!< Name of the queue, NULL if unnamed
+	uint32_t	NumMaxItems;            //!< Maximum number of items in the queue
+	uint32_t	HighWatermark;          //!< Maximum number of items which have been in the queue at the same time
+	uint32_t	NumPushed;              //!< Total number of items pushed into the queue
+	uint32_t	NumPushFailed;          //!< Number of items discarded because the queue was full
+	uint32_t	NumOverwritten;         //!< Number of items dropped to make room for new ones
+	uint32_t	NumCoalesced;           //!< Number of items replaced by an equivalent newer item
+	uint32_t	NumCleared;             //!< Number of items dropped by LibFifoQueue_Clear()
+	bool_t		IsRegistered;           //!< Specifies whether the statistics are linked into the registry
+} S_LibFifoQueue_Stats_t;
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Function checking whether a pushed item supersedes a queued item, see LIBFIFO_DEFINE_COALESCING_INST()
+/// \param pQueuedItem The item in the queue
+/// \param pItem The pushed item
+/// \return True if the queued item shall be replaced by the pushed one
+// --------------------------------------------------------------------------------------------------------------------
+typedef bool_t (*LibFifoQueue_IsSameItem_t)(const void* pQueuedItem, const void* pItem);
 
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief Instance structure of the fifo queue
@@ -64,32 +206,58 @@ typedef struct
 	const uint32_t	ItemLen;            //!< Length of one item in byte.
 	const uint32_t	NumMaxItems;        //!< Maximum number of items in the queue
 	const bool_t		OverwriteItems;     //!< Specifies whether items can be overwritten, if the queue is full
+	const bool_t		IsShared;           //!< Specifies whether the queue is accessed with interrupts suspended
+	const bool_t		IsSpsc;             //!< Specifies whether the queue is a lock-free single producer/consumer queue
+	const LibFifoQueue_IsSameItem_t	pfIsSameItem;   //!< Coalesces items of a full queue, NULL if not used
 
 	// ----------------------------------------------------------------------------------------------------------------
 	/// \brief index of the head element (oldest) in the queue
+	/// \details For SPSC queues the free-running number of popped items, written by the consumer only.
 	/// \attention Initialize with 0, if the fifo is empty. Don´t change it, if the the fifo is in use (it is changed
 	/// from the fifo itself).
 	// ----------------------------------------------------------------------------------------------------------------
 	uint32_t	HeadIdx;
 	// ----------------------------------------------------------------------------------------------------------------
 	/// \brief index of the tail element in the queue
+	/// \details For SPSC queues the free-running number of pushed items, written by the producer only.
 	/// \attention Initialize with 0, if the fifo is empty. Don´t change it, if the the fifo is in use (it is changed
 	/// from the fifo itself).
 	// ----------------------------------------------------------------------------------------------------------------
 	uint32_t	TailIdx;
 	// ----------------------------------------------------------------------------------------------------------------
 	/// \brief number of items currently in the queue
+	/// \details Not used by SPSC queues, the number of items is the difference of the tail and the head index.
 	/// \attention Initialize with 0, if the fifo is empty. Don´t change it, if the the fifo is in use (it is changed
 	/// from the fifo itself).
 	// ----------------------------------------------------------------------------------------------------------------
 	uint32_t	Count;
 
+#ifdef LIBFIFOQUEUECFG_STATISTICS
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Statistics of the queue
+	// ----------------------------------------------------------------------------------------------------------------
+	S_LibFifoQueue_Stats_t	Stats;
+#endif
+
 } S_LibFifoQueue_Inst_t;
 
 // --------------------------------------------------------------------------------------------------------------------
 //	Global Data Types
 // --------------------------------------------------------------------------------------------------------------------
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Maximum number of contiguous spans covering the items of a queue (one before and one after the wrap)
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBFIFO_NUM_SPANS			2U
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Contiguous span of items in the memory of a queue
+// --------------------------------------------------------------------------------------------------------------------
+typedef struct
+{
+	void*		pItems;             //!< Pointer to the first item of the span, NULL if the span is empty
+	uint32_t	NumItems;           //!< Number of items in the span
+} S_LibFifoQueue_Span_t;
 
 // --------------------------------------------------------------------------------------------------------------------
 //	Imported variables
@@ -130,11 +298,22 @@ void LibFifoQueue_Pop(S_LibFifoQueue_Inst_t* const pInst);
 
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief Clears all elements from the queue
+/// \details For SPSC queues the consumer drops all pushed elements, the producer must not call this function.
 /// \param pInst The settings of the fifo queue
 /// \sa S_LibFifoQueue_Inst_t
 // --------------------------------------------------------------------------------------------------------------------
 void LibFifoQueue_Clear(S_LibFifoQueue_Inst_t* const pInst);
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Get the number of items in the queue
+/// \details For SPSC queues the difference of the tail and the head index, otherwise the count of the queue. May be
+/// called from the producer and the consumer, the result is a snapshot which is outdated by the next push or pop.
+/// \param pInst The settings of the fifo queue
+/// \return Number of items in the queue
+/// \sa S_LibFifoQueue_Inst_t
+// --------------------------------------------------------------------------------------------------------------------
+uint32_t LibFifoQueue_GetCount(const S_LibFifoQueue_Inst_t* const pInst);
+
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief Access queue element selected by the index
 /// \param itemIndex Index of the element to be accessed,
@@ -147,11 +326,123 @@ void* LibFifoQueue_GetItem(const S_LibFifoQueue_Inst_t* const pInst, uint32_t it
 
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief Access the first queue element and pop it from the queue
+/// \attention The element is released to the producer: for shared and SPSC queues it may be overwritten by the next
+/// push, use LibFifoQueue_GetItem() and LibFifoQueue_Pop() instead.
 /// \param pInst The settings of the fifo queue
 /// \return The element, NULL if item does not exist
 /// \sa S_LibFifoQueue_Inst_t
 // --------------------------------------------------------------------------------------------------------------------
 void* LibFifoQueue_GetPopItem(S_LibFifoQueue_Inst_t* const pInst);
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Copy the first item out of the queue and pop it
+/// \details Copying and popping is done at once, so the item cannot be overwritten or coalesced in the meantime.
+/// \param pInst The settings of the fifo queue
+/// \param pItem Memory receiving the item
+/// \return True if an item was copied, false if the queue is empty
+/// \sa S_LibFifoQueue_Inst_t
+// --------------------------------------------------------------------------------------------------------------------
+bool_t LibFifoQueue_PopCopy(S_LibFifoQueue_Inst_t* const pInst, void* const pItem);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Reserve the next free element of the queue to construct an item in place
+/// \details The element is not visible to the consumer before LibFifoQueue_Commit() is called. If the queue is full and
+/// items can be overwritten, the oldest item is dropped.
+/// The consumer may pop or clear the queue while an element is reserved.
+/// \attention Only one reservation may be pending per queue: the producer must not push or reserve again before it
+/// has committed the element, which also rules out several producers on one queue.
+/// \param pInst The settings of the fifo queue
+/// \return The element to be filled, NULL if the queue is full
+/// \sa LibFifoQueue_Commit
+// --------------------------------------------------------------------------------------------------------------------
+void* LibFifoQueue_Reserve(S_LibFifoQueue_Inst_t* const pInst);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Publish the element returned by the preceding successful LibFifoQueue_Reserve() to the consumer
+/// \param pInst The settings of the fifo queue
+/// \sa LibFifoQueue_Reserve
+// --------------------------------------------------------------------------------------------------------------------
+void LibFifoQueue_Commit(S_LibFifoQueue_Inst_t* const pInst);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Access the oldest element of the queue in place without removing it
+/// \details The element stays valid and unchanged until it is released (except for queues overwriting items).
+/// \param pInst The settings of the fifo queue
+/// \return The element, NULL if the queue is empty
+/// \sa LibFifoQueue_Release
+// --------------------------------------------------------------------------------------------------------------------
+void* LibFifoQueue_Peek(const S_LibFifoQueue_Inst_t* const pInst);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Release the element returned by LibFifoQueue_Peek(), handing its memory back to the producer
+/// \param pInst The settings of the fifo queue
+/// \sa LibFifoQueue_Peek
+// --------------------------------------------------------------------------------------------------------------------
+void LibFifoQueue_Release(S_LibFifoQueue_Inst_t* const pInst);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Add several items into the queue at once
+/// \details The items are copied with at most two memcpy calls. Items which do not fit into the queue are not stored,
+/// regardless of the overwrite flag.
+/// \param pInst The settings of the fifo queue
+/// \param pItems The items, stored one after another
+/// \param numItems Number of items
+/// \return Number of items inserted
+// --------------------------------------------------------------------------------------------------------------------
+uint32_t LibFifoQueue_PushN(S_LibFifoQueue_Inst_t* const pInst, const void* const pItems, const uint32_t numItems);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Access all items of the queue in place as up to two contiguous spans
+/// \details The first span starts with the head element, the second span holds the items after the wrap-around of the
+/// buffer. The items stay valid until they are removed by LibFifoQueue_PopN(); items pushed in the meantime are not
+/// part of the spans.
+/// \param pInst The settings of the fifo queue
+/// \param pSpans Array of LIBFIFO_NUM_SPANS spans to be filled, empty spans have no items
+/// \return Total number of items in the spans
+/// \sa LibFifoQueue_PopN
+// --------------------------------------------------------------------------------------------------------------------
+uint32_t LibFifoQueue_GetSpans(const S_LibFifoQueue_Inst_t* const pInst, S_LibFifoQueue_Span_t* const pSpans);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Pop several items from the queue at once
+/// \param pInst The settings of the fifo queue
+/// \param numItems Number of items to be popped, limited to the number of items in the queue
+// --------------------------------------------------------------------------------------------------------------------
+void LibFifoQueue_PopN(S_LibFifoQueue_Inst_t* const pInst, const uint32_t numItems);
+
+#ifdef LIBFIFOQUEUECFG_STATISTICS
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Record pushed and discarded items in the statistics of a queue
+/// \details Called by the producer, with interrupts suspended if several producers share the queue.
+/// \param pStats The statistics of the queue
+/// \param numPushed Number of items pushed
+/// \param numFailed Number of items discarded because the queue was full
+/// \param count Number of items in the queue after the push
+// --------------------------------------------------------------------------------------------------------------------
+void LibFifoQueue_RecordPush(S_LibFifoQueue_Stats_t* const pStats, const uint32_t numPushed, const uint32_t numFailed,
+							 const uint32_t count);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Link the statistics of a queue into the registry, if not done yet
+/// \attention Suspends and resumes all interrupts on the first call, so it must not be called with interrupts
+/// suspended.
+/// \param pStats The statistics of the queue
+/// \param pName Name of the queue, NULL if unnamed
+/// \param numMaxItems Maximum number of items in the queue
+// --------------------------------------------------------------------------------------------------------------------
+void LibFifoQueue_RegisterStats(S_LibFifoQueue_Stats_t* const pStats, const char* const pName,
+								const uint32_t numMaxItems);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Get the statistics of the most recently registered queue to enumerate all queues
+/// \details The registry only grows, the queues are enumerated by following pNext:
+/// \code
+///		for (pStats = LibFifoQueue_GetFirstStats(); NULL != pStats; pStats = pStats->pNext) { ... }
+/// \endcode
+/// \return The statistics, NULL if no queue has been used yet
+// --------------------------------------------------------------------------------------------------------------------
+const S_LibFifoQueue_Stats_t* LibFifoQueue_GetFirstStats(void);
+#endif // LIBFIFOQUEUECFG_STATISTICS
+
 #endif  //LIB_FIFO_QUEUE_H__INCLUDED
 
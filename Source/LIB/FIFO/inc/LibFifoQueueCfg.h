@@ -0,0 +1,53 @@
+// --------------------------------------------------------------------------------------------------------------------
+///
+/// \file LibFifoQueueCfg.h
+///
+/// \brief Configuration file for the fifo queues.
+///
+///
+///
+/// All Rights Reserved.
+///
+// --------------------------------------------------------------------------------------------------------------------
+
+
+#ifndef LIB_FIFO_QUEUE_CFG_H__INCLUDED
+#define LIB_FIFO_QUEUE_CFG_H__INCLUDED
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Includes
+// --------------------------------------------------------------------------------------------------------------------
+
+
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Global Definitions
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief In case that each queue shall record its high watermark, push failures, overwrites and throughput and shall
+/// be enumerable at runtime by LibFifoQueue_GetFirstStats() uncomment this line, otherwise comment it out.
+///
+/// The statistics cost one S_LibFifoQueue_Stats_t per queue and a few instructions per push, and the first push of
+/// each queue links it into the registry with interrupts suspended. Enable them for debug builds only.
+// --------------------------------------------------------------------------------------------------------------------
+//#define LIBFIFOQUEUECFG_STATISTICS
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Global Data Types
+// --------------------------------------------------------------------------------------------------------------------
+
+
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Imported Variables
+// --------------------------------------------------------------------------------------------------------------------
+
+
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Global Function Prototypes
+// --------------------------------------------------------------------------------------------------------------------
+
+
+#endif // LIB_FIFO_QUEUE_CFG_H__INCLUDED
@@ -0,0 +1,179 @@
+// --------------------------------------------------------------------------------------------------------------------
+///
+/// \file LibFifoTyped.h
+///
+/// \brief Generator for FIFO queues specialized for one item type and a constant depth
+///
+/// LIBFIFO_DECLARE_TYPED() emits a queue type and inline functions for one item type and a power-of-two depth known
+/// at compile time. Items are copied by assignment and indexed by mask, so the compiler inlines fixed-size copies
+/// instead of calling memcpy with the runtime item length of LibFifoQueue. The queue is a lock-free
+/// single-producer/single-consumer queue with the same rules as LIBFIFO_DEFINE_SPSC_INST().
+///
+/// Example:
+/// \code
+///		// header: type S_CanRx_Fifo_t and functions CanRx_Push(), CanRx_Peek(), ...
+///		LIBFIFO_DECLARE_TYPED(CanRx, S_LibCan_Msg_t, 8U)
+///		extern S_CanRx_Fifo_t CanRx_Fifo;
+///
+///		// source file
+///		S_CanRx_Fifo_t CanRx_Fifo = LIBFIFO_TYPED_INIT();
+/// \endcode
+///
+/// All Rights Reserved.
+///
+// --------------------------------------------------------------------------------------------------------------------
+
+#ifndef LIB_FIFO_TYPED_H__INCLUDED
+#define LIB_FIFO_TYPED_H__INCLUDED
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Includes
+// --------------------------------------------------------------------------------------------------------------------
+#include "LibTypes.h"
+#include "LibFifoQueue.h"
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Global Definitions
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+///	\brief Initializer of an empty typed FIFO
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBFIFO_TYPED_INIT()		{ .HeadIdx = 0U, .TailIdx = 0U }
+
+// --------------------------------------------------------------------------------------------------------------------
+///	\brief Declare the type S_<prefix>_Fifo_t and the inline functions <prefix>_xxx() of a typed FIFO
+///
+/// Generated functions, the producer functions may only be called by the producer, all others only by the consumer:
+/// - bool_t <prefix>_Push(S_<prefix>_Fifo_t* pFifo, const itemType* pItem) - producer, false if the queue is full
+/// - itemType* <prefix>_Reserve(S_<prefix>_Fifo_t* pFifo) - producer, the next free item or NULL if the queue is full
+/// - void <prefix>_Commit(S_<prefix>_Fifo_t* pFifo) - producer, publish the item returned by <prefix>_Reserve()
+/// - void <prefix>_Discard(S_<prefix>_Fifo_t* pFifo) - producer, drop the item returned by <prefix>_Reserve()
+/// - itemType* <prefix>_Peek(S_<prefix>_Fifo_t* pFifo) - the oldest item or NULL if the queue is empty
+/// - void <prefix>_Pop(S_<prefix>_Fifo_t* pFifo) - remove the oldest item
+/// - uint32_t <prefix>_GetCount(S_<prefix>_Fifo_t* pFifo) - producer or consumer, the number of items in the queue
+/// - void <prefix>_Clear(S_<prefix>_Fifo_t* pFifo) - remove all items
+///
+/// \param prefix Module unique prefix of the type and the functions
+/// \param itemType Type of one item
+/// \param numItems Max. number of items, a power of two (checked at compile time)
+/// \sa LIBFIFOQUEUECFG_STATISTICS, the statistics are registered under the name of the prefix
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBFIFO_DECLARE_TYPED(prefix, itemType, numItems)															\
+	typedef char prefix##_FifoNumItemsIsPowerOfTwo[(0U == ((numItems) & ((numItems) - 1U))) ? 1 : -1];			\
+																													\
+	typedef struct																									\
+	{																												\
+		itemType	Items[numItems];        /* memory of the items */												\
+		uint32_t	HeadIdx;                /* free-running number of popped items, written by the consumer */		\
+		uint32_t	TailIdx;                /* free-running number of pushed items, written by the producer */		\
+		LIBFIFO_TYPED_STATS_MEMBER																					\
+	} S_##prefix##_Fifo_t;																							\
+																													\
+	static inline itemType* prefix##_Reserve(S_##prefix##_Fifo_t* const pFifo)										\
+	{																												\
+		const uint32_t tailIdx = pFifo->TailIdx;																	\
+		itemType* pSlot = NULL;																						\
+		if ((tailIdx - LibAtomic_Load(&pFifo->HeadIdx)) < (numItems))												\
+		{																											\
+			pSlot = &pFifo->Items[tailIdx & ((numItems) - 1U)];														\
+		}																											\
+		else																										\
+		{																											\
+			LIBFIFO_TYPED_STATS_PUSH(prefix, pFifo, 0U, 1U, (numItems), (numItems));								\
+		}																											\
+		return pSlot;																								\
+	}																												\
+																													\
+	static inline void prefix##_Commit(S_##prefix##_Fifo_t* const pFifo)											\
+	{																												\
+		const uint32_t tailIdx = pFifo->TailIdx + 1U;																\
+		LibAtomic_Store(&pFifo->TailIdx, tailIdx);																	\
+		LIBFIFO_TYPED_STATS_PUSH(prefix, pFifo, 1U, 0U, tailIdx - LibAtomic_Load(&pFifo->HeadIdx), numItems);		\
+	}																												\
+																													\
+	static inline void prefix##_Discard(S_##prefix##_Fifo_t* const pFifo)											\
+	{																												\
+		(void)pFifo;																								\
+		LIBFIFO_TYPED_STATS_PUSH(prefix, pFifo, 0U, 1U, 0U, numItems);												\
+	}																												\
+																													\
+	static inline bool_t prefix##_Push(S_##prefix##_Fifo_t* const pFifo, const itemType* const pItem)				\
+	{																												\
+		itemType* const pSlot = prefix##_Reserve(pFifo);															\
+		if (NULL != pSlot)																							\
+		{																											\
+			*pSlot = *pItem;																						\
+			prefix##_Commit(pFifo);																					\
+		}																											\
+		return (NULL != pSlot);																						\
+	}																												\
+																													\
+	static inline itemType* prefix##_Peek(S_##prefix##_Fifo_t* const pFifo)											\
+	{																												\
+		const uint32_t headIdx = pFifo->HeadIdx;																	\
+		return (LibAtomic_Load(&pFifo->TailIdx) != headIdx) ? &pFifo->Items[headIdx & ((numItems) - 1U)] : NULL;	\
+	}																												\
+																													\
+	static inline void prefix##_Pop(S_##prefix##_Fifo_t* const pFifo)												\
+	{																												\
+		const uint32_t headIdx = pFifo->HeadIdx;																	\
+		if (LibAtomic_Load(&pFifo->TailIdx) != headIdx)																\
+		{																											\
+			LibAtomic_Store(&pFifo->HeadIdx, headIdx + 1U);															\
+		}																											\
+	}																												\
+																													\
+	static inline uint32_t prefix##_GetCount(S_##prefix##_Fifo_t* const pFifo)										\
+	{																												\
+		return LibAtomic_Load(&pFifo->TailIdx) - LibAtomic_Load(&pFifo->HeadIdx);									\
+	}																												\
+																													\
+	static inline void prefix##_Clear(S_##prefix##_Fifo_t* const pFifo)												\
+	{																												\
+		const uint32_t tailIdx = LibAtomic_Load(&pFifo->TailIdx);													\
+		LIBFIFO_TYPED_STATS_CLEAR(pFifo, tailIdx - pFifo->HeadIdx);													\
+		LibAtomic_Store(&pFifo->HeadIdx, tailIdx);																	\
+	}
+
+#ifdef LIBFIFOQUEUECFG_STATISTICS
+// --------------------------------------------------------------------------------------------------------------------
+///	\brief Statistics member of a typed FIFO, see LIBFIFO_DECLARE_TYPED()
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBFIFO_TYPED_STATS_MEMBER		S_LibFifoQueue_Stats_t Stats;
+
+// --------------------------------------------------------------------------------------------------------------------
+///	\brief Record pushed and discarded items of a typed FIFO and register it under the name of the prefix
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBFIFO_TYPED_STATS_PUSH(prefix, pFifo, numPushed, numFailed, count, numItems)								\
+	do {																											\
+		LibFifoQueue_RecordPush(&(pFifo)->Stats, (numPushed), (numFailed), (count));								\
+		LibFifoQueue_RegisterStats(&(pFifo)->Stats, #prefix, (numItems));											\
+	} while (false)
+
+// --------------------------------------------------------------------------------------------------------------------
+///	\brief Record the items dropped by clearing a typed FIFO
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBFIFO_TYPED_STATS_CLEAR(pFifo, count)		do { (pFifo)->Stats.NumCleared += (count); } while (false)
+#else
+#define LIBFIFO_TYPED_STATS_MEMBER
+#define LIBFIFO_TYPED_STATS_PUSH(prefix, pFifo, numPushed, numFailed, count, numItems)	do { } while (false)
+#define LIBFIFO_TYPED_STATS_CLEAR(pFifo, count)		do { } while (false)
+#endif
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Global Data Types
+// --------------------------------------------------------------------------------------------------------------------
+
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Imported variables
+// --------------------------------------------------------------------------------------------------------------------
+
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Global Function Prototypes
+// --------------------------------------------------------------------------------------------------------------------
+
+
+#endif  //LIB_FIFO_TYPED_H__INCLUDED
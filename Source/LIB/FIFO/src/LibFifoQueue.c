@@ -25,6 +25,58 @@
 //	Local Definitions
 // --------------------------------------------------------------------------------------------------------------------
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Enter the critical section of a shared queue
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBFIFO_LOCK(pInst)			do { if ((pInst)->IsShared) { SuspendAllInterrupts(); } } while (false)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Leave the critical section of a shared queue
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBFIFO_UNLOCK(pInst)		do { if ((pInst)->IsShared) { ResumeAllInterrupts(); } } while (false)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Get the address of an item of a SPSC queue from its free-running index
+// --------------------------------------------------------------------------------------------------------------------
+//lint -emacro((9087, 9016), LIBFIFO_SPSC_ITEM) Cast is ok, pointer arithmetic checked
+#define LIBFIFO_SPSC_ITEM(pInst, idx)	\
+	(((uint8_t*)(void*)(pInst)->pFifoMem) + (((idx) & ((pInst)->NumMaxItems - 1U)) * (pInst)->ItemLen))
+
+#ifdef LIBFIFOQUEUECFG_STATISTICS
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Record pushed and discarded items, count is the number of items in the queue afterwards
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBFIFO_STATS_PUSH(pInst, numPushed, numFailed, count)	\
+	LibFifoQueue_RecordPush(&(pInst)->Stats, (numPushed), (numFailed), (count))
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Record an item dropped to make room for a new one
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBFIFO_STATS_OVERWRITE(pInst)			do { (pInst)->Stats.NumOverwritten++; } while (false)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Record an item replaced by an equivalent newer item
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBFIFO_STATS_COALESCE(pInst)			do { (pInst)->Stats.NumCoalesced++; } while (false)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Record the items dropped by clearing the queue
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBFIFO_STATS_CLEAR(pInst, count)		do { (pInst)->Stats.NumCleared += (count); } while (false)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Link the queue into the statistics registry, must be called with interrupts enabled
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBFIFO_STATS_REGISTER(pInst)	\
+	LibFifoQueue_RegisterStats(&(pInst)->Stats, (pInst)->Stats.pName, (pInst)->NumMaxItems)
+#else
+#define LIBFIFO_STATS_PUSH(pInst, numPushed, numFailed, count)	do { } while (false)
+#define LIBFIFO_STATS_OVERWRITE(pInst)			do { } while (false)
+#define LIBFIFO_STATS_COALESCE(pInst)			do { } while (false)
+#define LIBFIFO_STATS_CLEAR(pInst, count)		do { } while (false)
+#define LIBFIFO_STATS_REGISTER(pInst)			do { } while (false)
+#endif
+
 // --------------------------------------------------------------------------------------------------------------------
 //	Local Data Types
 // --------------------------------------------------------------------------------------------------------------------
@@ -39,11 +91,53 @@
 //	Local variables
 // --------------------------------------------------------------------------------------------------------------------
 
+#ifdef LIBFIFOQUEUECFG_STATISTICS
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Head of the registry: the statistics of the most recently registered queue
+// --------------------------------------------------------------------------------------------------------------------
+static S_LibFifoQueue_Stats_t* LibFifoQueue_pFirstStats = NULL;
+#endif
+
 
 // --------------------------------------------------------------------------------------------------------------------
 //	Local Function Prototypes
 // --------------------------------------------------------------------------------------------------------------------
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Init a SPSC queue, see LibFifoQueue_Init()
+// --------------------------------------------------------------------------------------------------------------------
+static void LibFifoQueue_SpscInit(S_LibFifoQueue_Inst_t* const pInst, const uint32_t headIdx, const uint32_t count);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Add an item into a SPSC queue, called by the producer only
+/// \param pInst The settings of the fifo queue
+/// \param pItem The item
+/// \return True if item was inserted, false if the queue is full
+// --------------------------------------------------------------------------------------------------------------------
+static bool_t LibFifoQueue_SpscPush(S_LibFifoQueue_Inst_t* const pInst, const void* const pItem);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Pop the first item from a SPSC queue, called by the consumer only
+/// \param pInst The settings of the fifo queue
+// --------------------------------------------------------------------------------------------------------------------
+static void LibFifoQueue_SpscPop(S_LibFifoQueue_Inst_t* const pInst);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Access an element of a SPSC queue, called by the consumer only
+/// \param pInst The settings of the fifo queue
+/// \param itemIndex Index of the element to be accessed, counted from 0x00 for the head element
+/// \return The element, NULL if item does not exist
+// --------------------------------------------------------------------------------------------------------------------
+static void* LibFifoQueue_SpscGetItem(const S_LibFifoQueue_Inst_t* const pInst, const uint32_t itemIndex);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Replace the newest queued item equivalent to the pushed one, called with the queue locked
+/// \param pInst The settings of the fifo queue
+/// \param pItem The pushed item
+/// \return True if an item has been replaced
+// --------------------------------------------------------------------------------------------------------------------
+static bool_t LibFifoQueue_Coalesce(S_LibFifoQueue_Inst_t* const pInst, const void* const pItem);
+
 // ====================================================================================================================
 // LibFifoQueue_Init:
 // ====================================================================================================================
@@ -51,26 +145,35 @@ void LibFifoQueue_Init(S_LibFifoQueue_Inst_t* const pInst, const uint32_t headId
 {
 	Lib_Assert((NULL != pInst) && (headIdx < pInst->NumMaxItems) && (count <= pInst->NumMaxItems));
 
-	pInst->HeadIdx = headIdx;
-
-	if (0U == count)
+	if (pInst->IsSpsc)
 	{
-		pInst->TailIdx = headIdx;
+		LibFifoQueue_SpscInit(pInst, headIdx, count);
 	}
 	else
 	{
-		// Calculation of the tail position
-		// Decrease by 1, the tail is the last valid element and not first free space
-		uint32_t posTail = headIdx + count - 1U ;
+		LIBFIFO_LOCK(pInst);
+		pInst->HeadIdx = headIdx;
 
-		if (posTail >= pInst->NumMaxItems)
+		if (0U == count)
 		{
-			posTail -= pInst->NumMaxItems;
+			pInst->TailIdx = headIdx;
+		}
+		else
+		{
+			// Calculation of the tail position
+			// Decrease by 1, the tail is the last valid element and not first free space
+			uint32_t posTail = headIdx + count - 1U ;
+
+			if (posTail >= pInst->NumMaxItems)
+			{
+				posTail -= pInst->NumMaxItems;
+			}
+			pInst->TailIdx = posTail;
 		}
-		pInst->TailIdx = posTail;
-	}
 	
-	pInst->Count = count;
+		pInst->Count = count;
+		LIBFIFO_UNLOCK(pInst);
+	}
 }
 
 
@@ -88,12 +191,35 @@ bool_t LibFifoQueue_Push(S_LibFifoQueue_Inst_t* const pInst, const void* const p
 		{
 #endif
 
-			if (0U == pInst->Count)
+			if (pInst->IsSpsc)
+			{
+				ret = LibFifoQueue_SpscPush(pInst, pItem);
+			}
+			else
 			{
-				// The queue is empty and we add the first element
-				// position of the tail will not be changed.
-				if (pInst->HeadIdx == pInst->TailIdx)
+				LIBFIFO_LOCK(pInst);
+				if (0U == pInst->Count)
+				{
+					// The queue is empty and we add the first element
+					// position of the tail will not be changed.
+					if (pInst->HeadIdx == pInst->TailIdx)
+					{
+						//lint -e{9087, 9016} Cast is ok, pointer arithmetic checked
+						(void)memcpy((((uint8_t*)(void*)pInst->pFifoMem) + (pInst->TailIdx * pInst->ItemLen)),
+									 pItem,
+									 pInst->ItemLen);
+						pInst->Count++;
+						ret = true;
+					}
+				}
+				else if (pInst->Count < pInst->NumMaxItems)
 				{
+					pInst->TailIdx++;
+
+					if (pInst->TailIdx >= pInst->NumMaxItems)
+					{
+						pInst->TailIdx = 0U;
+					}
 					//lint -e{9087, 9016} Cast is ok, pointer arithmetic checked
 					(void)memcpy((((uint8_t*)(void*)pInst->pFifoMem) + (pInst->TailIdx * pInst->ItemLen)),
 								 pItem,
@@ -101,41 +227,35 @@ bool_t LibFifoQueue_Push(S_LibFifoQueue_Inst_t* const pInst, const void* const p
 					pInst->Count++;
 					ret = true;
 				}
-			}
-			else if (pInst->Count < pInst->NumMaxItems)
-			{
-				pInst->TailIdx++;
-
-				if (pInst->TailIdx >= pInst->NumMaxItems)
+				else if ((NULL != pInst->pfIsSameItem) && LibFifoQueue_Coalesce(pInst, pItem))
 				{
-					pInst->TailIdx = 0U;
+					LIBFIFO_STATS_COALESCE(pInst);
+					ret = true;
 				}
-				//lint -e{9087, 9016} Cast is ok, pointer arithmetic checked
-				(void)memcpy((((uint8_t*)(void*)pInst->pFifoMem) + (pInst->TailIdx * pInst->ItemLen)),
-							 pItem,
-							 pInst->ItemLen);
-				pInst->Count++;
-				ret = true;
-			}
-			else if (pInst->OverwriteItems)
-			{
-				pInst->TailIdx = pInst->HeadIdx;
-				pInst->HeadIdx++;
+				else if (pInst->OverwriteItems)
+				{
+					pInst->TailIdx = pInst->HeadIdx;
+					pInst->HeadIdx++;
 
-				if (pInst->HeadIdx >= pInst->NumMaxItems)
+					if (pInst->HeadIdx >= pInst->NumMaxItems)
+					{
+						pInst->HeadIdx = 0U;
+					}
+					//lint -e{9087, 9016} Cast is ok, pointer arithmetic checked
+					(void)memcpy((((uint8_t*)(void*)pInst->pFifoMem) + (pInst->TailIdx * pInst->ItemLen)),
+								 pItem,
+								 pInst->ItemLen);
+					LIBFIFO_STATS_OVERWRITE(pInst);
+					ret = true;
+				}
+				else
 				{
-					pInst->HeadIdx = 0U;
+					// discard the item
 				}
-				//lint -e{9087, 9016} Cast is ok, pointer arithmetic checked
-				(void)memcpy((((uint8_t*)(void*)pInst->pFifoMem) + (pInst->TailIdx * pInst->ItemLen)),
-							 pItem,
-							 pInst->ItemLen);
-				ret = true;
-			}
-			else
-			{
-				// discard the item
+				LIBFIFO_STATS_PUSH(pInst, ret ? 1U : 0U, ret ? 0U : 1U, pInst->Count);
+				LIBFIFO_UNLOCK(pInst);
 			}
+			LIBFIFO_STATS_REGISTER(pInst);
 
 #ifndef FIFO_QUEUE_NO_NULL_QUECKS
 		}
@@ -156,22 +276,31 @@ void LibFifoQueue_Pop(S_LibFifoQueue_Inst_t* const pInst)
 	{
 #endif
 
-		if (0U != pInst->Count)
+		if (pInst->IsSpsc)
 		{
-			pInst->Count--;
-
+			LibFifoQueue_SpscPop(pInst);
+		}
+		else
+		{
+			LIBFIFO_LOCK(pInst);
 			if (0U != pInst->Count)
 			{
-				// move head index only if this
-				// is not the last element in
-				// the queue
-				pInst->HeadIdx++;
+				pInst->Count--;
 
-				if (pInst->HeadIdx >= pInst->NumMaxItems)
+				if (0U != pInst->Count)
 				{
-					pInst->HeadIdx = 0U;
+					// move head index only if this
+					// is not the last element in
+					// the queue
+					pInst->HeadIdx++;
+
+					if (pInst->HeadIdx >= pInst->NumMaxItems)
+					{
+						pInst->HeadIdx = 0U;
+					}
 				}
 			}
+			LIBFIFO_UNLOCK(pInst);
 		}
 
 #ifndef FIFO_QUEUE_NO_NULL_QUECKS
@@ -190,15 +319,54 @@ void LibFifoQueue_Clear(S_LibFifoQueue_Inst_t* const pInst)
 	if (NULL != pInst)
 	{
 #endif
-		pInst->HeadIdx = 0U;
-		pInst->TailIdx = 0U;
-		pInst->Count = 0U;
+		if (pInst->IsSpsc)
+		{
+			// drop all pushed items: the tail index belongs to the producer
+			const uint32_t tailIdx = LibAtomic_Load(&pInst->TailIdx);
+
+			LIBFIFO_STATS_CLEAR(pInst, tailIdx - pInst->HeadIdx);
+			LibAtomic_Store(&pInst->HeadIdx, tailIdx);
+		}
+		else
+		{
+			LIBFIFO_LOCK(pInst);
+			// keep the tail, a pending reservation of the producer follows it
+			LIBFIFO_STATS_CLEAR(pInst, pInst->Count);
+			pInst->HeadIdx = pInst->TailIdx;
+			pInst->Count = 0U;
+			LIBFIFO_UNLOCK(pInst);
+		}
+		LIBFIFO_STATS_REGISTER(pInst);
 #ifndef FIFO_QUEUE_NO_NULL_QUECKS
 	}
 
 #endif
 }
 
+// ====================================================================================================================
+// LibFifoQueue_GetCount:
+// ====================================================================================================================
+uint32_t LibFifoQueue_GetCount(const S_LibFifoQueue_Inst_t* const pInst)
+{
+	uint32_t count;
+
+	Lib_Assert(NULL != pInst);
+
+	if (pInst->IsSpsc)
+	{
+		// the head is read first, so the tail read afterwards cannot be behind it
+		const uint32_t headIdx = LibAtomic_Load(&pInst->HeadIdx);
+		count = LibAtomic_Load(&pInst->TailIdx) - headIdx;
+	}
+	else
+	{
+		// a single word, consistent without the lock
+		count = LibAtomic_Load(&pInst->Count);
+	}
+
+	return count;
+}
+
 // ====================================================================================================================
 // LibFifoQueue_GetItem:
 // ====================================================================================================================
@@ -213,16 +381,25 @@ void* LibFifoQueue_GetItem(const S_LibFifoQueue_Inst_t* const pInst, const uint3
 		{
 #endif
 
-			if ((itemIndex < pInst->Count) && (0U != pInst->Count) && (NULL != pInst->pFifoMem))
+			if (pInst->IsSpsc)
 			{
-				uint32_t pos = (pInst->HeadIdx + itemIndex);
-
-				if (pos >= pInst->NumMaxItems)
+				pRet = LibFifoQueue_SpscGetItem(pInst, itemIndex);
+			}
+			else
+			{
+				LIBFIFO_LOCK(pInst);
+				if ((itemIndex < pInst->Count) && (0U != pInst->Count) && (NULL != pInst->pFifoMem))
 				{
-					pos -= pInst->NumMaxItems;
+					uint32_t pos = (pInst->HeadIdx + itemIndex);
+
+					if (pos >= pInst->NumMaxItems)
+					{
+						pos -= pInst->NumMaxItems;
+					}
+					//lint -e{9087, 9016} Cast is ok, pointer arithmetic checked
+					pRet = ((uint8_t*)(void*)pInst->pFifoMem) + (pos * pInst->ItemLen);
 				}
-				//lint -e{9087, 9016} Cast is ok, pointer arithmetic checked
-				pRet = ((uint8_t*)(void*)pInst->pFifoMem) + (pos * pInst->ItemLen);
+				LIBFIFO_UNLOCK(pInst);
 			}
 
 #ifndef FIFO_QUEUE_NO_NULL_QUECKS
@@ -247,25 +424,38 @@ void* LibFifoQueue_GetPopItem(S_LibFifoQueue_Inst_t* const pInst)
 		{
 #endif
 
-			if (0U != pInst->Count)
+			if (pInst->IsSpsc)
 			{
-				//lint -e{9087, 9016} Cast is ok, pointer arithmetic checked
-				pRet = ((uint8_t*)(void*)pInst->pFifoMem) + (pInst->HeadIdx * pInst->ItemLen);
-				// now pop the item
-				pInst->Count--;
-
+				pRet = LibFifoQueue_SpscGetItem(pInst, UINT32_C(0));
+				if (NULL != pRet)
+				{
+					LibFifoQueue_SpscPop(pInst);
+				}
+			}
+			else
+			{
+				LIBFIFO_LOCK(pInst);
 				if (0U != pInst->Count)
 				{
-					// move head index only if this
-					// is not the last element in
-					// the queue
-					pInst->HeadIdx++;
+					//lint -e{9087, 9016} Cast is ok, pointer arithmetic checked
+					pRet = ((uint8_t*)(void*)pInst->pFifoMem) + (pInst->HeadIdx * pInst->ItemLen);
+					// now pop the item
+					pInst->Count--;
 
-					if (pInst->HeadIdx >= pInst->NumMaxItems)
+					if (0U != pInst->Count)
 					{
-						pInst->HeadIdx = 0U;
+						// move head index only if this
+						// is not the last element in
+						// the queue
+						pInst->HeadIdx++;
+
+						if (pInst->HeadIdx >= pInst->NumMaxItems)
+						{
+							pInst->HeadIdx = 0U;
+						}
 					}
 				}
+				LIBFIFO_UNLOCK(pInst);
 			}
 
 #ifndef FIFO_QUEUE_NO_NULL_QUECKS
@@ -276,4 +466,466 @@ void* LibFifoQueue_GetPopItem(S_LibFifoQueue_Inst_t* const pInst)
 	return pRet;
 }
 
+// ====================================================================================================================
+// LibFifoQueue_PopCopy:
+// ====================================================================================================================
+bool_t LibFifoQueue_PopCopy(S_LibFifoQueue_Inst_t* const pInst, void* const pItem)
+{
+	bool_t ret = false;
+
+	Lib_Assert((NULL != pInst) && (NULL != pInst->pFifoMem) && (NULL != pItem));
+
+	if (pInst->IsSpsc)
+	{
+		const void* const pQueued = LibFifoQueue_SpscGetItem(pInst, UINT32_C(0));
+
+		if (NULL != pQueued)
+		{
+			(void)memcpy(pItem, pQueued, pInst->ItemLen);
+			LibFifoQueue_SpscPop(pInst);
+			ret = true;
+		}
+	}
+	else
+	{
+		LIBFIFO_LOCK(pInst);
+		if (0U != pInst->Count)
+		{
+			//lint -e{9087, 9016} Cast is ok, pointer arithmetic checked
+			(void)memcpy(pItem, ((uint8_t*)(void*)pInst->pFifoMem) + (pInst->HeadIdx * pInst->ItemLen), pInst->ItemLen);
+			pInst->Count--;
+
+			if (0U != pInst->Count)
+			{
+				// move head index only if this is not the last element in the queue
+				pInst->HeadIdx++;
+
+				if (pInst->HeadIdx >= pInst->NumMaxItems)
+				{
+					pInst->HeadIdx = 0U;
+				}
+			}
+			ret = true;
+		}
+		LIBFIFO_UNLOCK(pInst);
+	}
+
+	return ret;
+}
+
+// ====================================================================================================================
+// LibFifoQueue_Reserve:
+// ====================================================================================================================
+void* LibFifoQueue_Reserve(S_LibFifoQueue_Inst_t* const pInst)
+{
+	void* pRet = NULL;
+
+	Lib_Assert((NULL != pInst) && (NULL != pInst->pFifoMem));
 
+	if (pInst->IsSpsc)
+	{
+		const uint32_t tailIdx = pInst->TailIdx;
+
+		if ((tailIdx - LibAtomic_Load(&pInst->HeadIdx)) < pInst->NumMaxItems)
+		{
+			pRet = LIBFIFO_SPSC_ITEM(pInst, tailIdx);
+		}
+		else
+		{
+			LIBFIFO_STATS_PUSH(pInst, 0U, 1U, pInst->NumMaxItems);
+		}
+	}
+	else
+	{
+		LIBFIFO_LOCK(pInst);
+		if ((pInst->Count >= pInst->NumMaxItems) && (pInst->OverwriteItems))
+		{
+			// drop the oldest item to make room for the new one
+			LIBFIFO_STATS_OVERWRITE(pInst);
+			pInst->Count--;
+			pInst->HeadIdx++;
+
+			if (pInst->HeadIdx >= pInst->NumMaxItems)
+			{
+				pInst->HeadIdx = 0U;
+			}
+		}
+
+		if (pInst->Count < pInst->NumMaxItems)
+		{
+			// reserve the element after the tail, also for an empty queue: the tail is only moved by the producer,
+			// while the consumer may pop the last item and move the head until the element is committed
+			uint32_t pos = pInst->TailIdx + 1U;
+
+			if (pos >= pInst->NumMaxItems)
+			{
+				pos = 0U;
+			}
+			//lint -e{9087, 9016} Cast is ok, pointer arithmetic checked
+			pRet = ((uint8_t*)(void*)pInst->pFifoMem) + (pos * pInst->ItemLen);
+		}
+		else
+		{
+			// the queue is full
+			LIBFIFO_STATS_PUSH(pInst, 0U, 1U, pInst->Count);
+		}
+		LIBFIFO_UNLOCK(pInst);
+	}
+	LIBFIFO_STATS_REGISTER(pInst);
+
+	return pRet;
+}
+
+// ====================================================================================================================
+// LibFifoQueue_Commit:
+// ====================================================================================================================
+void LibFifoQueue_Commit(S_LibFifoQueue_Inst_t* const pInst)
+{
+	Lib_Assert(NULL != pInst);
+
+	if (pInst->IsSpsc)
+	{
+		// publish the item: the construction is visible to the consumer before the new tail index
+		const uint32_t tailIdx = pInst->TailIdx + 1U;
+
+		LibAtomic_Store(&pInst->TailIdx, tailIdx);
+		LIBFIFO_STATS_PUSH(pInst, 1U, 0U, tailIdx - LibAtomic_Load(&pInst->HeadIdx));
+	}
+	else
+	{
+		LIBFIFO_LOCK(pInst);
+		if (pInst->Count < pInst->NumMaxItems)
+		{
+			// the reserved element follows the tail, see LibFifoQueue_Reserve()
+			pInst->TailIdx++;
+
+			if (pInst->TailIdx >= pInst->NumMaxItems)
+			{
+				pInst->TailIdx = 0U;
+			}
+
+			if (0U == pInst->Count)
+			{
+				// the first element of an empty queue is the head
+				pInst->HeadIdx = pInst->TailIdx;
+			}
+			pInst->Count++;
+			LIBFIFO_STATS_PUSH(pInst, 1U, 0U, pInst->Count);
+		}
+		else
+		{
+			// nothing has been reserved
+		}
+		LIBFIFO_UNLOCK(pInst);
+	}
+}
+
+// ====================================================================================================================
+// LibFifoQueue_Peek:
+// ====================================================================================================================
+void* LibFifoQueue_Peek(const S_LibFifoQueue_Inst_t* const pInst)
+{
+	return LibFifoQueue_GetItem(pInst, UINT32_C(0));
+}
+
+// ====================================================================================================================
+// LibFifoQueue_Release:
+// ====================================================================================================================
+void LibFifoQueue_Release(S_LibFifoQueue_Inst_t* const pInst)
+{
+	LibFifoQueue_Pop(pInst);
+}
+
+// ====================================================================================================================
+// LibFifoQueue_PushN:
+// ====================================================================================================================
+uint32_t LibFifoQueue_PushN(S_LibFifoQueue_Inst_t* const pInst, const void* const pItems, const uint32_t numItems)
+{
+	uint32_t numPushed = 0U;
+	uint32_t pos = 0U;
+	uint32_t tailIdx = 0U;
+	uint32_t count = 0U;
+
+	Lib_Assert((NULL != pInst) && (NULL != pInst->pFifoMem) && (NULL != pItems));
+
+	if (pInst->IsSpsc)
+	{
+		tailIdx = pInst->TailIdx;
+		count = tailIdx - LibAtomic_Load(&pInst->HeadIdx);
+		numPushed = pInst->NumMaxItems - count;
+		pos = tailIdx & (pInst->NumMaxItems - 1U);
+	}
+	else
+	{
+		LIBFIFO_LOCK(pInst);
+		count = pInst->Count;
+		numPushed = pInst->NumMaxItems - count;
+		pos = (0U == pInst->Count) ? pInst->HeadIdx : (pInst->TailIdx + 1U);
+
+		if (pos >= pInst->NumMaxItems)
+		{
+			pos = 0U;
+		}
+	}
+
+	if (numPushed > numItems)
+	{
+		numPushed = numItems;
+	}
+
+	if (0U != numPushed)
+	{
+		// copy up to the end of the buffer and the rest to its start
+		const uint32_t numFirst = ((pInst->NumMaxItems - pos) < numPushed) ? (pInst->NumMaxItems - pos) : numPushed;
+		//lint -e{9087, 9016} Cast is ok, pointer arithmetic checked
+		(void)memcpy((((uint8_t*)(void*)pInst->pFifoMem) + (pos * pInst->ItemLen)), pItems, numFirst * pInst->ItemLen);
+		if (numFirst < numPushed)
+		{
+			//lint -e{9087, 9016} Cast is ok, pointer arithmetic checked
+			(void)memcpy(pInst->pFifoMem, ((const uint8_t*)pItems) + (numFirst * pInst->ItemLen),
+						 (numPushed - numFirst) * pInst->ItemLen);
+		}
+	}
+
+	if (pInst->IsSpsc)
+	{
+		LibAtomic_Store(&pInst->TailIdx, tailIdx + numPushed);
+		LIBFIFO_STATS_PUSH(pInst, numPushed, numItems - numPushed, count + numPushed);
+	}
+	else
+	{
+		if (0U != numPushed)
+		{
+			// the tail is the last valid element
+			pos += numPushed - 1U;
+
+			if (pos >= pInst->NumMaxItems)
+			{
+				pos -= pInst->NumMaxItems;
+			}
+			pInst->TailIdx = pos;
+			pInst->Count += numPushed;
+		}
+		LIBFIFO_STATS_PUSH(pInst, numPushed, numItems - numPushed, pInst->Count);
+		LIBFIFO_UNLOCK(pInst);
+	}
+	LIBFIFO_STATS_REGISTER(pInst);
+
+	return numPushed;
+}
+
+// ====================================================================================================================
+// LibFifoQueue_GetSpans:
+// ====================================================================================================================
+uint32_t LibFifoQueue_GetSpans(const S_LibFifoQueue_Inst_t* const pInst, S_LibFifoQueue_Span_t* const pSpans)
+{
+	uint32_t count;
+	uint32_t pos;
+
+	Lib_Assert((NULL != pInst) && (NULL != pInst->pFifoMem) && (NULL != pSpans));
+
+	if (pInst->IsSpsc)
+	{
+		const uint32_t headIdx = pInst->HeadIdx;
+		count = LibAtomic_Load(&pInst->TailIdx) - headIdx;
+		pos = headIdx & (pInst->NumMaxItems - 1U);
+	}
+	else
+	{
+		LIBFIFO_LOCK(pInst);
+		count = pInst->Count;
+		pos = pInst->HeadIdx;
+		LIBFIFO_UNLOCK(pInst);
+	}
+
+	// the first span ends at the end of the buffer, the second one continues at its start
+	pSpans[0].NumItems = ((pInst->NumMaxItems - pos) < count) ? (pInst->NumMaxItems - pos) : count;
+	pSpans[1].NumItems = count - pSpans[0].NumItems;
+	//lint -e{9087, 9016} Cast is ok, pointer arithmetic checked
+	pSpans[0].pItems =
+		(0U != pSpans[0].NumItems) ? (((uint8_t*)(void*)pInst->pFifoMem) + (pos * pInst->ItemLen)) : NULL;
+	pSpans[1].pItems = (0U != pSpans[1].NumItems) ? (void*)pInst->pFifoMem : NULL;
+
+	return count;
+}
+
+// ====================================================================================================================
+// LibFifoQueue_PopN:
+// ====================================================================================================================
+void LibFifoQueue_PopN(S_LibFifoQueue_Inst_t* const pInst, const uint32_t numItems)
+{
+	Lib_Assert(NULL != pInst);
+
+	if (pInst->IsSpsc)
+	{
+		const uint32_t headIdx = pInst->HeadIdx;
+		const uint32_t count = LibAtomic_Load(&pInst->TailIdx) - headIdx;
+
+		// release the slots: all reads of the items are done before the producer sees the new head index
+		LibAtomic_Store(&pInst->HeadIdx, headIdx + ((numItems < count) ? numItems : count));
+	}
+	else
+	{
+		LIBFIFO_LOCK(pInst);
+		if (numItems >= pInst->Count)
+		{
+			// the queue becomes empty: the head stays at the last element, see LibFifoQueue_Pop()
+			pInst->HeadIdx = pInst->TailIdx;
+			pInst->Count = 0U;
+		}
+		else
+		{
+			pInst->HeadIdx += numItems;
+
+			if (pInst->HeadIdx >= pInst->NumMaxItems)
+			{
+				pInst->HeadIdx -= pInst->NumMaxItems;
+			}
+			pInst->Count -= numItems;
+		}
+		LIBFIFO_UNLOCK(pInst);
+	}
+}
+
+// ====================================================================================================================
+// LibFifoQueue_SpscInit:
+// ====================================================================================================================
+static void LibFifoQueue_SpscInit(S_LibFifoQueue_Inst_t* const pInst, const uint32_t headIdx, const uint32_t count)
+{
+	// the mask arithmetic requires a power of two, items cannot be overwritten or coalesced by the producer while the
+	// consumer accesses them in place
+	Lib_Assert((0U == (pInst->NumMaxItems & (pInst->NumMaxItems - 1U))) && (!pInst->OverwriteItems) &&
+			   (NULL == pInst->pfIsSameItem));
+
+	pInst->HeadIdx = headIdx;
+	pInst->Count = 0U;
+	LibAtomic_Store(&pInst->TailIdx, headIdx + count);
+}
+
+// ====================================================================================================================
+// LibFifoQueue_SpscPush:
+// ====================================================================================================================
+static bool_t LibFifoQueue_SpscPush(S_LibFifoQueue_Inst_t* const pInst, const void* const pItem)
+{
+	bool_t ret = false;
+	// the tail index is written by the producer only, the head index is acquired so that the consumer has finished
+	// reading the slot which is reused
+	const uint32_t tailIdx = pInst->TailIdx;
+	const uint32_t headIdx = LibAtomic_Load(&pInst->HeadIdx);
+
+	if ((tailIdx - headIdx) < pInst->NumMaxItems)
+	{
+		(void)memcpy(LIBFIFO_SPSC_ITEM(pInst, tailIdx), pItem, pInst->ItemLen);
+
+		// publish the item: the copy is visible to the consumer before the new tail index
+		LibAtomic_Store(&pInst->TailIdx, tailIdx + 1U);
+		ret = true;
+	}
+	LIBFIFO_STATS_PUSH(pInst, ret ? 1U : 0U, ret ? 0U : 1U, (tailIdx - headIdx) + (ret ? 1U : 0U));
+
+	return ret;
+}
+
+// ====================================================================================================================
+// LibFifoQueue_SpscPop:
+// ====================================================================================================================
+static void LibFifoQueue_SpscPop(S_LibFifoQueue_Inst_t* const pInst)
+{
+	const uint32_t headIdx = pInst->HeadIdx;
+
+	if (LibAtomic_Load(&pInst->TailIdx) != headIdx)
+	{
+		// release the slot: all reads of the item are done before the producer sees the new head index
+		LibAtomic_Store(&pInst->HeadIdx, headIdx + 1U);
+	}
+}
+
+// ====================================================================================================================
+// LibFifoQueue_SpscGetItem:
+// ====================================================================================================================
+static void* LibFifoQueue_SpscGetItem(const S_LibFifoQueue_Inst_t* const pInst, const uint32_t itemIndex)
+{
+	void* pRet = NULL;
+	const uint32_t headIdx = pInst->HeadIdx;
+
+	// the acquired tail index makes all items up to it visible
+	if (itemIndex < (LibAtomic_Load(&pInst->TailIdx) - headIdx))
+	{
+		pRet = LIBFIFO_SPSC_ITEM(pInst, headIdx + itemIndex);
+	}
+
+	return pRet;
+}
+
+// ====================================================================================================================
+// LibFifoQueue_Coalesce:
+// ====================================================================================================================
+static bool_t LibFifoQueue_Coalesce(S_LibFifoQueue_Inst_t* const pInst, const void* const pItem)
+{
+	bool_t ret = false;
+	uint32_t pos = pInst->TailIdx;
+
+	// search from the newest item backwards, so the replaced item keeps its order to the items queued before it
+	for (uint32_t i = 0U; (i < pInst->Count) && (!ret); i++)
+	{
+		//lint -e{9087, 9016} Cast is ok, pointer arithmetic checked
+		uint8_t* const pQueued = ((uint8_t*)(void*)pInst->pFifoMem) + (pos * pInst->ItemLen);
+
+		if (pInst->pfIsSameItem(pQueued, pItem))
+		{
+			(void)memcpy(pQueued, pItem, pInst->ItemLen);
+			ret = true;
+		}
+		pos = (0U == pos) ? (pInst->NumMaxItems - 1U) : (pos - 1U);
+	}
+
+	return ret;
+}
+
+#ifdef LIBFIFOQUEUECFG_STATISTICS
+// ====================================================================================================================
+// LibFifoQueue_RecordPush:
+// ====================================================================================================================
+void LibFifoQueue_RecordPush(S_LibFifoQueue_Stats_t* const pStats, const uint32_t numPushed, const uint32_t numFailed,
+							 const uint32_t count)
+{
+	pStats->NumPushed += numPushed;
+	pStats->NumPushFailed += numFailed;
+
+	if (count > pStats->HighWatermark)
+	{
+		pStats->HighWatermark = count;
+	}
+}
+
+// ====================================================================================================================
+// LibFifoQueue_RegisterStats:
+// ====================================================================================================================
+void LibFifoQueue_RegisterStats(S_LibFifoQueue_Stats_t* const pStats, const char* const pName,
+								const uint32_t numMaxItems)
+{
+	if (!pStats->IsRegistered)
+	{
+		SuspendAllInterrupts();
+		// check again, an interrupting context may have registered the queue in the meantime
+		if (!pStats->IsRegistered)
+		{
+			pStats->pName = pName;
+			pStats->NumMaxItems = numMaxItems;
+			pStats->pNext = LibFifoQueue_pFirstStats;
+			pStats->IsRegistered = true;
+			// publish the completely linked statistics to readers in other contexts
+			LibAtomic_Store(&LibFifoQueue_pFirstStats, pStats);
+		}
+		ResumeAllInterrupts();
+	}
+}
+
+// ====================================================================================================================
+// LibFifoQueue_GetFirstStats:
+// ====================================================================================================================
+const S_LibFifoQueue_Stats_t* LibFifoQueue_GetFirstStats(void)
+{
+	return LibAtomic_Load(&LibFifoQueue_pFirstStats);
+}
+#endif // LIBFIFOQUEUECFG_STATISTICS
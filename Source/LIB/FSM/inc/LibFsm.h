@@ -24,6 +24,10 @@
 #include "LibFsmInternals.h"
 #include "LibFsmCfg.h"
 
+#if defined(LIBFSMCFG_DEBUG) && defined(LIBFMSCFG_USE_NAME_DECODING) && !defined(LIBFSMCFG_NAME_TABLES)
+#define LIBFSMCFG_NAME_TABLES
+#endif
+
 
 // --------------------------------------------------------------------------------------------------------------------
 //	Global Definitions
@@ -32,14 +36,21 @@
 //lint -estring(123,*_FSM_EVENTS)
 //lint -estring(123,*_FSM_STATES)
 
-#ifdef LIBFSMCFG_DEBUG
+#ifdef LIBFSMCFG_TRACE
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief New state recorded in the trace for an event without transition in the current state.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBFSM_TRACE_UNHANDLED				UINT8_C(0xFF)
+#endif
+
+#ifdef LIBFSMCFG_NAME_TABLES
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief Define string from state name. Use to print state name in debug messages.
 ///
 /// \param name
 /// State name.
 // --------------------------------------------------------------------------------------------------------------------
-#define LIBFSM_EXPAND_STATES_NAME_DEF(name, ...) static const char_t stateName_##name[] = #name;
+#define LIBFSM_EXPAND_STATES_NAME_DEF(name, ...) static const char stateName_##name[] = #name;
 
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief Get string name which contain state name from states table.
@@ -55,7 +66,7 @@
 /// \param name
 /// Event name.
 // --------------------------------------------------------------------------------------------------------------------
-#define LIBFSM_EXPAND_EVENTS_NAME_DEF(name, ...) static const char_t eventName_##name[] = #name;
+#define LIBFSM_EXPAND_EVENTS_NAME_DEF(name, ...) static const char eventName_##name[] = #name;
 
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief Get string name which contain event name from events table.
@@ -254,6 +265,11 @@ LIBFSM_DECLARE_STATES_ENUM(NAME,STATES)
 ///
 /// Xxx_GetLastEvent(void)					- returns last event dispatched to the state machine
 ///
+/// Xxx_PostEvent(E_Xxx_Event_t event)		- queues the event without processing it, e.g. from an ISR
+///											  (only with LIBFSMCFG_EVENT_QUEUE)
+///
+/// Xxx_ProcessEvents(void)					- processes the queued events (only with LIBFSMCFG_EVENT_QUEUE)
+///
 /// Xxx_Empty(void)							- method to be used for states without run handler and transitions without handler
 ///											  (shall be used instead NULL in the transition and states configurations macros in case
 ///											  there is no specific handler). Deprecated, instead of it use LibFsm_Empty.
@@ -371,15 +387,15 @@ LIBFSM_DECLARE_STATE_MACHINE_EX(NAME, NAME, STATES, USER_DATA, EVENTS)
 /// \param USER_DATA pointer to the user data
 /// \param EVENTS X-macro list of events definitions
 // --------------------------------------------------------------------------------------------------------------------
-#if defined(LIBFSMCFG_DEBUG) && defined(LIBFMSCFG_USE_NAME_DECODING)
+#ifdef LIBFSMCFG_NAME_TABLES
 #define LIBFSM_EXPAND_NAMES(NAME, PARENT_STATE_MACHINE_NAME, STATES, USER_DATA, EVENTS)\
 STATES(LIBFSM_EXPAND_STATES_NAME_DEF)\
-static const char_t* const NAME##StateNames[NAME##_ST_NUM]=\
+static const char* const NAME##StateNames[NAME##_ST_NUM]=\
 {\
 	STATES(LIBFSM_EXPAND_STATE_NAME)\
 };\
 EVENTS(LIBFSM_EXPAND_EVENTS_NAME_DEF)\
-static const char_t* const NAME##EventNames[]=\
+static const char* const NAME##EventNames[]=\
 {\
 	EVENTS(LIBFSM_EXPAND_EVENT_NAME)\
 };
@@ -395,9 +411,10 @@ static const char_t* const NAME##EventNames[]=\
 /// \param STATES X-macro list of states definitions with corresponding states handlers
 /// \param USER_DATA pointer to the user data
 /// \param EVENTS X-macro list of events definitions
+/// \param IS_DENSE true if the transition tables are generated by LIBFSM_DECLARE_DENSE_TRDESC_TABS
 // --------------------------------------------------------------------------------------------------------------------
-#if defined(LIBFSMCFG_DEBUG) && defined(LIBFMSCFG_USE_NAME_DECODING)
-#define LIBFSM_INIT_FSM_CONST_STRUCT(NAME, PARENT_STATE_MACHINE_NAME, STATES, USER_DATA, EVENTS)\
+#ifdef LIBFSMCFG_NAME_TABLES
+#define LIBFSM_INIT_FSM_CONST_STRUCT(NAME, PARENT_STATE_MACHINE_NAME, STATES, USER_DATA, EVENTS, IS_DENSE)\
 static const S_LibFsm_Consts_t NAME##_FsmConsts =\
 {\
 	.pStateNames			= NAME##StateNames,\
@@ -405,16 +422,18 @@ static const S_LibFsm_Consts_t NAME##_FsmConsts =\
 	.pStatesTrDesc			= NAME##_Stt,\
 	.pStateFunc				= NAME##_StateHndl,\
 	.StatesNum				= (uint8_t)NAME##_ST_NUM,\
-	.EvNum					= (uint8_t)PARENT_STATE_MACHINE_NAME##_EV_NUM\
+	.EvNum					= (uint8_t)PARENT_STATE_MACHINE_NAME##_EV_NUM,\
+	.IsDense				= IS_DENSE\
 };
 #else
-#define LIBFSM_INIT_FSM_CONST_STRUCT(NAME, PARENT_STATE_MACHINE_NAME, STATES, USER_DATA, EVENTS)\
+#define LIBFSM_INIT_FSM_CONST_STRUCT(NAME, PARENT_STATE_MACHINE_NAME, STATES, USER_DATA, EVENTS, IS_DENSE)\
 static const S_LibFsm_Consts_t NAME##_FsmConsts =\
 {\
 	.pStatesTrDesc			= NAME##_Stt,\
 	.pStateFunc				= NAME##_StateHndl,\
 	.StatesNum				= (uint8_t)NAME##_ST_NUM,\
-	.EvNum					= (uint8_t)PARENT_STATE_MACHINE_NAME##_EV_NUM\
+	.EvNum					= (uint8_t)PARENT_STATE_MACHINE_NAME##_EV_NUM,\
+	.IsDense				= IS_DENSE\
 };
 #endif
 
@@ -439,6 +458,7 @@ S_LibFsm_t NAME##_Fsm =\
 	.pUserData		= USER_DATA,\
 	.pConsts		= &NAME##_FsmConsts,\
 	.DebugLevel		= LIBFSM_DEBUGLEVEL_DISABLED\
+	LIBFSM_INIT_TRACE_MEMBERS(NAME)\
 };
 #else
 #define LIBFSM_INIT_FSM_INST_STRUCT(NAME, PARENT_STATE_MACHINE_NAME, STATES, USER_DATA, EVENTS)\
@@ -451,9 +471,54 @@ S_LibFsm_t NAME##_Fsm = \
 	.IsReentered	= FALSE,\
 	.pUserData		= USER_DATA,\
 	.pConsts		= &NAME##_FsmConsts\
+	LIBFSM_INIT_TRACE_MEMBERS(NAME)\
 };
 #endif
 
+#ifdef LIBFSMCFG_TRACE
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Define the time in state statistics of the FSM instance, one entry per state.
+///
+/// \param NAME prefix for the state machine instances
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBFSM_DECLARE_TRACE_VARS(NAME)\
+static S_LibFsm_StateStats_t NAME##_StateStats[NAME##_ST_NUM];
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Initialize the trace members of the FSM instance structure.
+///
+/// \param NAME prefix for the state machine instances
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBFSM_INIT_TRACE_MEMBERS(NAME)		, .pStateStats = NAME##_StateStats
+#else
+#define LIBFSM_DECLARE_TRACE_VARS(NAME)
+#define LIBFSM_INIT_TRACE_MEMBERS(NAME)
+#endif
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Define the functions to post events to the queue of the FSM instance and to process the queued events.
+///
+/// \param NAME prefix for the state machine instances
+/// \param PARENT_STATE_MACHINE_NAME the name of state machine which events will be used
+// --------------------------------------------------------------------------------------------------------------------
+#ifdef LIBFSMCFG_EVENT_QUEUE
+#define LIBFSM_DECLARE_EVENT_QUEUE_FUNCS(NAME, PARENT_STATE_MACHINE_NAME)\
+/*lint -e{830,957}*/\
+bool_t NAME##_PostEvent(E_##PARENT_STATE_MACHINE_NAME##_Event_t ev);\
+bool_t NAME##_PostEvent(E_##PARENT_STATE_MACHINE_NAME##_Event_t ev)\
+{\
+	return LibFsm_PostEvent(&NAME##_Fsm,(uint8_t)ev);\
+}\
+/*lint -e{830,957}*/\
+void NAME##_ProcessEvents(void);\
+void NAME##_ProcessEvents(void)\
+{\
+	LibFsm_ProcessEvents(&NAME##_Fsm);\
+}
+#else
+#define LIBFSM_DECLARE_EVENT_QUEUE_FUNCS(NAME, PARENT_STATE_MACHINE_NAME)
+#endif
+
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief  Macro for the declaration of the finite state machine structure / functions within *.c files and reusage
 /// of already defined event enumeration e.g. from another state machine
@@ -476,6 +541,11 @@ S_LibFsm_t NAME##_Fsm = \
 ///
 /// Xxx_GetLastEvent(void)					- returns last event dispatched to the state machine
 ///
+/// Xxx_PostEvent(E_Xxx_Event_t event)		- queues the event without processing it, e.g. from an ISR
+///											  (only with LIBFSMCFG_EVENT_QUEUE)
+///
+/// Xxx_ProcessEvents(void)					- processes the queued events (only with LIBFSMCFG_EVENT_QUEUE)
+///
 /// Xxx_Empty(void)							- method to be used for states without run handler and transitions without handler
 ///											  (shall be used instead NULL in the transition and states configurations macros in case
 ///											  there is no specific handler). Deprecated, instead of it use LibFsm_Empty.
@@ -584,6 +654,44 @@ S_LibFsm_t NAME##_Fsm = \
 // --------------------------------------------------------------------------------------------------------------------
 //lint --emacro({123}, LIBFSM_DECLARE_STATE_MACHINE_EX)
 #define LIBFSM_DECLARE_STATE_MACHINE_EX(NAME, PARENT_STATE_MACHINE_NAME, STATES, USER_DATA, EVENTS)\
+LIBFSM_DECLARE_STATE_MACHINE_TABS_EX(NAME, PARENT_STATE_MACHINE_NAME, STATES, USER_DATA, EVENTS,\
+	LIBFSM_DECLARE_TRDESC_TABS, false)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief  Same as LIBFSM_DECLARE_STATE_MACHINE_EX but with dense transition tables indexed by [state][event]
+///
+/// The transition of the current state for an event is found by indexing instead of searching the transitions list of
+/// the state, so the dispatch time does not depend on the number of transitions. Each state costs one transition
+/// descriptor for every event up to its highest handled event, use LIBFSM_DECLARE_STATE_MACHINE_EX for state machines
+/// with many events and few transitions per state where flash is short.
+/// \attention Each event may be used only once within a TRANSITIONS_FOR_STATE_xxx list.
+///
+/// \param NAME prefix for the state machine instances
+/// \param PARENT_STATE_MACHINE_NAME the name of state machine which events will be used
+/// \param STATES X-macro list of states definitions with corresponding states handlers
+/// \param USER_DATA pointer to the user data
+/// \param EVENTS X-macro list of events definitions
+// --------------------------------------------------------------------------------------------------------------------
+//lint --emacro({123}, LIBFSM_DECLARE_DENSE_STATE_MACHINE_EX)
+#define LIBFSM_DECLARE_DENSE_STATE_MACHINE_EX(NAME, PARENT_STATE_MACHINE_NAME, STATES, USER_DATA, EVENTS)\
+LIBFSM_DECLARE_STATE_MACHINE_TABS_EX(NAME, PARENT_STATE_MACHINE_NAME, STATES, USER_DATA, EVENTS,\
+	LIBFSM_DECLARE_DENSE_TRDESC_TABS, true)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief  Common part of LIBFSM_DECLARE_STATE_MACHINE_EX and LIBFSM_DECLARE_DENSE_STATE_MACHINE_EX
+///
+/// \param NAME prefix for the state machine instances
+/// \param PARENT_STATE_MACHINE_NAME the name of state machine which events will be used
+/// \param STATES X-macro list of states definitions with corresponding states handlers
+/// \param USER_DATA pointer to the user data
+/// \param EVENTS X-macro list of events definitions
+/// \param DECLARE_TABS X-macro generating the transitions table of one state (LIBFSM_DECLARE_TRDESC_TABS or
+/// LIBFSM_DECLARE_DENSE_TRDESC_TABS)
+/// \param IS_DENSE true if DECLARE_TABS is LIBFSM_DECLARE_DENSE_TRDESC_TABS
+// --------------------------------------------------------------------------------------------------------------------
+//lint --emacro({123}, LIBFSM_DECLARE_STATE_MACHINE_TABS_EX)
+#define LIBFSM_DECLARE_STATE_MACHINE_TABS_EX(NAME, PARENT_STATE_MACHINE_NAME, STATES, USER_DATA, EVENTS, DECLARE_TABS,\
+	IS_DENSE)\
 STATES(LIBFSM_EXPAND_STATE_TO_ENTRY_FUNC_DEC)\
 STATES(LIBFSM_EXPAND_STATE_TO_EXIT_FUNC_DEC)\
 STATES(LIBFSM_EXPAND_STATE_TO_FUNC_DEC)\
@@ -591,19 +699,22 @@ static const S_LibFsm_StateFunc_t NAME##_StateHndl[NAME##_ST_NUM]=\
 {\
 	STATES(LIBFSM_EXPAND_STATE_FUNCS)\
 };\
-STATES(LIBFSM_DECLARE_TRDESC_TABS)\
+STATES(DECLARE_TABS)\
 static const S_LibFsm_StateTrDesc_t NAME##_Stt[NAME##_ST_NUM]=\
 {\
 	STATES(LIBFSM_EXPAND_TO_STT_INIT)\
 };\
 LIBFSM_EXPAND_NAMES(NAME, PARENT_STATE_MACHINE_NAME, STATES, USER_DATA, EVENTS)\
-LIBFSM_INIT_FSM_CONST_STRUCT(NAME, PARENT_STATE_MACHINE_NAME, STATES, USER_DATA, EVENTS)\
+LIBFSM_INIT_FSM_CONST_STRUCT(NAME, PARENT_STATE_MACHINE_NAME, STATES, USER_DATA, EVENTS, IS_DENSE)\
+LIBFSM_DECLARE_TRACE_VARS(NAME)\
 LIBFSM_INIT_FSM_INST_STRUCT(NAME, PARENT_STATE_MACHINE_NAME, STATES, USER_DATA, EVENTS)\
-/*lint -esym(528, *_DispatchEvent)*/\
-static void NAME##_DispatchEvent(E_##PARENT_STATE_MACHINE_NAME##_Event_t ev)\
+/*lint -e{830,957}*/\
+bool_t NAME##_DispatchEvent(E_##PARENT_STATE_MACHINE_NAME##_Event_t ev);\
+bool_t NAME##_DispatchEvent(E_##PARENT_STATE_MACHINE_NAME##_Event_t ev)\
 {\
-	LibFsm_DispatchEvent(&NAME##_Fsm,(uint8_t)ev);\
+	return LibFsm_DispatchEvent(&NAME##_Fsm,(uint8_t)ev);\
 }\
+LIBFSM_DECLARE_EVENT_QUEUE_FUNCS(NAME, PARENT_STATE_MACHINE_NAME)\
 /*lint -e{830,957}*/\
 void NAME##_RunCurrentState(void);\
 void NAME##_RunCurrentState(void)\
@@ -632,8 +743,8 @@ E_##PARENT_STATE_MACHINE_NAME##_Event_t NAME##_GetLastEvent(void)\
 	return (E_##PARENT_STATE_MACHINE_NAME##_Event_t)LibFsm_GetLastEvent(&NAME##_Fsm);\
 }\
 /*lint -e{715,818,830,957}*/\
-/*lint -esym(528, *_Empty)*/\
-static void NAME##_Empty(void* pData){}
+void NAME##_Empty(void* pData);\
+void NAME##_Empty(void* pData){}
 
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief  Macro for declaration of the finite state machine within *.c files
@@ -656,6 +767,11 @@ static void NAME##_Empty(void* pData){}
 ///
 /// Xxx_GetLastEvent(void)					- returns last event dispatched to the state machine
 ///
+/// Xxx_PostEvent(E_Xxx_Event_t event)		- queues the event without processing it, e.g. from an ISR
+///											  (only with LIBFSMCFG_EVENT_QUEUE)
+///
+/// Xxx_ProcessEvents(void)					- processes the queued events (only with LIBFSMCFG_EVENT_QUEUE)
+///
 /// Xxx_Empty(void)							- method to be used for states without run handler and transitions without handler
 ///											  (shall be used instead NULL in the transition and states configurations macros in case
 ///											  there is no specific handler). Deprecated, instead of it use LibFsm_Empty.
@@ -755,6 +871,21 @@ static void NAME##_Empty(void* pData){}
 	LIBFSM_DECLARE_STATE_MACHINE_ENUMS(NAME,EVENTS,STATES)\
 	LIBFSM_DECLARE_STATE_MACHINE_STRUCTURE(NAME,EVENTS,STATES,USER_DATA)
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief  Macro for declaration of the finite state machine with dense transition tables within *.c files
+/// Same usage and generated interfaces as LIBFSM_DECLARE_STATE_MACHINE, the events are dispatched in constant time.
+/// \sa LIBFSM_DECLARE_DENSE_STATE_MACHINE_EX
+///
+/// \param NAME prefix for the state machine instances
+/// \param EVENTS X-macro list of events definitions
+/// \param STATES X-macro list of states definitions with corresponding states handlers
+/// \param USER_DATA Pointer to the user data
+// --------------------------------------------------------------------------------------------------------------------
+//lint --emacro({123}, LIBFSM_DECLARE_DENSE_STATE_MACHINE)
+#define LIBFSM_DECLARE_DENSE_STATE_MACHINE(NAME,EVENTS,STATES,USER_DATA)\
+	LIBFSM_DECLARE_STATE_MACHINE_ENUMS(NAME,EVENTS,STATES)\
+	LIBFSM_DECLARE_DENSE_STATE_MACHINE_EX(NAME,NAME,STATES,USER_DATA,EVENTS)
+
 // --------------------------------------------------------------------------------------------------------------------
 //	Global Data Types
 // --------------------------------------------------------------------------------------------------------------------
@@ -799,7 +930,7 @@ typedef struct
 // --------------------------------------------------------------------------------------------------------------------
 typedef struct
 {
-	uint8_t	 					NumOfTransitions;	//!< number of defined transitions
+	uint8_t	 					NumOfTransitions;	//!< number of defined transitions (dense: number of table entries)
 	const S_LibFsm_TrDesc_t*	pTrTab;				//!< pointer to the table with transitions descriptions
 } S_LibFsm_StateTrDesc_t;
 
@@ -818,16 +949,42 @@ typedef struct
 // --------------------------------------------------------------------------------------------------------------------
 typedef struct
 {
-#if defined(LIBFSMCFG_DEBUG) && defined(LIBFMSCFG_USE_NAME_DECODING)
-	const char_t* const* const		pStateNames;	//!< pointer to the table which contains state names
-	const char_t* const* const		pEventNames;	//!< pointer to the table which contains event names
+#ifdef LIBFSMCFG_NAME_TABLES
+	const char* const* const		pStateNames;	//!< pointer to the table which contains state names
+	const char* const* const		pEventNames;	//!< pointer to the table which contains event names
 #endif
 	const S_LibFsm_StateTrDesc_t* 	pStatesTrDesc;	//!< pointer to the states transitions description table
 	const S_LibFsm_StateFunc_t*		pStateFunc;		//!< pointer to the table which contains the state handlers
 	uint8_t							StatesNum;		//!< number of states in this instance
 	uint8_t							EvNum;			//!< number of events in this instance
+	bool_t							IsDense;		//!< transition tables are indexed by the event
 } S_LibFsm_Consts_t;
 
+#ifdef LIBFSMCFG_TRACE
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Entry of the trace ring, one per dispatched event
+// --------------------------------------------------------------------------------------------------------------------
+typedef struct
+{
+	uint32_t	Timestamp;		//!< time of the dispatch, see LibCycleClock_Get()
+	uint8_t		FsmId;			//!< trace id of the FSM instance, see LibFsm_GetTracedFsm()
+	uint8_t		OldState;		//!< state before the event
+	uint8_t		Event;			//!< dispatched event
+	uint8_t		NewState;		//!< state after the event or LIBFSM_TRACE_UNHANDLED if the event was not handled
+} S_LibFsm_TraceEntry_t;
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Time in state statistics of one state, in units of LibCycleClock_Get()
+/// The time of a stay is taken when the state is left, stays longer than the wrap of the clock are not reliable.
+// --------------------------------------------------------------------------------------------------------------------
+typedef struct
+{
+	uint32_t	NumLeft;		//!< number of completed stays in the state
+	uint32_t	MaxTime;		//!< longest stay in the state
+	uint64_t	TotalTime;		//!< accumulated time in the state (average = TotalTime / NumLeft)
+} S_LibFsm_StateStats_t;
+#endif // LIBFSMCFG_TRACE
+
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief Contains all information about single instance of the state machine
 // --------------------------------------------------------------------------------------------------------------------
@@ -846,6 +1003,22 @@ typedef struct
 #ifdef LIBFSMCFG_DEBUG
 	E_LibFsm_DebugLevel_t		DebugLevel;		//!< Level of debug messages
 #endif
+#ifdef LIBFSMCFG_EVENT_QUEUE
+	// -----------------------------------------------------------------------------------------------------------------
+	/// \brief Queue of the pending events
+	/// Each slot holds the event + 1, zero marks a slot which is free or reserved but not yet written by the poster.
+	// -----------------------------------------------------------------------------------------------------------------
+	uint8_t						EvQueue[LIBFSMCFG_EVENT_QUEUE_SIZE];
+	uint8_t						EvQueueHead;	//!< free-running number of processed events, written by the dispatcher
+	uint8_t						EvQueueTail;	//!< free-running number of reserved slots, written by the posters
+	uint8_t						IsDispatching;	//!< the queued events are being processed
+	uint8_t						NumLostEvents;	//!< number of events dropped because the queue was full (saturated)
+#endif
+#ifdef LIBFSMCFG_TRACE
+	S_LibFsm_StateStats_t*		pStateStats;	//!< time in state statistics, one entry per state (NULL: not recorded)
+	uint32_t					StateEnterTime;	//!< time when the current state has been entered
+	uint8_t						TraceId;		//!< id of the instance in the trace, assigned on the first dispatch
+#endif
 } S_LibFsm_t;
 
 //STRUCT_PACK_END
@@ -863,11 +1036,37 @@ typedef struct
 /// \brief Sends event to the state machine possibly causing state transition
 /// In case there is no transition defined for the event and the current state, the event will be ignored and
 /// the state of the FSM will not change
+/// With LIBFSMCFG_EVENT_QUEUE the event is queued and processed together with all other queued events before the
+/// function returns. When called from an entry, exit or transition handler of the same FSM, the event is processed
+/// after the current transition has finished.
 /// \param ev event to trigger the state machine
 /// \param pFsm pointer to the state machine instance structure
+/// \return false if the event queue is full and the event has been dropped (only with LIBFSMCFG_EVENT_QUEUE)
 // --------------------------------------------------------------------------------------------------------------------
 //lint -ecall(641, LibFsm_DispatchEvent) converting enum '' to 'int'
-void LibFsm_DispatchEvent(S_LibFsm_t* const pFsm, const uint8_t ev);
+bool_t LibFsm_DispatchEvent(S_LibFsm_t* const pFsm, const uint8_t ev);
+
+#ifdef LIBFSMCFG_EVENT_QUEUE
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Queues an event without processing it
+/// Lock-free, may be called from interrupt service routines. The event is processed by the next call of
+/// LibFsm_DispatchEvent() or LibFsm_ProcessEvents() in task context.
+///
+/// \param pFsm pointer to the state machine instance structure
+/// \param ev event to trigger the state machine
+/// \return false if the queue is full and the event has been dropped
+// --------------------------------------------------------------------------------------------------------------------
+//lint -ecall(641, LibFsm_PostEvent) converting enum '' to 'int'
+bool_t LibFsm_PostEvent(S_LibFsm_t* const pFsm, const uint8_t ev);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Processes the queued events in the order they have been posted until the queue is empty
+/// Returns immediately if the events are already being processed by an outer call.
+///
+/// \param pFsm pointer to the state machine instance structure
+// --------------------------------------------------------------------------------------------------------------------
+void LibFsm_ProcessEvents(S_LibFsm_t* const pFsm);
+#endif
 
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief Returns current state of the given state machine instance
@@ -933,5 +1132,40 @@ static inline void LibFsm_Empty(void* pData)
 void LibFsm_SetDebugLevel(S_LibFsm_t* const pFsm, const E_LibFsm_DebugLevel_t debugLevel);
 #endif
 
+#ifdef LIBFSMCFG_TRACE
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Returns an entry of the trace ring
+/// \attention An entry may be overwritten while it is read, stop the dispatching for consistent snapshots.
+///
+/// \param age 0 for the latest dispatch, 1 for the one before, ...
+/// \return pointer to the entry or NULL if the entry has not been recorded or is already overwritten
+// --------------------------------------------------------------------------------------------------------------------
+const S_LibFsm_TraceEntry_t* LibFsm_GetTraceEntry(const uint32_t age);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Returns the FSM instance with the given trace id
+///
+/// \param fsmId trace id of the FSM instance, see S_LibFsm_TraceEntry_t
+/// \return pointer to the instance or NULL if the id is unknown
+// --------------------------------------------------------------------------------------------------------------------
+const S_LibFsm_t* LibFsm_GetTracedFsm(const uint8_t fsmId);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Decodes a trace entry into one line of text
+/// The state and event names are taken from the pStateNames / pEventNames tables of the FSM if they are available
+/// (#LIBFSMCFG_NAME_TABLES), otherwise the numbers are written.
+///
+/// \param pEntry trace entry to decode
+/// \param pText buffer for the text
+/// \param maxLen size of the buffer including the terminating zero
+// --------------------------------------------------------------------------------------------------------------------
+void LibFsm_DecodeTraceEntry(const S_LibFsm_TraceEntry_t* const pEntry, char* const pText, const uint32_t maxLen);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Writes the trace ring, oldest entry first, and the time in state statistics of all traced FSMs to the UART
+// --------------------------------------------------------------------------------------------------------------------
+void LibFsm_DumpTrace(void);
+#endif // LIBFSMCFG_TRACE
+
 #endif // LIB_FSM_H__INCLUDED
 
@@ -35,6 +35,52 @@
 // --------------------------------------------------------------------------------------------------------------------
 //#define LIBFMSCFG_USE_NAME_DECODING
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief If this line is defined the names of the states and events are stored in the FSM descriptors, also without
+/// #LIBFSMCFG_DEBUG, so that LibFsm_DecodeTraceEntry() and LibFsm_DumpTrace() write names instead of numbers. Costs
+/// the flash for the name strings, comment it out if the trace is decoded off target. Always defined when
+/// #LIBFSMCFG_DEBUG and #LIBFMSCFG_USE_NAME_DECODING are defined.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBFSMCFG_NAME_TABLES
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief If this line is defined each FSM instance gets a queue of pending events and runs to completion: events
+/// dispatched from the entry, exit, transition handlers are queued and processed after the current transition has
+/// finished, events may be posted from interrupt service routines by LibFsm_PostEvent(). Otherwise events dispatched
+/// from the handlers are processed immediately (nested).
+///
+/// An event posted to a full queue is dropped: LibFsm_DispatchEvent() and LibFsm_PostEvent() return false and the
+/// caller has to repeat the event later. Enable the queue only if all callers of the FSMs handle this and
+/// #LIBFSMCFG_EVENT_QUEUE_SIZE covers the longest chain of events dispatched from the handlers.
+// --------------------------------------------------------------------------------------------------------------------
+//#define LIBFSMCFG_EVENT_QUEUE
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Max. number of pending events per FSM instance, a power of two not greater than 128.
+/// This option is valid only when #LIBFSMCFG_EVENT_QUEUE is defined.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBFSMCFG_EVENT_QUEUE_SIZE			8U
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief If this line is defined each dispatched event is recorded in a binary trace ring (FSM id, old state, event,
+/// new state, timestamp) and the time spent in each state is accumulated per FSM instance. The recording costs a few
+/// stores per dispatch, so it may stay enabled in production. Otherwise comment it out.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBFSMCFG_TRACE
+
+#ifdef LIBFSMCFG_TRACE
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Number of entries of the trace ring shared by all FSM instances, a power of two.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBFSMCFG_TRACE_SIZE				64U
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Max. number of FSM instances which can be mapped from their trace id back to the instance for decoding.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBFSMCFG_TRACE_MAX_FSM				8U
+
+#endif // LIBFSMCFG_TRACE
+
 // --------------------------------------------------------------------------------------------------------------------
 //	Global Data Types
 // --------------------------------------------------------------------------------------------------------------------
@@ -304,6 +304,29 @@ typedef enum\
 TRANSITIONS_FOR_STATE_##state(LIBFSM_EXPAND_TRDESC_TO_TRDEC)\
 static const S_LibFsm_TrDesc_t state##_TrDescTab[]={TRANSITIONS_FOR_STATE_##state(LIBFSM_EXPAND_TRDESC_ENTRY)};
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief  Macro to generate entries of the dense state's transitions tables within FSM
+/// The entry is placed at the index of its event, the entries of not handled events stay zero (pTransition = NULL).
+///
+/// \param event event which causes this transition
+/// \param state new state after this transition
+/// \param trFunc name of the function called during this state transition
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBFSM_EXPAND_TRDESC_DENSE_ENTRY(event,state,trFunc)\
+	[event] = {(uint8_t)event, (uint8_t)state, trFunc},
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief  X-Macro used during generation of the dense transition tables out of the state definition lists.
+/// Same as LIBFSM_DECLARE_TRDESC_TABS but the generated state##_TrDescTab[] is indexed by the event, so the FSM finds
+/// the transition without searching. The table of a state ends with its highest handled event.
+/// \attention Each event may be used only once within the TRANSITIONS_FOR_STATE_xxx list.
+///
+/// \param state enumerator of the state
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBFSM_DECLARE_DENSE_TRDESC_TABS(state,...) \
+TRANSITIONS_FOR_STATE_##state(LIBFSM_EXPAND_TRDESC_TO_TRDEC)\
+static const S_LibFsm_TrDesc_t state##_TrDescTab[]={TRANSITIONS_FOR_STATE_##state(LIBFSM_EXPAND_TRDESC_DENSE_ENTRY)};
+
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief  Macro used to generate initialization content of the S_xxx_Stt[] table of the FSM
 /// The S_xxx_Stt[] table describes all transitions for all states within generated FSM end contains for each
@@ -24,6 +24,25 @@
 //	Local Definitions
 // --------------------------------------------------------------------------------------------------------------------
 
+#ifdef LIBFSMCFG_EVENT_QUEUE
+//lint -esym(751, LibFsm_EvQueueSizeIsPowerOfTwo)
+typedef char LibFsm_EvQueueSizeIsPowerOfTwo[((0U == (LIBFSMCFG_EVENT_QUEUE_SIZE & (LIBFSMCFG_EVENT_QUEUE_SIZE - 1U)))
+	&& (LIBFSMCFG_EVENT_QUEUE_SIZE <= 128U)) ? 1 : -1];
+
+#define LIBFSM_EV_QUEUE_MASK		((uint8_t)(LIBFSMCFG_EVENT_QUEUE_SIZE - 1U))
+#endif
+
+#ifdef LIBFSMCFG_TRACE
+//lint -esym(751, LibFsm_TraceSizeIsPowerOfTwo)
+typedef char LibFsm_TraceSizeIsPowerOfTwo[(0U == (LIBFSMCFG_TRACE_SIZE & (LIBFSMCFG_TRACE_SIZE - 1U))) ? 1 : -1];
+
+#define LIBFSM_TRACE_MASK			(LIBFSMCFG_TRACE_SIZE - 1U)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Max. length of one decoded trace line including the terminating zero
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBFSM_TRACE_TEXT_LEN		128U
+#endif
 
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -42,13 +61,47 @@
 //	Local Variables
 // --------------------------------------------------------------------------------------------------------------------
 
+#ifdef LIBFSMCFG_TRACE
+static S_LibFsm_TraceEntry_t LibFsm_Trace[LIBFSMCFG_TRACE_SIZE];		//!< trace ring shared by all FSM instances
+static uint32_t LibFsm_TraceIdx = 0U;								//!< free-running number of recorded entries
+static uint8_t LibFsm_NumTracedFsm = 0U;								//!< number of assigned trace ids
+static const S_LibFsm_t* LibFsm_pTracedFsm[LIBFSMCFG_TRACE_MAX_FSM];	//!< FSM instances by trace id - 1
+#endif
 
 
 // --------------------------------------------------------------------------------------------------------------------
 //	Local Function Prototypes
 // --------------------------------------------------------------------------------------------------------------------
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Find the transition of the current state for the event
+/// Dense transition tables are indexed by the event, sparse ones are searched.
+///
+/// \param pFsm pointer to the state machine instance structure
+/// \param ev dispatched event
+/// \return pointer to the transition description or NULL if the event is not handled in the current state
+// --------------------------------------------------------------------------------------------------------------------
+static const S_LibFsm_TrDesc_t* LibFsm_FindTransition(const S_LibFsm_t* const pFsm, const uint8_t ev);
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Performs the transition of the current state for the event, if there is any
+///
+/// \param pFsm pointer to the state machine instance structure
+/// \param ev event to trigger the state machine
+// --------------------------------------------------------------------------------------------------------------------
+static void LibFsm_HandleEvent(S_LibFsm_t* const pFsm, const uint8_t ev);
+
+#ifdef LIBFSMCFG_TRACE
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Records the dispatched event in the trace ring and updates the time in state statistics
+/// Has to be called before the transition is performed.
+///
+/// \param pFsm pointer to the state machine instance structure
+/// \param ev dispatched event
+/// \param pTrDesc transition for the event or NULL if the event is not handled in the current state
+// --------------------------------------------------------------------------------------------------------------------
+static void LibFsm_RecordTrace(S_LibFsm_t* const pFsm, const uint8_t ev, const S_LibFsm_TrDesc_t* const pTrDesc);
+#endif
 
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -58,13 +111,92 @@
 //=====================================================================================================================
 // LibFsm_DispatchEvent:
 //=====================================================================================================================
-void LibFsm_DispatchEvent(S_LibFsm_t* const pFsm, const uint8_t ev)
+bool_t LibFsm_DispatchEvent(S_LibFsm_t* const pFsm, const uint8_t ev)
+{
+#ifdef LIBFSMCFG_EVENT_QUEUE
+	const bool_t isPosted = LibFsm_PostEvent(pFsm, ev);
+
+	// Process the queue also if the event has been dropped, so that the caller can repeat it
+	LibFsm_ProcessEvents(pFsm);
+	return isPosted;
+#else
+	LibFsm_HandleEvent(pFsm, ev);
+	return true;
+#endif
+}
+
+#ifdef LIBFSMCFG_EVENT_QUEUE
+//=====================================================================================================================
+// LibFsm_PostEvent:
+//=====================================================================================================================
+bool_t LibFsm_PostEvent(S_LibFsm_t* const pFsm, const uint8_t ev)
 {
-	uint8_t trCnt = 0;
+	uint8_t tailIdx = LibAtomic_Load(&pFsm->EvQueueTail);
+	bool_t isReserved = false;
+
+	// Reserve a slot, on a failed exchange tailIdx is reloaded with the slots reserved meanwhile by interrupting posters
+	while (!isReserved && ((uint8_t)(tailIdx - LibAtomic_Load(&pFsm->EvQueueHead)) < LIBFSMCFG_EVENT_QUEUE_SIZE))
+	{
+		isReserved = LibAtomic_CompareExchange(&pFsm->EvQueueTail, &tailIdx, (uint8_t)(tailIdx + 1U));
+	}
 
+	if (isReserved)
+	{
+		LibAtomic_Store(&pFsm->EvQueue[tailIdx & LIBFSM_EV_QUEUE_MASK], (uint8_t)(ev + 1U));
+	}
+	else
+	{
+		// Diagnostic counter only, an increment may get lost when posters interrupt each other
+		if (pFsm->NumLostEvents < UINT8_MAX)
+		{
+			pFsm->NumLostEvents++;
+		}
+		Lib_Assert(false);
+	}
+
+	return isReserved;
+}
+
+//=====================================================================================================================
+// LibFsm_ProcessEvents:
+//=====================================================================================================================
+void LibFsm_ProcessEvents(S_LibFsm_t* const pFsm)
+{
+	uint8_t isDispatching = FALSE;
+	bool_t isPending = true;
+
+	// Only one context processes the events at a time, the others leave their events in the queue
+	while (isPending && LibAtomic_CompareExchange(&pFsm->IsDispatching, &isDispatching, (uint8_t)TRUE))
+	{
+		uint8_t headIdx = pFsm->EvQueueHead;
+		uint8_t slot = LibAtomic_Load(&pFsm->EvQueue[headIdx & LIBFSM_EV_QUEUE_MASK]);
+
+		// Stop at a free slot or at a slot reserved by a preempted poster, which processes the events by itself
+		while (0U != slot)
+		{
+			LibAtomic_Store(&pFsm->EvQueue[headIdx & LIBFSM_EV_QUEUE_MASK], 0U);
+			headIdx++;
+			LibAtomic_Store(&pFsm->EvQueueHead, headIdx);
+			LibFsm_HandleEvent(pFsm, (uint8_t)(slot - 1U));
+			slot = LibAtomic_Load(&pFsm->EvQueue[headIdx & LIBFSM_EV_QUEUE_MASK]);
+		}
+
+		LibAtomic_Store(&pFsm->IsDispatching, (uint8_t)FALSE);
+
+		// An event may have been posted after the last check and before the release
+		isDispatching = FALSE;
+		isPending = (0U != LibAtomic_Load(&pFsm->EvQueue[headIdx & LIBFSM_EV_QUEUE_MASK]));
+	}
+}
+#endif
+
+//=====================================================================================================================
+// LibFsm_HandleEvent:
+//=====================================================================================================================
+static void LibFsm_HandleEvent(S_LibFsm_t* const pFsm, const uint8_t ev)
+{
 	//Lib_Assert(pFsm->CurrentState < pFsm->pConsts->StatesNum);
 	//Lib_Assert(ev < pFsm->pConsts->EvNum);
-	const S_LibFsm_StateTrDesc_t* const pCurStateTr = &pFsm->pConsts->pStatesTrDesc[pFsm->CurrentState];
 
 	if (pFsm->IsReentered)
 	{
@@ -72,51 +204,49 @@ void LibFsm_DispatchEvent(S_LibFsm_t* const pFsm, const uint8_t ev)
 		pFsm->IsReentered = FALSE;
 	}
 
-	for (;trCnt < pCurStateTr->NumOfTransitions; trCnt++)
+	const S_LibFsm_TrDesc_t* const pTrDesc = LibFsm_FindTransition(pFsm, ev);
+#ifdef LIBFSMCFG_TRACE
+	LibFsm_RecordTrace(pFsm, ev, pTrDesc);
+#endif
+	if (NULL != pTrDesc)
 	{
-		const S_LibFsm_TrDesc_t* const pTrDesc = &pCurStateTr->pTrTab[trCnt];
-		if (pTrDesc->Event == ev)
-		{
-			pFsm->LastState = pFsm->CurrentState;
-			pFsm->CurrentState = pTrDesc->NewState;
-			pFsm->LastEvent = ev;
+		pFsm->LastState = pFsm->CurrentState;
+		pFsm->CurrentState = pTrDesc->NewState;
+		pFsm->LastEvent = ev;
 
 #ifdef LIBFSMCFG_DEBUG
-			if (LIBFSM_DEBUGLEVEL_ALL == pFsm->DebugLevel)
-			{
+		if (LIBFSM_DEBUGLEVEL_ALL == pFsm->DebugLevel)
+		{
 #ifdef LIBFMSCFG_USE_NAME_DECODING
-				LibLog_Info("State transition from %s to %s by event %s", strlen(pFsm->pConsts->pStateNames[pFsm->LastState]), pFsm->pConsts->pStateNames[pFsm->LastState], strlen(pFsm->pConsts->pStateNames[pFsm->CurrentState]), pFsm->pConsts->pStateNames[pFsm->CurrentState], strlen(pFsm->pConsts->pEventNames[ev]), pFsm->pConsts->pEventNames[ev]);
+			LibLog_Info("State transition from %s to %s by event %s", strlen(pFsm->pConsts->pStateNames[pFsm->LastState]), pFsm->pConsts->pStateNames[pFsm->LastState], strlen(pFsm->pConsts->pStateNames[pFsm->CurrentState]), pFsm->pConsts->pStateNames[pFsm->CurrentState], strlen(pFsm->pConsts->pEventNames[ev]), pFsm->pConsts->pEventNames[ev]);
 #else
-				LibLog_Info("State transition from %d to %d by event %d", pFsm->LastState, pFsm->CurrentState, ev);
+			LibLog_Info("State transition from %d to %d by event %d", pFsm->LastState, pFsm->CurrentState, ev);
 #endif // LIBFMSCFG_USE_NAME_DECODING
-			}
+		}
 #endif // LIBFSMCFG_DEBUG
 
-			// In case that state is not changed by event, no state entry and exit function will be called.
-			if (pFsm->LastState != pFsm->CurrentState)
-			{
-				// If transition function dispatch event, which cause the state change. IsReentered flag catches
-				// this situation and runs entry function of the state before it is changed once again.
-				pFsm->IsReentered = TRUE;
-				pFsm->pConsts->pStateFunc[pFsm->LastState].Exit(pFsm->pUserData);
-				(*pTrDesc->pTransition)(pFsm->pUserData);
-				if (pFsm->IsReentered)
-				{
-					pFsm->IsReentered = FALSE;
-					pFsm->pConsts->pStateFunc[pFsm->CurrentState].Entry(pFsm->pUserData);
-				}
-			}
-			else
+		// In case that state is not changed by event, no state entry and exit function will be called.
+		if (pFsm->LastState != pFsm->CurrentState)
+		{
+			// If transition function dispatch event, which cause the state change. IsReentered flag catches
+			// this situation and runs entry function of the state before it is changed once again.
+			pFsm->IsReentered = TRUE;
+			pFsm->pConsts->pStateFunc[pFsm->LastState].Exit(pFsm->pUserData);
+			(*pTrDesc->pTransition)(pFsm->pUserData);
+			if (pFsm->IsReentered)
 			{
-				(*pTrDesc->pTransition)(pFsm->pUserData);
+				pFsm->IsReentered = FALSE;
+				pFsm->pConsts->pStateFunc[pFsm->CurrentState].Entry(pFsm->pUserData);
 			}
-
-			break;
+		}
+		else
+		{
+			(*pTrDesc->pTransition)(pFsm->pUserData);
 		}
 	}
 
 #ifdef LIBFSMCFG_DEBUG
-	if ((trCnt >= pCurStateTr->NumOfTransitions) && (pFsm->DebugLevel != LIBFSM_DEBUGLEVEL_DISABLED))
+	if ((NULL == pTrDesc) && (pFsm->DebugLevel != LIBFSM_DEBUGLEVEL_DISABLED))
 	{
 #ifdef LIBFMSCFG_USE_NAME_DECODING
 		LibLog_Warning("Event %s is not handled in the state %s", strlen(pFsm->pConsts->pEventNames[ev]), pFsm->pConsts->pEventNames[ev], strlen(pFsm->pConsts->pStateNames[pFsm->CurrentState]), pFsm->pConsts->pStateNames[pFsm->CurrentState]);
@@ -173,3 +303,186 @@ uint8_t LibFsm_GetLastEvent(const S_LibFsm_t* const pFsm)
 {
 	return pFsm->LastEvent;
 }
+
+//=====================================================================================================================
+// LibFsm_FindTransition:
+//=====================================================================================================================
+static const S_LibFsm_TrDesc_t* LibFsm_FindTransition(const S_LibFsm_t* const pFsm, const uint8_t ev)
+{
+	const S_LibFsm_StateTrDesc_t* const pCurStateTr = &pFsm->pConsts->pStatesTrDesc[pFsm->CurrentState];
+	const S_LibFsm_TrDesc_t* pTrDesc = NULL;
+
+	if (pFsm->pConsts->IsDense)
+	{
+		// Entries of the events not handled in the state are zero initialized
+		if ((ev < pCurStateTr->NumOfTransitions) && (NULL != pCurStateTr->pTrTab[ev].pTransition))
+		{
+			pTrDesc = &pCurStateTr->pTrTab[ev];
+		}
+	}
+	else
+	{
+		for (uint8_t trCnt = 0U; trCnt < pCurStateTr->NumOfTransitions; trCnt++)
+		{
+			if (pCurStateTr->pTrTab[trCnt].Event == ev)
+			{
+				pTrDesc = &pCurStateTr->pTrTab[trCnt];
+				break;
+			}
+		}
+	}
+
+	return pTrDesc;
+}
+
+#ifdef LIBFSMCFG_TRACE
+//=====================================================================================================================
+// LibFsm_GetTraceEntry:
+//=====================================================================================================================
+const S_LibFsm_TraceEntry_t* LibFsm_GetTraceEntry(const uint32_t age)
+{
+	const uint32_t numRecorded = LibAtomic_Load(&LibFsm_TraceIdx);
+	const S_LibFsm_TraceEntry_t* pEntry = NULL;
+
+	if ((age < numRecorded) && (age < LIBFSMCFG_TRACE_SIZE))
+	{
+		pEntry = &LibFsm_Trace[(numRecorded - 1U - age) & LIBFSM_TRACE_MASK];
+	}
+
+	return pEntry;
+}
+
+//=====================================================================================================================
+// LibFsm_GetTracedFsm:
+//=====================================================================================================================
+const S_LibFsm_t* LibFsm_GetTracedFsm(const uint8_t fsmId)
+{
+	const S_LibFsm_t* pFsm = NULL;
+
+	if ((0U != fsmId) && (fsmId <= LIBFSMCFG_TRACE_MAX_FSM))
+	{
+		pFsm = LibAtomic_Load(&LibFsm_pTracedFsm[fsmId - 1U]);
+	}
+
+	return pFsm;
+}
+
+//=====================================================================================================================
+// LibFsm_DecodeTraceEntry:
+//=====================================================================================================================
+void LibFsm_DecodeTraceEntry(const S_LibFsm_TraceEntry_t* const pEntry, char* const pText, const uint32_t maxLen)
+{
+	const bool_t isHandled = (LIBFSM_TRACE_UNHANDLED != pEntry->NewState);
+	const S_LibFsm_t* const pFsm = LibFsm_GetTracedFsm(pEntry->FsmId);
+	bool_t isDecoded = false;
+
+#ifdef LIBFSMCFG_NAME_TABLES
+	if ((NULL != pFsm) && (pEntry->OldState < pFsm->pConsts->StatesNum) && (pEntry->Event < pFsm->pConsts->EvNum)
+		&& (!isHandled || (pEntry->NewState < pFsm->pConsts->StatesNum)))
+	{
+		(void)snprintf(pText, maxLen, "%10u fsm %u: %s --%s--> %s", (unsigned int)pEntry->Timestamp,
+					   (unsigned int)pEntry->FsmId, pFsm->pConsts->pStateNames[pEntry->OldState],
+					   pFsm->pConsts->pEventNames[pEntry->Event],
+					   isHandled ? pFsm->pConsts->pStateNames[pEntry->NewState] : "unhandled");
+		isDecoded = true;
+	}
+#else
+	(void)pFsm;
+#endif
+
+	if (!isDecoded && isHandled)
+	{
+		(void)snprintf(pText, maxLen, "%10u fsm %u: %u --%u--> %u", (unsigned int)pEntry->Timestamp,
+					   (unsigned int)pEntry->FsmId, (unsigned int)pEntry->OldState, (unsigned int)pEntry->Event,
+					   (unsigned int)pEntry->NewState);
+	}
+	else if (!isDecoded)
+	{
+		(void)snprintf(pText, maxLen, "%10u fsm %u: %u --%u--> unhandled", (unsigned int)pEntry->Timestamp,
+					   (unsigned int)pEntry->FsmId, (unsigned int)pEntry->OldState, (unsigned int)pEntry->Event);
+	}
+	else
+	{
+		// decoded with names
+	}
+}
+
+//=====================================================================================================================
+// LibFsm_DumpTrace:
+//=====================================================================================================================
+void LibFsm_DumpTrace(void)
+{
+	char text[LIBFSM_TRACE_TEXT_LEN];
+
+	// the dump is explicitly requested, therefore it is written to the UART directly instead of the LibLog macros
+	// which are compiled out
+	(void)VirtualPrintf("Fsm trace: time fsm: old --event--> new\n");
+	for (uint32_t age = LIBFSMCFG_TRACE_SIZE; age > 0U; age--)
+	{
+		const S_LibFsm_TraceEntry_t* const pEntry = LibFsm_GetTraceEntry(age - 1U);
+		if (NULL != pEntry)
+		{
+			LibFsm_DecodeTraceEntry(pEntry, text, sizeof(text));
+			(void)VirtualPrintf("Fsm trace: %s\n", text);
+		}
+	}
+
+	(void)VirtualPrintf("Fsm state stats: fsm state left max avg\n");
+	for (uint8_t fsmId = 1U; fsmId <= LIBFSMCFG_TRACE_MAX_FSM; fsmId++)
+	{
+		const S_LibFsm_t* const pFsm = LibFsm_GetTracedFsm(fsmId);
+		if ((NULL != pFsm) && (NULL != pFsm->pStateStats))
+		{
+			for (uint8_t state = 0U; state < pFsm->pConsts->StatesNum; state++)
+			{
+				const S_LibFsm_StateStats_t* const pStats = &pFsm->pStateStats[state];
+				const uint32_t avg = (0U != pStats->NumLeft) ? (uint32_t)(pStats->TotalTime / pStats->NumLeft) : 0U;
+				(void)VirtualPrintf("Fsm state stats: %u %u %u %u %u\n", (unsigned int)fsmId, (unsigned int)state,
+									(unsigned int)pStats->NumLeft, (unsigned int)pStats->MaxTime, (unsigned int)avg);
+			}
+		}
+	}
+}
+
+//=====================================================================================================================
+// LibFsm_RecordTrace:
+//=====================================================================================================================
+static void LibFsm_RecordTrace(S_LibFsm_t* const pFsm, const uint8_t ev, const S_LibFsm_TrDesc_t* const pTrDesc)
+{
+	const uint32_t now = LibCycleClock_Get();
+
+	if (0U == pFsm->TraceId)
+	{
+		// First dispatch: assign the trace id, the current state is taken as entered now
+		LibCycleClock_Init();
+		const uint8_t idx = LibAtomic_FetchAdd(&LibFsm_NumTracedFsm, 1U);
+		if (idx < LIBFSMCFG_TRACE_MAX_FSM)
+		{
+			LibAtomic_Store(&LibFsm_pTracedFsm[idx], pFsm);
+		}
+		pFsm->TraceId = (idx < (UINT8_MAX - 1U)) ? (uint8_t)(idx + 1U) : (uint8_t)UINT8_MAX;
+		pFsm->StateEnterTime = now;
+	}
+
+	S_LibFsm_TraceEntry_t* const pEntry = &LibFsm_Trace[LibAtomic_FetchAdd(&LibFsm_TraceIdx, 1U) & LIBFSM_TRACE_MASK];
+	pEntry->Timestamp = now;
+	pEntry->FsmId = pFsm->TraceId;
+	pEntry->OldState = pFsm->CurrentState;
+	pEntry->Event = ev;
+	pEntry->NewState = (NULL != pTrDesc) ? pTrDesc->NewState : LIBFSM_TRACE_UNHANDLED;
+
+	if ((NULL != pTrDesc) && (pTrDesc->NewState != pFsm->CurrentState) && (NULL != pFsm->pStateStats))
+	{
+		S_LibFsm_StateStats_t* const pStats = &pFsm->pStateStats[pFsm->CurrentState];
+		const uint32_t time = now - pFsm->StateEnterTime;
+
+		pStats->NumLeft++;
+		pStats->TotalTime += time;
+		if (time > pStats->MaxTime)
+		{
+			pStats->MaxTime = time;
+		}
+		pFsm->StateEnterTime = now;
+	}
+}
+#endif
@@ -26,6 +26,7 @@
 //  Includes
 // --------------------------------------------------------------------------------------------------------------------
 #include "LibTypes.h"
+#include "LibServiceCfg.h"
 
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -65,7 +66,35 @@
 														UINT32_C(0),	/* EventMask */								\
 														false,			/* Terminated */							\
 														(serviceFunc),	/* ServiceFunc */							\
-														(pData)			/* pData */									\
+														(pData),		/* pData */									\
+														UINT32_C(0),	/* PendingBit */							\
+														false			/* IsPolled */								\
+													}
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Macro to initialize a polled service instance structure.
+///
+/// The service host only invokes the service function of a service with pending events. A polled service is invoked
+/// on every pass of the service host instead, which is required by services performing work outside of their event
+/// handlers (e.g. monitoring a flag which is not signalled by an event).
+///
+/// \attention
+/// A polled service is always pending (see LibServiceHost_IsPending()): a host task which blocks while its service
+/// host is idle never blocks. Only use polled services in service hosts run by a periodic task.
+///
+/// \param serviceFunc
+/// The service function to be invoked from the context of the host task on every pass of the service host.
+/// \param pData
+/// Pointer to user data passed back to the service function.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBSERVICE_INIT_POLLED_SERVICE(serviceFunc, pData)	{														\
+														NULL,			/* pServiceHost */							\
+														UINT32_C(0),	/* EventMask */								\
+														false,			/* Terminated */							\
+														(serviceFunc),	/* ServiceFunc */							\
+														(pData),		/* pData */									\
+														UINT32_C(0),	/* PendingBit */							\
+														true			/* IsPolled */								\
 													}
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -105,6 +134,23 @@
 //  Global Data Types
 // --------------------------------------------------------------------------------------------------------------------
 
+#ifdef LIBSERVICECFG_PROFILING
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Data type for the execution profile of a service.
+///
+/// The times are measured by the service host around each invocation of the service function in units of the clock
+/// source LibCycleClock_Get() (CPU cycles on target, nanoseconds on host builds).
+// --------------------------------------------------------------------------------------------------------------------
+typedef struct S_LibService_Profile
+{
+	uint32_t Count;				//!< Number of invocations of the service function
+	uint32_t MinCycles;			//!< Shortest execution time of the service function
+	uint32_t MaxCycles;			//!< Longest execution time of the service function
+	uint64_t TotalCycles;		//!< Accumulated execution time of the service function (average = TotalCycles / Count)
+	uint32_t WorstEventMask;	//!< Event mask pending on the invocation with the longest execution time
+} S_LibService_Profile_t;
+#endif // LIBSERVICECFG_PROFILING
+
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief Data type for a service.
 ///
@@ -141,6 +187,29 @@ typedef struct S_LibService_Inst
 	// ----------------------------------------------------------------------------------------------------------------
 	void* pData;
 
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief The bit of the service in the pending mask of the service host.
+	///
+	/// \attention
+	/// The bit is automatically initialized by LibServiceHost_Init() according to the priority of the service.
+	// ----------------------------------------------------------------------------------------------------------------
+	uint32_t PendingBit;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Stores whether the service is invoked on every pass of the service host regardless of pending events.
+	// ----------------------------------------------------------------------------------------------------------------
+	bool_t IsPolled;
+
+#ifdef LIBSERVICECFG_PROFILING
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief The execution profile of the service.
+	///
+	/// \attention
+	/// The profile is zero initialized by omission from #LIBSERVICE_INIT_SERVICE and updated by the service host.
+	// ----------------------------------------------------------------------------------------------------------------
+	S_LibService_Profile_t Profile;
+#endif // LIBSERVICECFG_PROFILING
+
 } S_LibService_Inst_t;
 
 
@@ -229,5 +298,25 @@ bool_t LibService_CheckClearEvent(S_LibService_Inst_t* const pService, const uin
 // --------------------------------------------------------------------------------------------------------------------
 void LibService_Terminate(S_LibService_Inst_t* const pService);
 
+#ifdef LIBSERVICECFG_PROFILING
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Get a consistent copy of the execution profile of the service.
+///
+/// \param pService
+/// Pointer to the service.
+/// \param pProfile
+/// Pointer to the structure receiving the execution profile.
+// --------------------------------------------------------------------------------------------------------------------
+void LibService_GetProfile(const S_LibService_Inst_t* const pService, S_LibService_Profile_t* const pProfile);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Reset the execution profile of the service.
+///
+/// \param pService
+/// Pointer to the service.
+// --------------------------------------------------------------------------------------------------------------------
+void LibService_ResetProfile(S_LibService_Inst_t* const pService);
+#endif // LIBSERVICECFG_PROFILING
+
 
 #endif // LIB_SERVICE_H__INCLUDED
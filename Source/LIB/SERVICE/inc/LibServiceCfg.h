@@ -0,0 +1,51 @@
+// --------------------------------------------------------------------------------------------------------------------
+///
+/// \file LibServiceCfg.h
+///
+/// \brief Configuration file for services and service hosts.
+///
+///
+///
+/// All Rights Reserved.
+///
+// --------------------------------------------------------------------------------------------------------------------
+
+
+#ifndef LIB_SERVICE_CFG_H__INCLUDED
+#define LIB_SERVICE_CFG_H__INCLUDED
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Includes
+// --------------------------------------------------------------------------------------------------------------------
+
+
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Global Definitions
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief In case that the execution time of each service function shall be profiled by the service host, uncomment
+/// this line otherwise comment it out. The times are taken from LibCycleClock_Get() (LibTypes.h).
+// --------------------------------------------------------------------------------------------------------------------
+//#define LIBSERVICECFG_PROFILING
+
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Global Data Types
+// --------------------------------------------------------------------------------------------------------------------
+
+
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Imported Variables
+// --------------------------------------------------------------------------------------------------------------------
+
+
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Global Function Prototypes
+// --------------------------------------------------------------------------------------------------------------------
+
+
+#endif // LIB_SERVICE_CFG_H__INCLUDED
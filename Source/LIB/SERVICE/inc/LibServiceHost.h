@@ -20,6 +20,7 @@
 //  Includes
 // --------------------------------------------------------------------------------------------------------------------
 #include "LibTypes.h"
+#include "LibServiceCfg.h"
 
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -35,8 +36,14 @@
 /// {
 ///		&LibExample_Service
 /// };
+/// static const uint8_t LibExample_ServicePrio[] =
+/// {
+///		0U
+/// };
+/// static S_LibServiceHost_State_t LibExample_ServiceHostState;
 /// static S_LibServiceHost_Inst_t LibExample_ServiceHost =
-///		LIBSERVICEHOST_INIT_CALLBACK_EX(LibExample_Callback, NULL, LibExample_ServiceTable, LIBEXAMPLE_SERVICE_COUNT, false);
+///		LIBSERVICEHOST_INIT_CALLBACK_EX(LibExample_Callback, NULL, LibExample_ServiceTable, LIBEXAMPLE_SERVICE_COUNT,
+///										&LibExample_ServiceHostState, LibExample_ServicePrio, 2U);
 /// \endcode
 ///
 /// The macro can also be used to initialize a service host instance structure part of another structure:
@@ -59,7 +66,8 @@
 /// static S_LibExample_Inst_t LibExample_Inst =
 /// {
 ///		0,
-///		LIBSERVICEHOST_INIT_CALLBACK_EX(LibExample_Callback, NULL, LibExample_ServiceTable, LIBEXAMPLE_SERVICE_COUNT, false),
+///		LIBSERVICEHOST_INIT_CALLBACK_EX(LibExample_Callback, NULL, LibExample_ServiceTable, LIBEXAMPLE_SERVICE_COUNT,
+///										&LibExample_ServiceHostState, LibExample_ServicePrio, 2U),
 ///		0
 /// };
 /// \endcode
@@ -71,14 +79,62 @@
 /// \param pSvc
 /// Array containing pointers to the services hosted by this service host instance.
 /// \param count
-/// The number of services in pServices.
+/// The number of services in pServices (at most #LIBSERVICEHOST_MAX_SERVICES).
+/// \param pHostState
+/// Pointer to the runtime state of the service host.
+/// \param pPrio
+/// Array of count indices into pSvc ordered by descending priority, or NULL to use the order of pSvc.
+/// \param budget_ms
+/// The maximum time in milliseconds spent by LibServiceHost_Service() in one pass, or 0 for no limit.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBSERVICEHOST_INIT_CALLBACK_EX(callback, pUserData, pSvc, count, pHostState, pPrio, budget_ms)				\
+	LIBSERVICEHOST_INIT_CALLBACK_LEVELS(callback, pUserData, pSvc, count, pHostState, pPrio, NULL, budget_ms)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Macro to initialize a service host instance structure with services sharing a priority level.
+///
+/// Like #LIBSERVICEHOST_INIT_CALLBACK_EX, additionally pLvl assigns a priority level to each entry of pPrio. Services
+/// of the same level are serviced round robin: if a pass is stopped because its time budget is exhausted, the next
+/// pass continues with the service of that level following the last one serviced.
+/// \code
+/// static const uint8_t LibExample_ServicePrio[] =
+/// {
+///		0U, 1U, 2U
+/// };
+/// static const uint8_t LibExample_ServiceLevel[] =
+/// {
+///		0U, 1U, 1U		// the 2nd and 3rd service share a priority level below the 1st service
+/// };
+/// \endcode
+///
+/// \param callback
+/// The callback function to be invoked on pending events.
+/// \param pUserData
+/// Pointer to user data passed back to the callback function.
+/// \param pSvc
+/// Array containing pointers to the services hosted by this service host instance.
+/// \param count
+/// The number of services in pServices (at most #LIBSERVICEHOST_MAX_SERVICES).
+/// \param pHostState
+/// Pointer to the runtime state of the service host.
+/// \param pPrio
+/// Array of count indices into pSvc ordered by descending priority, or NULL to use the order of pSvc.
+/// \param pLvl
+/// Array of count priority levels in the order of pPrio (non-decreasing, equal values share a level), or NULL if all
+/// services have distinct priorities.
+/// \param budget_ms
+/// The maximum time in milliseconds spent by LibServiceHost_Service() in one pass, or 0 for no limit.
 // --------------------------------------------------------------------------------------------------------------------
-#define LIBSERVICEHOST_INIT_CALLBACK_EX(callback, pUserData, pSvc, count)											\
+#define LIBSERVICEHOST_INIT_CALLBACK_LEVELS(callback, pUserData, pSvc, count, pHostState, pPrio, pLvl, budget_ms)	\
 	{																												\
 		.Callback		= (callback),																				\
 		.pData			= (pUserData),																				\
 		.pServices		= (pSvc),																					\
-		.ServiceCount	= (count)																					\
+		.ServiceCount	= (count),																					\
+		.pState			= (pHostState),																				\
+		.pPrioTab		= (pPrio),																					\
+		.pLevelTab		= (pLvl),																					\
+		.PassBudget_ms	= (budget_ms)																				\
 	}
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -91,8 +147,10 @@
 /// {
 ///		&LibExample_Service
 /// };
+/// static S_LibServiceHost_State_t LibExample_ServiceHostState;
 /// static S_LibServiceHost_Inst_t LibExample_ServiceHost = 
-///		LIBSERVICEHOST_INIT_CALLBACK(LibExample_Callback, NULL, LibExample_ServiceTable, LIBEXAMPLE_SERVICE_COUNT);
+///		LIBSERVICEHOST_INIT_CALLBACK(LibExample_Callback, NULL, LibExample_ServiceTable, LIBEXAMPLE_SERVICE_COUNT,
+///									 &LibExample_ServiceHostState);
 /// \endcode
 ///
 /// The macro can also be used to initialize a service host instance structure part of another structure:
@@ -115,7 +173,8 @@
 /// static S_LibExample_Inst_t LibExample_Inst = 
 /// {
 ///		0, 
-///		LIBSERVICEHOST_INIT_CALLBACK(LibExample_Callback, NULL, LibExample_ServiceTable, LIBEXAMPLE_SERVICE_COUNT),
+///		LIBSERVICEHOST_INIT_CALLBACK(LibExample_Callback, NULL, LibExample_ServiceTable, LIBEXAMPLE_SERVICE_COUNT,
+///									 &LibExample_ServiceHostState),
 ///		0
 /// };
 /// \endcode
@@ -127,16 +186,60 @@
 /// \param pSvc
 /// Array containing pointers to the services hosted by this service host instance.
 /// \param count
-/// The number of services in pServices.
+/// The number of services in pServices (at most #LIBSERVICEHOST_MAX_SERVICES).
+/// \param pHostState
+/// Pointer to the runtime state of the service host.
 // --------------------------------------------------------------------------------------------------------------------
-#define LIBSERVICEHOST_INIT_CALLBACK(callback, pUserData, pSvc, count)												\
-	LIBSERVICEHOST_INIT_CALLBACK_EX(callback, pUserData, pSvc, count)
+#define LIBSERVICEHOST_INIT_CALLBACK(callback, pUserData, pSvc, count, pHostState)									\
+	LIBSERVICEHOST_INIT_CALLBACK_EX(callback, pUserData, pSvc, count, pHostState, NULL, UINT32_C(0))
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief The maximum number of services hosted by one service host (one bit per service in the pending mask).
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBSERVICEHOST_MAX_SERVICES					UINT32_C(32)
 
 // --------------------------------------------------------------------------------------------------------------------
 //  Global Data Types
 // --------------------------------------------------------------------------------------------------------------------
 struct S_LibService_Inst;
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Data type for the runtime state of a service host.
+///
+/// The service host instance itself is usually constant, therefore the data modified at runtime is kept separately.
+///
+/// \attention
+/// This structure shall not be used directly but only via the functions and macros provided by this module.
+// --------------------------------------------------------------------------------------------------------------------
+typedef struct S_LibServiceHost_State
+{
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Mask of the services with pending events.
+	///
+	/// Bit n is set if the service with priority n (0 = highest) has to be invoked. The mask is set by
+	/// LibService_SetEvent() and cleared by the service host before the service function is invoked.
+	// ----------------------------------------------------------------------------------------------------------------
+	volatile uint32_t PendingMask;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief The priority following the service serviced last.
+	///
+	/// Among pending services of the same priority level, the service at or after this priority is serviced first so
+	/// that a flooded service cannot starve the other services of its level when the time budget of a pass is
+	/// exhausted. Services of a higher level are always serviced first.
+	// ----------------------------------------------------------------------------------------------------------------
+	uint32_t ResumeIdx;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Mask of the priorities serviced by a pass stopped because its time budget was exhausted.
+	///
+	/// The next pass resumes the stopped one and services the pending services not in this mask first, so that a
+	/// flooded service of a higher level cannot starve the lower levels. 0 if the last pass was completed.
+	// ----------------------------------------------------------------------------------------------------------------
+	uint32_t StoppedMask;
+
+} S_LibServiceHost_State_t;
+
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief Data type for a service host.
 ///
@@ -165,6 +268,31 @@ typedef struct S_LibServiceHost_Inst
 	// ----------------------------------------------------------------------------------------------------------------
 	uint32_t ServiceCount;
 
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Pointer to the runtime state of the service host.
+	// ----------------------------------------------------------------------------------------------------------------
+	S_LibServiceHost_State_t* const pState;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Table of indices into S_LibServiceHost_Inst_t.pServices ordered by descending priority.
+	///
+	/// If NULL, the services are prioritized in the order of S_LibServiceHost_Inst_t.pServices.
+	// ----------------------------------------------------------------------------------------------------------------
+	const uint8_t* const pPrioTab;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Table of the priority levels in the order of S_LibServiceHost_Inst_t.pPrioTab.
+	///
+	/// Consecutive entries with equal values share a priority level and are serviced round robin. If NULL, all
+	/// services have distinct priorities.
+	// ----------------------------------------------------------------------------------------------------------------
+	const uint8_t* const pLevelTab;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief The maximum time in milliseconds spent by LibServiceHost_Service() in one pass (0 = no limit).
+	// ----------------------------------------------------------------------------------------------------------------
+	uint32_t PassBudget_ms;
+
 } S_LibServiceHost_Inst_t;
 
 
@@ -197,6 +325,12 @@ void LibServiceHost_Init(const S_LibServiceHost_Inst_t* const pServiceHost);
 ///
 /// This function should be used with a service host instance initialized by #LIBSERVICEHOST_INIT_CALLBACK.
 ///
+/// The services are invoked in the order of their priority, each service at most once per pass. Every pass starts
+/// with the highest priority service with pending events. If the service host has a time budget and the budget is
+/// exhausted, the pass is stopped and the next call resumes it: the services not yet serviced by the stopped pass
+/// are serviced before a new pass starts with the highest priority again. Services of the same priority level are
+/// serviced round robin across passes.
+///
 /// \param pServiceHost
 /// Pointer to the service host.
 // --------------------------------------------------------------------------------------------------------------------
@@ -222,7 +356,7 @@ void LibServiceHost_Service(const S_LibServiceHost_Inst_t* const pServiceHost);
 /// \param pServiceHost
 /// Pointer to the service host.
 /// \param pIdx
-/// Pointer to a variable initialized with 0 to store the index of the next service to be checked for pending events.
+/// Pointer to a variable initialized with 0 to store the mask of the priorities serviced in this pass.
 /// \retval true
 /// A service with pending events has been found and the service has been serviced.
 /// \retval false
@@ -254,6 +388,21 @@ void LibServiceHost_TriggerShutdown(const S_LibServiceHost_Inst_t* const pServic
 // --------------------------------------------------------------------------------------------------------------------
 bool_t LibServiceHost_IsTerminated(const S_LibServiceHost_Inst_t* const pServiceHost);
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Get whether a hosted service is pending, i.e. has events left or is polled.
+///
+/// Used by the host task after LibServiceHost_Service() to decide whether to start the next pass right away or to
+/// block until the next notification (#LIBSERVICEHOST_INIT_CALLBACK).
+///
+/// \param pServiceHost
+/// Pointer to the service host.
+/// \retval true
+/// At least one service is pending.
+/// \retval false
+/// No service is pending: the service host is idle until the next event is set.
+// --------------------------------------------------------------------------------------------------------------------
+bool_t LibServiceHost_IsPending(const S_LibServiceHost_Inst_t* const pServiceHost);
+
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief Notify the service host instance about a new pending event from a hosted service.
 ///
@@ -264,5 +413,28 @@ bool_t LibServiceHost_IsTerminated(const S_LibServiceHost_Inst_t* const pService
 // --------------------------------------------------------------------------------------------------------------------
 void LibServiceHost_Notify(const S_LibServiceHost_Inst_t* const pServiceHost);
 
+#ifdef LIBSERVICECFG_PROFILING
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Dump the execution profiles of all services hosted by the service host to the log.
+///
+/// One line is written per service in the order of S_LibServiceHost_Inst_t.pServices: the number of invocations,
+/// the minimum, maximum and average execution time and the event mask pending on the slowest invocation.
+///
+/// \attention
+/// This function writes to the UART log and therefore shall not be called from interrupt context.
+/// \param pServiceHost
+/// Pointer to the service host.
+// --------------------------------------------------------------------------------------------------------------------
+void LibServiceHost_DumpProfile(const S_LibServiceHost_Inst_t* const pServiceHost);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Reset the execution profiles of all services hosted by the service host.
+///
+/// \param pServiceHost
+/// Pointer to the service host.
+// --------------------------------------------------------------------------------------------------------------------
+void LibServiceHost_ResetProfile(const S_LibServiceHost_Inst_t* const pServiceHost);
+#endif // LIBSERVICECFG_PROFILING
+
 
 #endif // LIB_SERVICE_HOST_H__INCLUDED
@@ -56,11 +56,14 @@
 
 void LibService_SetEvent(S_LibService_Inst_t* const pService, const uint32_t eventMask)
 {
-	// set the event
+	// set the event: the event has to be visible before the service is marked as pending
 	Lib_Assert(NULL != pService);
-	SuspendAllInterrupts();
-	pService->EventMask |= eventMask;
-	ResumeAllInterrupts();
+	(void)LibAtomic_FetchOr(&pService->EventMask, eventMask);
+	if (NULL != pService->pServiceHost)
+	{
+		// mark the service as pending so that the service host invokes it on its next pass
+		(void)LibAtomic_FetchOr(&pService->pServiceHost->pState->PendingMask, pService->PendingBit);
+	}
 	
 	// notify the service host about a new pending event from a hosted service
 	if (NULL != pService->pServiceHost)
@@ -79,9 +82,7 @@ uint32_t LibService_GetEvent(const S_LibService_Inst_t* const pService)
 
 	// get the event mask
 	Lib_Assert(NULL != pService);
-	SuspendAllInterrupts();
-	retval = pService->EventMask;
-	ResumeAllInterrupts();
+	retval = LibAtomic_Load(&pService->EventMask);
 
 	return retval;
 }
@@ -94,9 +95,7 @@ void LibService_ClearEvent(S_LibService_Inst_t* const pService, const uint32_t e
 {
 	// clear the event
 	Lib_Assert(NULL != pService);
-	SuspendAllInterrupts();
-	pService->EventMask &= ~eventMask;
-	ResumeAllInterrupts();
+	(void)LibAtomic_FetchAnd(&pService->EventMask, ~eventMask);
 }
 
 
@@ -107,12 +106,9 @@ bool_t LibService_CheckClearEvent(S_LibService_Inst_t* const pService, const uin
 {
 	bool_t retval;
 	
-	// check whether at least one of the events has been set and clear the event(s)
+	// check whether at least one of the events has been set and clear the event(s) in one atomic operation
 	Lib_Assert(NULL != pService);
-	SuspendAllInterrupts();
-	retval = (UINT32_C(0) != (pService->EventMask & eventMask));
-	pService->EventMask &= ~eventMask;
-	ResumeAllInterrupts();
+	retval = (UINT32_C(0) != (LibAtomic_FetchAnd(&pService->EventMask, ~eventMask) & eventMask));
 
 	return retval;
 }
@@ -126,3 +122,29 @@ void LibService_Terminate(S_LibService_Inst_t* const pService)
 	Lib_Assert((NULL != pService) && (!pService->Terminated));
 	pService->Terminated = true;
 }
+
+
+#ifdef LIBSERVICECFG_PROFILING
+//=====================================================================================================================
+// LibService_GetProfile:
+//=====================================================================================================================
+void LibService_GetProfile(const S_LibService_Inst_t* const pService, S_LibService_Profile_t* const pProfile)
+{
+	Lib_Assert((NULL != pService) && (NULL != pProfile));
+	SuspendAllInterrupts();
+	*pProfile = pService->Profile;
+	ResumeAllInterrupts();
+}
+
+
+//=====================================================================================================================
+// LibService_ResetProfile:
+//=====================================================================================================================
+void LibService_ResetProfile(S_LibService_Inst_t* const pService)
+{
+	Lib_Assert(NULL != pService);
+	SuspendAllInterrupts();
+	(void)memset(&pService->Profile, 0, sizeof(pService->Profile));
+	ResumeAllInterrupts();
+}
+#endif // LIBSERVICECFG_PROFILING
@@ -22,12 +22,25 @@
 #include "LibServiceHost.h"
 #include "LibService.h"
 #include "LibTypes.h"
+#include "LibTimer.h"
 
 
 // --------------------------------------------------------------------------------------------------------------------
 //	Local Definitions
 // --------------------------------------------------------------------------------------------------------------------
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Time base in milliseconds used to enforce the time budget of a pass of LibServiceHost_Service().
+// --------------------------------------------------------------------------------------------------------------------
+#ifndef LIBSERVICEHOST_GET_TIME_MS
+#define LIBSERVICEHOST_GET_TIME_MS()		LibTimer_GetUpTime_ms()
+#endif
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Get the index of the lowest bit set in a non-zero mask (i.e. the highest priority pending service).
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBSERVICEHOST_LOWEST_BIT_IDX(mask)	((uint32_t)__builtin_ctz(mask))
+
 
 // --------------------------------------------------------------------------------------------------------------------
 //	Local Data Types
@@ -48,6 +61,33 @@
 //	Local Function Prototypes
 // --------------------------------------------------------------------------------------------------------------------
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Get the mask of the priorities sharing the priority level of a priority.
+///
+/// \param pServiceHost
+/// Pointer to the service host, S_LibServiceHost_Inst_t.pLevelTab shall not be NULL.
+/// \param prio
+/// The priority.
+/// \return
+/// The mask of the priorities of the level, including prio.
+// --------------------------------------------------------------------------------------------------------------------
+static uint32_t LibServiceHost_GetLevelMask(const S_LibServiceHost_Inst_t* const pServiceHost, const uint32_t prio);
+
+#ifdef LIBSERVICECFG_PROFILING
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Account one invocation of the service function to the execution profile of the service.
+///
+/// \param pService
+/// Pointer to the service.
+/// \param cycles
+/// The execution time of the invocation.
+/// \param eventMask
+/// The event mask pending on the invocation.
+// --------------------------------------------------------------------------------------------------------------------
+static void LibServiceHost_UpdateProfile(S_LibService_Inst_t* const pService, const uint32_t cycles,
+										 const uint32_t eventMask);
+#endif // LIBSERVICECFG_PROFILING
+
 
 // --------------------------------------------------------------------------------------------------------------------
 //	Functions
@@ -59,21 +99,37 @@
 void LibServiceHost_Init(const S_LibServiceHost_Inst_t* const pServiceHost)
 {
 	Lib_Assert((NULL != pServiceHost) && (pServiceHost->ServiceCount > 0U));
+	Lib_Assert((NULL != pServiceHost->pState) && (pServiceHost->ServiceCount <= LIBSERVICEHOST_MAX_SERVICES));
 
 	// initialize all services hosted by the service host: be aware that this function will be also called for
 	// re-initialization and therefore some clean-up is required (i.e. clearing event LIBSERVICE_EV_TRIGGER_SHUTDOWN)
 	SuspendAllInterrupts();
-	for (uint32_t i = UINT32_C(0); i < pServiceHost->ServiceCount; i++)
+	for (uint32_t prio = UINT32_C(0); prio < pServiceHost->ServiceCount; prio++)
 	{
+		const uint32_t i = (NULL != pServiceHost->pPrioTab)? pServiceHost->pPrioTab[prio] : prio;
+		Lib_Assert(i < pServiceHost->ServiceCount);
+		Lib_Assert((NULL == pServiceHost->pLevelTab) || (UINT32_C(0) == prio)
+				|| (pServiceHost->pLevelTab[prio - UINT32_C(1)] <= pServiceHost->pLevelTab[prio]));
 		S_LibService_Inst_t* const pService = pServiceHost->pServices[i];
 		Lib_Assert(NULL != pService);
 		pService->pServiceHost = pServiceHost;
+		pService->PendingBit = UINT32_C(1) << prio;
 		pService->EventMask &= ~LIBSERVICE_EV_TRIGGER_SHUTDOWN;
 		pService->EventMask |= pService->Terminated? LIBSERVICE_EV_RE_INIT : LIBSERVICE_EV_INIT;
 		pService->Terminated = false;
 	}
+
+	// all services have a pending (re-)initialization event
+	pServiceHost->pState->PendingMask = (pServiceHost->ServiceCount < LIBSERVICEHOST_MAX_SERVICES)?
+		((UINT32_C(1) << pServiceHost->ServiceCount) - UINT32_C(1)) : UINT32_MAX;
+	pServiceHost->pState->ResumeIdx = UINT32_C(0);
+	pServiceHost->pState->StoppedMask = UINT32_C(0);
 	ResumeAllInterrupts();
 
+#ifdef LIBSERVICECFG_PROFILING
+	LibCycleClock_Init();
+#endif // LIBSERVICECFG_PROFILING
+
 	// notify the service host about a new pending event from a hosted service
 	LibServiceHost_Notify(pServiceHost);
 }
@@ -83,9 +139,38 @@ void LibServiceHost_Init(const S_LibServiceHost_Inst_t* const pServiceHost)
 //=====================================================================================================================
 void LibServiceHost_Service(const S_LibServiceHost_Inst_t* const pServiceHost)
 {
-	uint32_t i = 0U;
-	while (LibServiceHost_ServiceNext(pServiceHost, &i))
+	Lib_Assert(NULL != pServiceHost);
+
+	S_LibServiceHost_State_t* const pState = pServiceHost->pState;
+
+	if (UINT32_C(0) == pServiceHost->PassBudget_ms)
 	{
+		uint32_t servicedMask = UINT32_C(0);
+
+		while (LibServiceHost_ServiceNext(pServiceHost, &servicedMask))
+		{
+		}
+	}
+	else
+	{
+		// resume a pass stopped by its budget first: the services it has not reached yet are serviced before the
+		// flooded services serviced by it, the pass is completed if the budget allows
+		uint32_t servicedMask = pState->StoppedMask;
+		bool_t isStopped = false;
+		const uint32_t start_ms = LIBSERVICEHOST_GET_TIME_MS();
+
+		while (LibServiceHost_ServiceNext(pServiceHost, &servicedMask))
+		{
+			if ((LIBSERVICEHOST_GET_TIME_MS() - start_ms) >= pServiceHost->PassBudget_ms)
+			{
+				isStopped = true;
+				break;
+			}
+		}
+
+		// keep the mask if services are pending which the stopped pass has not reached
+		pState->StoppedMask = (isStopped && (UINT32_C(0) != (LibAtomic_Load(&pState->PendingMask) & ~servicedMask)))?
+			servicedMask : UINT32_C(0);
 	}
 }
 
@@ -97,19 +182,63 @@ bool_t LibServiceHost_ServiceNext(const S_LibServiceHost_Inst_t* const pServiceH
 	bool_t retval = false;
 
 	Lib_Assert((NULL != pServiceHost) && (NULL != pIdx));
-	Lib_Assert(*pIdx <= pServiceHost->ServiceCount);
 
-	// call the service function of the next service with pending events
-	while (*pIdx < pServiceHost->ServiceCount)
+	S_LibServiceHost_State_t* const pState = pServiceHost->pState;
+
+	// call the service function of the next service with pending events: an idle pass only costs a load and a
+	// compare
+	for (;;)
 	{
-		// check for a pending event
-		const S_LibService_Inst_t* const pService = pServiceHost->pServices[(*pIdx)++];
+		// fetch the highest priority pending service not yet serviced in this pass
+		const uint32_t pending = LibAtomic_Load(&pState->PendingMask) & ~(*pIdx);
+		if (UINT32_C(0) == pending)
+		{
+			break;
+		}
+		uint32_t prio = LIBSERVICEHOST_LOWEST_BIT_IDX(pending);
+
+		// among the pending services of its priority level, continue after the service serviced last
+		if ((NULL != pServiceHost->pLevelTab) && (pState->ResumeIdx > prio)
+		 && (pState->ResumeIdx < LIBSERVICEHOST_MAX_SERVICES))
+		{
+			const uint32_t candidates = pending & LibServiceHost_GetLevelMask(pServiceHost, prio)
+									  & (UINT32_MAX << pState->ResumeIdx);
+			if (UINT32_C(0) != candidates)
+			{
+				prio = LIBSERVICEHOST_LOWEST_BIT_IDX(candidates);
+			}
+		}
+
+		// clear the pending bit: bits are only cleared by the service host itself, so the bit found in the snapshot
+		// is still set when it is cleared
+		const uint32_t pendingBit = UINT32_C(1) << prio;
+		(void)LibAtomic_FetchAnd(&pState->PendingMask, ~pendingBit);
+		*pIdx |= pendingBit;
+		pState->ResumeIdx = prio + UINT32_C(1);
+
+		const uint32_t i = (NULL != pServiceHost->pPrioTab)? pServiceHost->pPrioTab[prio] : prio;
+		S_LibService_Inst_t* const pService = pServiceHost->pServices[i];
 		if (!pService->Terminated)
 		{
 			// call the service function for the current service
 			Lib_Assert(NULL != pService->ServiceFunc);
+#ifdef LIBSERVICECFG_PROFILING
+			const uint32_t eventMask = pService->EventMask;
+			const uint32_t start = LibCycleClock_Get();
 			pService->ServiceFunc(pService->pData);
+			LibServiceHost_UpdateProfile(pService, LibCycleClock_Get() - start, eventMask);
+#else
+			pService->ServiceFunc(pService->pData);
+#endif // LIBSERVICECFG_PROFILING
 			Lib_Assert(UINT32_C(0) == (pService->EventMask & (LIBSERVICE_EV_INIT | LIBSERVICE_EV_RE_INIT)));
+
+			// keep the service pending if it is polled or has left events unhandled
+			if ((!pService->Terminated)
+			 && ((pService->IsPolled) || (UINT32_C(0) != LibAtomic_Load(&pService->EventMask))))
+			{
+				(void)LibAtomic_FetchOr(&pState->PendingMask, pendingBit);
+			}
+
 			retval = true;
 			break;
 		}
@@ -125,12 +254,11 @@ void LibServiceHost_TriggerShutdown(const S_LibServiceHost_Inst_t* const pServic
 {
 	Lib_Assert(NULL != pServiceHost);
 
-	SuspendAllInterrupts();
 	for (uint32_t i = UINT32_C(0); i < pServiceHost->ServiceCount; i++)
 	{
-		pServiceHost->pServices[i]->EventMask |= LIBSERVICE_EV_TRIGGER_SHUTDOWN;
+		(void)LibAtomic_FetchOr(&pServiceHost->pServices[i]->EventMask, LIBSERVICE_EV_TRIGGER_SHUTDOWN);
+		(void)LibAtomic_FetchOr(&pServiceHost->pState->PendingMask, pServiceHost->pServices[i]->PendingBit);
 	}
-	ResumeAllInterrupts();
 
 	LibServiceHost_Notify(pServiceHost);
 }
@@ -155,6 +283,15 @@ bool_t LibServiceHost_IsTerminated(const S_LibServiceHost_Inst_t* const pService
 	return terminated;
 }
 
+//=====================================================================================================================
+// LibServiceHost_IsPending:
+//=====================================================================================================================
+bool_t LibServiceHost_IsPending(const S_LibServiceHost_Inst_t* const pServiceHost)
+{
+	Lib_Assert(NULL != pServiceHost);
+	return (UINT32_C(0) != LibAtomic_Load(&pServiceHost->pState->PendingMask));
+}
+
 //=====================================================================================================================
 // LibServiceHost_Notify:
 //=====================================================================================================================
@@ -166,3 +303,84 @@ void LibServiceHost_Notify(const S_LibServiceHost_Inst_t* const pServiceHost)
 		pServiceHost->Callback(pServiceHost->pData);
 	}
 }
+
+//=====================================================================================================================
+// LibServiceHost_GetLevelMask:
+//=====================================================================================================================
+static uint32_t LibServiceHost_GetLevelMask(const S_LibServiceHost_Inst_t* const pServiceHost, const uint32_t prio)
+{
+	const uint8_t level = pServiceHost->pLevelTab[prio];
+	uint32_t mask = UINT32_C(1) << prio;
+
+	// the levels are ordered like the priorities, so the services of a level are adjacent
+	for (uint32_t lo = prio; (lo > UINT32_C(0)) && (pServiceHost->pLevelTab[lo - UINT32_C(1)] == level); lo--)
+	{
+		mask |= UINT32_C(1) << (lo - UINT32_C(1));
+	}
+	for (uint32_t hi = prio + UINT32_C(1); (hi < pServiceHost->ServiceCount) && (pServiceHost->pLevelTab[hi] == level);
+		 hi++)
+	{
+		mask |= UINT32_C(1) << hi;
+	}
+
+	return mask;
+}
+
+#ifdef LIBSERVICECFG_PROFILING
+//=====================================================================================================================
+// LibServiceHost_DumpProfile:
+//=====================================================================================================================
+void LibServiceHost_DumpProfile(const S_LibServiceHost_Inst_t* const pServiceHost)
+{
+	Lib_Assert(NULL != pServiceHost);
+
+	// the dump is explicitly requested, therefore it is written to the UART directly instead of the LibLog macros
+	// which are compiled out
+	(void)VirtualPrintf("ServiceHost profile: idx count min max avg worstEv\n");
+	for (uint32_t i = UINT32_C(0); i < pServiceHost->ServiceCount; i++)
+	{
+		S_LibService_Profile_t profile;
+		LibService_GetProfile(pServiceHost->pServices[i], &profile);
+
+		const uint32_t avg = (UINT32_C(0) != profile.Count)? (uint32_t)(profile.TotalCycles / profile.Count) : 0U;
+		(void)VirtualPrintf("ServiceHost profile: %u %u %u %u %u 0x%08X\n", (unsigned int)i, (unsigned int)profile.Count,
+							(unsigned int)profile.MinCycles, (unsigned int)profile.MaxCycles, (unsigned int)avg,
+							(unsigned int)profile.WorstEventMask);
+	}
+}
+
+//=====================================================================================================================
+// LibServiceHost_ResetProfile:
+//=====================================================================================================================
+void LibServiceHost_ResetProfile(const S_LibServiceHost_Inst_t* const pServiceHost)
+{
+	Lib_Assert(NULL != pServiceHost);
+	for (uint32_t i = UINT32_C(0); i < pServiceHost->ServiceCount; i++)
+	{
+		LibService_ResetProfile(pServiceHost->pServices[i]);
+	}
+}
+
+//=====================================================================================================================
+// LibServiceHost_UpdateProfile:
+//=====================================================================================================================
+static void LibServiceHost_UpdateProfile(S_LibService_Inst_t* const pService, const uint32_t cycles,
+										 const uint32_t eventMask)
+{
+	S_LibService_Profile_t* const pProfile = &pService->Profile;
+
+	SuspendAllInterrupts();
+	if ((UINT32_C(0) == pProfile->Count) || (cycles < pProfile->MinCycles))
+	{
+		pProfile->MinCycles = cycles;
+	}
+	if ((UINT32_C(0) == pProfile->Count) || (cycles > pProfile->MaxCycles))
+	{
+		pProfile->MaxCycles = cycles;
+		pProfile->WorstEventMask = eventMask;
+	}
+	pProfile->TotalCycles += cycles;
+	pProfile->Count++;
+	ResumeAllInterrupts();
+}
+#endif // LIBSERVICECFG_PROFILING
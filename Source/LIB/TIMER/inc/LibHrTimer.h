@@ -0,0 +1,194 @@
+// -------------------------------------------------------------------------------------------------------------------- 
+/// 
+/// \file LibHrTimer.h
+/// 
+/// \brief LibHrTimer define: one-shot timers with microsecond resolution
+/// 
+/// 
+/// All Rights Reserved. 
+/// 
+// -------------------------------------------------------------------------------------------------------------------- 
+#ifndef _LIBHRTIMER_H_INCLUDED
+#define _LIBHRTIMER_H_INCLUDED
+// -------------------------------------------------------------------------------------------------------------------- 
+//  Includes 
+// --------------------------------------------------------------------------------------------------------------------
+#include "LibTypes.h"
+#include "LibTimerCfg.h"
+
+
+// -------------------------------------------------------------------------------------------------------------------- 
+//  Local Definitions 
+// -------------------------------------------------------------------------------------------------------------------- 
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Data Types
+// --------------------------------------------------------------------------------------------------------------------
+
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Global Variables
+// --------------------------------------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Macro to initialize a high resolution timer instance structure.
+///
+/// The following example shows how to create and initialize a high resolution timer instance structure:
+/// \code
+/// static S_LibHrTimer_Inst_t LibExample_HrTimer = LIBHRTIMER_INIT_TIMER(LibExample_HrTimerCallback, NULL);
+/// \endcode
+///
+/// \param callback
+/// The callback function to be invoked from ISR context when the timer expires.
+/// \param pData
+/// Pointer to user data passed back to the callback function.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBHRTIMER_INIT_TIMER(callback, pData)		{																\
+														NULL,			/* pNext */									\
+														UINT32_C(0),	/* Deadline_us */							\
+														false,			/* IsRunning */								\
+														callback,		/* Callback */								\
+														pData			/* pData */									\
+													}
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Convert a time in milliseconds into the microseconds expected by LibHrTimer_Start().
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBHRTIMER_MS_TO_US(ms)						((uint32_t)(ms) * UINT32_C(1000))
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief The maximum timeout in microseconds which can be passed to LibHrTimer_Start().
+///
+/// The deadlines are compared using the signed difference of the free running 32 bit microsecond counter.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBHRTIMER_MAX_TIMEOUT_US					UINT32_C(0x7FFFFFFE)
+
+
+// --------------------------------------------------------------------------------------------------------------------
+//  Global Data Types
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Data type for a high resolution one-shot timer.
+///
+/// \attention
+/// This structure shall not be used directly but only via the functions and macros provided by this module.
+// --------------------------------------------------------------------------------------------------------------------
+typedef struct S_LibHrTimer_Inst
+{
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief The pointer to the next entry in the compare queue (sorted by deadline).
+	// ----------------------------------------------------------------------------------------------------------------
+	struct S_LibHrTimer_Inst* pNext;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief The absolute deadline of the timer in microseconds.
+	// ----------------------------------------------------------------------------------------------------------------
+	uint32_t Deadline_us;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Whether the timer is linked into the compare queue.
+	// ----------------------------------------------------------------------------------------------------------------
+	bool_t IsRunning;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief The callback function to be invoked from ISR context when the timer expires.
+	// ----------------------------------------------------------------------------------------------------------------
+	void (*Callback)(void* pData);
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Pointer to user data passed back to the callback function.
+	// ----------------------------------------------------------------------------------------------------------------
+	void* pData;
+
+} S_LibHrTimer_Inst_t;
+
+
+// --------------------------------------------------------------------------------------------------------------------
+//  Imported variables
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+//  Global Function Prototypes
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Initialize the high resolution timer management and start the free running microsecond counter.
+///
+/// On the target the general-purpose timer selected by LIBTIMERCFG_HRTIMER_TIM is used, on host builds the counter
+/// is simulated and advanced by LibHrTimer_HostAdvance_us().
+// --------------------------------------------------------------------------------------------------------------------
+void LibHrTimer_Init(void);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Get the value of the free running microsecond counter.
+///
+/// \return
+/// The current time in microseconds (wraps around after 2^32 microseconds).
+// --------------------------------------------------------------------------------------------------------------------
+uint32_t LibHrTimer_GetTime_us(void);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Start a one-shot timer using the given timeout in microseconds.
+///
+/// \note
+/// The callback function will be invoked from ISR context no earlier than timeout_us after the call.
+/// \attention 
+/// The timer is only started if the timer is not running.
+/// \attention
+/// This function will assert if timeout_us is 0 or exceeds LIBHRTIMER_MAX_TIMEOUT_US.
+/// \param pTimer
+/// Pointer to the timer.
+/// \param timeout_us
+/// The timeout of the timer in microseconds.
+/// \retval true
+/// The timer has been successfully started.
+/// \retval false
+/// The timer is already running.
+// --------------------------------------------------------------------------------------------------------------------
+bool_t LibHrTimer_Start(S_LibHrTimer_Inst_t* const pTimer, const uint32_t timeout_us);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Stop a timer.
+/// 
+/// \param pTimer
+/// Pointer to the timer.
+// --------------------------------------------------------------------------------------------------------------------
+void LibHrTimer_Stop(S_LibHrTimer_Inst_t* const pTimer);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Get the time of a timer in microseconds left to run.
+///
+/// \param pTimer
+/// Pointer to the timer.
+/// \return
+/// The number of microseconds left to run (0 if the timer is not running or has finished the run).
+// --------------------------------------------------------------------------------------------------------------------
+uint32_t LibHrTimer_GetTimeLeft_us(const S_LibHrTimer_Inst_t* const pTimer);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Handle the compare match interrupt of the hardware timer.
+///
+/// All expired timers are removed from the compare queue and their callbacks are invoked, then the compare register
+/// is programmed with the deadline of the next timer.
+///
+/// \attention
+/// This function has to be called from the interrupt handler of LIBTIMERCFG_HRTIMER_TIM.
+// --------------------------------------------------------------------------------------------------------------------
+void LibHrTimer_IrqHandler(void);
+
+#if !defined(__ARMCC_VERSION) && !defined(__arm__)
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Advance the simulated microsecond counter of host builds.
+///
+/// The callbacks of all timers whose deadline is reached on the way are invoked at their deadline.
+///
+/// \param delta_us
+/// The number of microseconds to advance.
+// --------------------------------------------------------------------------------------------------------------------
+void LibHrTimer_HostAdvance_us(const uint32_t delta_us);
+#endif
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Functions
+// --------------------------------------------------------------------------------------------------------------------
+#endif
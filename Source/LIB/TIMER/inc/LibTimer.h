@@ -14,6 +14,7 @@
 //  Includes 
 // --------------------------------------------------------------------------------------------------------------------
 #include "LibTypes.h"
+#include "LibTimerCfg.h"
 
 
 // -------------------------------------------------------------------------------------------------------------------- 
@@ -51,19 +52,62 @@
 /// \endcode
 ///
 /// \param callback
+/// The callback function to be invoked when the timer expires: from ISR context or, in case of
+/// LIBTIMERCFG_DEFERRED_CALLBACKS, from the context calling LibTimer_Dispatch().
+/// \param pData
+/// Pointer to user data passed back to the callback function.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTIMER_INIT_TIMER(callback, pData)		LIBTIMER_INIT_TIMER_EX(callback, pData, false)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Macro to initialize a timer instance structure whose callback is always invoked from the tick ISR.
+///
+/// This is only required for the few timers which cannot tolerate the latency of the deferred callback execution
+/// (LIBTIMERCFG_DEFERRED_CALLBACKS). Without deferred callback execution it is the same as LIBTIMER_INIT_TIMER().
+///
+/// \param callback
 /// The callback function to be invoked from ISR context when the timer expires.
 /// \param pData
 /// Pointer to user data passed back to the callback function.
 // --------------------------------------------------------------------------------------------------------------------
-#define LIBTIMER_INIT_TIMER(callback, pData)		{																\
+#define LIBTIMER_INIT_ISR_TIMER(callback, pData)	LIBTIMER_INIT_TIMER_EX(callback, pData, true)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Macro to initialize a timer instance structure, used by LIBTIMER_INIT_TIMER() and LIBTIMER_INIT_ISR_TIMER().
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTIMER_INIT_TIMER_EX(callback, pData, isIsrCallback)														\
+													{																\
 														NULL,			/* pNext */									\
 														NULL,			/* pPrev */									\
 														UINT32_C(0),	/* Timeout_ms */							\
 														UINT32_C(0),	/* Period_ms */								\
 														callback,		/* Callback */								\
 														pData			/* pData */									\
+														LIBTIMER_INIT_WHEEL_MEMBERS									\
+														LIBTIMER_INIT_DEFERRED_MEMBERS(isIsrCallback)				\
 													}
 
+#ifdef LIBTIMERCFG_TIMING_WHEEL
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Initializer of the members only present if the timing wheel backend is used.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTIMER_INIT_WHEEL_MEMBERS					, NULL		/* ppSlot */
+#else
+#define LIBTIMER_INIT_WHEEL_MEMBERS
+#endif
+
+#ifdef LIBTIMERCFG_DEFERRED_CALLBACKS
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Initializer of the members only present in case of deferred callback execution.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTIMER_INIT_DEFERRED_MEMBERS(isIsrCallback)																\
+													, NULL,				/* pNextReady */							\
+													UINT8_C(0),			/* ReadyState */							\
+													isIsrCallback		/* IsIsrCallback */
+#else
+#define LIBTIMER_INIT_DEFERRED_MEMBERS(isIsrCallback)
+#endif
+
 
 // --------------------------------------------------------------------------------------------------------------------
 //  Global Data Types
@@ -98,7 +142,7 @@ typedef struct S_LibTimer_Inst
 	uint32_t Period_ms;
 
 	// ----------------------------------------------------------------------------------------------------------------
-	/// \brief The callback function to be invoked from ISR context when the timer expires.
+	/// \brief The callback function to be invoked when the timer expires.
 	// ----------------------------------------------------------------------------------------------------------------
 	void (*Callback)(void* pData);
 
@@ -110,6 +154,32 @@ typedef struct S_LibTimer_Inst
 	// ----------------------------------------------------------------------------------------------------------------
 	void* pData;
 
+#ifdef LIBTIMERCFG_TIMING_WHEEL
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Pointer to the head of the timing wheel slot the timer is linked into (NULL if the timer is not running).
+	///
+	/// The slot head is required to remove the first entry of a slot in constant time.
+	// ----------------------------------------------------------------------------------------------------------------
+	struct S_LibTimer_Inst** ppSlot;
+#endif
+
+#ifdef LIBTIMERCFG_DEFERRED_CALLBACKS
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief The pointer to the next entry in the list of expired timers waiting for their callback.
+	// ----------------------------------------------------------------------------------------------------------------
+	struct S_LibTimer_Inst* pNextReady;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief The state of the timer regarding the list of expired timers (one of LIBTIMER_READY_xxx).
+	// ----------------------------------------------------------------------------------------------------------------
+	uint8_t ReadyState;
+
+	// ----------------------------------------------------------------------------------------------------------------
+	/// \brief Whether the callback is invoked from the tick ISR instead of LibTimer_Dispatch().
+	// ----------------------------------------------------------------------------------------------------------------
+	const bool_t IsIsrCallback;
+#endif
+
 } S_LibTimer_Inst_t;
 
 
@@ -135,6 +205,21 @@ uint32_t LibTimer_GetUpTime_ms(void);
 ///
 /// This function has to be called every millisecond in order to handle expired timers.
 ///
+/// \note
+/// With LIBTIMERCFG_DEFERRED_CALLBACKS only the callbacks of timers initialized by LIBTIMER_INIT_ISR_TIMER() are
+/// invoked here. All other expired timers are appended to a ready list and the dispatch callback registered by
+/// LibTimer_SetDispatchCallback() is invoked as soon as the list becomes non-empty.
+///
+/// \note
+/// With LIBTIMERCFG_TIMING_WHEEL the cost of a tick is constant apart from the callbacks of the expired timers: timers
+/// far in the future are parked on the coarser wheel levels and are moved one level down each time the finer level
+/// has completed a turn, so every timer is moved at most five times during its whole run.
+///
+/// \note
+/// Both backends handle the expired timers one by one: a periodic timer is re-armed and a one-shot timer stops
+/// running before its callback is invoked, so a callback can restart or stop its own timer. Stopping a timer which
+/// expires with the same tick but has not been handled yet suppresses its callback. The order of the callbacks of
+/// timers expiring with the same tick is unspecified and differs between the backends.
 /// \attention
 /// This function has to be called from ISR context or with interrupts disabled!
 // --------------------------------------------------------------------------------------------------------------------
@@ -184,6 +269,63 @@ void LibTimer_Stop(S_LibTimer_Inst_t* const pTimer);
 // --------------------------------------------------------------------------------------------------------------------
 uint32_t LibTimer_GetTimeLeft_ms(const S_LibTimer_Inst_t* const pTimer);
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Get the number of milliseconds until the timer management has to run again.
+///
+/// Used by the tickless idle mode of the RTOS to limit the number of suppressed ticks: the returned value is a lower
+/// bound of the time until the next timer expires. With LIBTIMERCFG_TIMING_WHEEL it is the time until the next timer
+/// expires or is moved to a finer level of the wheel.
+///
+/// \attention
+/// This function has to be called from ISR context or with interrupts disabled!
+/// \return
+/// The number of ticks which may be suppressed, 0 if expired timers are waiting for LibTimer_Dispatch() and
+/// UINT32_MAX if no timer is running.
+// --------------------------------------------------------------------------------------------------------------------
+uint32_t LibTimer_GetNextExpiry_ms(void);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Catch up on ticks which have been suppressed by the tickless idle mode of the RTOS.
+///
+/// The up time is advanced by the given number of milliseconds and every skipped tick is handled like LibTimer_Tick()
+/// would have done, so no expiry is lost if the sleep ends later than announced. No callback is invoked here, also
+/// not of the timers initialized by LIBTIMER_INIT_ISR_TIMER(): the expired timers are appended to the ready list and
+/// run by LibTimer_Dispatch(). Therefore LIBTIMERCFG_DEFERRED_CALLBACKS is required for the tickless idle mode.
+///
+/// \attention
+/// This function has to be called from ISR context or with interrupts disabled!
+/// \param ticks
+/// The number of suppressed milliseconds ticks.
+// --------------------------------------------------------------------------------------------------------------------
+void LibTimer_StepTicks(const uint32_t ticks);
+
+#ifdef LIBTIMERCFG_DEFERRED_CALLBACKS
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Register the function notifying the dispatch context about expired timers.
+///
+/// The function is invoked from the tick ISR each time the list of expired timers becomes non-empty, typically to
+/// wake up a high-priority task calling LibTimer_Dispatch().
+///
+/// \param callback
+/// The function to be invoked from ISR context (NULL to disable the notification).
+/// \param pData
+/// Pointer to user data passed back to the function.
+// --------------------------------------------------------------------------------------------------------------------
+void LibTimer_SetDispatchCallback(void (*callback)(void* pData), void* pData);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Invoke the callbacks of all expired timers in the ready list.
+///
+/// The callbacks are invoked in expiry order with interrupts enabled. A timer which expires again before its
+/// callback has been invoked gets its callback invoked only once, a timer which has been stopped before its callback
+/// has been invoked gets no callback.
+///
+/// \attention
+/// This function has to be called from task context only.
+// --------------------------------------------------------------------------------------------------------------------
+void LibTimer_Dispatch(void);
+#endif
+
 // --------------------------------------------------------------------------------------------------------------------
 //	Functions
 // --------------------------------------------------------------------------------------------------------------------
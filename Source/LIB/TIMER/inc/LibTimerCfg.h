@@ -0,0 +1,84 @@
+// --------------------------------------------------------------------------------------------------------------------
+///
+/// \file LibTimerCfg.h
+///
+/// \brief Configuration file for the timer management.
+///
+///
+///
+/// All Rights Reserved.
+///
+// --------------------------------------------------------------------------------------------------------------------
+
+
+#ifndef LIB_TIMER_CFG_H__INCLUDED
+#define LIB_TIMER_CFG_H__INCLUDED
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Includes
+// --------------------------------------------------------------------------------------------------------------------
+
+
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Global Definitions
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief In case that the active timers shall be managed by a hierarchical timing wheel (constant time start, stop
+/// and expiry) uncomment this line, otherwise comment it out to use the sorted double linked list.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTIMERCFG_TIMING_WHEEL
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief In case that the timer callbacks shall be invoked from a dispatch task calling LibTimer_Dispatch() instead
+/// of the tick ISR uncomment this line, otherwise comment it out.
+///
+/// Timers initialized by LIBTIMER_INIT_ISR_TIMER() always have their callback invoked from the tick ISR.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTIMERCFG_DEFERRED_CALLBACKS
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief The 32 bit general-purpose timer used as free running microsecond counter by LibHrTimer (TIM2 or TIM5).
+///
+/// The timer runs on the APB1 timer clock, the prescaler is derived from the clock configuration at initialization.
+/// Its interrupt handler has to call LibHrTimer_IrqHandler().
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTIMERCFG_HRTIMER_TIM				TIM2
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief The interrupt number of LIBTIMERCFG_HRTIMER_TIM.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTIMERCFG_HRTIMER_IRQN			TIM2_IRQn
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Enable the peripheral clock of LIBTIMERCFG_HRTIMER_TIM.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTIMERCFG_HRTIMER_CLK_ENABLE()	__HAL_RCC_TIM2_CLK_ENABLE()
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief The interrupt priority of LIBTIMERCFG_HRTIMER_TIM.
+///
+/// The timer callbacks use the FreeRTOS ISR API, so the priority must not be higher (numerically lower) than
+/// configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTIMERCFG_HRTIMER_IRQ_PRIORITY	5U
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Global Data Types
+// --------------------------------------------------------------------------------------------------------------------
+
+
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Imported Variables
+// --------------------------------------------------------------------------------------------------------------------
+
+
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Global Function Prototypes
+// --------------------------------------------------------------------------------------------------------------------
+
+
+#endif // LIB_TIMER_CFG_H__INCLUDED
@@ -0,0 +1,452 @@
+// -------------------------------------------------------------------------------------------------------------------- 
+/// 
+/// \file LibHrTimer.c
+/// 
+/// \brief LibHrTimer: one-shot timers with microsecond resolution
+/// 
+/// The active timers are kept in a compare queue sorted by their absolute deadline. Only the deadline of the first
+/// timer is programmed into the compare register of the hardware timer, so the number of interrupts is the number of
+/// distinct deadlines. The queue is expected to hold a handful of timers (transport protocol timing), the O(n)
+/// insertion is not an issue for this use case.
+/// 
+/// All Rights Reserved. 
+/// 
+// -------------------------------------------------------------------------------------------------------------------- 
+
+// -------------------------------------------------------------------------------------------------------------------- 
+//  Includes 
+// --------------------------------------------------------------------------------------------------------------------
+#include "LibHrTimer.h"
+#include "LibTypes.h"
+
+#if defined(__ARMCC_VERSION) || defined(__arm__)
+#include "stm32f7xx_hal.h"
+#endif
+
+
+// -------------------------------------------------------------------------------------------------------------------- 
+//  Local Definitions 
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Check whether the absolute time a is before the absolute time b (wrap-around safe).
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBHRTIMER_IS_BEFORE(a, b)		((int32_t)((uint32_t)(a) - (uint32_t)(b)) < 0)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief The frequency of the microsecond counter in Hz.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBHRTIMER_COUNTER_FREQ_HZ		UINT32_C(1000000)
+
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Data Types
+// --------------------------------------------------------------------------------------------------------------------
+
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Global Variables
+// --------------------------------------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Variables
+// --------------------------------------------------------------------------------------------------------------------	
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Pointer to the first timer in the compare queue.
+// --------------------------------------------------------------------------------------------------------------------
+static S_LibHrTimer_Inst_t* LibHrTimer_pFirstActiveTimer = NULL;
+
+#if !defined(__ARMCC_VERSION) && !defined(__arm__)
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief The simulated microsecond counter of host builds.
+// --------------------------------------------------------------------------------------------------------------------
+static uint32_t LibHrTimer_HostCounter_us = UINT32_C(0);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief The simulated compare register of host builds.
+// --------------------------------------------------------------------------------------------------------------------
+static uint32_t LibHrTimer_HostCompare_us = UINT32_C(0);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief The simulated compare interrupt enable of host builds.
+// --------------------------------------------------------------------------------------------------------------------
+static bool_t LibHrTimer_HostCompareEnabled = false;
+#endif
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Local Function Prototypes
+// --------------------------------------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Start the free running microsecond counter.
+// --------------------------------------------------------------------------------------------------------------------
+static void LibHrTimer_PortInit(void);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Read the free running microsecond counter.
+// --------------------------------------------------------------------------------------------------------------------
+static uint32_t LibHrTimer_PortGetCounter(void);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Program the compare match for the given deadline.
+///
+/// In case that the deadline has already been reached while programming, the compare interrupt is triggered by
+/// software so that no deadline can be missed.
+///
+/// \param deadline_us
+/// The absolute deadline in microseconds.
+// --------------------------------------------------------------------------------------------------------------------
+static void LibHrTimer_PortSetCompare(const uint32_t deadline_us);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Disable the compare match interrupt (compare queue empty).
+// --------------------------------------------------------------------------------------------------------------------
+static void LibHrTimer_PortDisableCompare(void);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Acknowledge a pending compare match interrupt.
+///
+/// \retval true
+/// A compare match interrupt was pending.
+/// \retval false
+/// No compare match interrupt was pending.
+// --------------------------------------------------------------------------------------------------------------------
+static bool_t LibHrTimer_PortAckCompare(void);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Program the compare match for the first timer in the compare queue or disable it if the queue is empty.
+///
+/// \attention
+/// This function has to be called with interrupts disabled.
+// --------------------------------------------------------------------------------------------------------------------
+static void LibHrTimer_UpdateCompare(void);
+
+// --------------------------------------------------------------------------------------------------------------------
+//	Functions
+// --------------------------------------------------------------------------------------------------------------------
+//=====================================================================================================================
+// LibHrTimer_Init:
+//=====================================================================================================================
+void LibHrTimer_Init(void)
+{
+	SuspendAllInterrupts();
+	LibHrTimer_pFirstActiveTimer = NULL;
+	LibHrTimer_PortInit();
+	ResumeAllInterrupts();
+}
+
+
+//=====================================================================================================================
+// LibHrTimer_GetTime_us:
+//=====================================================================================================================
+uint32_t LibHrTimer_GetTime_us(void)
+{
+	return LibHrTimer_PortGetCounter();
+}
+
+
+//=====================================================================================================================
+// LibHrTimer_Start:
+//=====================================================================================================================
+bool_t LibHrTimer_Start(S_LibHrTimer_Inst_t* const pTimer, const uint32_t timeout_us)
+{
+	bool_t retval = false;
+
+	SuspendAllInterrupts();
+	Lib_Assert(NULL != pTimer);
+	Lib_Assert((timeout_us > UINT32_C(0)) && (timeout_us <= LIBHRTIMER_MAX_TIMEOUT_US));
+	Lib_Assert(NULL != pTimer->Callback);
+	if (!pTimer->IsRunning)
+	{
+		S_LibHrTimer_Inst_t** ppEntry = &LibHrTimer_pFirstActiveTimer;
+
+		// add one microsecond: the counter may be about to increment, so the time waited would be too short
+		pTimer->Deadline_us = LibHrTimer_PortGetCounter() + timeout_us + 1U;
+		pTimer->IsRunning = true;
+
+		// insert behind all timers with the same or an earlier deadline
+		while ((NULL != *ppEntry) && !LIBHRTIMER_IS_BEFORE(pTimer->Deadline_us, (*ppEntry)->Deadline_us))
+		{
+			ppEntry = &(*ppEntry)->pNext;
+		}
+		pTimer->pNext = *ppEntry;
+		*ppEntry = pTimer;
+
+		// the compare match has to be moved if the timer is the new first entry
+		if (pTimer == LibHrTimer_pFirstActiveTimer)
+		{
+			LibHrTimer_UpdateCompare();
+		}
+		retval = true;
+	}
+	ResumeAllInterrupts();
+
+	return retval;
+}
+
+
+//=====================================================================================================================
+// LibHrTimer_Stop:
+//=====================================================================================================================
+void LibHrTimer_Stop(S_LibHrTimer_Inst_t* const pTimer)
+{
+	SuspendAllInterrupts();
+	Lib_Assert(NULL != pTimer);
+	if (pTimer->IsRunning)
+	{
+		S_LibHrTimer_Inst_t** ppEntry = &LibHrTimer_pFirstActiveTimer;
+		const bool_t wasFirst = (pTimer == LibHrTimer_pFirstActiveTimer);
+
+		while ((NULL != *ppEntry) && (pTimer != *ppEntry))
+		{
+			ppEntry = &(*ppEntry)->pNext;
+		}
+		if (NULL != *ppEntry)
+		{
+			*ppEntry = pTimer->pNext;
+		}
+		pTimer->pNext = NULL;
+		pTimer->IsRunning = false;
+
+		if (wasFirst)
+		{
+			LibHrTimer_UpdateCompare();
+		}
+	}
+	ResumeAllInterrupts();
+}
+
+
+//=====================================================================================================================
+// LibHrTimer_GetTimeLeft_us:
+//=====================================================================================================================
+uint32_t LibHrTimer_GetTimeLeft_us(const S_LibHrTimer_Inst_t* const pTimer)
+{
+	uint32_t retval = UINT32_C(0);
+
+	SuspendAllInterrupts();
+	Lib_Assert(NULL != pTimer);
+	if (pTimer->IsRunning)
+	{
+		const uint32_t now_us = LibHrTimer_PortGetCounter();
+		if (LIBHRTIMER_IS_BEFORE(now_us, pTimer->Deadline_us))
+		{
+			retval = pTimer->Deadline_us - now_us;
+		}
+	}
+	ResumeAllInterrupts();
+
+	return retval;
+}
+
+
+//=====================================================================================================================
+// LibHrTimer_IrqHandler:
+//=====================================================================================================================
+void LibHrTimer_IrqHandler(void)
+{
+	if (LibHrTimer_PortAckCompare())
+	{
+		S_LibHrTimer_Inst_t* pTimer;
+
+		do
+		{
+			// take the first timer from the compare queue if its deadline has been reached: the counter is read again
+			// for every timer as the callbacks take time themselves
+			SuspendAllInterrupts();
+			pTimer = LibHrTimer_pFirstActiveTimer;
+			if ((NULL != pTimer) && !LIBHRTIMER_IS_BEFORE(LibHrTimer_PortGetCounter(), pTimer->Deadline_us))
+			{
+				LibHrTimer_pFirstActiveTimer = pTimer->pNext;
+				pTimer->pNext = NULL;
+				pTimer->IsRunning = false;
+			}
+			else
+			{
+				pTimer = NULL;
+				LibHrTimer_UpdateCompare();
+			}
+			ResumeAllInterrupts();
+
+			if (NULL != pTimer)
+			{
+				pTimer->Callback(pTimer->pData);
+			}
+		} while (NULL != pTimer);
+	}
+}
+
+
+//=====================================================================================================================
+// LibHrTimer_UpdateCompare:
+//=====================================================================================================================
+static void LibHrTimer_UpdateCompare(void)
+{
+	if (NULL != LibHrTimer_pFirstActiveTimer)
+	{
+		LibHrTimer_PortSetCompare(LibHrTimer_pFirstActiveTimer->Deadline_us);
+	}
+	else
+	{
+		LibHrTimer_PortDisableCompare();
+	}
+}
+
+
+#if defined(__ARMCC_VERSION) || defined(__arm__)
+//=====================================================================================================================
+// LibHrTimer_PortInit:
+//=====================================================================================================================
+static void LibHrTimer_PortInit(void)
+{
+	TIM_TypeDef* const pTim = LIBTIMERCFG_HRTIMER_TIM;
+	uint32_t timerClock_Hz = HAL_RCC_GetPCLK1Freq();
+
+	// the APB1 timers run on twice the APB1 clock if the APB1 clock is divided
+	if (RCC_CFGR_PPRE1_DIV1 != (RCC->CFGR & RCC_CFGR_PPRE1))
+	{
+		timerClock_Hz *= 2U;
+	}
+
+	LIBTIMERCFG_HRTIMER_CLK_ENABLE();
+	pTim->CR1 = UINT32_C(0);
+	pTim->DIER = UINT32_C(0);
+	pTim->PSC = (timerClock_Hz / LIBHRTIMER_COUNTER_FREQ_HZ) - 1U;
+	pTim->ARR = UINT32_C(0xFFFFFFFF);
+	pTim->CCMR1 = UINT32_C(0);				// CC1 as output compare without output (frozen)
+	pTim->EGR = TIM_EGR_UG;					// load the prescaler
+	pTim->SR = UINT32_C(0);
+	pTim->CR1 = TIM_CR1_CEN;
+
+	HAL_NVIC_SetPriority(LIBTIMERCFG_HRTIMER_IRQN, LIBTIMERCFG_HRTIMER_IRQ_PRIORITY, 0U);
+	HAL_NVIC_EnableIRQ(LIBTIMERCFG_HRTIMER_IRQN);
+}
+
+
+//=====================================================================================================================
+// LibHrTimer_PortGetCounter:
+//=====================================================================================================================
+static uint32_t LibHrTimer_PortGetCounter(void)
+{
+	return LIBTIMERCFG_HRTIMER_TIM->CNT;
+}
+
+
+//=====================================================================================================================
+// LibHrTimer_PortSetCompare:
+//=====================================================================================================================
+static void LibHrTimer_PortSetCompare(const uint32_t deadline_us)
+{
+	TIM_TypeDef* const pTim = LIBTIMERCFG_HRTIMER_TIM;
+
+	pTim->CCR1 = deadline_us;
+	pTim->SR = ~TIM_SR_CC1IF;
+	pTim->DIER |= TIM_DIER_CC1IE;
+
+	// the counter may have passed the deadline before the compare register was written
+	if (!LIBHRTIMER_IS_BEFORE(pTim->CNT, deadline_us))
+	{
+		pTim->EGR = TIM_EGR_CC1G;
+	}
+}
+
+
+//=====================================================================================================================
+// LibHrTimer_PortDisableCompare:
+//=====================================================================================================================
+static void LibHrTimer_PortDisableCompare(void)
+{
+	LIBTIMERCFG_HRTIMER_TIM->DIER &= ~TIM_DIER_CC1IE;
+}
+
+
+//=====================================================================================================================
+// LibHrTimer_PortAckCompare:
+//=====================================================================================================================
+static bool_t LibHrTimer_PortAckCompare(void)
+{
+	TIM_TypeDef* const pTim = LIBTIMERCFG_HRTIMER_TIM;
+	const bool_t isPending = (0U != (pTim->SR & TIM_SR_CC1IF));
+
+	pTim->SR = ~TIM_SR_CC1IF;
+	return isPending;
+}
+#else
+//=====================================================================================================================
+// LibHrTimer_HostAdvance_us:
+//=====================================================================================================================
+void LibHrTimer_HostAdvance_us(const uint32_t delta_us)
+{
+	const uint32_t target_us = LibHrTimer_HostCounter_us + delta_us;
+
+	bool_t isDone = false;
+
+	// step from compare match to compare match so that the callbacks see the counter at their deadline
+	while (LibHrTimer_HostCompareEnabled && !isDone)
+	{
+		if (LIBHRTIMER_IS_BEFORE(LibHrTimer_HostCounter_us, LibHrTimer_HostCompare_us))
+		{
+			if (LIBHRTIMER_IS_BEFORE(target_us, LibHrTimer_HostCompare_us))
+			{
+				isDone = true;
+			}
+			else
+			{
+				LibHrTimer_HostCounter_us = LibHrTimer_HostCompare_us;
+				LibHrTimer_IrqHandler();
+			}
+		}
+		else
+		{
+			// the compare match has already been reached
+			LibHrTimer_IrqHandler();
+		}
+	}
+	LibHrTimer_HostCounter_us = target_us;
+}
+
+
+//=====================================================================================================================
+// LibHrTimer_PortInit:
+//=====================================================================================================================
+static void LibHrTimer_PortInit(void)
+{
+	LibHrTimer_HostCompareEnabled = false;
+}
+
+
+//=====================================================================================================================
+// LibHrTimer_PortGetCounter:
+//=====================================================================================================================
+static uint32_t LibHrTimer_PortGetCounter(void)
+{
+	return LibHrTimer_HostCounter_us;
+}
+
+
+//=====================================================================================================================
+// LibHrTimer_PortSetCompare:
+//=====================================================================================================================
+static void LibHrTimer_PortSetCompare(const uint32_t deadline_us)
+{
+	LibHrTimer_HostCompare_us = deadline_us;
+	LibHrTimer_HostCompareEnabled = true;
+}
+
+
+//=====================================================================================================================
+// LibHrTimer_PortDisableCompare:
+//=====================================================================================================================
+static void LibHrTimer_PortDisableCompare(void)
+{
+	LibHrTimer_HostCompareEnabled = false;
+}
+
+
+//=====================================================================================================================
+// LibHrTimer_PortAckCompare:
+//=====================================================================================================================
+static bool_t LibHrTimer_PortAckCompare(void)
+{
+	return LibHrTimer_HostCompareEnabled;
+}
+#endif
@@ -22,6 +22,57 @@
 // -------------------------------------------------------------------------------------------------------------------- 
 //  Local Definitions 
 // --------------------------------------------------------------------------------------------------------------------
+#ifdef LIBTIMERCFG_TIMING_WHEEL
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief The number of bits of the absolute timeout covered by one level of the timing wheel.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTIMER_WHEEL_SLOT_BITS		6U
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief The number of slots of one level of the timing wheel.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTIMER_WHEEL_SLOTS			(1U << LIBTIMER_WHEEL_SLOT_BITS)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Mask to get the slot index of a level from the shifted absolute timeout.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTIMER_WHEEL_SLOT_MASK		(LIBTIMER_WHEEL_SLOTS - 1U)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief The number of levels of the timing wheel: six levels of six bits cover the 32 bit absolute timeout (only
+/// four slots of the last level are used).
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTIMER_WHEEL_LEVELS			6U
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Check whether a timer is running, i.e. linked into a slot of the timing wheel.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTIMER_IS_RUNNING(pTimer)		(NULL != (pTimer)->ppSlot)
+#else
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Check whether a timer is running, i.e. linked into the active list or the list of timers expiring with the
+/// current tick.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTIMER_IS_RUNNING(pTimer)		((NULL != (pTimer)->pPrev) || ((pTimer) == LibTimer_pFirstActiveTimer)			\
+										 || ((pTimer) == LibTimer_pFirstExpiredTimer))
+#endif
+
+#ifdef LIBTIMERCFG_DEFERRED_CALLBACKS
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief The timer is not linked into the list of expired timers.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTIMER_READY_NONE				UINT8_C(0)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief The timer is linked into the list of expired timers and its callback is due.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTIMER_READY_QUEUED			UINT8_C(1)
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief The timer is linked into the list of expired timers but has been stopped: its callback is not due anymore.
+// --------------------------------------------------------------------------------------------------------------------
+#define LIBTIMER_READY_CANCELLED		UINT8_C(2)
+#endif
 
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -41,14 +92,121 @@
 // --------------------------------------------------------------------------------------------------------------------
 static volatile uint32_t LibTimer_UpTime_ms = UINT32_C(0);
 
+#ifdef LIBTIMERCFG_TIMING_WHEEL
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief The slots of the hierarchical timing wheel.
+///
+/// Each slot is the head of a double linked list of timers. Level 0 holds the timers expiring within the next
+/// LIBTIMER_WHEEL_SLOTS milliseconds indexed by the lowest bits of their absolute timeout, each further level holds
+/// the timers expiring within the next turn of that level indexed by the next higher bits of their absolute timeout.
+// --------------------------------------------------------------------------------------------------------------------
+static S_LibTimer_Inst_t* LibTimer_Wheel[LIBTIMER_WHEEL_LEVELS][LIBTIMER_WHEEL_SLOTS];
+#else
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief Pointer to the first timer in the active list.
 // --------------------------------------------------------------------------------------------------------------------
 static S_LibTimer_Inst_t* LibTimer_pFirstActiveTimer = NULL;
 
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Pointer to the first timer expiring with the current tick whose callback has not been handled yet.
+///
+/// The timers expiring with a tick are split off the active list before they are handled one by one, like the
+/// current slot of the timing wheel: until then they are still running and can be stopped by other callbacks.
+// --------------------------------------------------------------------------------------------------------------------
+static S_LibTimer_Inst_t* LibTimer_pFirstExpiredTimer = NULL;
+#endif
+
+#ifdef LIBTIMERCFG_DEFERRED_CALLBACKS
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Pointer to the first timer in the list of expired timers waiting for their callback.
+// --------------------------------------------------------------------------------------------------------------------
+static S_LibTimer_Inst_t* LibTimer_pFirstReadyTimer = NULL;
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Pointer to the last timer in the list of expired timers waiting for their callback.
+// --------------------------------------------------------------------------------------------------------------------
+static S_LibTimer_Inst_t* LibTimer_pLastReadyTimer = NULL;
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief The function notifying the dispatch context about expired timers.
+// --------------------------------------------------------------------------------------------------------------------
+static void (*LibTimer_DispatchCallback)(void* pData) = NULL;
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Pointer to user data passed back to the dispatch notification function.
+// --------------------------------------------------------------------------------------------------------------------
+static void* LibTimer_pDispatchData = NULL;
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Whether LibTimer_StepTicks() is catching up on suppressed ticks: all expired timers are only queued.
+// --------------------------------------------------------------------------------------------------------------------
+static bool_t LibTimer_IsSteppingTicks = false;
+#endif
+
 // --------------------------------------------------------------------------------------------------------------------
 //	Local Function Prototypes
 // --------------------------------------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Handle an expired timer: invoke its callback or, in case of deferred callback execution, append it to the
+/// list of expired timers.
+///
+/// \param pTimer
+/// Pointer to the timer.
+// --------------------------------------------------------------------------------------------------------------------
+static void LibTimer_Expire(S_LibTimer_Inst_t* const pTimer);
+
+#ifdef LIBTIMERCFG_TIMING_WHEEL
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Insert a timer into the timing wheel.
+///
+/// The level is selected by the distance between the absolute timeout and the given base time, the slot by the bits
+/// of the absolute timeout covered by that level. An absolute timeout equal to the base time is treated as a full
+/// wrap-around of the millisecond counter, as in the sorted list.
+///
+/// \param pTimer
+/// Pointer to the timer (not running).
+/// \param base_ms
+/// The last millisecond tick which has been handled by the timer management.
+// --------------------------------------------------------------------------------------------------------------------
+static void LibTimer_InsertIntoWheel(S_LibTimer_Inst_t* const pTimer, const uint32_t base_ms);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Link a timer in front of the given slot of the timing wheel.
+///
+/// \param pTimer
+/// Pointer to the timer (not running).
+/// \param ppSlot
+/// Pointer to the head of the slot.
+// --------------------------------------------------------------------------------------------------------------------
+static void LibTimer_LinkIntoSlot(S_LibTimer_Inst_t* const pTimer, S_LibTimer_Inst_t** const ppSlot);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Unlink a running timer from its slot of the timing wheel.
+///
+/// \param pTimer
+/// Pointer to the timer.
+// --------------------------------------------------------------------------------------------------------------------
+static void LibTimer_UnlinkFromSlot(S_LibTimer_Inst_t* const pTimer);
+
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Handle the timing wheel for a new millisecond tick.
+///
+/// The due slots of the coarser levels are moved one level down first, then the timers of the current level 0 slot
+/// are invoked.
+///
+/// \param upTime_ms
+/// The new number of milliseconds that have elapsed since the system was started.
+// --------------------------------------------------------------------------------------------------------------------
+static void LibTimer_ExpireWheel(const uint32_t upTime_ms);
+#else
+// --------------------------------------------------------------------------------------------------------------------
+/// \brief Handle the sorted timer list for a new millisecond tick.
+///
+/// \param upTime_ms
+/// The new number of milliseconds that have elapsed since the system was started.
+// --------------------------------------------------------------------------------------------------------------------
+static void LibTimer_ExpireList(const uint32_t upTime_ms);
+
 // --------------------------------------------------------------------------------------------------------------------
 /// \brief Insert a timer into the double linked timer list.
 ///
@@ -62,6 +220,7 @@ static S_LibTimer_Inst_t* LibTimer_pFirstActiveTimer = NULL;
 /// Pointer to the timer.
 // --------------------------------------------------------------------------------------------------------------------
 static void LibTimer_InsertIntoList(S_LibTimer_Inst_t* const pTimer);
+#endif
 
 // --------------------------------------------------------------------------------------------------------------------
 //	Functions
@@ -90,47 +249,28 @@ void LibTimer_Init(void)
 //=====================================================================================================================
 void LibTimer_Tick(void)
 {
-	S_LibTimer_Inst_t* pEntry = LibTimer_pFirstActiveTimer;
-	S_LibTimer_Inst_t* pPrevEntry = NULL;
 	const uint32_t upTime_ms = LibTimer_UpTime_ms + 1U;
+#ifdef LIBTIMERCFG_DEFERRED_CALLBACKS
+	const bool_t wasReadyListEmpty = (NULL == LibTimer_pFirstReadyTimer);
+#endif
 
 	// increment the number of milliseconds that have elapsed since the system was started
 	LibTimer_UpTime_ms = upTime_ms;
-	
-	// check for timers which have expired
-	while ((NULL != pEntry) && (upTime_ms == pEntry->Timeout_ms))
-	{
-		// the timer has expired, invoke the callback
-		pEntry->Callback(pEntry->pData);
-
-		// continue with the next timer
-		pPrevEntry = pEntry;
-		pEntry = pEntry->pNext;
-	}
 
-	// split the list after the last expired timer
-	if (NULL != pEntry)
-	{
-		pEntry->pPrev = NULL;
-	}
-	LibTimer_pFirstActiveTimer = pEntry;
+#ifdef LIBTIMERCFG_TIMING_WHEEL
+	LibTimer_ExpireWheel(upTime_ms);
+#else
+	LibTimer_ExpireList(upTime_ms);
+#endif
 
-	// remove the expired timers from the list and re-insert periodic timers
-	while (NULL != pPrevEntry)
+#ifdef LIBTIMERCFG_DEFERRED_CALLBACKS
+	// notify the dispatch context once the first expired timer is waiting: as long as the list is not empty, the
+	// dispatch context has not finished yet
+	if ((wasReadyListEmpty) && (NULL != LibTimer_pFirstReadyTimer) && (NULL != LibTimer_DispatchCallback))
 	{
-		// remove the timer from the list
-		S_LibTimer_Inst_t* const pTimer = pPrevEntry;
-		pPrevEntry = pTimer->pPrev;
-		pTimer->pNext = NULL;
-		pTimer->pPrev = NULL;
-
-		// re-insert periodic timers
-		if (UINT32_C(0) != pTimer->Period_ms)
-		{
-			pTimer->Timeout_ms = upTime_ms + pTimer->Period_ms;
-			LibTimer_InsertIntoList(pTimer);
-		}
+		LibTimer_DispatchCallback(LibTimer_pDispatchData);
 	}
+#endif
 }
 
 
@@ -145,13 +285,17 @@ bool_t LibTimer_Start(S_LibTimer_Inst_t* const pTimer, const uint32_t timeout_ms
 	Lib_Assert(NULL != pTimer);
 	Lib_Assert(timeout_ms > UINT32_C(0));
 	Lib_Assert(NULL != pTimer->Callback);
-	if (((NULL == pTimer->pPrev) && (pTimer != LibTimer_pFirstActiveTimer)))
+	if (!LIBTIMER_IS_RUNNING(pTimer))
 	{
 		// increment the number of milliseconds: the timer waits for the given amount of millisecond ticks to come, so 
 		// if this function is called in the middle of two millisecond ticks, the time waited would be too short
 		pTimer->Timeout_ms = LibTimer_UpTime_ms + timeout_ms + 1U;
 		pTimer->Period_ms = period_ms;
+#ifdef LIBTIMERCFG_TIMING_WHEEL
+		LibTimer_InsertIntoWheel(pTimer, LibTimer_UpTime_ms);
+#else
 		LibTimer_InsertIntoList(pTimer);
+#endif
 		retval = true;
 	}
 	ResumeAllInterrupts();
@@ -167,14 +311,22 @@ void LibTimer_Stop(S_LibTimer_Inst_t* const pTimer)
 {
 	SuspendAllInterrupts();
 	Lib_Assert(NULL != pTimer);
-	if ((NULL != pTimer->pPrev) || (pTimer == LibTimer_pFirstActiveTimer))
+	if (LIBTIMER_IS_RUNNING(pTimer))
 	{
+#ifdef LIBTIMERCFG_TIMING_WHEEL
+		LibTimer_UnlinkFromSlot(pTimer);
+#else
 		// remove the timer from the list: update the previous entry in the double linked list first
-		if (NULL == pTimer->pPrev)
+		if (pTimer == LibTimer_pFirstActiveTimer)
 		{
 			// remove the first entry from the list
 			LibTimer_pFirstActiveTimer = pTimer->pNext;
 		}
+		else if (pTimer == LibTimer_pFirstExpiredTimer)
+		{
+			// remove the first entry from the list of timers expiring with the current tick
+			LibTimer_pFirstExpiredTimer = pTimer->pNext;
+		}
 		else
 		{
 			// remove any other entry from the list
@@ -190,7 +342,15 @@ void LibTimer_Stop(S_LibTimer_Inst_t* const pTimer)
 		// reset the previous and next pointer of the timer
 		pTimer->pPrev = NULL;
 		pTimer->pNext = NULL;
+#endif
+	}
+#ifdef LIBTIMERCFG_DEFERRED_CALLBACKS
+	// the timer might have expired already with its callback still waiting for the dispatch: drop the callback
+	if (LIBTIMER_READY_QUEUED == pTimer->ReadyState)
+	{
+		pTimer->ReadyState = LIBTIMER_READY_CANCELLED;
 	}
+#endif
 	ResumeAllInterrupts();
 }
 
@@ -204,7 +364,7 @@ uint32_t LibTimer_GetTimeLeft_ms(const S_LibTimer_Inst_t* const pTimer)
 
 	SuspendAllInterrupts();
 	Lib_Assert(NULL != pTimer);
-	if ((NULL != pTimer->pPrev) || (pTimer == LibTimer_pFirstActiveTimer))
+	if (LIBTIMER_IS_RUNNING(pTimer))
 	{
 		retval = pTimer->Timeout_ms - LibTimer_UpTime_ms;
 	}
@@ -214,6 +374,352 @@ uint32_t LibTimer_GetTimeLeft_ms(const S_LibTimer_Inst_t* const pTimer)
 }
 
 
+//=====================================================================================================================
+// LibTimer_GetNextExpiry_ms:
+//=====================================================================================================================
+uint32_t LibTimer_GetNextExpiry_ms(void)
+{
+	const uint32_t upTime_ms = LibTimer_UpTime_ms;
+	uint32_t retval = UINT32_MAX;
+
+#ifdef LIBTIMERCFG_DEFERRED_CALLBACKS
+	if (NULL != LibTimer_pFirstReadyTimer)
+	{
+		// callbacks are still waiting for the dispatch context: the tick must not be suppressed
+		retval = UINT32_C(0);
+	}
+#endif
+
+#ifdef LIBTIMERCFG_TIMING_WHEEL
+	uint32_t level;
+
+	// the first occupied slot of each level gives the time the slot is handled: the expiry on level 0 and the cascade
+	// to a finer level on all other levels. The earliest of them is a lower bound of the next expiry.
+	for (level = 0U; level < LIBTIMER_WHEEL_LEVELS; level++)
+	{
+		const uint32_t shift = LIBTIMER_WHEEL_SLOT_BITS * level;
+		const uint32_t slotBits = ((32U - shift) < LIBTIMER_WHEEL_SLOT_BITS) ? (32U - shift) : LIBTIMER_WHEEL_SLOT_BITS;
+		const uint32_t slotMask = (UINT32_C(1) << slotBits) - 1U;
+		const uint32_t currentIndex = (upTime_ms >> shift) & slotMask;
+		uint32_t distance;
+
+		for (distance = 1U; distance <= (slotMask + 1U); distance++)
+		{
+			if (NULL != LibTimer_Wheel[level][(currentIndex + distance) & slotMask])
+			{
+				// the slot is handled once the finer levels have completed the given number of turns
+				const uint64_t slotTime_ms = ((uint64_t)distance << shift)
+					- (upTime_ms & ((UINT32_C(1) << shift) - 1U));
+				if (slotTime_ms < retval)
+				{
+					retval = (uint32_t)slotTime_ms;
+				}
+				break;
+			}
+		}
+	}
+#else
+	if (NULL != LibTimer_pFirstActiveTimer)
+	{
+		const uint32_t timeLeft_ms = LibTimer_pFirstActiveTimer->Timeout_ms - upTime_ms;
+
+		// a time left of zero means a full wrap-around of the up time
+		if ((UINT32_C(0) != timeLeft_ms) && (timeLeft_ms < retval))
+		{
+			retval = timeLeft_ms;
+		}
+	}
+#endif
+
+	return retval;
+}
+
+
+//=====================================================================================================================
+// LibTimer_StepTicks:
+//=====================================================================================================================
+void LibTimer_StepTicks(const uint32_t ticks)
+{
+	uint32_t tick;
+
+	// the skipped ticks are handled one by one: the suppression is limited to the next expiry, so apart from the
+	// up time normally nothing happens here. The RTOS calls this with the scheduler suspended and the interrupts
+	// disabled, so no callback is invoked here, not even of the ISR timers: the expired timers are only queued for
+	// LibTimer_Dispatch().
+#ifdef LIBTIMERCFG_DEFERRED_CALLBACKS
+	LibTimer_IsSteppingTicks = true;
+#endif
+	for (tick = 0U; tick < ticks; tick++)
+	{
+		LibTimer_Tick();
+	}
+#ifdef LIBTIMERCFG_DEFERRED_CALLBACKS
+	LibTimer_IsSteppingTicks = false;
+#endif
+}
+
+
+#ifdef LIBTIMERCFG_DEFERRED_CALLBACKS
+//=====================================================================================================================
+// LibTimer_SetDispatchCallback:
+//=====================================================================================================================
+void LibTimer_SetDispatchCallback(void (*callback)(void* pData), void* pData)
+{
+	SuspendAllInterrupts();
+	LibTimer_DispatchCallback = callback;
+	LibTimer_pDispatchData = pData;
+	ResumeAllInterrupts();
+}
+
+
+//=====================================================================================================================
+// LibTimer_Dispatch:
+//=====================================================================================================================
+void LibTimer_Dispatch(void)
+{
+	S_LibTimer_Inst_t* pTimer;
+
+	do
+	{
+		bool_t isDue = false;
+
+		// take the first timer from the list of expired timers
+		SuspendAllInterrupts();
+		pTimer = LibTimer_pFirstReadyTimer;
+		if (NULL != pTimer)
+		{
+			LibTimer_pFirstReadyTimer = pTimer->pNextReady;
+			if (NULL == LibTimer_pFirstReadyTimer)
+			{
+				LibTimer_pLastReadyTimer = NULL;
+			}
+			pTimer->pNextReady = NULL;
+			isDue = (LIBTIMER_READY_QUEUED == pTimer->ReadyState);
+			pTimer->ReadyState = LIBTIMER_READY_NONE;
+		}
+		ResumeAllInterrupts();
+
+		// invoke the callback with interrupts enabled
+		if (isDue)
+		{
+			pTimer->Callback(pTimer->pData);
+		}
+	} while (NULL != pTimer);
+}
+#endif
+
+
+//=====================================================================================================================
+// LibTimer_Expire:
+//=====================================================================================================================
+static void LibTimer_Expire(S_LibTimer_Inst_t* const pTimer)
+{
+#ifdef LIBTIMERCFG_DEFERRED_CALLBACKS
+	if ((pTimer->IsIsrCallback) && (!LibTimer_IsSteppingTicks))
+	{
+		pTimer->Callback(pTimer->pData);
+	}
+	else if (LIBTIMER_READY_NONE == pTimer->ReadyState)
+	{
+		// append the timer to the list of expired timers
+		if (NULL == LibTimer_pLastReadyTimer)
+		{
+			LibTimer_pFirstReadyTimer = pTimer;
+		}
+		else
+		{
+			LibTimer_pLastReadyTimer->pNextReady = pTimer;
+		}
+		LibTimer_pLastReadyTimer = pTimer;
+		pTimer->ReadyState = LIBTIMER_READY_QUEUED;
+	}
+	else
+	{
+		// the timer is still linked into the list of expired timers: a pending callback is invoked only once
+		pTimer->ReadyState = LIBTIMER_READY_QUEUED;
+	}
+#else
+	pTimer->Callback(pTimer->pData);
+#endif
+}
+
+
+#ifdef LIBTIMERCFG_TIMING_WHEEL
+//=====================================================================================================================
+// LibTimer_InsertIntoWheel:
+//=====================================================================================================================
+static void LibTimer_InsertIntoWheel(S_LibTimer_Inst_t* const pTimer, const uint32_t base_ms)
+{
+	const uint32_t delta_ms = pTimer->Timeout_ms - base_ms;
+	uint32_t level = 0U;
+
+	if (UINT32_C(0) == delta_ms)
+	{
+		// the absolute timeout is only reached again after a full wrap-around: park on the coarsest level
+		level = LIBTIMER_WHEEL_LEVELS - 1U;
+	}
+	else
+	{
+		// select the finest level whose turn covers the distance to the absolute timeout
+		while ((level < (LIBTIMER_WHEEL_LEVELS - 1U))
+			&& ((delta_ms >> (LIBTIMER_WHEEL_SLOT_BITS * (level + 1U))) != 0U))
+		{
+			level++;
+		}
+	}
+
+	LibTimer_LinkIntoSlot(pTimer,
+		&LibTimer_Wheel[level][(pTimer->Timeout_ms >> (LIBTIMER_WHEEL_SLOT_BITS * level)) & LIBTIMER_WHEEL_SLOT_MASK]);
+}
+
+
+//=====================================================================================================================
+// LibTimer_LinkIntoSlot:
+//=====================================================================================================================
+static void LibTimer_LinkIntoSlot(S_LibTimer_Inst_t* const pTimer, S_LibTimer_Inst_t** const ppSlot)
+{
+	Lib_Assert((NULL == pTimer->pPrev) && (NULL == pTimer->pNext) && (NULL == pTimer->ppSlot));
+
+	pTimer->pNext = *ppSlot;
+	if (NULL != *ppSlot)
+	{
+		(*ppSlot)->pPrev = pTimer;
+	}
+	*ppSlot = pTimer;
+	pTimer->ppSlot = ppSlot;
+}
+
+
+//=====================================================================================================================
+// LibTimer_UnlinkFromSlot:
+//=====================================================================================================================
+static void LibTimer_UnlinkFromSlot(S_LibTimer_Inst_t* const pTimer)
+{
+	// update the previous entry or the slot head in case of the first entry
+	if (NULL == pTimer->pPrev)
+	{
+		*pTimer->ppSlot = pTimer->pNext;
+	}
+	else
+	{
+		pTimer->pPrev->pNext = pTimer->pNext;
+	}
+
+	// update the next entry in the double linked list
+	if (NULL != pTimer->pNext)
+	{
+		pTimer->pNext->pPrev = pTimer->pPrev;
+	}
+
+	pTimer->pPrev = NULL;
+	pTimer->pNext = NULL;
+	pTimer->ppSlot = NULL;
+}
+
+
+//=====================================================================================================================
+// LibTimer_ExpireWheel:
+//=====================================================================================================================
+static void LibTimer_ExpireWheel(const uint32_t upTime_ms)
+{
+	S_LibTimer_Inst_t** const ppCurrentSlot = &LibTimer_Wheel[0][upTime_ms & LIBTIMER_WHEEL_SLOT_MASK];
+	uint32_t level = 0U;
+
+	// a level is due each time all finer levels have completed a turn: search for the coarsest level which is due
+	while ((level < (LIBTIMER_WHEEL_LEVELS - 1U))
+		&& (((upTime_ms >> (LIBTIMER_WHEEL_SLOT_BITS * level)) & LIBTIMER_WHEEL_SLOT_MASK) == 0U))
+	{
+		level++;
+	}
+
+	// move the timers of the due slots to the finer levels, starting at the coarsest level
+	for (; level > 0U; level--)
+	{
+		S_LibTimer_Inst_t** const ppSlot =
+			&LibTimer_Wheel[level][(upTime_ms >> (LIBTIMER_WHEEL_SLOT_BITS * level)) & LIBTIMER_WHEEL_SLOT_MASK];
+
+		while (NULL != *ppSlot)
+		{
+			S_LibTimer_Inst_t* const pTimer = *ppSlot;
+			LibTimer_UnlinkFromSlot(pTimer);
+			if (upTime_ms == pTimer->Timeout_ms)
+			{
+				// the timer expires with this tick
+				LibTimer_LinkIntoSlot(pTimer, ppCurrentSlot);
+			}
+			else
+			{
+				// the distance is below the turn of the current level now, so the timer ends up on a finer level
+				LibTimer_InsertIntoWheel(pTimer, upTime_ms);
+			}
+		}
+	}
+
+	// all timers of the current slot have expired: re-insert periodic timers and handle the callbacks. Timers (re-)
+	// started by the callbacks expire at least one tick later, so they never end up in the current slot.
+	while (NULL != *ppCurrentSlot)
+	{
+		S_LibTimer_Inst_t* const pTimer = *ppCurrentSlot;
+		LibTimer_UnlinkFromSlot(pTimer);
+		if (UINT32_C(0) != pTimer->Period_ms)
+		{
+			pTimer->Timeout_ms = upTime_ms + pTimer->Period_ms;
+			LibTimer_InsertIntoWheel(pTimer, upTime_ms);
+		}
+		LibTimer_Expire(pTimer);
+	}
+}
+#else
+//=====================================================================================================================
+// LibTimer_ExpireList:
+//=====================================================================================================================
+static void LibTimer_ExpireList(const uint32_t upTime_ms)
+{
+	S_LibTimer_Inst_t* pEntry = LibTimer_pFirstActiveTimer;
+	S_LibTimer_Inst_t* pPrevEntry = NULL;
+
+	// search for the timers which have expired
+	while ((NULL != pEntry) && (upTime_ms == pEntry->Timeout_ms))
+	{
+		pPrevEntry = pEntry;
+		pEntry = pEntry->pNext;
+	}
+
+	// split the list after the last expired timer: re-inserted timers must not be sorted in between the expired ones
+	if (NULL != pPrevEntry)
+	{
+		LibTimer_pFirstExpiredTimer = LibTimer_pFirstActiveTimer;
+		pPrevEntry->pNext = NULL;
+		if (NULL != pEntry)
+		{
+			pEntry->pPrev = NULL;
+		}
+		LibTimer_pFirstActiveTimer = pEntry;
+	}
+
+	// remove the expired timers from the list, re-insert periodic timers and handle the callbacks, the same as the
+	// timing wheel does. Timers (re-)started by the callbacks expire at least one tick later, so they are never
+	// handled again with this tick.
+	while (NULL != LibTimer_pFirstExpiredTimer)
+	{
+		S_LibTimer_Inst_t* const pTimer = LibTimer_pFirstExpiredTimer;
+		LibTimer_pFirstExpiredTimer = pTimer->pNext;
+		if (NULL != LibTimer_pFirstExpiredTimer)
+		{
+			LibTimer_pFirstExpiredTimer->pPrev = NULL;
+		}
+		pTimer->pNext = NULL;
+
+		if (UINT32_C(0) != pTimer->Period_ms)
+		{
+			pTimer->Timeout_ms = upTime_ms + pTimer->Period_ms;
+			LibTimer_InsertIntoList(pTimer);
+		}
+		LibTimer_Expire(pTimer);
+	}
+}
+
+
 //=====================================================================================================================
 // LibTimer_InsertIntoList:
 //=====================================================================================================================
@@ -287,5 +793,4 @@ static void LibTimer_InsertIntoList(S_LibTimer_Inst_t* const pTimer)
 		}
 	}
 }
-
-
+#endif
@@ -22,6 +22,11 @@
 //#include "LibCanMsg.h"
 #include "FreeRTOS.h"
 #include "UartIF.h"
+#if defined(__ARMCC_VERSION) || defined(__arm__)
+#include "stm32f7xx.h"
+#else
+#include <time.h>
+#endif
 /*******************************************************************************
 	Global Data Types
 *******************************************************************************/
@@ -214,10 +219,45 @@ typedef union U8BYTES
 #define Lib_Assert(condition)	    do { if (!(condition)) { Exception(); } } while(false)
 #define LIB_UNUSED(x)               ((void)(x))
 
-#define LibLog_Info(format, ...)       VirtualPrintf/* printf */
-#define LibLog_Debug(format, ...)      VirtualPrintf/* printf */
-#define LibLog_Warning(format, ...)    VirtualPrintf/* printf */
-#define LibLog_Error(format, ...)      VirtualPrintf/* printf */
+/* lock-free read-modify-write of one word, compiled to LDREX/STREX loops on the Cortex-M7 and to the native atomics
+   on host builds; usable from tasks and interrupt service routines without suspending interrupts */
+#define LibAtomic_Load(pVar)               __atomic_load_n((pVar), __ATOMIC_ACQUIRE)
+#define LibAtomic_Store(pVar, value)       __atomic_store_n((pVar), (value), __ATOMIC_RELEASE)
+#define LibAtomic_FetchOr(pVar, mask)      __atomic_fetch_or((pVar), (mask), __ATOMIC_ACQ_REL)
+#define LibAtomic_FetchAnd(pVar, mask)     __atomic_fetch_and((pVar), (mask), __ATOMIC_ACQ_REL)
+#define LibAtomic_FetchAdd(pVar, value)    __atomic_fetch_add((pVar), (value), __ATOMIC_ACQ_REL)
+#define LibAtomic_CompareExchange(pVar, pExpected, desired)\
+	__atomic_compare_exchange_n((pVar), (pExpected), (desired), false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+
+/* free running clock for time stamps and execution time measurements (FSM trace, service profiling): the DWT cycle
+   counter of the Cortex-M7 in CPU cycles (wraps after ~19.8 s at 216 MHz), the monotonic clock in nanoseconds on host
+   builds (wraps after ~4.3 s, clock() is too coarse to time a single service call); the lock access register of the
+   DWT has to be unlocked on the Cortex-M7 before the counter can be enabled */
+#if defined(__ARMCC_VERSION) || defined(__arm__)
+#define LibCycleClock_Init()\
+	do {\
+		CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;\
+		DWT->LAR = UINT32_C(0xC5ACCE55);\
+		DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;\
+	} while (false)
+#define LibCycleClock_Get()                (DWT->CYCCNT)
+#else
+#define LibCycleClock_Init()               do { } while (false)
+#define LibCycleClock_Get()                LibCycleClock_GetHost()
+static inline uint32_t LibCycleClock_GetHost(void)
+{
+	struct timespec now;
+	(void)clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint32_t)(((uint64_t)now.tv_sec * UINT64_C(1000000000)) + (uint64_t)now.tv_nsec);
+}
+#endif
+
+/* the logs are compiled out: the arguments are type checked and count as used, but neither evaluated nor printed */
+#define LibLog_Disabled(format, ...)   do { if (false) { (void)VirtualPrintf((format), ##__VA_ARGS__); } } while (false)
+#define LibLog_Info(format, ...)       LibLog_Disabled((format), ##__VA_ARGS__)
+#define LibLog_Debug(format, ...)      LibLog_Disabled((format), ##__VA_ARGS__)
+#define LibLog_Warning(format, ...)    LibLog_Disabled((format), ##__VA_ARGS__)
+#define LibLog_Error(format, ...)      LibLog_Disabled((format), ##__VA_ARGS__)
 
 void STR16_BIG(uint8_t* pDesbuff, uint16_t Sourdata);
 void STR32_BIG(uint8_t* pDesbuff, uint32_t Sourdata);